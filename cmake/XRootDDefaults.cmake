@@ -21,3 +21,13 @@ option( ENABLE_PYTHON    "Enable python bindings."
 option( XRDCL_ONLY       "Build only the client and necessary dependencies"               FALSE )
 option( ENABLE_CRC32C    "Build crc32c submodule"                                         TRUE )
 define_default( XRD_PYTHON_REQ_VERSION 2.4 )
+define_default( XRDCMS_MAXNODES   256 )
+
+#-------------------------------------------------------------------------------
+# The cmsd server masks have one bit per subscriber, in 64 bit words
+#-------------------------------------------------------------------------------
+math( EXPR XRDCMS_MAXNODES_REM "${XRDCMS_MAXNODES} % 64" )
+if( NOT XRDCMS_MAXNODES_REM EQUAL 0 OR XRDCMS_MAXNODES LESS 64 )
+  message( FATAL_ERROR "XRDCMS_MAXNODES must be a positive multiple of 64" )
+endif()
+add_definitions( -DXRDCMS_MAXNODES=${XRDCMS_MAXNODES} )
@@ -115,6 +115,7 @@ enum CmsReqCode            // Request Codes
      kYR_update  = 25,
      kYR_usage   = 26,
      kYR_xauth   = 27,
+     kYR_nsfilt  = 28,
      kYR_MaxReq            // Count of request numbers (highest + 1)
 };
 
@@ -229,9 +230,12 @@ struct CmsGoneRequest
 // Request: have <path>
 // Respond: n/a
 //
+// When the Batch modifier is set the request holds a sequence of raw
+// CmsBatchEntry items instead of a single path (see the state request).
+//
 struct CmsHaveRequest
 {      CmsRRHdr      Hdr;
-       enum          {Online = 1, Pending = 2};  // Modifiers
+       enum          {Online = 1, Pending = 2, Batch = 4};  // Modifiers
 //     kXR_string    Path;
 };
 
@@ -299,6 +303,8 @@ struct CmsLoginData
                   kYR_suspend =   0x00000100,   // Suspended login
                   kYR_nostage =   0x00000200,   // Staging unavailable
                   kYR_trying  =   0x00000400,   // Extensive login retries
+                  kYR_batchq  =   0x00000800,   // Accepts batched state
+                  kYR_nsfilter=   0x00001000,   // Accepts namespace filters
                   kYR_debug   =   0x80000000,
                   kYR_share   =   0x7f000000,   // Mask to isolate share
                   kYR_shift   =   24,           // Share shift position
@@ -322,6 +328,7 @@ struct CmsLoginResponse
 /******************************************************************************/
   
 // Request: load <cpu> <io> <load> <mem> <pag> <util> <dskfree>
+//               [<svctime> <inflight>]
 // Respond: n/a
 //
 struct CmsLoadRequest
@@ -330,6 +337,8 @@ struct CmsLoadRequest
                      numLoad};
 //     kXR_char      theLoad[numload];
 //     kXR_int       dskFree;
+//     kXR_int       svcTime;  // Optional: average service time in ms
+//     kXR_int       inFlight; // Optional: requests currently in progress
 };
 
 /******************************************************************************/
@@ -374,6 +383,40 @@ struct CmsMvRequest {
 //     kXR_string    New_Path;
 };
 
+/******************************************************************************/
+/*                        n s f i l t   R e q u e s t                         */
+/******************************************************************************/
+
+// Request: nsfilt <gen> <base> <words> <hashes> [<offs> <count> <bits>] ...
+// Respond: n/a
+//
+// A data server sends a Bloom filter of its exported name space to managers
+// that logged it in with kYR_nsfilter. It is always sent raw and spans as many
+// requests as needed, all with the same generation, the first one flagged
+// kYR_nsfirst and the last one kYR_nslast. When base is zero the filter is
+// sent in full. Otherwise, only words that changed relative to generation
+// base are sent. The filter is a sequence of 32-bit words that follows the
+// request as runs, each run being a CmsNSFiltRun followed by count words.
+//
+struct CmsNSFiltRequest
+{      CmsRRHdr      Hdr;
+       kXR_unt32     Gen;      // Generation of the filter
+       kXR_unt32     Base;     // Generation being updated (0 -> full filter)
+       kXR_unt32     Words;    // Number of words in the filter (power of 2)
+       kXR_char      Hashes;   // Number of bits set per path
+       kXR_char      Rsvd[3];
+
+enum  {kYR_nsfirst = 0x01,     // Modifier
+       kYR_nslast  = 0x02
+      };
+};
+
+struct CmsNSFiltRun
+{      kXR_unt32     Offs;     // Word offset of the run
+       kXR_unt32     Count;    // Number of words in the run
+//     kXR_unt32     Bits[Count];
+};
+
 /******************************************************************************/
 /*                          p i n g   R e q u e s t                           */
 /******************************************************************************/
@@ -549,9 +592,24 @@ struct CmsStateRequest
 
 enum  {kYR_refresh = 0x01,   // Modifier
        kYR_noresp  = 0x02,
+       kYR_batch   = 0x04,
        kYR_metaman = 0x08
       };
 };
+
+// A raw state request with the kYR_batch modifier, sent only to nodes that
+// logged in with kYR_batchq, holds a sequence of the entries below; each one
+// describing what would otherwise have been a separate request. Found files
+// are reported back in a single have request with the Batch modifier whose
+// entries carry the have modifier. The hash is opaque, as is the streamid.
+//
+struct CmsBatchEntry
+{      kXR_unt32     Hash;   // The streamid for the path
+       kXR_char      Mods;   // The modifier for the path
+       kXR_char      Rsvd;
+       kXR_unt16     Plen;   // Length of the path including the null byte
+//     kXR_char      Path[Plen];
+};
   
 /******************************************************************************/
 /*                        s t a t f s   R e q u e s t                         */
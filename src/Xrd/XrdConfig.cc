@@ -187,12 +187,14 @@ XrdConfig::XrdConfig()
    mySitName= 0;
    AdminPath= strdup("/tmp");
    HomePath = 0;
+   LocalSock= 0;
    tlsCert  = 0;
    tlsKey   = 0;
    caDir    = 0;
    caFile   = 0;
    AdminMode= 0700;
    HomeMode = 0700;
+   LocalMode= 0700;
    Police   = 0;
    Net_Opts = XRDNET_KEEPALIVE;
    TLS_Blen = 0;  // Accept OS default (leave Linux autotune in effect)
@@ -206,6 +208,7 @@ XrdConfig::XrdConfig()
    tlsNoVer   = false;
    NetTCPlep  = -1;
    NetADM     = 0;
+   NetLCL     = 0;
    coreV      = 1;
    memset(NetTCP, 0, sizeof(NetTCP));
 
@@ -547,6 +550,11 @@ int XrdConfig::Configure(int argc, char **argv)
        XrdSysThread::setDebug(&Log);
       }
 
+// Establish how tls sessions are resumed. This applies to all server-side
+// contexts, including those made by protocols.
+//
+   XrdTlsContext::SetSessionParms(tlsSess);
+
 // If tls enabled, set it up
 //
    if (!tlsCert) ProtInfo.tlsCtx= 0;
@@ -654,6 +662,7 @@ int XrdConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest)
    TS_Xeq("adminpath",     xapath);
    TS_Xeq("allow",         xallow);
    TS_Xeq("homepath",      xhpath);
+   TS_Xeq("localsock",     xlsock);
    TS_Xeq("port",          xport);
    TS_Xeq("protocol",      xprot);
    TS_Xeq("report",        xrep);
@@ -661,6 +670,7 @@ int XrdConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest)
    TS_Xeq("timeout",       xtmo);
    TS_Xeq("tls",           xtls);
    TS_Xeq("tlsca",         xtlsca);
+   TS_Xeq("tlssession",    xtlssess);
    }
 
    // No match found, complain.
@@ -1135,6 +1145,17 @@ int XrdConfig::Setup(char *dfltp, char *libProt)
          Firstcp = cp->Next; delete cp;
         }
 
+// If a local named socket was requested, create a network for it. It serves
+// the same protocols as the default port (e.g. for a local connection broker).
+//
+   if (LocalSock)
+      {NetLCL = new XrdInet(&Log, &XrdTrace, Police);
+       if (myDomain) NetLCL->setDomain(myDomain);
+       if (NetLCL->Bind(LocalSock, "tcp")) return 1;
+       chmod(LocalSock, LocalMode); // This may fail on some platforms
+       TRACE(NET, "local socket " <<LocalSock);
+      }
+
 // Leave the env port number to be the first used port number. This may
 // or may not be the same as the default port number.
 //
@@ -1548,6 +1569,60 @@ int XrdConfig::xnkap(XrdSysError *eDest, char *val)
    return 0;
 }
   
+/******************************************************************************/
+/*                                x l s o c k                                 */
+/******************************************************************************/
+
+/* Function: xlsock
+
+   Purpose:  To parse the directive: localsock <path> [group | all]
+
+             <path>    the path of the named socket on which local clients may
+                       connect using the protocols of the default port.
+
+             group     allows group access to the socket.
+
+             all       allows everyone access to the socket.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdConfig::xlsock(XrdSysError *eDest, XrdOucStream &Config)
+{
+    char *pval, *val;
+    mode_t mode = S_IRWXU;
+
+// Get the path
+//
+   pval = Config.GetWord();
+   if (!pval || !pval[0])
+      {eDest->Emsg("Config", "localsock path not specified"); return 1;}
+
+// Make sure it's an absolute path that fits in a socket address
+//
+   if (*pval != '/')
+      {eDest->Emsg("Config", "localsock path not absolute"); return 1;}
+   if (strlen(pval) >= 108)
+      {eDest->Emsg("Config", "localsock path", pval, "too long"); return 1;}
+
+// Get the optional access rights
+//
+   if ((val = Config.GetWord()) && val[0])
+      {     if (!strcmp("group", val)) mode |= S_IRWXG;
+       else if (!strcmp("all",   val)) mode |= S_IRWXG | S_IRWXO;
+       else {eDest->Emsg("Config", "invalid localsock modifier -", val);
+             return 1;
+            }
+      }
+
+// Record the path
+//
+   if (LocalSock) free(LocalSock);
+   LocalSock = strdup(pval);
+   LocalMode = mode;
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 x p o r t                                  */
 /******************************************************************************/
@@ -1724,7 +1799,8 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
         {"sched",    XRD_STATS_SCHD},
         {"sgen",     XRD_STATS_SGEN},
         {"sync",     XRD_STATS_SYNC},
-        {"syncwp",   XRD_STATS_SYNCA}
+        {"syncwp",   XRD_STATS_SYNCA},
+        {"tls",      XRD_STATS_TLS}
        };
    int i, neg, numopts = sizeof(rpopts)/sizeof(struct repopts);
    char  *val, *cp;
@@ -2064,6 +2140,76 @@ int XrdConfig::xtlsca(XrdSysError *eDest, XrdOucStream &Config)
    return 0;
 }
   
+/******************************************************************************/
+/*                               x t l s s e s s                              */
+/******************************************************************************/
+
+/* Function: xtlssess
+
+   Purpose:  To parse directive: tlssession [off] [cache <n>] [lifetime <sec>]
+                                            [rotate <sec>] [[no]tickets]
+
+             off      sessions are not resumed; this is the same as specifying
+                      cache 0 notickets.
+             cache    the maximum number of sessions kept for resumption by
+                      clients that do not use session tickets (default 20480).
+             lifetime the number of seconds a session may be resumed
+                      (default 3600).
+             rotate   the number of seconds between session ticket key
+                      rotations (default 3600). A ticket is honored for at
+                      least this long after it is issued.
+             tickets  issue session tickets (the default). Specify notickets
+                      to only resume sessions from the cache.
+
+   Output: 0 upon success or 1 upon failure.
+*/
+
+int XrdConfig::xtlssess(XrdSysError *eDest, XrdOucStream &Config)
+{
+   char *val, kword[16];
+   int  num;
+
+   if (!(val = Config.GetWord()))
+      {eDest->Emsg("Config", "tlssession parameter not specified"); return 1;}
+
+   do {     if (!strcmp(val, "off"))
+               {tlsSess.cacheMax = 0; tlsSess.tickets = false;}
+       else if (!strcmp(val, "tickets"))   tlsSess.tickets = true;
+       else if (!strcmp(val, "notickets")) tlsSess.tickets = false;
+       else {if (strlen(val) >= (int)sizeof(kword))
+                {eDest->Emsg("Config", "Invalid tlssession parameter -", val);
+                 return 1;
+                }
+             strcpy(kword, val);
+             if (!(val = Config.GetWord()))
+                {eDest->Emsg("Config","tlssession",kword,"value not specified");
+                 return 1;
+                }
+                  if (!strcmp(kword, "cache"))
+                     {if (XrdOuca2x::a2i(*eDest, "tlssession cache", val,
+                                         &num, 0)) return 1;
+                      tlsSess.cacheMax = num;
+                     }
+             else if (!strcmp(kword, "lifetime"))
+                     {if (XrdOuca2x::a2tm(*eDest, "tlssession lifetime", val,
+                                          &num, 1)) return 1;
+                      tlsSess.lifetime = num;
+                     }
+             else if (!strcmp(kword, "rotate"))
+                     {if (XrdOuca2x::a2tm(*eDest, "tlssession rotate", val,
+                                          &num, 60)) return 1;
+                      tlsSess.rotate = num;
+                     }
+             else {eDest->Emsg("Config", "Invalid tlssession parameter -",
+                               kword);
+                   return 1;
+                  }
+            }
+      } while((val = Config.GetWord()));
+
+   return 0;
+}
+
 /******************************************************************************/
 /*                                  x t m o                                   */
 /******************************************************************************/
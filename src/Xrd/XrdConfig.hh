@@ -39,6 +39,7 @@
 #include "XrdOuc/XrdOucTrace.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysLogger.hh"
+#include "XrdTls/XrdTlsContext.hh"
 
 class XrdNetSecurity;
 class XrdOucStream;
@@ -57,6 +58,7 @@ int         ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest=0);
 
 XrdProtocol_Config  ProtInfo;
 XrdInet            *NetADM;
+XrdInet            *NetLCL;
 XrdInet            *NetTCP[XrdProtLoad::ProtoMax+1];
 
 private:
@@ -77,6 +79,7 @@ int   xbuf(XrdSysError *edest, XrdOucStream &Config);
 int   xnet(XrdSysError *edest, XrdOucStream &Config);
 int   xnkap(XrdSysError *edest, char *val);
 int   xlog(XrdSysError *edest, XrdOucStream &Config);
+int   xlsock(XrdSysError *edest, XrdOucStream &Config);
 int   xport(XrdSysError *edest, XrdOucStream &Config);
 int   xprot(XrdSysError *edest, XrdOucStream &Config);
 int   xrep(XrdSysError *edest, XrdOucStream &Config);
@@ -84,6 +87,7 @@ int   xsched(XrdSysError *edest, XrdOucStream &Config);
 int   xsit(XrdSysError *edest, XrdOucStream &Config);
 int   xtls(XrdSysError *edest, XrdOucStream &Config);
 int   xtlsca(XrdSysError *edest, XrdOucStream &Config);
+int   xtlssess(XrdSysError *edest, XrdOucStream &Config);
 int   xtrace(XrdSysError *edest, XrdOucStream &Config);
 int   xtmo(XrdSysError *edest, XrdOucStream &Config);
 int   yport(XrdSysError *edest, const char *ptyp, const char *pval);
@@ -98,12 +102,14 @@ const char         *myInsName;
 char               *myInstance;
 char               *AdminPath;
 char               *HomePath;
+char               *LocalSock;
 char               *tlsCert;
 char               *tlsKey;
 char               *caDir;
 char               *caFile;
 char               *ConfigFN;
 char               *repDest[2];
+XrdTlsContext::SessionParms tlsSess;
 XrdConfigProt      *Firstcp;
 XrdConfigProt      *Lastcp;
 int                 Net_Blen;
@@ -117,10 +123,11 @@ int                 PortTLS;      // TCP port to listen on for TLS connections
 int                 NetTCPlep;
 int                 AdminMode;
 int                 HomeMode;
+int                 LocalMode;
 int                 repInt;
 int                 tlsOpts;
+int                 repOpts;
 bool                tlsNoVer;
-char                repOpts;
 char                ppNet;
 signed char         coreV;
 };
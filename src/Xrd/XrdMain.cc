@@ -202,6 +202,20 @@ int main(int argc, char *argv[])
               }
           }
 
+// Start a thread for the local named socket, if any. It uses the protocols
+// of the main port.
+//
+   if (Main.Config.NetLCL)
+      {XrdMain *Parms = new XrdMain(Main.Config.NetLCL);
+       Parms->thePort = Main.Config.NetTCP[0]->Port();
+       if ((retc = XrdSysThread::Run(&tid, mainAccept, (void *)Parms,
+                                     XRDSYSTHREAD_BIND, "Local socket handler")))
+          {Main.Config.ProtInfo.eDest->Emsg("main", retc, "create",
+                                            "local socket handler");
+           _exit(3);
+          }
+      }
+
 // Finally, start accepting connections on the main port
 //
    Main.theNet  = Main.Config.NetTCP[0];
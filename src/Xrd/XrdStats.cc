@@ -45,6 +45,7 @@
 #include "XrdNet/XrdNetMsg.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysTimer.hh"
+#include "XrdTls/XrdTlsContext.hh"
 
 /******************************************************************************/
 /*                        S t a t i c   O b j e c t s                         */
@@ -194,7 +195,8 @@ const char *XrdStats::GenStats(int &rsz, int opts) // statsMutex must be locked!
    if (!(bp = buff))
       {blen = InfoStats(0,0) + BuffPool->Stats(0,0) + XrdLink::Stats(0,0)
             + ProcStats(0,0) + XrdSched->Stats(0,0) + XrdPoll::Stats(0,0)
-            + XrdProtLoad::Statistics(0,0) + ovrhed + Hlen;
+            + XrdProtLoad::Statistics(0,0) + XrdTlsContext::Stats(0,0)
+            + ovrhed + Hlen;
        buff = (char *)memalign(getpagesize(), blen+256);
        if (!(bp = buff)) {rsz = snulsz; return snul;}
       }
@@ -246,6 +248,11 @@ const char *XrdStats::GenStats(int &rsz, int opts) // statsMutex must be locked!
        bp += sz; bl -= sz;
       }
 
+   if (opts & XRD_STATS_TLS)
+      {sz = XrdTlsContext::Stats(bp, bl, do_sync);
+       bp += sz; bl -= sz;
+      }
+
    if (opts & XRD_STATS_SGEN)
       {unsigned long totTime = 0;
        myTimer.Report(totTime);
@@ -33,7 +33,7 @@
 
 #include "XrdSys/XrdSysPthread.hh"
 
-#define XRD_STATS_ALL    0x000000FF
+#define XRD_STATS_ALL    0x000001FF
 #define XRD_STATS_INFO   0x00000001
 #define XRD_STATS_BUFF   0x00000002
 #define XRD_STATS_LINK   0x00000004
@@ -42,6 +42,7 @@
 #define XRD_STATS_PROT   0x00000020
 #define XRD_STATS_SCHD   0x00000040
 #define XRD_STATS_SGEN   0x00000080
+#define XRD_STATS_TLS    0x00000100
 #define XRD_STATS_SYNC   0x40000000
 #define XRD_STATS_SYNCA  0x20000000
 
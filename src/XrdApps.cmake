@@ -82,6 +82,18 @@ if( NOT XRDCL_ONLY )
     XrdServer
     XrdUtils )
 
+  #-----------------------------------------------------------------------------
+  # xrdcmsparsebench (not installed)
+  #-----------------------------------------------------------------------------
+  add_executable(
+    xrdcmsparsebench
+    XrdApps/XrdCmsParseBench.cc )
+
+  target_link_libraries(
+    xrdcmsparsebench
+    XrdServer
+    XrdUtils )
+
   #-------------------------------------------------------------------------------
   # xrdmapc
   #-------------------------------------------------------------------------------
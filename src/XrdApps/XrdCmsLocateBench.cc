@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d C m s L o c a t e B e n c h . c c                   */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "XrdCms/XrdCmsCache.hh"
+#include "XrdCms/XrdCmsSelect.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+#include "XrdCms/XrdCmsTypes.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysHeaders.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+using namespace XrdCms;
+
+// This program measures the locate rate of a manager with many subscribers.
+// The location cache is filled with files that have a few replicas spread
+// over all the nodes. Each locate then looks the file up in the cache, picks
+// the least loaded node holding it and computes the nodes that would have to
+// be asked should the entry be refreshed. This is the server mask work of
+// XrdCmsCluster::Locate() and SelNode() without the network. The number of
+// nodes is limited by the mask width the cmsd was built with (STMax) and so
+// defaults to 1000 or STMax, whichever is less; use -DXRDCMS_MAXNODES=1024 to
+// benchmark 1000 nodes. With -t several threads run
+// locates at the same time and -u mixes in have reports, which update the
+// cache, to produce a locate storm.
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+namespace
+{
+char   **Paths = 0;
+int     *PLens = 0;
+int      Load[STMax];
+}
+
+/******************************************************************************/
+/*                              P o p u l a t e                               */
+/******************************************************************************/
+
+void Populate(int nFiles, int nRep, int nNodes)
+{
+   char path[64];
+
+   srand(1);
+   Paths = new char *[nFiles];
+   PLens = new int[nFiles];
+   for (int i = 0; i < nFiles; i++)
+       {PLens[i] = snprintf(path, sizeof(path),
+                            "/store/data/run%06d/file%07d.root", i % 5000, i);
+        Paths[i] = strdup(path);
+        XrdCmsSelect Sel(0, Paths[i], PLens[i]);
+        Cache.AddFile(Sel, SMask_t(0));
+        for (int r = 0; r < nRep; r++)
+            Cache.AddFile(Sel, SMask_t::Bit(rand() % nNodes));
+       }
+
+   for (int i = 0; i < STMax; i++) Load[i] = rand() % 100;
+}
+
+/******************************************************************************/
+/*                                L o c a t e                                 */
+/******************************************************************************/
+
+struct LocArgs
+      {const SMask_t *allNodes;
+       long long      nLoc;
+       long long      found;
+       long long      qCount;
+       int            nFiles;
+       int            nNodes;
+       int            hPct;
+       unsigned int   seed;
+      };
+
+void *Locate(void *carg)
+{
+   LocArgs &Args = *static_cast<LocArgs *>(carg);
+   const SMask_t &allNodes = *Args.allNodes;
+   unsigned int seed = Args.seed;
+
+   Args.found = Args.qCount = 0;
+   for (long long i = 0; i < Args.nLoc; i++)
+       {seed = seed * 1103515245 + 12345;
+        int k = (seed >> 8) % Args.nFiles;
+
+    // Some of the traffic is nodes reporting that they have a file
+    //
+        if ((int)(seed % 100) < Args.hPct)
+           {XrdCmsSelect Sel(XrdCmsSelect::Advisory, Paths[k], PLens[k]);
+            Cache.AddFile(Sel, SMask_t::Bit((seed >> 16) % Args.nNodes));
+            continue;
+           }
+
+        XrdCmsSelect Sel(0, Paths[k], PLens[k]);
+        if (Cache.GetFile(Sel, allNodes) <= 0 || !Sel.Vec.hf) continue;
+
+    // Pick the least loaded node that has the file
+    //
+        int best = -1;
+        for (int n = Sel.Vec.hf.First(); n >= 0; n = Sel.Vec.hf.First(n+1))
+            if (best < 0 || Load[n] < Load[best]) best = n;
+        Args.found += (best >= 0);
+
+    // The nodes that would be queried on a refresh
+    //
+        Args.qCount += (allNodes & ~(Sel.Vec.hf | Sel.Vec.pf)).Count();
+       }
+   return 0;
+}
+
+/******************************************************************************/
+/*                                 U s a g e                                  */
+/******************************************************************************/
+
+void Usage(const char *msg)
+{
+   if (msg) cerr <<"xrdcmslocatebench: " <<msg <<endl;
+   cerr <<"Usage: xrdcmslocatebench [-n <nodes>] [-f <files>] [-r <replicas>] "
+          "[-l <locates>] [-t <threads>] [-u <have%>]" <<endl;
+   exit(msg ? 1 : 0);
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+   XrdSysLogger Logger;
+   struct timespec tBeg, tEnd;
+   long long nLoc = 2000000, found = 0, qCount = 0;
+   int c, nNodes = (STMax < 1000 ? STMax : 1000), nFiles = 200000, nRep = 3;
+   int nThreads = 1, hPct = 0;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "f:hl:n:r:t:u:")) != -1)
+        {switch(c)
+               {case 'f': if ((nFiles = atoi(optarg)) <= 0)
+                             Usage("invalid file count");
+                          break;
+                case 'l': if ((nLoc = atoll(optarg)) <= 0)
+                             Usage("invalid locate count");
+                          break;
+                case 'n': if ((nNodes = atoi(optarg)) <= 0)
+                             Usage("invalid node count");
+                          break;
+                case 'r': if ((nRep = atoi(optarg)) <= 0)
+                             Usage("invalid replica count");
+                          break;
+                case 't': if ((nThreads = atoi(optarg)) <= 0)
+                             Usage("invalid thread count");
+                          break;
+                case 'u': if ((hPct = atoi(optarg)) < 0 || hPct > 100)
+                             Usage("invalid have percentage");
+                          break;
+                case 'h': Usage(0); break;
+                default:  Usage("invalid option");
+               }
+        }
+
+// The masks must be wide enough for all of the nodes
+//
+   if (nNodes > STMax)
+      {cerr <<"xrdcmslocatebench: This build supports at most " <<STMax
+            <<" nodes; rebuild with -DXRDCMS_MAXNODES=" <<((nNodes+63)/64)*64
+            <<endl;
+       return 1;
+      }
+
+// Initialize the cache (entries are held for 8 hours) and let every node
+// subscribe, as a manager would when the node logs in.
+//
+   Say.logger(&Logger);
+   if (!Cache.Init(8*60*60, 5, 5, 0, 0)) return 2;
+   SMask_t allNodes;
+   for (int i = 0; i < nNodes; i++)
+       {SMask_t nMask = SMask_t::Bit(i);
+        Cache.Bounce(nMask, i);
+        allNodes |= nMask;
+       }
+
+// Fill the cache and time the locates, each thread does the full count
+//
+   Populate(nFiles, nRep, nNodes);
+   LocArgs   *Args = new LocArgs[nThreads];
+   pthread_t *tids = new pthread_t[nThreads];
+   clock_gettime(CLOCK_MONOTONIC, &tBeg);
+   for (int i = 0; i < nThreads; i++)
+       {LocArgs aInit = {&allNodes, nLoc, 0, 0, nFiles, nNodes, hPct,
+                         12345u + 7919u*i};
+        Args[i] = aInit;
+        if (pthread_create(&tids[i], 0, Locate, &Args[i]))
+           {cerr <<"xrdcmslocatebench: Unable to start thread" <<endl;
+            return 2;
+           }
+       }
+   for (int i = 0; i < nThreads; i++)
+       {pthread_join(tids[i], 0);
+        found += Args[i].found; qCount += Args[i].qCount;
+       }
+   clock_gettime(CLOCK_MONOTONIC, &tEnd);
+   double tLoc = (tEnd.tv_sec - tBeg.tv_sec) + (tEnd.tv_nsec - tBeg.tv_nsec)/1e9;
+   double nOps = (double)nLoc * nThreads;
+
+   printf("%d nodes (mask width %d), %d files x %d replicas\n",
+          nNodes, STMax, nFiles, nRep);
+   printf("%d threads, %d%% have updates\n", nThreads, hPct);
+   printf("locate: %8.1f ns/op %10.0f requests/s\n", tLoc*1e9/nOps, nOps/tLoc);
+   printf("%lld found, %.1f nodes to query per refresh\n",
+          found, found ? (double)qCount/found : 0.0);
+   return 0;
+}
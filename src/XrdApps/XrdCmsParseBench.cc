@@ -0,0 +1,328 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d C m s P a r s e B e n c h . c c                    */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+  
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+
+#include "XProtocol/YProtocol.hh"
+#include "XrdCms/XrdCmsParser.hh"
+#include "XrdCms/XrdCmsRRData.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+#include "XrdOuc/XrdOucPup.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysHeaders.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+using namespace XrdCms;
+
+// This program measures cms request argument parsing throughput. It uses a
+// corpus of messages as they appear on the wire (i.e. a CmsRRHdr followed by
+// datalen bytes of arguments, repeated). A corpus may be recorded from a live
+// cmsd connection or it may be synthesized and optionally saved with -w.
+// Each message is first parsed by both the direct and the generic parser and
+// the results compared; then each parser is timed over the whole corpus.
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+namespace
+{
+struct Msg {CmsRRHdr Hdr; const char *Args; int Alen;};
+
+char *Corpus  = 0;
+int   CorpLen = 0;
+int   CorpMax = 0;
+}
+  
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+
+void Add(int rCode, const char *args, int alen)
+{
+   CmsRRHdr Hdr = {0, static_cast<kXR_char>(rCode), 0,
+                   htons(static_cast<kXR_unt16>(alen))};
+
+   if (CorpLen + (int)sizeof(Hdr) + alen > CorpMax)
+      {CorpMax = (CorpMax ? CorpMax*2 : 1024*1024);
+       if (!(Corpus = (char *)realloc(Corpus, CorpMax)))
+          {cerr <<"ParseBench: Insufficient memory for corpus" <<endl;
+           exit(4);
+          }
+      }
+   memcpy(Corpus+CorpLen, &Hdr, sizeof(Hdr));
+   memcpy(Corpus+CorpLen+sizeof(Hdr), args, alen);
+   CorpLen += sizeof(Hdr) + alen;
+}
+
+/******************************************************************************/
+/*                                  L o a d                                   */
+/******************************************************************************/
+
+bool Load(const char *fn)
+{
+   struct stat Stat;
+   char *buff;
+   int fd, n;
+
+   if ((fd = open(fn, O_RDONLY)) < 0 || fstat(fd, &Stat))
+      {cerr <<"ParseBench: Unable to open " <<fn <<"; " <<strerror(errno) <<endl;
+       return false;
+      }
+
+   if (!(buff = (char *)malloc(Stat.st_size ? Stat.st_size : 1))
+   ||  (n = read(fd, buff, Stat.st_size)) != Stat.st_size)
+      {cerr <<"ParseBench: Unable to read " <<fn <<endl;
+       close(fd); free(buff);
+       return false;
+      }
+   close(fd);
+
+// Add every well formed message in the file
+//
+   char *bp = buff, *bend = buff + n;
+   CmsRRHdr Hdr;
+   int dlen;
+   while(bp + (int)sizeof(Hdr) <= bend)
+        {memcpy(&Hdr, bp, sizeof(Hdr));
+         dlen = ntohs(Hdr.datalen);
+         bp += sizeof(Hdr);
+         if (bp + dlen > bend) break;
+         Add(Hdr.rrCode, bp, dlen);
+         bp += dlen;
+        }
+   if (bp != bend) cerr <<"ParseBench: Ignoring partial message at end of "
+                        <<fn <<endl;
+   free(buff);
+   return true;
+}
+
+/******************************************************************************/
+/*                            S y n t h e s i z e                             */
+/******************************************************************************/
+
+// The mix approximates what a manager sees: mostly have and state traffic
+// followed by locate/select requests and periodic load and avail reports.
+//
+void Synthesize(int nMsg)
+{
+   char args[4096], path[256], opq[128], *bp;
+   unsigned int opts;
+   int i, r;
+
+   srand(1);
+   for (i = 0; i < nMsg; i++)
+       {bp = args;
+        snprintf(path, sizeof(path), "/store/data/run%06d/file%05d.root",
+                 rand() % 5000, rand() % 20000);
+        r = rand() % 100;
+        if (r < 55)
+           {XrdOucPup::Pack(&bp, path);
+            Add((r < 35 ? kYR_have : kYR_state), args, bp-args);
+            continue;
+           }
+        if (r < 85)
+           {opts = (r < 70 ? CmsSelectRequest::kYR_read
+                           : CmsSelectRequest::kYR_write
+                           | CmsSelectRequest::kYR_create);
+            opts|= CmsSelectRequest::kYR_retipv46;
+            XrdOucPup::Pack(&bp, "");
+            XrdOucPup::Pack(&bp, opts);
+            XrdOucPup::Pack(&bp, path);
+            if (r & 1)
+               {snprintf(opq, sizeof(opq), "oss.asize=%d&cms.aff=w",
+                         rand() % 1000000);
+                XrdOucPup::Pack(&bp, opq);
+                if (!(r % 5)) XrdOucPup::Pack(&bp, "host1.domain,host2");
+               }
+            Add((r < 78 ? kYR_select : kYR_locate), args, bp-args);
+            continue;
+           }
+        if (r < 95)
+           {char loads[CmsLoadRequest::numLoad];
+            for (int j = 0; j < CmsLoadRequest::numLoad; j++)
+                loads[j] = static_cast<char>(rand() % 100);
+            XrdOucPup::Pack(&bp, loads, sizeof(loads));
+            XrdOucPup::Pack(&bp, (unsigned int)(rand() % 100000000));
+            XrdOucPup::Pack(&bp, (unsigned int)(rand() % 5000));
+            XrdOucPup::Pack(&bp, (unsigned int)(rand() % 64));
+            Add(kYR_load, args, bp-args);
+           } else {
+            XrdOucPup::Pack(&bp, (unsigned int)(rand() % 100000000));
+            XrdOucPup::Pack(&bp, (unsigned int)(rand() % 100));
+            Add(kYR_avail, args, bp-args);
+           }
+       }
+}
+
+/******************************************************************************/
+/*                                 S a m e                                    */
+/******************************************************************************/
+
+bool Same(XrdCmsRRData &a, XrdCmsRRData &b)
+{
+   return a.Path    == b.Path    && a.Opaque  == b.Opaque
+       && a.Avoid   == b.Avoid   && a.Ident   == b.Ident
+       && a.Opts    == b.Opts    && a.PathLen == b.PathLen
+       && a.dskFree == b.dskFree && a.dskUtil == b.dskUtil
+       && a.svcTime == b.svcTime && a.inFlight == b.inFlight;
+}
+
+/******************************************************************************/
+/*                                  T i m e                                   */
+/******************************************************************************/
+
+double Time(Msg *mVec, int mNum, int passes, bool fast)
+{
+   XrdCmsRRData Data;
+   struct timespec tBeg, tEnd;
+   long long okCnt = 0;
+
+   memset(&Data, 0, sizeof(Data));
+   clock_gettime(CLOCK_MONOTONIC, &tBeg);
+   for (int p = 0; p < passes; p++)
+       for (int i = 0; i < mNum; i++)
+           {const char *aP = mVec[i].Args, *aT = aP + mVec[i].Alen;
+            int rc = mVec[i].Hdr.rrCode;
+            okCnt += (fast ? Parser.Parse(rc, aP, aT, &Data)
+                           : Parser.ParseSlow(rc, aP, aT, &Data)) != 0;
+           }
+   clock_gettime(CLOCK_MONOTONIC, &tEnd);
+
+   if (okCnt != (long long)mNum*passes)
+      cerr <<"ParseBench: " <<(long long)mNum*passes - okCnt
+           <<" parse failures" <<endl;
+   return (tEnd.tv_sec - tBeg.tv_sec) + (tEnd.tv_nsec - tBeg.tv_nsec)/1e9;
+}
+
+/******************************************************************************/
+/*                                 U s a g e                                  */
+/******************************************************************************/
+
+void Usage(const char *msg)
+{
+   if (msg) cerr <<"xrdcmsparsebench: " <<msg <<endl;
+   cerr <<"Usage: xrdcmsparsebench [-m <msgs>] [-p <passes>] [-w <file>] "
+          "[<corpus> [...]]" <<endl;
+   exit(msg ? 1 : 0);
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+  
+int main(int argc, char **argv)
+{
+   XrdSysLogger Logger;
+   const char *wFile = 0;
+   Msg  *mVec;
+   int   c, mNum = 0, nMsg = 100000, passes = 20, bad = 0;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "hm:p:w:")) != -1)
+        {switch(c)
+               {case 'm': if ((nMsg = atoi(optarg)) <= 0)
+                             Usage("invalid message count");
+                          break;
+                case 'p': if ((passes = atoi(optarg)) <= 0)
+                             Usage("invalid pass count");
+                          break;
+                case 'w': wFile = optarg;
+                          break;
+                case 'h': Usage(0); break;
+                default:  Usage("invalid option");
+               }
+        }
+
+// Malformed messages are reported by the generic parser
+//
+   Say.logger(&Logger);
+
+// Load the corpus or make one up
+//
+   if (optind < argc)
+      {for (int i = optind; i < argc; i++) if (!Load(argv[i])) return 2;}
+      else Synthesize(nMsg);
+
+// Save the corpus if so wanted
+//
+   if (wFile)
+      {int fd = open(wFile, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+       if (fd < 0 || write(fd, Corpus, CorpLen) != CorpLen)
+          {cerr <<"ParseBench: Unable to write " <<wFile <<endl; return 2;}
+       close(fd);
+      }
+
+// Index the messages
+//
+   mVec = new Msg[CorpLen/sizeof(CmsRRHdr)+1];
+   for (char *bp = Corpus; bp < Corpus+CorpLen; mNum++)
+       {memcpy(&mVec[mNum].Hdr, bp, sizeof(CmsRRHdr));
+        mVec[mNum].Args = bp + sizeof(CmsRRHdr);
+        mVec[mNum].Alen = ntohs(mVec[mNum].Hdr.datalen);
+        bp += sizeof(CmsRRHdr) + mVec[mNum].Alen;
+       }
+   if (!mNum) {cerr <<"ParseBench: Corpus is empty" <<endl; return 2;}
+
+// Verify that both parsers agree on every message
+//
+   for (int i = 0; i < mNum; i++)
+       {XrdCmsRRData a, b;
+        const char *aP = mVec[i].Args, *aT = aP + mVec[i].Alen;
+        int rc = mVec[i].Hdr.rrCode, ra, rb;
+        memset(&a, 0, sizeof(a)); memset(&b, 0, sizeof(b));
+        ra = Parser.Parse(    rc, aP, aT, &a) != 0;
+        rb = Parser.ParseSlow(rc, aP, aT, &b) != 0;
+        if (ra != rb || (ra && !Same(a, b))) bad++;
+       }
+   if (bad) {cerr <<"ParseBench: " <<bad <<" parse mismatches" <<endl; return 3;}
+
+// Time each parser
+//
+   double tSlow = Time(mVec, mNum, passes, false);
+   double tFast = Time(mVec, mNum, passes, true);
+   double nTot  = (double)mNum * passes;
+
+   printf("%d msgs (%d bytes) x %d passes\n", mNum, CorpLen, passes);
+   printf("generic: %8.1f ns/msg %10.0f msgs/s\n",
+          tSlow*1e9/nTot, nTot/tSlow);
+   printf("direct:  %8.1f ns/msg %10.0f msgs/s (x%.2f)\n",
+          tFast*1e9/nTot, nTot/tFast, tSlow/tFast);
+   return 0;
+}
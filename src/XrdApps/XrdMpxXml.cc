@@ -131,6 +131,10 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"ofs.tpc.deny",    "TPC denials:"},
 {"ofs.tpc.err",     "TPC errors:"},
 {"ofs.tpc.exp",     "TPC expires:"},
+{"ofs.tpc.xfr",     "TPC copies:"},
+{"ofs.tpc.fail",    "TPC copy failures:"},
+{"ofs.tpc.bytes",   "TPC bytes copied:"},
+{"ofs.tpc.msec",    "TPC copy millisecs:"},
 {"oss.paths",       "Oss exports:"},
 {"oss.space",       "Oss space:"},
 {"sched.jobs",      "Tasks scheduled: "},
@@ -144,6 +148,18 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"sgen.as",         "Unsynchronized stats:"},
 {"sgen.et",         "Mills to collect stats:"},
 {"sgen.toe",        "~Time when stats collected:"},
+{"tls.srv.full",    "TLS server full handshakes:"},
+{"tls.srv.rsm",     "TLS server resumed handshakes:"},
+{"tls.srv.fail",    "TLS server failed handshakes:"},
+{"tls.clnt.full",   "TLS client full handshakes:"},
+{"tls.clnt.rsm",    "TLS client resumed handshakes:"},
+{"tls.clnt.fail",   "TLS client failed handshakes:"},
+{"tls.cache.num",   "TLS sessions cached:"},
+{"tls.cache.hits",  "TLS session cache hits:"},
+{"tls.cache.miss",  "TLS session cache misses:"},
+{"tls.cache.evict", "TLS session cache evictions:"},
+{"tls.tkt.new",     "TLS session tickets issued:"},
+{"tls.tkt.keys",    "TLS session ticket keys made:"},
 {"ssi.err",         "SSI errors:"},
 {"ssi.req.bytes",   "Request total bytes:"},
 {"ssi.req.maxsz",   "Request largest size:"},
@@ -110,7 +110,7 @@ namespace XrdCl
 
     int keepAlive = DefaultTCPKeepAlive;
     env->GetInt( "TCPKeepAlive", keepAlive );
-    if( keepAlive )
+    if( keepAlive && pSockAddr.Family() != AF_UNIX )
     {
       int    param = 1;
       Status st    = pSocket->SetSockOpt( SOL_SOCKET, SO_KEEPALIVE, &param,
@@ -81,6 +81,11 @@ namespace XrdCl
   const int DefaultPreserveLocateTried     = 1;
   const int DefaultNotAuthorizedRetryLimit = 3;
   const int DefaultPreserveXAttrs          = 0;
+  const int DefaultZipCdCacheSize          = 32;
+  const int DefaultHedgedOpenPercentile    = 0;
+  const int DefaultHedgedOpenDelay         = 500;
+  const int DefaultWorkerQueues            = 0;
+  const int DefaultTlsSessions             = 256;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
@@ -92,6 +97,7 @@ namespace XrdCl
   const char * const DefaultWriteRecovery      = "true";
   const char * const DefaultOpenRecovery       = "true";
   const char * const DefaultGlfnRedirector     = "";
+  const char * const DefaultConnectionBroker   = "";
 }
 
 #endif // __XRD_CL_CONSTANTS_HH__
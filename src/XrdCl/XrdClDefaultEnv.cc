@@ -293,6 +293,11 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "PreserveLocateTried",     DefaultPreserveLocateTried     );
     REGISTER_VAR_INT( varsInt, "NotAuthorizedRetryLimit", DefaultNotAuthorizedRetryLimit );
     REGISTER_VAR_INT( varsInt, "PreserveXAttrs",          DefaultPreserveXAttrs          );
+    REGISTER_VAR_INT( varsInt, "ZipCdCacheSize",          DefaultZipCdCacheSize          );
+    REGISTER_VAR_INT( varsInt, "HedgedOpenPercentile",    DefaultHedgedOpenPercentile    );
+    REGISTER_VAR_INT( varsInt, "HedgedOpenDelay",         DefaultHedgedOpenDelay         );
+    REGISTER_VAR_INT( varsInt, "WorkerQueues",            DefaultWorkerQueues            );
+    REGISTER_VAR_INT( varsInt, "TlsSessions",             DefaultTlsSessions             );
 
     REGISTER_VAR_STR( varsStr, "ClientMonitor",           DefaultClientMonitor           );
     REGISTER_VAR_STR( varsStr, "ClientMonitorParam",      DefaultClientMonitorParam      );
@@ -303,6 +308,7 @@ namespace XrdCl
     REGISTER_VAR_STR( varsStr, "WriteRecovery",           DefaultWriteRecovery           );
     REGISTER_VAR_STR( varsStr, "OpenRecovery",            DefaultOpenRecovery            );
     REGISTER_VAR_STR( varsStr, "GlfnRedirector",          DefaultGlfnRedirector          );
+    REGISTER_VAR_STR( varsStr, "ConnectionBroker",        DefaultConnectionBroker        );
 
     //--------------------------------------------------------------------------
     // Process the configuration files
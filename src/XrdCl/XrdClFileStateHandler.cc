@@ -37,6 +37,7 @@
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClUglyHacks.hh"
+#include "XrdCl/XrdClHedgedOpen.hh"
 #include "XrdClRedirectorRegistry.hh"
 
 #include <sstream>
@@ -56,10 +57,14 @@ namespace
       //------------------------------------------------------------------------
       // Constructor
       //------------------------------------------------------------------------
-      OpenHandler( XrdCl::FileStateHandler *stateHandler,
-                   XrdCl::ResponseHandler  *userHandler ):
+      OpenHandler( XrdCl::FileStateHandler            *stateHandler,
+                   XrdCl::ResponseHandler             *userHandler,
+                   std::shared_ptr<XrdCl::HedgedOpen>  hedge   = std::shared_ptr<XrdCl::HedgedOpen>(),
+                   bool                                isHedge = false ):
         pStateHandler( stateHandler ),
-        pUserHandler( userHandler )
+        pUserHandler( userHandler ),
+        pHedge( hedge ),
+        pIsHedge( isHedge )
       {
       }
 
@@ -72,6 +77,16 @@ namespace
       {
         using namespace XrdCl;
 
+        //----------------------------------------------------------------------
+        // If the open has been hedged only the winner gets through
+        //----------------------------------------------------------------------
+        if( pHedge )
+        {
+          std::shared_ptr<HedgedOpen> hedge = pHedge;
+          if( !hedge->Arbitrate( this, status, response, hostList, pIsHedge ) )
+            return;
+        }
+
         //----------------------------------------------------------------------
         // Extract the statistics info
         //----------------------------------------------------------------------
@@ -95,8 +110,10 @@ namespace
       }
 
     private:
-      XrdCl::FileStateHandler *pStateHandler;
-      XrdCl::ResponseHandler  *pUserHandler;
+      XrdCl::FileStateHandler            *pStateHandler;
+      XrdCl::ResponseHandler             *pUserHandler;
+      std::shared_ptr<XrdCl::HedgedOpen>  pHedge;
+      bool                                pIsHedge;
   };
 
   //----------------------------------------------------------------------------
@@ -514,7 +531,27 @@ namespace XrdCl
 
     pOpenMode  = mode;
     pOpenFlags = flags;
-    OpenHandler *openHandler = new OpenHandler( this, handler );
+
+    MessageSendParams params; params.timeout = timeout;
+    params.followRedirects = pFollowRedirects;
+    MessageUtils::ProcessSendParams( params );
+
+    //--------------------------------------------------------------------------
+    // Prepare a hedged open at another replica in case this one is slow
+    //--------------------------------------------------------------------------
+    std::shared_ptr<HedgedOpen> hedge;
+    if( pFollowRedirects && HedgedOpen::CanHedge( *pFileUrl, flags ) )
+    {
+      FileStateHandler *self = this;
+      hedge.reset( new HedgedOpen( *pFileUrl, flags, mode, params,
+                                   pUseVirtRedirector, pLFileHandler,
+                                   [self, handler]( std::shared_ptr<HedgedOpen> h )
+                                   {
+                                     return new OpenHandler( self, handler, h, true );
+                                   } ) );
+    }
+
+    OpenHandler *openHandler = new OpenHandler( this, handler, hedge );
 
     Message           *msg;
     ClientOpenRequest *req;
@@ -528,9 +565,6 @@ namespace XrdCl
     msg->Append( path.c_str(), path.length(), 24 );
 
     XRootDTransport::SetDescription( msg );
-    MessageSendParams params; params.timeout = timeout;
-    params.followRedirects = pFollowRedirects;
-    MessageUtils::ProcessSendParams( params );
 
     Status st = IssueRequest( *pFileUrl, msg, openHandler, params );
 
@@ -541,6 +575,9 @@ namespace XrdCl
       pFileState = Error;
       return st;
     }
+
+    if( hedge )
+      hedge->Start();
     return st;
   }
 
@@ -0,0 +1,616 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClHedgedOpen.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClMessageUtils.hh"
+#include "XrdCl/XrdClFileSystem.hh"
+#include "XrdCl/XrdClXRootDTransport.hh"
+#include "XrdClRedirectorRegistry.hh"
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Hedging statistics
+  //----------------------------------------------------------------------------
+  std::atomic<uint64_t> hedgesFired( 0 );
+  std::atomic<uint64_t> hedgesWon( 0 );
+
+  //----------------------------------------------------------------------------
+  // Current time in milliseconds
+  //----------------------------------------------------------------------------
+  uint64_t NowMS()
+  {
+    timeval now;
+    gettimeofday( &now, 0 );
+    return uint64_t( now.tv_sec ) * 1000 + now.tv_usec / 1000;
+  }
+
+  //----------------------------------------------------------------------------
+  // The latencies of the recent successful opens
+  //----------------------------------------------------------------------------
+  class OpenLatencies
+  {
+    public:
+      OpenLatencies(): pNext( 0 ), pCount( 0 ) {}
+
+      static OpenLatencies &Instance()
+      {
+        static OpenLatencies latencies;
+        return latencies;
+      }
+
+      void Add( uint32_t ms )
+      {
+        XrdSysMutexHelper scopedLock( pMutex );
+        pSamples[pNext] = ms;
+        pNext = ( pNext + 1 ) % kSize;
+        if( pCount < kSize ) ++pCount;
+      }
+
+      //------------------------------------------------------------------------
+      // Get the given percentile, 0 if we don't have enough samples yet
+      //------------------------------------------------------------------------
+      uint32_t Percentile( int pct )
+      {
+        std::vector<uint32_t> samples;
+        {
+          XrdSysMutexHelper scopedLock( pMutex );
+          if( pCount < kMinSamples ) return 0;
+          samples.assign( pSamples, pSamples + pCount );
+        }
+        size_t n = ( samples.size() - 1 ) * std::min( pct, 100 ) / 100;
+        std::nth_element( samples.begin(), samples.begin() + n, samples.end() );
+        return samples[n];
+      }
+
+    private:
+      static const size_t kSize       = 256;
+      static const size_t kMinSamples = 16;
+
+      XrdSysMutex pMutex;
+      uint32_t    pSamples[kSize];
+      size_t      pNext;
+      size_t      pCount;
+  };
+
+  //----------------------------------------------------------------------------
+  // Millisecond timer firing the hedges. The task manager only has
+  // a resolution of seconds so we run our own thread.
+  //----------------------------------------------------------------------------
+  class HedgeTimer
+  {
+    public:
+      HedgeTimer(): pCond( 0 ), pPid( 0 ) {}
+
+      //------------------------------------------------------------------------
+      // Never destroyed, the thread may be waiting on the condition variable
+      // when the process exits
+      //------------------------------------------------------------------------
+      static HedgeTimer &Instance()
+      {
+        static HedgeTimer *timer = new HedgeTimer();
+        return *timer;
+      }
+
+      void Schedule( std::shared_ptr<HedgedOpen> hedge, uint32_t delay )
+      {
+        XrdSysCondVarHelper scopedLock( pCond );
+
+        //----------------------------------------------------------------------
+        // Start the thread if it is not running in this process (it does not
+        // survive a fork)
+        //----------------------------------------------------------------------
+        if( pPid != getpid() )
+        {
+          pthread_t tid;
+          if( XrdSysThread::Run( &tid, RunTimer, this, 0, "XrdCl hedge timer" ) )
+          {
+            Log *log = DefaultEnv::GetLog();
+            log->Error( FileMsg, "Unable to start the hedged open timer" );
+            return;
+          }
+          pPid = getpid();
+        }
+
+        pQueue.insert( std::make_pair( NowMS() + delay, hedge ) );
+        pCond.Signal();
+      }
+
+    private:
+      static void *RunTimer( void *arg )
+      {
+        static_cast<HedgeTimer*>( arg )->Run();
+        return 0;
+      }
+
+      void Run()
+      {
+        pCond.Lock();
+        while( true )
+        {
+          if( pQueue.empty() )
+          {
+            pCond.Wait();
+            continue;
+          }
+
+          uint64_t now = NowMS();
+          Queue::iterator it = pQueue.begin();
+          if( it->first > now )
+          {
+            pCond.WaitMS( it->first - now );
+            continue;
+          }
+
+          std::shared_ptr<HedgedOpen> hedge = it->second;
+          pQueue.erase( it );
+          pCond.UnLock();
+          hedge->Fire();
+          hedge.reset();
+          pCond.Lock();
+        }
+      }
+
+      typedef std::multimap<uint64_t, std::shared_ptr<HedgedOpen> > Queue;
+
+      XrdSysCondVar pCond;
+      Queue         pQueue;
+      pid_t         pPid;
+  };
+
+  //----------------------------------------------------------------------------
+  // Handle the locate response
+  //----------------------------------------------------------------------------
+  class LocateHandler: public ResponseHandler
+  {
+    public:
+      LocateHandler( std::shared_ptr<HedgedOpen> hedge ): pHedge( hedge ) {}
+
+      virtual void HandleResponse( XRootDStatus *status, AnyObject *response )
+      {
+        pHedge->OnLocate( status, response );
+        delete this;
+      }
+
+    private:
+      std::shared_ptr<HedgedOpen> pHedge;
+  };
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  HedgedOpen::HedgedOpen( const URL               &url,
+                          uint16_t                 flags,
+                          uint16_t                 mode,
+                          const MessageSendParams &params,
+                          bool                     useVirtRedirector,
+                          LocalFileHandler        *lFileHandler,
+                          HandlerFactory           makeHandler ):
+    pUrl( url ),
+    pFlags( flags ),
+    pMode( mode ),
+    pParams( new MessageSendParams( params ) ),
+    pUseVirtRedirector( useVirtRedirector ),
+    pLFileHandler( lFileHandler ),
+    pMakeHandler( makeHandler ),
+    pFired( false ),
+    pHedgeDone( false ),
+    pDecided( false ),
+    pDeferred( 0 ),
+    pDefStatus( 0 ),
+    pDefResponse( 0 ),
+    pDefHostList( 0 ),
+    pReleased( 0 )
+  {
+    gettimeofday( &pStart, 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  HedgedOpen::~HedgedOpen()
+  {
+    delete pParams;
+  }
+
+  //----------------------------------------------------------------------------
+  // Check whether an open of given URL with given flags may be hedged
+  //----------------------------------------------------------------------------
+  bool HedgedOpen::CanHedge( const URL &url, uint16_t flags )
+  {
+    int percentile = DefaultHedgedOpenPercentile;
+    DefaultEnv::GetEnv()->GetInt( "HedgedOpenPercentile", percentile );
+    if( percentile <= 0 )
+      return false;
+
+    //--------------------------------------------------------------------------
+    // Only opens for reading, anything else could end up with two files
+    //--------------------------------------------------------------------------
+    static const uint16_t modifying = OpenFlags::Delete | OpenFlags::New    |
+                                      OpenFlags::Update | OpenFlags::Write  |
+                                      OpenFlags::Append | OpenFlags::MakePath |
+                                      OpenFlags::POSC;
+    if( flags & modifying )
+      return false;
+
+    return !url.IsLocalFile() || url.IsMetalink();
+  }
+
+  //----------------------------------------------------------------------------
+  // Arm the hedge timer
+  //----------------------------------------------------------------------------
+  void HedgedOpen::Start()
+  {
+    int percentile = DefaultHedgedOpenPercentile;
+    int minDelay   = DefaultHedgedOpenDelay;
+    Env *env = DefaultEnv::GetEnv();
+    env->GetInt( "HedgedOpenPercentile", percentile );
+    env->GetInt( "HedgedOpenDelay",      minDelay );
+
+    uint32_t delay = OpenLatencies::Instance().Percentile( percentile );
+    if( delay < uint32_t( std::max( minDelay, 0 ) ) ) delay = minDelay;
+
+    HedgeTimer::Instance().Schedule( shared_from_this(), delay );
+  }
+
+  //----------------------------------------------------------------------------
+  // Decide what to do with an open response
+  //----------------------------------------------------------------------------
+  bool HedgedOpen::Arbitrate( ResponseHandler *handler,
+                              XRootDStatus    *status,
+                              AnyObject       *response,
+                              HostList        *hostList,
+                              bool             isHedge )
+  {
+    Log *log = DefaultEnv::GetLog();
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    //--------------------------------------------------------------------------
+    // A deferred response that we have let go
+    //--------------------------------------------------------------------------
+    if( handler == pReleased )
+    {
+      pReleased = 0;
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // The other open has already won, close this one if it succeeded
+    //--------------------------------------------------------------------------
+    if( pDecided )
+    {
+      if( status->IsOK() )
+        CloseLoser( response, hostList );
+      delete status;
+      delete response;
+      delete hostList;
+      delete handler;
+      return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // We have a winner
+    //--------------------------------------------------------------------------
+    if( status->IsOK() )
+    {
+      pDecided = true;
+      OpenLatencies::Instance().Add( Elapsed() );
+      if( isHedge )
+      {
+        ++hedgesWon;
+        log->Debug( FileMsg, "[%s] Hedged open won after %u ms",
+                    pUrl.GetURL().c_str(), Elapsed() );
+      }
+
+      if( pDeferred )
+      {
+        delete pDefStatus;
+        delete pDefResponse;
+        delete pDefHostList;
+        delete pDeferred;
+        pDeferred = 0;
+      }
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // The hedged open failed, report the primary error if there is one
+    //--------------------------------------------------------------------------
+    if( isHedge )
+    {
+      log->Debug( FileMsg, "[%s] Hedged open failed: %s",
+                  pUrl.GetURL().c_str(), status->ToStr().c_str() );
+      delete status;
+      delete response;
+      delete hostList;
+      delete handler;
+      pHedgeDone = true;
+
+      if( pDeferred )
+        ReleaseDeferred( scopedLock );
+      return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // The primary open failed, wait for the hedged one if it is on its way
+    //--------------------------------------------------------------------------
+    if( pFired && !pHedgeDone )
+    {
+      pDeferred    = handler;
+      pDefStatus   = status;
+      pDefResponse = response;
+      pDefHostList = hostList;
+      return false;
+    }
+
+    pDecided = true;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the open to the alternate replica
+  //----------------------------------------------------------------------------
+  void HedgedOpen::Fire()
+  {
+    Log *log = DefaultEnv::GetLog();
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pDecided ) return;
+    pFired = true;
+    ++hedgesFired;
+
+    log->Debug( FileMsg, "[%s] Open did not return within %u ms, hedging",
+                pUrl.GetURL().c_str(), Elapsed() );
+
+    //--------------------------------------------------------------------------
+    // The metalink knows the replicas
+    //--------------------------------------------------------------------------
+    if( pUseVirtRedirector && pUrl.IsMetalink() )
+    {
+      VirtualRedirector *redirector = RedirectorRegistry::Instance().Get( pUrl );
+      if( !redirector || redirector->GetReplicas().size() < 2 )
+      {
+        scopedLock.UnLock();
+        HedgeFailed( XRootDStatus( stError, errNotFound ) );
+        return;
+      }
+      Status st = SendOpen( URL( redirector->GetReplicas()[1] ) );
+      if( !st.IsOK() )
+      {
+        scopedLock.UnLock();
+        HedgeFailed( st );
+      }
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Otherwise ask the original host where the replicas are
+    //--------------------------------------------------------------------------
+    Message             *msg;
+    ClientLocateRequest *req;
+    std::string          path = pUrl.GetPathWithFilteredParams();
+    MessageUtils::CreateRequest( msg, req, path.length() );
+
+    req->requestid = kXR_locate;
+    req->options   = OpenFlags::None;
+    req->dlen      = path.length();
+    msg->Append( path.c_str(), path.length(), 24 );
+    XRootDTransport::SetDescription( msg );
+
+    MessageSendParams params;
+    params.timeout = pParams->timeout;
+    MessageUtils::ProcessSendParams( params );
+
+    LocateHandler *handler = new LocateHandler( shared_from_this() );
+    Status st = MessageUtils::SendMessage( pUrl, msg, handler, params, 0 );
+    if( !st.IsOK() )
+    {
+      delete handler;
+      scopedLock.UnLock();
+      HedgeFailed( st );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle the location of the replicas
+  //----------------------------------------------------------------------------
+  void HedgedOpen::OnLocate( XRootDStatus *status, AnyObject *response )
+  {
+    std::unique_ptr<XRootDStatus> st( status );
+    std::unique_ptr<AnyObject>    resp( response );
+
+    LocationInfo *info = 0;
+    if( st->IsOK() && response )
+      response->Get( info );
+    if( !info )
+    {
+      HedgeFailed( st->IsOK() ? XRootDStatus( stError, errInternal ) : *st );
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Pick a random replica other than the original host
+    //--------------------------------------------------------------------------
+    std::vector<URL> candidates;
+    LocationInfo::Iterator it;
+    for( it = info->Begin(); it != info->End(); ++it )
+    {
+      if( !it->IsServer() ) continue;
+      URL location( pUrl.GetProtocol() + "://" + it->GetAddress() );
+      if( location.GetHostName() == pUrl.GetHostName() &&
+          location.GetPort()     == pUrl.GetPort() ) continue;
+      candidates.push_back( location );
+    }
+
+    if( candidates.empty() )
+    {
+      HedgeFailed( XRootDStatus( stError, errNotFound ) );
+      return;
+    }
+
+    const URL &location = candidates[random() % candidates.size()];
+    URL target( pUrl );
+    target.SetHostPort( location.GetHostName(), location.GetPort() );
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pDecided ) return;
+    Status sendSt = SendOpen( target );
+    if( !sendSt.IsOK() )
+    {
+      scopedLock.UnLock();
+      HedgeFailed( sendSt );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the hedging statistics
+  //----------------------------------------------------------------------------
+  void HedgedOpen::GetStats( uint64_t &fired, uint64_t &won )
+  {
+    fired = hedgesFired;
+    won   = hedgesWon;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the open request to the alternate replica, called with the lock held.
+  // Should that fail the caller must release the lock and call HedgeFailed().
+  //----------------------------------------------------------------------------
+  Status HedgedOpen::SendOpen( const URL &url )
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[%s] Sending a hedged open to %s",
+                pUrl.GetURL().c_str(), url.GetHostId().c_str() );
+
+    Message           *msg;
+    ClientOpenRequest *req;
+    std::string        path = url.GetPathWithFilteredParams();
+    MessageUtils::CreateRequest( msg, req, path.length() );
+
+    req->requestid = kXR_open;
+    req->mode      = pMode;
+    req->options   = pFlags | kXR_async | kXR_retstat;
+    req->dlen      = path.length();
+    msg->Append( path.c_str(), path.length(), 24 );
+    XRootDTransport::SetDescription( msg );
+
+    ResponseHandler *handler = pMakeHandler( shared_from_this() );
+    Status st = MessageUtils::SendMessage( url, msg, handler, *pParams,
+                                           pLFileHandler );
+    if( !st.IsOK() )
+      delete handler;
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // The hedged open could not be sent
+  //----------------------------------------------------------------------------
+  void HedgedOpen::HedgeFailed( const XRootDStatus &status )
+  {
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( FileMsg, "[%s] Unable to hedge the open: %s",
+                pUrl.GetURL().c_str(), status.ToStr().c_str() );
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    pHedgeDone = true;
+    if( pDecided || !pDeferred ) return;
+
+    ReleaseDeferred( scopedLock );
+  }
+
+  //----------------------------------------------------------------------------
+  // Let the deferred primary response go, the lock is released on return
+  //----------------------------------------------------------------------------
+  void HedgedOpen::ReleaseDeferred( XrdSysMutexHelper &scopedLock )
+  {
+    //--------------------------------------------------------------------------
+    // Take everything we need while still holding the lock, the handler
+    // comes back to Arbitrate() on another thread possibly
+    //--------------------------------------------------------------------------
+    ResponseHandler *handler  = pDeferred;
+    XRootDStatus    *status   = pDefStatus;
+    AnyObject       *response = pDefResponse;
+    HostList        *hostList = pDefHostList;
+
+    pDecided     = true;
+    pReleased    = handler;
+    pDeferred    = 0;
+    pDefStatus   = 0;
+    pDefResponse = 0;
+    pDefHostList = 0;
+    scopedLock.UnLock();
+
+    handler->HandleResponseWithHosts( status, response, hostList );
+  }
+
+  //----------------------------------------------------------------------------
+  // Close the file opened by the losing request
+  //----------------------------------------------------------------------------
+  void HedgedOpen::CloseLoser( AnyObject *response, HostList *hostList )
+  {
+    OpenInfo *openInfo = 0;
+    if( response ) response->Get( openInfo );
+    if( !openInfo || !hostList || hostList->empty() ) return;
+
+    Message            *msg;
+    ClientCloseRequest *req;
+    MessageUtils::CreateRequest( msg, req );
+
+    req->requestid = kXR_close;
+    openInfo->GetFileHandle( req->fhandle );
+
+    XRootDTransport::SetDescription( msg );
+    msg->SetSessionId( openInfo->GetSessionId() );
+    NullResponseHandler *handler = new NullResponseHandler();
+    MessageSendParams params;
+    params.followRedirects = false;
+    params.stateful        = true;
+    MessageUtils::ProcessSendParams( params );
+
+    Status st = MessageUtils::SendMessage( hostList->back().url, msg, handler,
+                                           params, 0 );
+    if( !st.IsOK() )
+      delete handler;
+  }
+
+  //----------------------------------------------------------------------------
+  // Milliseconds since the open was sent
+  //----------------------------------------------------------------------------
+  uint32_t HedgedOpen::Elapsed() const
+  {
+    timeval now;
+    gettimeofday( &now, 0 );
+    return ( now.tv_sec - pStart.tv_sec ) * 1000 +
+           ( now.tv_usec - pStart.tv_usec ) / 1000;
+  }
+}
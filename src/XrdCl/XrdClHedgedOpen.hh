@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_HEDGED_OPEN_HH__
+#define __XRD_CL_HEDGED_OPEN_HH__
+
+#include "XrdCl/XrdClURL.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <memory>
+#include <functional>
+#include <sys/time.h>
+
+namespace XrdCl
+{
+  class LocalFileHandler;
+  struct MessageSendParams;
+
+  //----------------------------------------------------------------------------
+  //! Speculative open of a file at an alternate replica.
+  //!
+  //! If the open did not return within the configured percentile of the
+  //! recent open latencies (HedgedOpenPercentile, HedgedOpenDelay being the
+  //! lower bound) a second open is sent to another replica, taken from the
+  //! metalink or from a kXR_locate at the original host. The first
+  //! successful open wins, the other one is closed as soon as it returns.
+  //! An error is only reported once both opens have failed.
+  //----------------------------------------------------------------------------
+  class HedgedOpen: public std::enable_shared_from_this<HedgedOpen>
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Creates the open handler for the alternate replica
+      //------------------------------------------------------------------------
+      typedef std::function<ResponseHandler*( std::shared_ptr<HedgedOpen> )>
+              HandlerFactory;
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      HedgedOpen( const URL               &url,
+                  uint16_t                 flags,
+                  uint16_t                 mode,
+                  const MessageSendParams &params,
+                  bool                     useVirtRedirector,
+                  LocalFileHandler        *lFileHandler,
+                  HandlerFactory           makeHandler );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~HedgedOpen();
+
+      //------------------------------------------------------------------------
+      //! Check whether an open of given URL with given flags may be hedged
+      //------------------------------------------------------------------------
+      static bool CanHedge( const URL &url, uint16_t flags );
+
+      //------------------------------------------------------------------------
+      //! Arm the hedge timer, to be called once the open has been sent
+      //------------------------------------------------------------------------
+      void Start();
+
+      //------------------------------------------------------------------------
+      //! Decide what to do with an open response.
+      //!
+      //! @return true if the response should be processed by the handler,
+      //!         false if it has been taken care of (the handler has been
+      //!         deleted or will be called again later)
+      //------------------------------------------------------------------------
+      bool Arbitrate( ResponseHandler *handler,
+                      XRootDStatus    *status,
+                      AnyObject       *response,
+                      HostList        *hostList,
+                      bool             isHedge );
+
+      //------------------------------------------------------------------------
+      //! Send the open to the alternate replica (called by the timer)
+      //------------------------------------------------------------------------
+      void Fire();
+
+      //------------------------------------------------------------------------
+      //! Handle the location of the replicas
+      //------------------------------------------------------------------------
+      void OnLocate( XRootDStatus *status, AnyObject *response );
+
+      //------------------------------------------------------------------------
+      //! Get the number of hedged opens that were sent and that won
+      //------------------------------------------------------------------------
+      static void GetStats( uint64_t &fired, uint64_t &won );
+
+    private:
+      HedgedOpen( const HedgedOpen & );
+      HedgedOpen &operator=( const HedgedOpen & );
+
+      Status SendOpen( const URL &url );
+      void HedgeFailed( const XRootDStatus &status );
+      void CloseLoser( AnyObject *response, HostList *hostList );
+      void ReleaseDeferred( XrdSysMutexHelper &scopedLock );
+      uint32_t Elapsed() const;
+
+      URL                pUrl;
+      uint16_t           pFlags;
+      uint16_t           pMode;
+      MessageSendParams *pParams;
+      bool               pUseVirtRedirector;
+      LocalFileHandler  *pLFileHandler;
+      HandlerFactory     pMakeHandler;
+      timeval            pStart;
+
+      XrdSysMutex        pMutex;
+      bool               pFired;
+      bool               pHedgeDone;
+      bool               pDecided;
+      ResponseHandler   *pDeferred;
+      XRootDStatus      *pDefStatus;
+      AnyObject         *pDefResponse;
+      HostList          *pDefHostList;
+      ResponseHandler   *pReleased;
+  };
+}
+
+#endif // __XRD_CL_HEDGED_OPEN_HH__
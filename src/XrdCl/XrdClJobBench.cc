@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClJobManager.hh"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// This program measures the callback throughput of the job manager. Several
+// producer threads, each acting like an event loop with a queue of its own,
+// queue short jobs as fast as they can while a growing number of workers run
+// them.
+//------------------------------------------------------------------------------
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Job counting the runs
+  //----------------------------------------------------------------------------
+  class CountingJob: public XrdCl::Job
+  {
+    public:
+      CountingJob(): pRuns( 0 ) {}
+
+      virtual void Run( void * )
+      {
+        // simulate a short callback
+        volatile uint32_t x = 0;
+        for( uint32_t i = 0; i < 500; ++i ) x += i;
+        pRuns.fetch_add( 1 );
+      }
+
+      uint64_t Runs() const { return pRuns.load(); }
+
+    private:
+      std::atomic<uint64_t> pRuns;
+  };
+
+  struct ProducerData
+  {
+    XrdCl::JobManager *jobMan;
+    CountingJob       *job;
+    uint32_t           count;
+  };
+
+  void *Producer( void *arg )
+  {
+    ProducerData *data  = (ProducerData*)arg;
+    uint32_t      queue = data->jobMan->AssignQueue();
+    for( uint32_t i = 0; i < data->count; ++i )
+      data->jobMan->QueueJob( data->job, 0, queue );
+    return 0;
+  }
+
+  void Usage( const char *msg )
+  {
+    if( msg ) std::cerr << "xrdcljobbench: " << msg << std::endl;
+    std::cerr << "Usage: xrdcljobbench [-p <producers>] [-n <jobs per producer>] "
+                 "[-w <max workers>]" << std::endl;
+    exit( msg ? 1 : 0 );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  uint32_t producers = 4, perProd = 100000, maxWorkers = 8;
+  int      c;
+
+  //----------------------------------------------------------------------------
+  // Process the options
+  //----------------------------------------------------------------------------
+  while( ( c = getopt( argc, argv, "hn:p:w:" ) ) != -1 )
+  {
+    switch( c )
+    {
+      case 'n': if( atoi( optarg ) <= 0 ) Usage( "invalid job count" );
+                perProd = atoi( optarg );
+                break;
+      case 'p': if( atoi( optarg ) <= 0 ) Usage( "invalid producer count" );
+                producers = atoi( optarg );
+                break;
+      case 'w': if( atoi( optarg ) <= 0 ) Usage( "invalid worker count" );
+                maxWorkers = atoi( optarg );
+                break;
+      case 'h': Usage( 0 ); break;
+      default:  Usage( "invalid option" );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Time the jobs for 1, 2, 4, ... workers
+  //----------------------------------------------------------------------------
+  std::cout << producers << " producers queueing " << perProd
+            << " jobs each" << std::endl;
+  for( uint32_t workers = 1; workers <= maxWorkers; workers *= 2 )
+  {
+    XrdCl::JobManager jobMan( workers, producers );
+    CountingJob       job;
+    if( !jobMan.Start() )
+    {
+      std::cerr << "xrdcljobbench: Unable to start the workers" << std::endl;
+      return 2;
+    }
+
+    ProducerData data = { &jobMan, &job, perProd };
+    std::vector<pthread_t> threads( producers );
+    timeval start, end;
+    gettimeofday( &start, 0 );
+    for( uint32_t i = 0; i < producers; ++i )
+      if( pthread_create( &threads[i], 0, Producer, &data ) )
+      {
+        std::cerr << "xrdcljobbench: Unable to start thread" << std::endl;
+        return 2;
+      }
+    for( uint32_t i = 0; i < producers; ++i )
+      pthread_join( threads[i], 0 );
+    while( job.Runs() < uint64_t( producers ) * perProd )
+      ::usleep( 1000 );
+    gettimeofday( &end, 0 );
+    jobMan.Stop();
+
+    double secs = ( end.tv_sec - start.tv_sec ) +
+                  ( end.tv_usec - start.tv_usec ) / 1e6;
+    std::cout << workers << " workers: "
+              << uint64_t( producers * double( perProd ) / secs )
+              << " jobs/s" << std::endl;
+  }
+  return 0;
+}
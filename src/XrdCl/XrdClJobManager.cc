@@ -22,6 +22,11 @@
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdSys/XrdSysE2T.hh"
 
+#include "XrdCl/XrdClUglyHacks.hh"
+
+#include <sched.h>
+#include <queue>
+
 //------------------------------------------------------------------------------
 // The thread
 //------------------------------------------------------------------------------
@@ -30,14 +35,190 @@ extern "C"
   static void *RunRunnerThread( void *arg )
   {
     using namespace XrdCl;
-    JobManager *mgr = (JobManager*)arg;
-    mgr->RunJobs();
+    std::pair<JobManager*, uint32_t> *worker =
+      (std::pair<JobManager*, uint32_t>*)arg;
+    worker->first->RunJobs( worker->second );
     return 0;
   }
 }
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  //! A job queue: a bounded lock-free ring (D. Vyukov's MPMC queue) with
+  //! a locked spill-over list for the rare case of the ring being full. The
+  //! counter tells how many jobs may still be claimed, idle workers sleep on
+  //! the semaphore of the job manager, which counts the jobs of all queues.
+  //----------------------------------------------------------------------------
+  class JobManager::JobQueue
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor, the size has to be a power of 2
+      //------------------------------------------------------------------------
+      JobQueue( size_t size ): pCells( new Cell[size] ), pMask( size - 1 ),
+        pEnqPos( 0 ), pDeqPos( 0 ), pSpillSize( 0 ), pCount( 0 )
+      {
+        for( size_t i = 0; i < size; ++i )
+          pCells[i].seq.store( i, std::memory_order_relaxed );
+      }
+
+      ~JobQueue()
+      {
+        delete [] pCells;
+      }
+
+      //------------------------------------------------------------------------
+      //! Put the job in the queue
+      //------------------------------------------------------------------------
+      void Put( const JobHelper &h )
+      {
+        if( !Push( h ) )
+        {
+          XrdSysMutexHelper scopedLock( pSpillMutex );
+          pSpill.push( h );
+          pSpillSize.fetch_add( 1, std::memory_order_release );
+        }
+        pCount.fetch_add( 1, std::memory_order_release );
+      }
+
+      //------------------------------------------------------------------------
+      //! Get a job if there is one
+      //------------------------------------------------------------------------
+      bool TryGet( JobHelper &h )
+      {
+        size_t count = pCount.load( std::memory_order_acquire );
+        do
+        {
+          if( count == 0 ) return false;
+        }
+        while( !pCount.compare_exchange_weak( count, count - 1,
+                                              std::memory_order_acq_rel ) );
+        h = Take();
+        return true;
+      }
+
+    private:
+      struct Cell
+      {
+        std::atomic<size_t> seq;
+        JobHelper           data;
+      };
+
+      //------------------------------------------------------------------------
+      // Take a job we are entitled to by the counter, a consumer that has
+      // claimed another one may still be in the middle of removing it
+      //------------------------------------------------------------------------
+      JobHelper Take()
+      {
+        JobHelper h;
+        for( ;; )
+        {
+          if( Pop( h ) ) return h;
+          if( pSpillSize.load( std::memory_order_acquire ) )
+          {
+            XrdSysMutexHelper scopedLock( pSpillMutex );
+            if( !pSpill.empty() )
+            {
+              h = pSpill.front();
+              pSpill.pop();
+              pSpillSize.fetch_sub( 1, std::memory_order_relaxed );
+              return h;
+            }
+          }
+          sched_yield();
+        }
+      }
+
+      bool Push( const JobHelper &h )
+      {
+        Cell   *cell;
+        size_t  pos = pEnqPos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+          cell = &pCells[pos & pMask];
+          size_t   seq = cell->seq.load( std::memory_order_acquire );
+          intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+          if( dif == 0 )
+          {
+            if( pEnqPos.compare_exchange_weak( pos, pos + 1,
+                                               std::memory_order_relaxed ) )
+              break;
+          }
+          else if( dif < 0 )
+            return false;
+          else
+            pos = pEnqPos.load( std::memory_order_relaxed );
+        }
+        cell->data = h;
+        cell->seq.store( pos + 1, std::memory_order_release );
+        return true;
+      }
+
+      bool Pop( JobHelper &h )
+      {
+        Cell   *cell;
+        size_t  pos = pDeqPos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+          cell = &pCells[pos & pMask];
+          size_t   seq = cell->seq.load( std::memory_order_acquire );
+          intptr_t dif = (intptr_t)seq - (intptr_t)( pos + 1 );
+          if( dif == 0 )
+          {
+            if( pDeqPos.compare_exchange_weak( pos, pos + 1,
+                                               std::memory_order_relaxed ) )
+              break;
+          }
+          else if( dif < 0 )
+            return false;
+          else
+            pos = pDeqPos.load( std::memory_order_relaxed );
+        }
+        h = cell->data;
+        cell->seq.store( pos + pMask + 1, std::memory_order_release );
+        return true;
+      }
+
+      Cell                  *pCells;
+      const size_t           pMask;
+      char                   pPad1[64];
+      std::atomic<size_t>    pEnqPos;
+      char                   pPad2[64];
+      std::atomic<size_t>    pDeqPos;
+      char                   pPad3[64];
+      std::atomic<size_t>    pSpillSize;
+      XrdSysMutex            pSpillMutex;
+      std::queue<JobHelper>  pSpill;
+      char                   pPad4[64];
+      std::atomic<size_t>    pCount;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  JobManager::JobManager( uint32_t workers, uint32_t queues ):
+    pNextQueue( 0 ), pPending( 0 ), pRunning( false )
+  {
+    if( queues > workers ) queues = workers;
+    if( queues == 0 ) queues = 1;
+
+    pWorkers.resize( workers );
+    for( uint32_t i = 0; i < workers; ++i )
+      pWorkerArgs.push_back( std::make_pair( this, i % queues ) );
+    for( uint32_t i = 0; i < queues; ++i )
+      pJobs.push_back( new JobQueue( 4096 ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  JobManager::~JobManager()
+  {
+    for( size_t i = 0; i < pJobs.size(); ++i )
+      delete pJobs[i];
+  }
+
   //----------------------------------------------------------------------------
   // Initialize the job manager
   //----------------------------------------------------------------------------
@@ -51,10 +232,37 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool JobManager::Finalize()
   {
-    pJobs.Clear();
+    JobHelper h;
+    while( pPending.CondWait() )
+      while( !Steal( pJobs.size(), h ) ) sched_yield();
     return true;
   }
 
+  //----------------------------------------------------------------------------
+  // Add a job to be run
+  //----------------------------------------------------------------------------
+  void JobManager::QueueJob( Job *job, void *arg )
+  {
+    QueueJob( job, arg, AssignQueue() );
+  }
+
+  //----------------------------------------------------------------------------
+  // Add a job to be run by the workers of given queue
+  //----------------------------------------------------------------------------
+  void JobManager::QueueJob( Job *job, void *arg, uint32_t queue )
+  {
+    pJobs[queue % pJobs.size()]->Put( JobHelper( job, arg ) );
+    pPending.Post();
+  }
+
+  //----------------------------------------------------------------------------
+  // Assign a job queue to a new job source
+  //----------------------------------------------------------------------------
+  uint32_t JobManager::AssignQueue()
+  {
+    if( pJobs.size() == 1 ) return 0;
+    return pNextQueue.fetch_add( 1, std::memory_order_relaxed ) % pJobs.size();
+  }
   //----------------------------------------------------------------------------
   // Start the workers
   //----------------------------------------------------------------------------
@@ -72,7 +280,8 @@ namespace XrdCl
 
     for( uint32_t i = 0; i < pWorkers.size(); ++i )
     {
-      int ret = ::pthread_create( &pWorkers[i], 0, ::RunRunnerThread, this );
+      int ret = ::pthread_create( &pWorkers[i], 0, ::RunRunnerThread,
+                                  &pWorkerArgs[i] );
       if( ret != 0 )
       {
         log->Error( JobMgrMsg, "Unable to spawn a job worker thread: %s",
@@ -83,7 +292,8 @@ namespace XrdCl
       }
     }
     pRunning = true;
-    log->Debug( JobMgrMsg, "Job manager started, %d workers", pWorkers.size() );
+    log->Debug( JobMgrMsg, "Job manager started, %d workers, %d queues",
+                pWorkers.size(), pJobs.size() );
     return true;
   }
 
@@ -137,14 +347,38 @@ namespace XrdCl
   }
 
   //----------------------------------------------------------------------------
-  // Initialize the job manager
+  // Take a job from any queue but the given one
   //----------------------------------------------------------------------------
-  void JobManager::RunJobs()
+  bool JobManager::Steal( uint32_t queue, JobHelper &h )
   {
+    for( size_t i = 1; i <= pJobs.size(); ++i )
+    {
+      size_t q = ( queue + i ) % pJobs.size();
+      if( q != queue && pJobs[q]->TryGet( h ) )
+        return true;
+    }
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run the jobs of given queue
+  //----------------------------------------------------------------------------
+  void JobManager::RunJobs( uint32_t queue )
+  {
+    JobQueue *jobs = pJobs[queue];
     pthread_setcanceltype( PTHREAD_CANCEL_DEFERRED, 0 );
     for( ;; )
     {
-      JobHelper h = pJobs.Get();
+      pthread_testcancel();
+
+      //------------------------------------------------------------------------
+      // Every job posts the semaphore once, so having passed it there is a
+      // job for us in one of the queues, preferably in our own
+      //------------------------------------------------------------------------
+      pPending.Wait();
+      JobHelper h;
+      while( !jobs->TryGet( h ) && !Steal( queue, h ) )
+        sched_yield();
       pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, 0 );
       h.job->Run( h.arg );
       pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, 0 );
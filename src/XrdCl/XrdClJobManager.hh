@@ -22,8 +22,9 @@
 #include <stdint.h>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <pthread.h>
-#include "XrdCl/XrdClSyncQueue.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 namespace XrdCl
 {
@@ -45,26 +46,31 @@ namespace XrdCl
   };
 
   //----------------------------------------------------------------------------
-  //! A synchronized queue
+  //! Run jobs in a pool of worker threads.
+  //!
+  //! The workers are split between a number of job queues. The jobs of a
+  //! given channel land in the queue of the event loop serving it, so that
+  //! channels handled by different event loops do not contend for the same
+  //! queue, other jobs are spread round-robin. A worker takes the jobs of its
+  //! own queue first and those of the other queues when it has nothing to
+  //! do. The idle workers of all the queues sleep on a common semaphore, so
+  //! that a job never waits for a busy worker while another one is idle.
   //----------------------------------------------------------------------------
   class JobManager
   {
     public:
       //------------------------------------------------------------------------
       //! Constructor
+      //!
+      //! @param workers number of worker threads
+      //! @param queues  number of job queues, at most one per worker
       //------------------------------------------------------------------------
-      JobManager( uint32_t workers )
-      {
-        pRunning = false;
-        pWorkers.resize( workers );
-      }
+      JobManager( uint32_t workers, uint32_t queues = 1 );
 
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~JobManager()
-      {
-      }
+      ~JobManager();
 
       //------------------------------------------------------------------------
       //! Initialize the job manager
@@ -89,15 +95,22 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Add a job to be run
       //------------------------------------------------------------------------
-      void QueueJob( Job *job, void *arg = 0 )
-      {
-        pJobs.Put( JobHelper( job, arg ) );
-      }
+      void QueueJob( Job *job, void *arg = 0 );
+
+      //------------------------------------------------------------------------
+      //! Add a job to be run by the workers of the queue given by AssignQueue
+      //------------------------------------------------------------------------
+      void QueueJob( Job *job, void *arg, uint32_t queue );
+
+      //------------------------------------------------------------------------
+      //! Assign a job queue to a new job source (ie. a stream)
+      //------------------------------------------------------------------------
+      uint32_t AssignQueue();
 
       //------------------------------------------------------------------------
-      //! Run the jobs
+      //! Run the jobs of given queue
       //------------------------------------------------------------------------
-      void RunJobs();
+      void RunJobs( uint32_t queue );
 
       bool IsWorker()
       {
@@ -120,10 +133,21 @@ namespace XrdCl
         void *arg;
       };
 
-      std::vector<pthread_t> pWorkers;
-      SyncQueue<JobHelper>   pJobs;
-      XrdSysMutex            pMutex;
-      bool                   pRunning;
+      class JobQueue;
+
+      //------------------------------------------------------------------------
+      //! Take a job from any queue but the given one, if there is one, any
+      //! queue at all if the given one is out of range
+      //------------------------------------------------------------------------
+      bool Steal( uint32_t queue, JobHelper &h );
+
+      std::vector<pthread_t>                       pWorkers;
+      std::vector<std::pair<JobManager*, uint32_t> > pWorkerArgs;
+      std::vector<JobQueue*>                       pJobs;
+      std::atomic<uint32_t>                        pNextQueue;
+      XrdSysSemaphore                              pPending;
+      XrdSysMutex                                  pMutex;
+      bool                                         pRunning;
   };
 }
 
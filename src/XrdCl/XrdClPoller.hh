@@ -26,6 +26,7 @@ namespace XrdCl
 {
   class Socket;
   class Poller;
+  class AnyObject;
 
   //----------------------------------------------------------------------------
   //! Interface
@@ -157,6 +158,17 @@ namespace XrdCl
       //! Is the event loop running?
       //------------------------------------------------------------------------
       virtual bool IsRunning() const = 0;
+
+      //------------------------------------------------------------------------
+      //! Get the index of the event loop serving the sockets of given channel
+      //!
+      //! @return the index or -1 if the channel has no sockets registered or
+      //!         the poller does not have several event loops
+      //------------------------------------------------------------------------
+      virtual int GetEventLoop( const AnyObject */*channelId*/ )
+      {
+        return -1;
+      }
   };
 }
 
@@ -31,6 +31,8 @@
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysIOEvents.hh"
 
+#include <algorithm>
+
 namespace
 {
   //----------------------------------------------------------------------------
@@ -526,6 +528,20 @@ namespace XrdCl
     return it != pSocketMap.end();
   }
 
+  //----------------------------------------------------------------------------
+  // Get the index of the event loop serving the sockets of given channel
+  //----------------------------------------------------------------------------
+  int PollerBuiltIn::GetEventLoop( const AnyObject *channelId )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    PollerMap::iterator itr = pPollerMap.find( channelId );
+    if( itr == pPollerMap.end() ) return -1;
+    PollerPool::iterator it = std::find( pPollerPool.begin(), pPollerPool.end(),
+                                         itr->second.first );
+    if( it == pPollerPool.end() ) return -1;
+    return it - pPollerPool.begin();
+  }
+
   //----------------------------------------------------------------------------
   // Return poller threads in round-robin fashion
   //----------------------------------------------------------------------------
@@ -119,6 +119,11 @@ namespace XrdCl
         return !pPollerPool.empty();
       }
 
+      //------------------------------------------------------------------------
+      //! Get the index of the event loop serving the sockets of given channel
+      //------------------------------------------------------------------------
+      virtual int GetEventLoop( const AnyObject *channelId );
+
     private:
 
       //------------------------------------------------------------------------
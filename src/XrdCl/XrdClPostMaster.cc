@@ -43,8 +43,19 @@ namespace XrdCl
     int workerThreads = DefaultWorkerThreads;
     env->GetInt( "WorkerThreads", workerThreads );
 
+    //--------------------------------------------------------------------------
+    // By default give each event loop its own job queue
+    //--------------------------------------------------------------------------
+    int workerQueues = DefaultWorkerQueues;
+    env->GetInt( "WorkerQueues", workerQueues );
+    if( workerQueues <= 0 )
+    {
+      workerQueues = DefaultParallelEvtLoop;
+      env->GetInt( "ParallelEvtLoop", workerQueues );
+    }
+
     pTaskManager = new TaskManager();
-    pJobManager  = new JobManager(workerThreads);
+    pJobManager  = new JobManager( workerThreads, workerQueues );
   }
 
   //----------------------------------------------------------------------------
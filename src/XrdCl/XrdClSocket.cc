@@ -80,10 +80,14 @@ namespace XrdCl
       return Status( stError, errFcntl, errno );
     }
 
+    //--------------------------------------------------------------------------
+    // Named sockets (local connection broker) have no TCP options
+    //--------------------------------------------------------------------------
     XrdCl::Env *env = XrdCl::DefaultEnv::GetEnv();
     flags = DefaultNoDelay;
     env->GetInt( "NoDelay", flags );
-    if( setsockopt( pSocket, IPPROTO_TCP, TCP_NODELAY, &flags, sizeof( int ) ) < 0 )
+    if( family != AF_UNIX &&
+        setsockopt( pSocket, IPPROTO_TCP, TCP_NODELAY, &flags, sizeof( int ) ) < 0 )
     {
       Close();
       return Status( stError, errFcntl, errno );
@@ -692,6 +696,12 @@ namespace XrdCl
 #if defined(TCP_CORK) // it's not defined on mac, we might want explore the possibility of using TCP_NOPUSH
     if( pCorked ) return Status();
 
+    if( pProtocolFamily == AF_UNIX )
+    {
+      pCorked = true;
+      return Status();
+    }
+
     int state = 1;
     int rc = setsockopt( pSocket, IPPROTO_TCP, TCP_CORK, &state, sizeof( state ) );
     if( rc != 0 )
@@ -709,6 +719,12 @@ namespace XrdCl
 #if defined(TCP_CORK) // it's not defined on mac, we might want explore the possibility of using TCP_NOPUSH
     if( !pCorked ) return Status();
 
+    if( pProtocolFamily == AF_UNIX )
+    {
+      pCorked = false;
+      return Status();
+    }
+
     int state = 0;
     int rc = setsockopt( pSocket, IPPROTO_TCP, TCP_CORK, &state, sizeof( state ) );
     if( rc != 0 )
@@ -39,6 +39,7 @@
 
 #include <sys/types.h>
 #include <algorithm>
+#include <errno.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 
@@ -114,6 +115,7 @@ namespace XrdCl
     pPoller( 0 ),
     pTaskManager( 0 ),
     pJobManager( 0 ),
+    pJobQueue( 0 ),
     pIncomingQueue( 0 ),
     pChannelData( 0 ),
     pLastStreamError( 0 ),
@@ -243,9 +245,14 @@ namespace XrdCl
     ++pConnectionCount;
 
     //--------------------------------------------------------------------------
-    // Resolve all the addresses of the host we're supposed to connect to
+    // If a local connection broker serves the host we're supposed to connect
+    // to we talk to it over its named socket, otherwise we resolve all
+    // the addresses of the host
     //--------------------------------------------------------------------------
-    Status st = Utils::GetHostAddresses( pAddresses, *pUrl, pAddressType );
+    Status st;
+    bool viaBroker = Utils::GetBrokerAddress( pAddresses, *pUrl );
+    if( !viaBroker )
+      st = Utils::GetHostAddresses( pAddresses, *pUrl, pAddressType );
     if( !st.IsOK() )
     {
       log->Error( PostMasterMsg, "[%s] Unable to resolve IP address for "
@@ -270,6 +277,30 @@ namespace XrdCl
         pSubStreams[0]->status = Socket::Connecting;
         break;
       }
+
+      //------------------------------------------------------------------------
+      // A broker that went away may have left its socket behind, in which
+      // case we connect to the host directly
+      //------------------------------------------------------------------------
+      if( viaBroker && ( st.errNo == ECONNREFUSED || st.errNo == ENOENT ) )
+      {
+        log->Warning( PostMasterMsg, "[%s] Connection broker is not "
+                      "responding, connecting directly: %s",
+                      pStreamName.c_str(), st.ToString().c_str() );
+        viaBroker = false;
+        st = Utils::GetHostAddresses( pAddresses, *pUrl, pAddressType );
+        if( !st.IsOK() )
+        {
+          log->Error( PostMasterMsg, "[%s] Unable to resolve IP address for "
+                      "the host", pStreamName.c_str() );
+          pLastStreamError = now;
+          st.status        = stFatal;
+          pLastFatalError  = st;
+          return st;
+        }
+        Utils::LogHostAddresses( log, PostMasterMsg, pUrl->GetHostId(),
+                                 pAddresses );
+      }
     }
     return st;
   }
@@ -459,7 +490,7 @@ namespace XrdCl
       log->Dump( PostMasterMsg, "[%s] Queuing received message: 0x%x.",
                  pStreamName.c_str(), msg );
 
-      pJobManager->QueueJob( pQueueIncMsgJob, msg );
+      pJobManager->QueueJob( pQueueIncMsgJob, msg, pJobQueue );
       return;
     }
 
@@ -494,7 +525,7 @@ namespace XrdCl
 
     Job *job = new HandleIncMsgJob( mh.handler );
     mh.Reset();
-    pJobManager->QueueJob( job, msg );
+    pJobManager->QueueJob( job, msg, pJobQueue );
   }
 
   //----------------------------------------------------------------------------
@@ -572,6 +603,13 @@ namespace XrdCl
       uint16_t numSub = pTransport->SubStreamNumber( *pChannelData );
       ++pSessionId;
 
+      //------------------------------------------------------------------------
+      // Have our callbacks run by the workers of our event loop
+      //------------------------------------------------------------------------
+      int evtLoop = pPoller->GetEventLoop( pChannelData );
+      if( evtLoop >= 0 )
+        pJobQueue = evtLoop;
+
       //------------------------------------------------------------------------
       // Create the streams if they don't exist yet
       //------------------------------------------------------------------------
@@ -641,7 +679,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       // For every connected data-stream call the on-connect handler
       //------------------------------------------------------------------------
-      pJobManager->QueueJob( pOnConnJob, 0 );
+      pJobManager->QueueJob( pOnConnJob, 0, pJobQueue );
     }
   }
 
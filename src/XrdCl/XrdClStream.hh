@@ -130,6 +130,7 @@ namespace XrdCl
       void SetJobManager( JobManager *jobManager )
       {
         pJobManager = jobManager;
+        pJobQueue   = jobManager->AssignQueue();
       }
 
       //------------------------------------------------------------------------
@@ -323,6 +324,7 @@ namespace XrdCl
       Poller                        *pPoller;
       TaskManager                   *pTaskManager;
       JobManager                    *pJobManager;
+      std::atomic<uint32_t>          pJobQueue;
       XrdSysRecMutex                 pMutex;
       InQueue                       *pIncomingQueue;
       AnyObject                     *pChannelData;
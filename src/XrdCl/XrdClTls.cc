@@ -73,6 +73,17 @@ namespace
                                      "/etc/grid-security/certificates";
     return cadir.c_str();
   }
+
+  //------------------------------------------------------------------------
+  // Helper function for setting up session reuse in TLS context, so that
+  // reconnecting to a server does not require a full handshake
+  //------------------------------------------------------------------------
+  static bool SetSessions( XrdTlsContext &tlsContext )
+  {
+    int maxSess = XrdCl::DefaultTlsSessions;
+    XrdCl::DefaultEnv::GetEnv()->GetInt( "TlsSessions", maxSess );
+    return tlsContext.ClientSessions( maxSess );
+  }
 }
 
 namespace XrdCl
@@ -95,6 +106,8 @@ namespace XrdCl
     // exception as this will be translated to TlsError anyway.
     //----------------------------------------------------------------------
     if( !tlsContext.Context() ) throw std::exception();
+    static bool sessions = SetSessions( tlsContext );
+    (void)sessions;
 
     pTls.reset(
         new XrdTlsSocket( tlsContext, pSocket->GetFD(), XrdTlsSocket::TLS_RNB_WNB,
@@ -34,6 +34,7 @@
 #include <string>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <dirent.h>
 
 namespace
@@ -206,6 +207,46 @@ namespace XrdCl
     return Status();
   }
 
+  //----------------------------------------------------------------------------
+  // Get the address of the local connection broker serving given endpoint
+  //----------------------------------------------------------------------------
+  bool Utils::GetBrokerAddress( std::vector<XrdNetAddr> &addresses,
+                                const URL               &url )
+  {
+    std::string brokerDir = DefaultConnectionBroker;
+    DefaultEnv::GetEnv()->GetString( "ConnectionBroker", brokerDir );
+    if( brokerDir.empty() )
+      return false;
+
+    std::ostringstream o;
+    o << brokerDir << "/" << url.GetHostName() << ":" << url.GetPort();
+    std::string path = o.str();
+
+    //--------------------------------------------------------------------------
+    // Fall back to a direct connection if there is no broker for the endpoint
+    //--------------------------------------------------------------------------
+    struct stat st;
+    if( ::stat( path.c_str(), &st ) != 0 || !S_ISSOCK( st.st_mode ) )
+      return false;
+
+    Log *log = DefaultEnv::GetLog();
+    XrdNetAddr addr;
+    const char *err = addr.Set( path.c_str() );
+    if( err )
+    {
+      log->Warning( UtilityMsg, "Unable to use connection broker %s: %s",
+                    path.c_str(), err );
+      return false;
+    }
+
+    log->Debug( UtilityMsg, "[%s] Connecting through the connection broker "
+                "at %s", url.GetHostId().c_str(), path.c_str() );
+
+    addresses.clear();
+    addresses.push_back( addr );
+    return true;
+  }
+
   //----------------------------------------------------------------------------
   // Log all the addresses on the list
   //----------------------------------------------------------------------------
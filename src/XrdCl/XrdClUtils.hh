@@ -111,6 +111,16 @@ namespace XrdCl
                                       const URL               &url,
                                       AddressType              type );
 
+      //------------------------------------------------------------------------
+      //! Get the address of the local connection broker serving given
+      //! endpoint, ie. the named socket <ConnectionBroker>/<host>:<port>
+      //!
+      //! @return true if the broker is configured and serves the endpoint,
+      //!         false otherwise
+      //------------------------------------------------------------------------
+      static bool GetBrokerAddress( std::vector<XrdNetAddr> &addresses,
+                                    const URL               &url );
+
       //------------------------------------------------------------------------
       //! Log all the addresses on the list
       //------------------------------------------------------------------------
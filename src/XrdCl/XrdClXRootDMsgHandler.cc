@@ -43,11 +43,19 @@
 #include <arpa/inet.h>              // for network unmarshalling stuff
 #include "XrdSys/XrdSysPlatform.hh" // same as above
 #include "XrdSys/XrdSysAtomics.hh"
+#include <atomic>
 #include <memory>
 #include <sstream>
 
 namespace
 {
+  //----------------------------------------------------------------------------
+  // Payload bytes delivered to the user buffers straight from the socket and
+  // those that had to be copied from an intermediate message buffer
+  //----------------------------------------------------------------------------
+  std::atomic<uint64_t> directBytes( 0 );
+  std::atomic<uint64_t> copiedBytes( 0 );
+
   //----------------------------------------------------------------------------
   // We need an extra task what will run the handler in the future, because
   // tasks get deleted and we need the handler
@@ -128,10 +136,11 @@ namespace XrdCl
     if( msg->GetSize() < 8 )
       return Ignore;
 
-    ServerResponse *rsp    = (ServerResponse *)msg->GetBuffer();
-    ClientRequest  *req    = (ClientRequest *)pRequest->GetBuffer();
-    uint16_t        status = 0;
-    uint32_t        dlen   = 0;
+    ServerResponse *rsp     = (ServerResponse *)msg->GetBuffer();
+    ClientRequest  *req     = (ClientRequest *)pRequest->GetBuffer();
+    uint16_t        status  = 0;
+    uint32_t        dlen    = 0;
+    uint32_t        hdrSize = 8;
 
     //--------------------------------------------------------------------------
     // We got an async message
@@ -158,8 +167,9 @@ namespace XrdCl
           embRsp->hdr.streamid[1] != req->header.streamid[1] )
         return Ignore;
 
-      status = ntohs( embRsp->hdr.status );
-      dlen   = ntohl( embRsp->hdr.dlen );
+      status  = ntohs( embRsp->hdr.status );
+      dlen    = ntohl( embRsp->hdr.dlen );
+      hdrSize = 24;
     }
     //--------------------------------------------------------------------------
     // We got a sync message - check if it belongs to us
@@ -214,10 +224,13 @@ namespace XrdCl
       {
         //----------------------------------------------------------------------
         // For kXR_read we read in raw mode if we haven't got the full message
-        // already (handler installed to late and the message has been cached)
+        // already (handler installed to late and the message has been cached),
+        // this also covers the responses delivered asynchronously (kXR_attn)
+        // as the transport reads the embedded header together with the outer
+        // one
         //----------------------------------------------------------------------
         uint16_t reqId = ntohs( req->header.requestid );
-        if( reqId == kXR_read && msg->GetSize() == 8 )
+        if( reqId == kXR_read && msg->GetSize() == hdrSize )
         {
           pReadRawStarted = false;
           pAsyncMsgSize   = dlen;
@@ -227,7 +240,7 @@ namespace XrdCl
         //----------------------------------------------------------------------
         // kXR_readv is the same as kXR_read
         //----------------------------------------------------------------------
-        if( reqId == kXR_readv  && msg->GetSize() == 8 )
+        if( reqId == kXR_readv  && msg->GetSize() == hdrSize )
         {
           pAsyncMsgSize      = dlen;
           pReadVRawMsgOffset = 0;
@@ -314,6 +327,16 @@ namespace XrdCl
     return Take | RemoveHandler;
   }
 
+  //----------------------------------------------------------------------------
+  // Get the process-wide data delivery statistics
+  //----------------------------------------------------------------------------
+  void XRootDMsgHandler::GetDataDeliveryStats( uint64_t &direct,
+                                               uint64_t &copied )
+  {
+    direct = directBytes;
+    copied = copiedBytes;
+  }
+
   //----------------------------------------------------------------------------
   // Get handler sid
   //----------------------------------------------------------------------------
@@ -341,8 +364,13 @@ namespace XrdCl
       log->Dump( XRootDMsg, "[%s] Got an async response to message %s, "
                  "processing it", pUrl.GetHostId().c_str(),
                  pRequest->GetDescription().c_str() );
-      Message *embededMsg = new Message( rsp->hdr.dlen-8 );
-      embededMsg->Append( msg->GetBuffer( 16 ), rsp->hdr.dlen-8 );
+      //------------------------------------------------------------------------
+      // If the payload has been read in raw mode we only got the header of
+      // the embedded response
+      //------------------------------------------------------------------------
+      uint32_t embSize = msg->GetSize() - 16;
+      Message *embededMsg = new Message( embSize );
+      embededMsg->Append( msg->GetBuffer( 16 ), embSize );
       XRDCL_SMART_PTR_T<Message> msgPtr( msg );
       pResponse = embededMsg; // this can never happen for oksofars
 
@@ -864,7 +892,10 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Read the data
     //--------------------------------------------------------------------------
-    return ReadAsync( socket, bytesRead );
+    uint32_t alreadyRead = bytesRead;
+    Status st = ReadAsync( socket, bytesRead );
+    directBytes += bytesRead - alreadyRead;
+    return st;
   }
 
   //----------------------------------------------------------------------------
@@ -1041,7 +1072,9 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Read the body
     //--------------------------------------------------------------------------
+    uint32_t alreadyRead = bytesRead;
     Status st = ReadAsync( socket, bytesRead );
+    directBytes += bytesRead - alreadyRead;
 
     if( st.IsOK() && st.code == suDone )
     {
@@ -1666,7 +1699,10 @@ namespace XrdCl
           }
 
           if( pPartialResps[i]->GetSize() > 8 )
+          {
             memcpy( cursor, part->body.buffer.data, part->hdr.dlen );
+            copiedBytes += part->hdr.dlen;
+          }
           currentOffset += part->hdr.dlen;
           cursor        += part->hdr.dlen;
         }
@@ -1674,7 +1710,10 @@ namespace XrdCl
         if( currentOffset + rsp->hdr.dlen <= chunk.length )
         {
           if( pResponse->GetSize() > 8 )
+          {
             memcpy( cursor, rsp->body.buffer.data, rsp->hdr.dlen );
+            copiedBytes += rsp->hdr.dlen;
+          }
           currentOffset += rsp->hdr.dlen;
         }
         else
@@ -2104,6 +2143,7 @@ namespace XrdCl
           return Status( stFatal, errInvalidResponse );
         }
         memcpy( (*pChunkList)[currentChunk].buffer, cursor+16, chunk->rlen );
+        copiedBytes += chunk->rlen;
       }
 
       pChunkStatus[currentChunk].done = true;
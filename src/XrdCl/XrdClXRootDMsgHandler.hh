@@ -386,6 +386,16 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void TakeDownTimeoutFence();
 
+      //------------------------------------------------------------------------
+      //! Get the process-wide data delivery statistics
+      //!
+      //! @param direct : number of payload bytes read from the socket straight
+      //!                 into the user buffers
+      //! @param copied : number of payload bytes copied into the user buffers
+      //!                 from intermediate message buffers
+      //------------------------------------------------------------------------
+      static void GetDataDeliveryStats( uint64_t &direct, uint64_t &copied );
+
     private:
 
       //------------------------------------------------------------------------
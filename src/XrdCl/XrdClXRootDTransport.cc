@@ -304,6 +304,34 @@ namespace XrdCl
       log->Dump( XRootDTransportMsg, "[msg: 0x%x] Expecting %d bytes of message "
                  "body", message, bodySize );
 
+      //------------------------------------------------------------------------
+      // For an asynchronous response we also need the header of the embedded
+      // response, otherwise the handler cannot claim the message and read
+      // the payload directly into the user buffers
+      //------------------------------------------------------------------------
+      ServerResponseHeader *hdr = (ServerResponseHeader*)message->GetBuffer();
+      if( hdr->status != kXR_attn || bodySize < 16 )
+        return Status( stOK, suDone );
+      message->ReAllocate( 24 );
+    }
+
+    //--------------------------------------------------------------------------
+    // Read the kXR_attn action code and the embedded response header
+    //--------------------------------------------------------------------------
+    if( message->GetSize() == 24 && message->GetCursor() < 24 )
+    {
+      size_t leftToBeRead = 24 - message->GetCursor();
+      while( leftToBeRead )
+      {
+        int bytesRead = 0;
+        Status status = socket->Read( message->GetBufferAtCursor(), leftToBeRead, bytesRead );
+
+        if( !status.IsOK() || status.code == suRetry )
+          return status;
+
+        leftToBeRead -= bytesRead;
+        message->AdvanceCursor( bytesRead );
+      }
       return Status( stOK, suDone );
     }
     return Status( stError, errInternal );
@@ -320,7 +348,7 @@ namespace XrdCl
     size_t   leftToBeRead = 0;
     uint32_t bodySize = *(uint32_t*)(message->GetBuffer(4));
 
-    if( message->GetCursor() == 8 )
+    if( message->GetSize() < bodySize + 8 )
       message->ReAllocate( bodySize + 8 );
 
     leftToBeRead = bodySize-(message->GetCursor()-8);
@@ -37,7 +37,10 @@
 
 #include <string>
 #include <map>
+#include <list>
+#include <vector>
 #include <memory>
+#include <algorithm>
 
 #include <zlib.h>
 
@@ -57,7 +60,7 @@ class ZipCache
 {
   public:
 
-    ZipCache() : rawOffset( 0 ), rawSize( 0 ), totalRead( 0 )
+    ZipCache() : rawOffset( 0 ), rawSize( 0 ), totalRead( 0 ), streamEnd( false )
     {
       strm.zalloc   = Z_NULL;
       strm.zfree    = Z_NULL;
@@ -95,7 +98,7 @@ class ZipCache
     {
       // we only support streaming for compressed files
       if( offset != totalRead )
-        return XRootDStatus( stError, errInternal );
+        return XRootDStatus( stError, errNotSupported, 0, "Compressed files can only be read sequentially." );
 
       strm.avail_out = outsize;
       strm.next_out  = (Bytef*)outbuff;
@@ -111,6 +114,7 @@ class ZipCache
       int rc = inflate( &strm, Z_SYNC_FLUSH );
       XRootDStatus st = ToXRootDStatus( rc, "inflate" );
       if( !st.IsOK() ) return st;
+      if( rc == Z_STREAM_END ) streamEnd = true;
 
       bytesRead = avail_before - strm.avail_out;
       totalRead += bytesRead;
@@ -124,9 +128,20 @@ class ZipCache
       return rawOffset + rawSize;
     }
 
-  private:
+    bool IsEnd()
+    {
+      return streamEnd;
+    }
+
+    // the buffer for the next chunk of raw data, the previous chunk
+    // is always fully consumed before we ask for the next one
+    char* RawBuffer( uint32_t size )
+    {
+      rawBuffer.reset( new char[size] );
+      return rawBuffer.get();
+    }
 
-    XRootDStatus ToXRootDStatus( int rc, const std::string &func )
+    static XRootDStatus ToXRootDStatus( int rc, const std::string &func )
     {
       std::string msg = "[zlib] " + func + " : ";
 
@@ -144,12 +159,50 @@ class ZipCache
       }
     }
 
-    uint64_t  rawOffset; // offset of the raw data chunk in the compressed file (not archive)
-    uint32_t  rawSize;   // size of the raw data chunk
-    uint64_t  totalRead; // total number of bytes read so far
-    z_stream  strm;      // the zlib stream we will use for reading
+    // the minimum size of a raw data chunk we read at once
+    static const uint32_t kMinChunkSize = 1048576;
+
+  private:
+
+    uint64_t                 rawOffset; // offset of the raw data chunk in the compressed file (not archive)
+    uint32_t                 rawSize;   // size of the raw data chunk
+    uint64_t                 totalRead; // total number of bytes read so far
+    bool                     streamEnd; // true if the whole file has been inflated
+    z_stream                 strm;      // the zlib stream we will use for reading
+    std::unique_ptr<char[]>  rawBuffer; // the raw data chunk
 };
 
+//----------------------------------------------------------------------------
+// Inflate a whole deflated file
+//----------------------------------------------------------------------------
+static XRootDStatus InflateFile( char *inbuff, uint64_t insize, char *outbuff, uint64_t outsize )
+{
+  z_stream strm;
+  strm.zalloc   = Z_NULL;
+  strm.zfree    = Z_NULL;
+  strm.opaque   = Z_NULL;
+  strm.avail_in = 0;
+  strm.next_in  = Z_NULL;
+
+  // negative window bits: raw deflate data, no zlib/gzip headers
+  int rc = inflateInit2( &strm, -MAX_WBITS );
+  if( rc != Z_OK ) return ZipCache::ToXRootDStatus( rc, "inflateInit2" );
+
+  strm.avail_in  = insize;
+  strm.next_in   = (Bytef*)inbuff;
+  strm.avail_out = outsize;
+  strm.next_out  = (Bytef*)outbuff;
+
+  rc = inflate( &strm, Z_FINISH );
+  uint64_t total = strm.total_out;
+  inflateEnd( &strm );
+
+  if( rc == Z_STREAM_END && total == outsize ) return XRootDStatus();
+  if( rc == Z_STREAM_END || rc == Z_OK || rc == Z_BUF_ERROR )
+    return XRootDStatus( stError, errDataError, Z_DATA_ERROR, "[zlib] inflate : size mismatch." );
+  return ZipCache::ToXRootDStatus( rc, "inflate" );
+}
+
 
 template<typename RESP>
 struct ZipHandlerException
@@ -208,7 +261,7 @@ struct ZIP64_EOCD
     {
       pZipVersion    = *reinterpret_cast<const uint16_t*>( buffer + 12 );
       pMinZipVersion = *reinterpret_cast<const uint16_t*>( buffer + 14 );
-      pNbCdEntries   = *reinterpret_cast<const uint16_t*>( buffer + 32 );
+      pNbCdEntries   = *reinterpret_cast<const uint64_t*>( buffer + 32 );
       pCdSize        = *reinterpret_cast<const uint64_t*>( buffer + 40 );
       pCdOffset      = *reinterpret_cast<const uint64_t*>( buffer + 48 );
     }
@@ -342,12 +395,78 @@ struct CDFH
     static const uint32_t kCdfhSign     = 0x02014b50;
 };
 
+//----------------------------------------------------------------------------
+// Process wide cache of the Central-directories of the archives we opened,
+// keyed by the URL, the size and the modification time of the archive, so
+// reopening an unchanged archive costs just the open (and stat) round trip.
+//----------------------------------------------------------------------------
+class ZipCdCache
+{
+  public:
+
+    struct Entry
+    {
+      std::string cd;        // the raw Central-directory
+      uint64_t    cdOffset;  // offset of the Central-directory in the archive
+      uint64_t    nbCdRec;   // number of Central-directory-file-header records
+    };
+
+    static ZipCdCache& Instance()
+    {
+      static ZipCdCache cache;
+      return cache;
+    }
+
+    std::shared_ptr<const Entry> Get( const std::string &key )
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      EntryMap::iterator it = pEntries.find( key );
+      if( it == pEntries.end() ) return std::shared_ptr<const Entry>();
+      pLru.splice( pLru.begin(), pLru, it->second.second );
+      return it->second.first;
+    }
+
+    void Put( const std::string &key, std::shared_ptr<const Entry> entry )
+    {
+      int maxSize = DefaultZipCdCacheSize;
+      DefaultEnv::GetEnv()->GetInt( "ZipCdCacheSize", maxSize );
+      if( maxSize <= 0 ) return;
+
+      XrdSysMutexHelper scopedLock( pMutex );
+      EntryMap::iterator it = pEntries.find( key );
+      if( it != pEntries.end() )
+      {
+        it->second.first = entry;
+        pLru.splice( pLru.begin(), pLru, it->second.second );
+        return;
+      }
+
+      while( pEntries.size() >= size_t( maxSize ) )
+      {
+        pEntries.erase( pLru.back() );
+        pLru.pop_back();
+      }
+
+      pLru.push_front( key );
+      pEntries[key] = std::make_pair( entry, pLru.begin() );
+    }
+
+  private:
+
+    typedef std::list<std::string> LruList;
+    typedef std::map<std::string, std::pair<std::shared_ptr<const Entry>, LruList::iterator> > EntryMap;
+
+    XrdSysMutex pMutex;
+    EntryMap    pEntries;
+    LruList     pLru;
+};
+
 
 class ZipArchiveReaderImpl
 {
   public:
 
-    ZipArchiveReaderImpl( File &archive ) : pArchive( archive ), pArchiveSize( 0 ), pRefCount( 1 ), pOpen( false ) { }
+    ZipArchiveReaderImpl( File &archive ) : pArchive( archive ), pArchiveSize( 0 ), pArchiveMTime( 0 ), pCdOffset( 0 ), pRefCount( 1 ), pOpen( false ) { }
 
     ZipArchiveReaderImpl* Self()
     {
@@ -379,6 +498,10 @@ class ZipArchiveReaderImpl
 
     XRootDStatus Read( const std::string &filename, uint64_t relativeOffset, uint32_t size, void *buffer, ResponseHandler *userHandler, uint16_t timeout = 0 );
 
+    XRootDStatus ReadCompressed( ZipCache &cache, uint64_t fileoff, uint64_t filesize, uint64_t relativeOffset, uint32_t size, void *buffer, uint32_t bytesRead, ResponseHandler *userHandler, uint16_t timeout );
+
+    XRootDStatus ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, ResponseHandler *userHandler, uint16_t timeout = 0 );
+
     XRootDStatus ZCRC32( const std::string &filename, std::string &checksum );
 
     XRootDStatus ZCRC32( std::string &checksum );
@@ -431,6 +554,34 @@ class ZipArchiveReaderImpl
       pArchiveSize = size;
     }
 
+    void SetArchiveMTime( uint64_t mtime )
+    {
+      pArchiveMTime = mtime;
+    }
+
+    std::string CdCacheKey() const
+    {
+      return pUrl + "#" + std::to_string( pArchiveSize ) + ":" + std::to_string( pArchiveMTime );
+    }
+
+    bool ReadCdFromCache()
+    {
+      std::shared_ptr<const ZipCdCache::Entry> entry = ZipCdCache::Instance().Get( CdCacheKey() );
+      if( !entry ) return false;
+
+      XRootDStatus st = ParseCdRecords( entry->cd.data(), entry->nbCdRec, entry->cd.size() );
+      if( !st.IsOK() )
+      {
+        ClearRecords();
+        return false;
+      }
+      pCdOffset = entry->cdOffset;
+
+      Log *log = DefaultEnv::GetLog();
+      log->Debug( FileMsg, "ZipArchiveReader using cached Central-directory of %s.", pUrl.c_str() );
+      return true;
+    }
+
     char* LookForEocd( uint64_t size )
     {
       for( ssize_t offset = size - EOCD::kEocdBaseSize; offset >= 0; --offset )
@@ -441,7 +592,7 @@ class ZipArchiveReaderImpl
       return 0;
     }
 
-    XRootDStatus ParseCdRecords( char *buffer, uint16_t nbCdRecords, uint32_t bufferSize )
+    XRootDStatus ParseCdRecords( const char *buffer, uint64_t nbCdRecords, uint32_t bufferSize )
     {
       uint32_t offset = 0;
       pCdRecords.reserve( nbCdRecords );
@@ -450,7 +601,7 @@ class ZipArchiveReaderImpl
       {
         if( bufferSize < CDFH::kCdfhBaseSize ) break;
         // check the signature
-        uint32_t *signature = (uint32_t*)( buffer + offset );
+        const uint32_t *signature = (const uint32_t*)( buffer + offset );
         if( *signature != CDFH::kCdfhSign ) return XRootDStatus( stError, errErrorResponse, errDataError, "Central-directory-file-header signature not found." );
         // parse the record
         CDFH *cdfh = new CDFH( buffer + offset );
@@ -476,14 +627,27 @@ class ZipArchiveReaderImpl
 
       // parse Central-Directory-File-Header records
       XRootDStatus st = ParseCdRecords( pBuffer.get() + pEocd->pCdOffset, pEocd->pNbCdRec, pEocd->pCdSize );
+      pCdOffset = pEocd->pCdOffset;
 
       return st;
     }
 
-    XRootDStatus HandleCdfh( uint16_t nbCdRecords, uint32_t bufferSize )
+    XRootDStatus HandleCdfh( uint64_t nbCdRecords, uint32_t bufferSize )
     {
       // parse Central-Directory-File-Header records
       XRootDStatus st = ParseCdRecords( pBuffer.get(), nbCdRecords, bufferSize );
+      pCdOffset = pZip64Eocd ? pZip64Eocd->pCdOffset : pEocd->pCdOffset;
+
+      // remember the Central-directory in case the archive is reopened
+      if( st.IsOK() )
+      {
+        std::shared_ptr<ZipCdCache::Entry> entry( new ZipCdCache::Entry() );
+        entry->cd.assign( pBuffer.get(), bufferSize );
+        entry->cdOffset = pCdOffset;
+        entry->nbCdRec  = nbCdRecords;
+        ZipCdCache::Instance().Put( CdCacheKey(), entry );
+      }
+
       // successful or not we don't need it anymore
       pBuffer.reset();
       return st;
@@ -519,7 +683,10 @@ class ZipArchiveReaderImpl
     }
 
     File                             &pArchive;
+    std::string                       pUrl;
     uint64_t                          pArchiveSize;
+    uint64_t                          pArchiveMTime;
+    uint64_t                          pCdOffset;
     std::unique_ptr<char[]>           pBuffer;
     std::unique_ptr<EOCD>             pEocd;
     std::unique_ptr<ZIP64_EOCD>       pZip64Eocd;
@@ -672,10 +839,21 @@ class StatArchiveHandler : public ZipHandlerBase<StatInfo>
     {
       uint64_t size = response->GetSize();
       pImpl->SetArchiveSize( size );
+      pImpl->SetArchiveMTime( response->GetModTime() );
 
       // if the size of the file is smaller than the maximum comment size +
       // EOCD size simply download the whole file, otherwise download the EOCD
-      XRootDStatus st = ( size <= EOCD::kMaxCommentSize + EOCD::kEocdBaseSize + ZIP64_EOCDL::kZip64EocdlSize ) ?
+      // unless we have the Central-directory of this very archive already
+      bool small = size <= EOCD::kMaxCommentSize + EOCD::kEocdBaseSize + ZIP64_EOCDL::kZip64EocdlSize;
+      if( !small && pImpl->ReadCdFromCache() )
+      {
+        delete response;
+        if( pUserHandler ) pUserHandler->HandleResponse( status, 0 );
+        else delete status;
+        return;
+      }
+
+      XRootDStatus st = small ?
                         pImpl->ReadArchive( pUserHandler ) :
                         pImpl->ReadEocd( pUserHandler );
       if( !st.IsOK() )
@@ -718,7 +896,7 @@ class ReadCdfhHandler : public ZipHandlerBase<ChunkInfo>
 {
   public:
 
-    ReadCdfhHandler( ZipArchiveReaderImpl *impl, ResponseHandler *userHandler, uint16_t nbCdRec ) : ZipHandlerBase<ChunkInfo>( impl, userHandler ), pNbCdRec( nbCdRec ) { }
+    ReadCdfhHandler( ZipArchiveReaderImpl *impl, ResponseHandler *userHandler, uint64_t nbCdRec ) : ZipHandlerBase<ChunkInfo>( impl, userHandler ), pNbCdRec( nbCdRec ) { }
 
     virtual void HandleResponseImpl( XRootDStatus *status, ChunkInfo *response )
     {
@@ -737,7 +915,7 @@ class ReadCdfhHandler : public ZipHandlerBase<ChunkInfo>
 
   private:
 
-    uint16_t pNbCdRec;
+    uint64_t pNbCdRec;
 };
 
 
@@ -787,17 +965,25 @@ class ZipReadCompressedHandler : public ZipHandlerBase<ChunkInfo>
   public:
 
     ZipReadCompressedHandler( ZipCache             &cache,
+                              uint64_t              fileOffset,
+                              uint64_t              fileSize,
                               uint64_t              relativeOffet,
                               uint64_t              rawOffset,
                               void                 *userBuffer,
                               uint32_t              userSize,
+                              uint32_t              bytesRead,
+                              uint16_t              timeout,
                               ZipArchiveReaderImpl *impl,
                               ResponseHandler      *userHandler ) : ZipHandlerBase<ChunkInfo>( impl, userHandler ),
                                                                     pCache( cache ),
+                                                                    pFileOffset( fileOffset ),
+                                                                    pFileSize( fileSize ),
                                                                     pUserOffset( relativeOffet ),
                                                                     pRawOffset( rawOffset ),
                                                                     pUserBuffer( userBuffer ),
-                                                                    pUserSize( userSize )
+                                                                    pUserSize( userSize ),
+                                                                    pBytesRead( bytesRead ),
+                                                                    pTimeout( timeout )
     {
 
     }
@@ -812,10 +998,7 @@ class ZipReadCompressedHandler : public ZipHandlerBase<ChunkInfo>
         return;
       }
 
-      // at this point we can be sure that all the needed data are in the cache
-      // (we requested as much data as the user asked for so in the worst case
-      // we have exactly as much data as the user needs, most likely we have
-      // more because the data are compressed)
+      // inflate as much as the output buffer can take
       uint32_t bytesRead = 0;
       st = pCache.Read( bytesRead );
       if( !st.IsOK() )
@@ -824,10 +1007,26 @@ class ZipReadCompressedHandler : public ZipHandlerBase<ChunkInfo>
         if( pUserHandler ) pUserHandler->HandleResponse( new XRootDStatus( st ), 0 );
         return;
       }
+      pBytesRead += bytesRead;
+
+      // the user buffer is not full yet and there is more raw data,
+      // stream in the next chunk
+      if( st.code == suPartial && !pCache.IsEnd() && pCache.NextChunkOffset() < pFileSize )
+      {
+        st = pImpl->ReadCompressed( pCache, pFileOffset, pFileSize, pUserOffset, pUserSize - pBytesRead, pUserBuffer, pBytesRead, pUserHandler, pTimeout );
+        if( !st.IsOK() )
+        {
+          DeleteArgs( status, response );
+          if( pUserHandler ) pUserHandler->HandleResponse( new XRootDStatus( st ), 0 );
+          return;
+        }
+        DeleteArgs( status, response );
+        return;
+      }
 
       // prepare the response for the end-user
       response->buffer = pUserBuffer;
-      response->length = pUserSize;
+      response->length = pBytesRead;
       response->offset = pUserOffset;
 
       if( pUserHandler ) pUserHandler->HandleResponse( status, PkgResp( response ) );
@@ -838,10 +1037,117 @@ class ZipReadCompressedHandler : public ZipHandlerBase<ChunkInfo>
   private:
 
     ZipCache &pCache;
+    uint64_t  pFileOffset;
+    uint64_t  pFileSize;
     uint64_t  pUserOffset;
     uint64_t  pRawOffset;
     void     *pUserBuffer;
     uint32_t  pUserSize;
+    uint32_t  pBytesRead;
+    uint16_t  pTimeout;
+};
+
+
+//----------------------------------------------------------------------------
+// The state shared by the vector reads fetching whole files from the archive
+//----------------------------------------------------------------------------
+struct ZipReadFilesBatch
+{
+    struct Member
+    {
+      CDFH                    *cdfh;      // the Central-directory record of the file
+      char                    *buffer;    // the user buffer
+      std::unique_ptr<char[]>  rawBuffer; // the deflated data (if compressed)
+    };
+
+    ZipReadFilesBatch( ResponseHandler *userHandler, size_t nbMembers ) : pUserHandler( userHandler ), pMembers( nbMembers ), pPending( 0 ) { }
+
+    //------------------------------------------------------------------------
+    // Account for the response of one of the vector reads, returns true if
+    // it was the last one (the caller then finalizes and deletes the batch)
+    //------------------------------------------------------------------------
+    bool Done( const XRootDStatus &status )
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      if( !status.IsOK() && pStatus.IsOK() ) pStatus = status;
+      return --pPending == 0;
+    }
+
+    //------------------------------------------------------------------------
+    // Inflate the compressed files and notify the user
+    //------------------------------------------------------------------------
+    void Finalize()
+    {
+      VectorReadInfo *info = 0;
+      if( pStatus.IsOK() )
+      {
+        info = new VectorReadInfo();
+        uint32_t total = 0;
+        for( size_t i = 0; i < pMembers.size(); ++i )
+        {
+          Member &m = pMembers[i];
+          if( m.rawBuffer )
+          {
+            pStatus = InflateFile( m.rawBuffer.get(), m.cdfh->pCompressedSize, m.buffer, m.cdfh->pUncompressedSize );
+            m.rawBuffer.reset();
+            if( !pStatus.IsOK() ) break;
+          }
+          info->GetChunks().push_back( ChunkInfo( 0, m.cdfh->pUncompressedSize, m.buffer ) );
+          total += m.cdfh->pUncompressedSize;
+        }
+        info->SetSize( total );
+      }
+
+      if( !pStatus.IsOK() )
+      {
+        delete info;
+        info = 0;
+      }
+
+      if( pUserHandler )
+      {
+        AnyObject *resp = 0;
+        if( info )
+        {
+          resp = new AnyObject();
+          resp->Set( info );
+        }
+        pUserHandler->HandleResponse( new XRootDStatus( pStatus ), resp );
+      }
+      else
+        delete info;
+    }
+
+    ResponseHandler     *pUserHandler;
+    std::vector<Member>  pMembers;
+    size_t               pPending;
+    XRootDStatus         pStatus;
+    XrdSysMutex          pMutex;
+};
+
+
+class ZipReadFilesHandler : public ZipHandlerCommon
+{
+  public:
+
+    ZipReadFilesHandler( ZipReadFilesBatch *batch, ZipArchiveReaderImpl *impl ) : ZipHandlerCommon( impl, 0 ), pBatch( batch ) { }
+
+    virtual void HandleResponse( XRootDStatus *status, AnyObject *response )
+    {
+      // the data went straight to the buffers of the batch
+      if( pBatch->Done( *status ) )
+      {
+        pBatch->Finalize();
+        delete pBatch;
+      }
+
+      DeleteArgs( status, response );
+      delete this;
+    }
+
+  private:
+
+    ZipReadFilesBatch *pBatch;
 };
 
 
@@ -859,6 +1165,7 @@ ZipArchiveReader::~ZipArchiveReader()
 
 XRootDStatus ZipArchiveReaderImpl::Open( const std::string &url, ResponseHandler *userHandler, uint16_t timeout )
 {
+  pUrl = url;
   ZipOpenHandler *handler = new ZipOpenHandler( this, userHandler );
   XRootDStatus st = pArchive.Open( url, OpenFlags::Read, Access::None, handler, timeout );
   if( !st.IsOK() ) delete handler;
@@ -975,7 +1282,8 @@ XRootDStatus ZipArchiveReaderImpl::ReadCdfh( uint64_t bytesRead, ResponseHandler
   uint64_t offset = pZip64Eocd ? pZip64Eocd->pCdOffset : pEocd->pCdOffset;
   uint32_t size   = pZip64Eocd ? pZip64Eocd->pCdSize   : pEocd->pCdSize;
   pBuffer.reset( new char[size] );
-  ReadCdfhHandler *handler = new ReadCdfhHandler( this, userHandler, pEocd->pNbCdRec );
+  uint64_t nbCdRec = pZip64Eocd ? pZip64Eocd->pNbCdEntries : pEocd->pNbCdRec;
+  ReadCdfhHandler *handler = new ReadCdfhHandler( this, userHandler, nbCdRec );
   XRootDStatus st = pArchive.Read( offset, size, pBuffer.get(), handler );
   if( !st.IsOK() ) delete handler;
   return st;
@@ -1039,6 +1347,27 @@ XRootDStatus ZipArchiveReader::Read( uint64_t offset, uint32_t size, void *buffe
   return status;
 }
 
+//------------------------------------------------------------------------
+// Async read of whole files.
+//------------------------------------------------------------------------
+XRootDStatus ZipArchiveReader::ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, ResponseHandler *handler, uint16_t timeout )
+{
+  return pImpl->ReadFiles( filenames, buffers, handler, timeout );
+}
+
+//------------------------------------------------------------------------
+// Sync read of whole files.
+//------------------------------------------------------------------------
+XRootDStatus ZipArchiveReader::ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, VectorReadInfo *&vReadInfo, uint16_t timeout )
+{
+  SyncResponseHandler handler;
+  Status st = ReadFiles( filenames, buffers, &handler, timeout );
+  if( !st.IsOK() )
+    return st;
+
+  return MessageUtils::WaitForResponse( &handler, vReadInfo );
+}
+
 //------------------------------------------------------------------------
 // Sync list
 //------------------------------------------------------------------------
@@ -1070,12 +1399,11 @@ XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t r
   // record and shift it by the file size.
   // The next record is either the next LFH (next file)
   // or the start of the Central-directory.
-  uint64_t cdOffset = pZip64Eocd ? pZip64Eocd->pCdOffset : pEocd->pCdOffset;
-  uint64_t nextRecordOffset = ( cditr->second + 1 < pCdRecords.size() ) ? pCdRecords[cditr->second + 1]->pOffset : cdOffset;
+  uint64_t nextRecordOffset = ( cditr->second + 1 < pCdRecords.size() ) ? pCdRecords[cditr->second + 1]->pOffset : pCdOffset;
   uint64_t filesize  = cdfh->pCompressedSize;
   uint64_t fileoff  = nextRecordOffset - filesize;
   uint64_t offset   = fileoff + relativeOffset;
-  uint64_t sizeTillEnd = cdfh->pUncompressedSize - relativeOffset;
+  uint64_t sizeTillEnd = relativeOffset < cdfh->pUncompressedSize ? cdfh->pUncompressedSize - relativeOffset : 0;
   if( size > sizeTillEnd ) size = sizeTillEnd;
 
   // if it is a compressed file use ZIP cache to read from the file
@@ -1090,11 +1418,12 @@ XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t r
     // straight away
     if( recent && pBuffer)
     {
-      XRootDStatus st = cache.Input( pBuffer.get() + offset, filesize - fileoff, relativeOffset );
+      XRootDStatus st = cache.Input( pBuffer.get() + fileoff, filesize, 0 );
       if( !st.IsOK() ) return st;
     }
 
     XRootDStatus st = cache.Output( buffer, size, relativeOffset );
+    if( !st.IsOK() ) return st;
 
     uint32_t bytesRead = 0;
     st = cache.Read( bytesRead );
@@ -1102,32 +1431,16 @@ XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t r
     // propagate errors to the end-user
     if( !st.IsOK() ) return st;
 
-    if( st.code == suPartial )
-    {
-      // the raw offset of the next chunk within the file
-      uint64_t rawOffset = cache.NextChunkOffset();
-      // if this is the first time we are setting an input chunk
-      // use the user-specified offset
-      if( !rawOffset )
-        rawOffset = relativeOffset;
-      // size of the next chunk of raw (compressed) data
-      uint32_t chunkSize = size;
-      // make sure we are not reading passed the end of the file
-      if( rawOffset + chunkSize > filesize )
-        chunkSize = filesize - rawOffset;
-      // allocate the buffer for the compressed data
-      pBuffer.reset( new char[chunkSize] );
-      ZipReadCompressedHandler *handler = new ZipReadCompressedHandler( cache, relativeOffset, rawOffset, buffer, size, this, userHandler );
-      st = pArchive.Read( fileoff + rawOffset, chunkSize, pBuffer.get(), handler, timeout );
-      if( !st.IsOK() ) delete handler;
-      return st;
-    }
+    // stream in the raw data until the user buffer is full
+    // or the end of the file has been reached
+    if( st.code == suPartial && !cache.IsEnd() && cache.NextChunkOffset() < filesize )
+      return ReadCompressed( cache, fileoff, filesize, relativeOffset, size - bytesRead, buffer, bytesRead, userHandler, timeout );
 
     if( userHandler )
     {
       XRootDStatus *st   = new XRootDStatus();
       AnyObject    *resp = new AnyObject();
-      ChunkInfo    *info = new ChunkInfo( relativeOffset, size, buffer );
+      ChunkInfo    *info = new ChunkInfo( relativeOffset, bytesRead, buffer );
       resp->Set( info );
       userHandler->HandleResponse( st, resp );
     }
@@ -1164,6 +1477,130 @@ XRootDStatus ZipArchiveReaderImpl::Read( const std::string &filename, uint64_t r
   return st;
 }
 
+XRootDStatus ZipArchiveReaderImpl::ReadCompressed( ZipCache &cache, uint64_t fileoff, uint64_t filesize, uint64_t relativeOffset, uint32_t size, void *buffer, uint32_t bytesRead, ResponseHandler *userHandler, uint16_t timeout )
+{
+  // the raw offset of the next chunk within the file
+  uint64_t rawOffset = cache.NextChunkOffset();
+  // size of the next chunk of raw (compressed) data, whatever
+  // is not inflated now will be used by the subsequent reads
+  uint32_t chunkSize = size;
+  if( chunkSize < ZipCache::kMinChunkSize ) chunkSize = ZipCache::kMinChunkSize;
+  // make sure we are not reading passed the end of the file
+  if( rawOffset + chunkSize > filesize )
+    chunkSize = filesize - rawOffset;
+  ZipReadCompressedHandler *handler = new ZipReadCompressedHandler( cache, fileoff, filesize, relativeOffset, rawOffset, buffer, size + bytesRead, bytesRead, timeout, this, userHandler );
+  XRootDStatus st = pArchive.Read( fileoff + rawOffset, chunkSize, cache.RawBuffer( chunkSize ), handler, timeout );
+  if( !st.IsOK() ) delete handler;
+  return st;
+}
+
+XRootDStatus ZipArchiveReaderImpl::ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, ResponseHandler *userHandler, uint16_t timeout )
+{
+  if( !pArchive.IsOpen() ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
+  if( filenames.size() != buffers.size() ) return XRootDStatus( stError, errInvalidArgs );
+
+  // the limits of a single vector read
+  static const uint32_t kMaxChunkSize = 2097136;
+  static const size_t   kMaxNbChunks  = 1024;
+
+  std::unique_ptr<ZipReadFilesBatch> batch( new ZipReadFilesBatch( userHandler, filenames.size() ) );
+  ChunkList chunks;
+  uint64_t  total = 0;
+
+  for( size_t i = 0; i < filenames.size(); ++i )
+  {
+    std::map<std::string, size_t>::iterator cditr = pFileToCdfh.find( filenames[i] );
+    if( cditr == pFileToCdfh.end() ) return XRootDStatus( stError, errNotFound, errNotFound, "File not found: " + filenames[i] );
+    CDFH *cdfh = pCdRecords[cditr->second];
+
+    if( cdfh->pCompressionMethod != 0 && cdfh->pCompressionMethod != Z_DEFLATED )
+      return XRootDStatus( stError, errNotSupported, 0, "The compression algorithm is not supported!" );
+
+    // the response sizes are 32 bit
+    total += cdfh->pUncompressedSize;
+    if( cdfh->pCompressedSize > 0xffffffff || total > 0xffffffff )
+      return XRootDStatus( stError, errInvalidArgs, 0, "Too much data for a single read." );
+
+    // see ZipArchiveReaderImpl::Read for how we locate the data
+    uint64_t nextRecordOffset = ( cditr->second + 1 < pCdRecords.size() ) ? pCdRecords[cditr->second + 1]->pOffset : pCdOffset;
+    uint64_t filesize = cdfh->pCompressedSize;
+    uint64_t fileoff  = nextRecordOffset - filesize;
+
+    ZipReadFilesBatch::Member &m = batch->pMembers[i];
+    m.cdfh   = cdfh;
+    m.buffer = reinterpret_cast<char*>( buffers[i] );
+
+    // stored files go straight to the user buffer, deflated
+    // ones are inflated once all the data have arrived
+    char *dst = m.buffer;
+    if( cdfh->pCompressionMethod == Z_DEFLATED )
+    {
+      m.rawBuffer.reset( new char[filesize] );
+      dst = m.rawBuffer.get();
+    }
+
+    // if we have the whole archive there is nothing to read
+    if( pBuffer )
+    {
+      memcpy( dst, pBuffer.get() + fileoff, filesize );
+      continue;
+    }
+
+    for( uint64_t done = 0; done < filesize; done += kMaxChunkSize )
+    {
+      uint32_t len = std::min<uint64_t>( kMaxChunkSize, filesize - done );
+      chunks.push_back( ChunkInfo( fileoff + done, len, dst + done ) );
+    }
+  }
+
+  // everything is local
+  if( chunks.empty() )
+  {
+    batch->Finalize();
+    return XRootDStatus();
+  }
+
+  // issue as few vector reads as the server limits allow
+  size_t nbReads = ( chunks.size() + kMaxNbChunks - 1 ) / kMaxNbChunks;
+  batch->pPending = nbReads;
+
+  Log *log = DefaultEnv::GetLog();
+  log->Debug( FileMsg, "ZipArchiveReader reading %u files in %u chunks using %u vector reads.",
+              (unsigned)filenames.size(), (unsigned)chunks.size(), (unsigned)nbReads );
+
+  ZipReadFilesBatch *b = batch.release();
+  for( size_t n = 0; n < nbReads; ++n )
+  {
+    ChunkList::iterator first = chunks.begin() + n * kMaxNbChunks;
+    ChunkList::iterator last  = ( n + 1 == nbReads ) ? chunks.end() : first + kMaxNbChunks;
+    ChunkList part( first, last );
+
+    ZipReadFilesHandler *handler = new ZipReadFilesHandler( b, this );
+    XRootDStatus st = pArchive.VectorRead( part, 0, handler, timeout );
+    if( st.IsOK() ) continue;
+    delete handler;
+
+    // nothing has been issued, it's all on us
+    if( n == 0 )
+    {
+      delete b;
+      return st;
+    }
+
+    // account for the reads that were not issued, the
+    // user will be notified by the outstanding ones
+    for( ; n < nbReads; ++n )
+      if( b->Done( st ) )
+      {
+        b->Finalize();
+        delete b;
+      }
+    break;
+  }
+
+  return XRootDStatus();
+}
+
 XRootDStatus ZipArchiveReaderImpl::ZCRC32( const std::string &filename, std::string &checksum )
 {
   if( !pArchive.IsOpen() ) return XRootDStatus( stError, errInvalidOp, errInvalidOp, "Archive not opened." );
@@ -1206,7 +1643,7 @@ DirectoryList* ZipArchiveReaderImpl::List()
   {
     CDFH *cdfh = *itr;
     StatInfo *entry_info = new StatInfo( info->GetId(),
-                                         cdfh->pCdfhSize,
+                                         cdfh->pUncompressedSize,
                                          info->GetFlags() & ( ~StatInfo::IsWritable ), // make sure it is not listed as writable
                                          info->GetModTime() );
     DirectoryList::ListEntry *entry =
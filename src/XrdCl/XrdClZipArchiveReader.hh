@@ -27,6 +27,9 @@
 
 #include "XrdClXRootDResponses.hh"
 
+#include <string>
+#include <vector>
+
 namespace XrdCl
 {
 
@@ -37,11 +40,11 @@ class File;
 //! A wrapper class for the XrdCl::File.
 //!
 //! It is an abstraction for a ZIP file containing multiple sub-files.
-//! The class does not provide any unzip utilities, it just readjusts
-//! the offset so a respective file inside of the archive can be read.
-//! It is meant for ZIP archives containing uncompressed root files,
-//! so a single file can be accessed without downloading the whole
-//! archive.
+//! It readjusts the offset so a respective file inside of the archive
+//! can be read without downloading the whole archive. Deflated files
+//! are inflated on the fly, many whole files can be fetched at once
+//! with vector reads, and the central directories of the opened
+//! archives are cached (see XRD_ZIPCDCACHESIZE).
 //----------------------------------------------------------------------------
 class ZipArchiveReader
 {
@@ -70,6 +73,10 @@ class ZipArchiveReader
     //! of the EOCD record the whole archive is being down-
     //! loaded and kept in local memory.
     //!
+    //! If the Central-directory of the archive (same URL,
+    //! size and modification time) is in the cache, no data
+    //! are being read at all.
+    //!
     //! @param url     : URL of the archive
     //! @param handler : the handler for the async operation
     //! @param timeout : the timeout of the async operation
@@ -86,6 +93,8 @@ class ZipArchiveReader
     //------------------------------------------------------------------------
     //! Async read.
     //!
+    //! Compressed files can only be read sequentially.
+    //!
     //! @param filename : name of the file that will the readout
     //! @param offset   : offset (relative for the given file)
     //! @param size     : size of the buffer
@@ -117,6 +126,29 @@ class ZipArchiveReader
     //------------------------------------------------------------------------
     XRootDStatus Read( uint64_t offset, uint32_t size, void *buffer, uint32_t &bytesRead, uint16_t timeout = 0 );
 
+    //------------------------------------------------------------------------
+    //! Async read of whole files.
+    //!
+    //! The data of all the files are fetched using as few vector reads
+    //! as possible, deflated files are inflated once they arrive.
+    //!
+    //! @param filenames : names of the files to be read
+    //! @param buffers   : for each file a buffer big enough to hold it
+    //!                    (see GetSize)
+    //! @param handler   : the handler for the async operation, the response
+    //!                    is a VectorReadInfo with a chunk for each file (in
+    //!                    the same order as filenames)
+    //! @param timeout   : the timeout of the async operation
+    //!
+    //! @return          : OK on success, error otherwise
+    //------------------------------------------------------------------------
+    XRootDStatus ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, ResponseHandler *handler, uint16_t timeout = 0 );
+
+    //------------------------------------------------------------------------
+    //! Sync read of whole files.
+    //------------------------------------------------------------------------
+    XRootDStatus ReadFiles( const std::vector<std::string> &filenames, const std::vector<void*> &buffers, VectorReadInfo *&vReadInfo, uint16_t timeout = 0 );
+
     //------------------------------------------------------------------------
     //! Sync list
     //------------------------------------------------------------------------
@@ -30,6 +30,7 @@
 
 #include <stdio.h>
 #include <limits.h>
+#include <stdlib.h>
 #include <string>
 #include <unistd.h>
 #include <inttypes.h>
@@ -40,9 +41,11 @@
 #include "XProtocol/YProtocol.hh"
 
 #include "XrdCms/XrdCmsAdmin.hh"
+#include "XrdCms/XrdCmsCluster.hh"
 #include "XrdCms/XrdCmsConfig.hh"
 #include "XrdCms/XrdCmsManager.hh"
 #include "XrdCms/XrdCmsMeter.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
 #include "XrdCms/XrdCmsPrepare.hh"
 #include "XrdCms/XrdCmsState.hh"
 #include "XrdCms/XrdCmsTrace.hh"
@@ -207,7 +210,7 @@ void XrdCmsAdmin::Login(int socknum)
 
 // Attach the socket FD to a stream
 //
-   Stream.Attach(socknum);
+   Stream.AttachIO(socknum, socknum);
 
 // The first request better be "login"
 //
@@ -233,8 +236,10 @@ void XrdCmsAdmin::Login(int socknum)
                      }
              else if (!strcmp("rmdid",    tp)) do_RmDid();   // via lfn
              else if (!strcmp("newfn",    tp)) do_RmDud();   // via lfn
+             else if (!strcmp("lat",      tp)) do_Lat();
              else if (!strcmp("perf",     tp)) do_Perf();
              else if (!strcmp("PERF",     tp)) do_Perf(true);
+             else if (!strcmp("stats",    tp)) do_Stats();
              else if (!strcmp("suspend",  tp)) 
                      {if ((tp = Stream.GetToken()) && *tp == 't') sPerm = 0;
                          else sPerm = 1;
@@ -740,6 +745,26 @@ int XrdCmsAdmin::do_Login()
    return 1;
 }
  
+/******************************************************************************/
+/*                                d o _ L a t                                 */
+/******************************************************************************/
+  
+void XrdCmsAdmin::do_Lat()
+{
+   const char *epname = "do_Lat";
+   char  buff[256];
+   unsigned int vers, svct, infl;
+
+// Format: lat <version> <svctime> <inflight> [...]
+// Later versions may append fields which we simply ignore.
+//
+   if (!Stream.GetRest(buff, sizeof(buff)))
+      Say.Emsg(epname,"latency data is too long.");
+      else if (sscanf(buff, "%u %u %u", &vers, &svct, &infl) != 3 || vers < 1)
+              Say.Emsg(epname,"latency data is invalid.");
+              else Meter.PutLatency(svct, infl);
+}
+
 /******************************************************************************/
 /*                               d o _ P e r f                                */
 /******************************************************************************/
@@ -824,6 +849,10 @@ void XrdCmsAdmin::do_RmDud(int isPfn)
           } else tp = apath;
       }
 
+// Record the new file in our name space summary
+//
+   NSSum.Add(tp);
+
 // Check if we are relaying remove events and, if so, vector through that.
 //
    if (areFunc) AddEvent(tp, kYR_have, Mods);
@@ -831,3 +860,32 @@ void XrdCmsAdmin::do_RmDud(int isPfn)
             XrdCmsManager::Inform(kYR_have, Mods, tp, strlen(tp)+1);
            }
 }
+  
+/******************************************************************************/
+/*                              d o _ S t a t s                               */
+/******************************************************************************/
+
+// The reply is the same report sent via xrd.report followed by a newline.
+//
+void XrdCmsAdmin::do_Stats()
+{
+   const char *epname = "do_Stats";
+   char *buff;
+   int blen, rlen;
+
+// Allocate a buffer large enough for the report
+//
+   blen = (Config.asManager() ? Cluster.Statt(0, 0) : Cluster.Stats(0, 0)) + 2;
+   buff = (char *)malloc(blen);
+
+// Format the report and send it off
+//
+   rlen = (Config.asManager() ? Cluster.Statt(buff, blen-1)
+                              : Cluster.Stats(buff, blen-1));
+   if (!rlen) Say.Emsg(epname, "statistics report is too long.");
+      else {buff[rlen++] = '\n';
+            if (Stream.Put(buff, rlen))
+               Say.Emsg(epname, "Unable to send statistics to", Stype, Sname);
+           }
+   free(buff);
+}
@@ -74,10 +74,12 @@ void  AddEvent(const char *path, XrdCms::CmsReqCode req, int mods);
 void  BegAds();
 bool  CheckVNid(const char *xNid);
 int   Con2Ads(const char *pname);
+void  do_Lat();
 int   do_Login();
 void  do_Perf(bool alert=false);
 void  do_RmDid(int dotrim=0);
 void  do_RmDud(int dotrim=0);
+void  do_Stats();
 
 static XrdOssStatInfo2_t  areFunc;
 static XrdOucTList       *areFirst;
@@ -33,6 +33,7 @@
 
 #include "XrdCms/XrdCmsCache.hh"
 #include "XrdCms/XrdCmsRRQ.hh"
+#include "XrdCms/XrdCmsTelemetry.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdSys/XrdSysTimer.hh"
@@ -116,19 +117,20 @@ void *XrdCmsStartTickTock(void *carg)
   
 int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   CacheStripe &S = Stripe(Sel.Path);
    XrdCmsKeyItem *iP;
    SMask_t xmask;
    int isrw = (Sel.Opts & XrdCmsSelect::Write), isnew = 0;
 
-// Serialize processing
+// Serialize processing for this path
 //
-   myMutex.Lock();
+   S.Mutex.Lock();
 
-// Check for fast path processing
+// Find the entry. We cannot use Sel.Path.TODRef without looking it up as the
+// item may have been recycled into another stripe, which we have not locked.
 //
-   if (  !(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path)))
-      if ((iP = Sel.Path.TODRef = CTable.Find(Sel.Path)))
-         Sel.Path.Ref = iP->Key.Ref;
+   if ((iP = Sel.Path.TODRef = S.CTable.Find(Sel.Path)))
+      Sel.Path.Ref = iP->Key.Ref;
 
 // Add/Modify the entry
 //
@@ -137,7 +139,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
           {iP->Loc.deadline = QDelay + time(0);
            iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
            iP->Loc.hfvec = 0; iP->Loc.pfvec = 0; iP->Loc.qfvec = 0;
-           iP->Loc.TOD_B = BClock;
+           iP->Loc.TOD_B = S.BClock;
            iP->Key.TOD = Tock;
           } else {
            xmask = iP->Loc.pfvec;
@@ -156,10 +158,13 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
           }
       } else if (!(Sel.Opts & XrdCmsSelect::Advisory))
                 {Sel.Path.TOD = Tock;
-                 if ((iP = CTable.Add(Sel.Path)))
+                 myMutex.Lock();
+                 iP = S.CTable.Add(Sel.Path);
+                 myMutex.UnLock();
+                 if (iP)
                     {iP->Loc.pfvec    = (Sel.Opts&XrdCmsSelect::Pending?mask:0);
                      iP->Loc.hfvec    = mask;
-                     iP->Loc.TOD_B    = BClock;
+                     iP->Loc.TOD_B    = S.BClock;
                      iP->Loc.qfvec    = 0;
                      iP->Loc.deadline = QDelay + time(0);
                      iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
@@ -170,7 +175,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // All done
 //
-   myMutex.UnLock();
+   S.Mutex.UnLock();
    return isnew;
 }
   
@@ -190,29 +195,33 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   CacheStripe &S = Stripe(Sel.Path);
    XrdCmsKeyItem *iP;
    int gone4good;
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   S.Mutex.Lock();
 
 // Look up the entry and remove server
 //
-   if ((iP = CTable.Find(Sel.Path)))
+   if ((iP = S.CTable.Find(Sel.Path)))
       {iP->Loc.hfvec &= ~mask;
        iP->Loc.pfvec &= ~mask;
        if ((gone4good = (iP->Loc.hfvec == 0)))
           {if (nilTMO) iP->Loc.lifeline = nilTMO + time(0);
-           if (!(Sel.Opts & XrdCmsSelect::Advisory)
-           &&  XrdCmsKeyItem::Unload(iP) && !CTable.Recycle(iP))
-              Say.Emsg("DelFile", "Delete failed for", iP->Key.Val);
+           if (!(Sel.Opts & XrdCmsSelect::Advisory))
+              {myMutex.Lock();
+               if (XrdCmsKeyItem::Unload(iP) && !S.CTable.Recycle(iP))
+                  Say.Emsg("DelFile", "Delete failed for", iP->Key.Val);
+               myMutex.UnLock();
+              }
           }
       } else gone4good = 0;
 
 // All done
 //
-   myMutex.UnLock();
+   S.Mutex.UnLock();
    return gone4good;
 }
   
@@ -231,19 +240,25 @@ int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   CacheStripe &S = Stripe(Sel.Path);
    XrdCmsKeyItem *iP;
    SMask_t bVec;
    int retc;
 
-// Lock the hash table
+// Lock the hash table. Only if some server bounced since the entry was last
+// looked at do we need the bounce history and hence the global lock.
 //
-   myMutex.Lock();
+   S.Mutex.Lock();
 
 // Look up the entry and return location information
 //
-   if ((iP = CTable.Find(Sel.Path)))
-      {if ((bVec = (iP->Loc.TOD_B < BClock 
-                 ? getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
+   if ((iP = S.CTable.Find(Sel.Path)))
+      {if (iP->Loc.TOD_B < S.BClock)
+          {myMutex.Lock();
+           bVec = getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask;
+           myMutex.UnLock();
+          } else bVec = 0;
+       if (bVec)
           {iP->Loc.hfvec &= ~bVec; 
            iP->Loc.pfvec &= ~bVec;
            iP->Loc.qfvec &= ~mask;
@@ -258,16 +273,17 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
        if (nilTMO && retc == 1 && iP->Loc.hfvec == 0
        &&  iP->Loc.lifeline <= time(0)) retc = 0;
 
-       Sel.Vec.hf      = okVec & iP->Loc.hfvec;
-       Sel.Vec.pf      = okVec & iP->Loc.pfvec;
-       Sel.Vec.bf      = okVec & (bVec | iP->Loc.qfvec); iP->Loc.qfvec = 0;
+       Sel.Vec.hf      = S.okVec & iP->Loc.hfvec;
+       Sel.Vec.pf      = S.okVec & iP->Loc.pfvec;
+       Sel.Vec.bf      = S.okVec & (bVec | iP->Loc.qfvec); iP->Loc.qfvec = 0;
        Sel.Path.Ref    = iP->Key.Ref;
       } else retc = 0;
 
 // All done
 //
-   myMutex.UnLock();
+   S.Mutex.UnLock();
    Sel.Path.TODRef = iP;
+   Telemetry.Cached(retc);
    return retc;
 }
 
@@ -278,23 +294,25 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 {
    EPNAME("UnkFile");
+   CacheStripe &S = Stripe(Sel.Path);
    XrdCmsKeyItem *iP;
 
 // Make sure we have the proper information. If so, lock the hash table
 //
-   myMutex.Lock();
+   S.Mutex.Lock();
 
 // Look up the entry and if valid update the unqueried vector. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
+// and that the entry must still be the one that was then found.
 //
-   if ((iP = Sel.Path.TODRef))
-      {if (iP->Key.Equiv(Sel.Path)) iP->Loc.qfvec = mask;
+   if ((iP = S.CTable.Find(Sel.Path)))
+      {if (iP->Key.Ref == Sel.Path.Ref) iP->Loc.qfvec = mask;
           else iP = 0;
       }
 
 // Return result
 //
-   myMutex.UnLock();
+   S.Mutex.UnLock();
    DEBUG("rc=" <<(iP ? 1 : 0) <<" path=" <<Sel.Path.Val);
    return (iP ? 1 : 0);
 }
@@ -313,12 +331,15 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 // Make sure we have the proper information. If so, lock the hash table
 //
    if (!Sel.InfoP) return DLTime;
-   myMutex.Lock();
+   CacheStripe &S = Stripe(Sel.Path);
+   S.Mutex.Lock();
 
 // Look up the entry and if valid add it to the callback queue. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
+// and that the entry must still be the one that was then found.
 //
-   if (!(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path))) retc = DLTime;
+   if (!(iP = S.CTable.Find(Sel.Path)) || iP->Key.Ref != Sel.Path.Ref)
+                                                              retc = DLTime;
       else if (iP->Loc.hfvec != mask)                         retc = 1;
               else {Now = time(0);                            retc = 0;
                     if (iP->Loc.deadline && iP->Loc.deadline <= Now)
@@ -328,7 +349,7 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   S.Mutex.UnLock();
    DEBUG("rc=" <<retc <<" path=" <<Sel.Path.Val);
    return retc;
 }
@@ -345,11 +366,11 @@ void XrdCmsCache::Bounce(SMask_t smask, int SNum)
 
 // Simply indicate that this server bounced
 //
-   myMutex.Lock();
+   LockAll();
    Bounced[SNum] = ++BClock;
    okVec |= smask;
    if (SNum > vecHi) vecHi = SNum;
-   myMutex.UnLock();
+   UnLockAll();
 }
 
 /******************************************************************************/
@@ -366,11 +387,11 @@ void XrdCmsCache::Drop(SMask_t smask, int SNum, int xHi)
 
 // Remove the node from the list of valid nodes
 //
-   myMutex.Lock();
+   LockAll();
    Bounced[SNum] = 0;
    okVec &= nmask;
    vecHi = xHi;
-   myMutex.UnLock();
+   UnLockAll();
 }
 
 /******************************************************************************/
@@ -431,11 +452,11 @@ void *XrdCmsCache::TickTock()
 // Simply adjust the clock and trim old entries
 //
    do {XrdSysTimer::Snooze(Tick);
-       myMutex.Lock();
+       LockAll();
        Tock = (Tock+1) & XrdCmsKeyItem::TickMask;
        Bhistory[Tock].Start = Bhistory[Tock].End = 0;
        iP = XrdCmsKeyItem::Unload(Tock);
-       myMutex.UnLock();
+       UnLockAll();
        if (iP) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
       } while(1);
 
@@ -516,7 +537,7 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
 // Calculate the new vector
 //
    for (i = 0; i <= vecHi; i++)
-       if (TODb < Bounced[i]) BVec |= 1ULL << i;
+       if (TODb < Bounced[i]) BVec.Set(i);
 
    Bhistory[TODa].Vec   = BVec;
    Bhistory[TODa].Start = TODb;
@@ -527,6 +548,19 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
    return BVec;
 }
 
+/******************************************************************************/
+/*                               L o c k A l l                                */
+/******************************************************************************/
+
+// Lock every stripe and then the global mutex. This is done when the clock
+// ticks or a server comes or goes, both of which are rare events.
+  
+void XrdCmsCache::LockAll()
+{
+   for (int i = 0; i < numStripes; i++) Stripes[i].Mutex.Lock();
+   myMutex.Lock();
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
@@ -543,7 +577,10 @@ void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
         {theList = iP->Key.TODRef;
          if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
          if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
-         myMutex.Lock(); CTable.Recycle(iP); myMutex.UnLock();
+         CacheStripe &S = Stripes[iP->Loc.HashSave >> (32 - StripeBits)];
+         S.Mutex.Lock(); myMutex.Lock();
+         S.CTable.Recycle(iP);
+         myMutex.UnLock(); S.Mutex.UnLock();
          numRecycled++;
         }
 
@@ -568,3 +605,20 @@ void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
            numRecycled, numHave, numFree);
    Say.Emsg("Recycle", msgBuff);
 }
+
+/******************************************************************************/
+/*                             U n L o c k A l l                              */
+/******************************************************************************/
+
+// Refresh the stripe copies of the server clock and valid node vector and
+// release all of the locks obtained by LockAll().
+  
+void XrdCmsCache::UnLockAll()
+{
+   for (int i = 0; i < numStripes; i++)
+       {Stripes[i].BClock = BClock;
+        Stripes[i].okVec  = okVec;
+       }
+   myMutex.UnLock();
+   for (int i = numStripes-1; i >= 0; i--) Stripes[i].Mutex.UnLock();
+}
@@ -85,7 +85,10 @@ static const int min_nxTime = 60;
                             DLTime(5), QDelay(5), Bhits(0), Bmiss(0), vecHi(-1),
                             isDFS(0)
                           {memset(Bounced,  0, sizeof(Bounced));
-                           memset(Bhistory, 0, sizeof(Bhistory));
+                           for (unsigned int i = 0; i < XrdCmsKeyItem::TickRate; i++)
+                               {Bhistory[i].Vec   = 0;
+                                Bhistory[i].Start = Bhistory[i].End = 0;
+                               }
                           }
            ~XrdCmsCache() {}   // Never gets deleted
 
@@ -96,6 +99,31 @@ void          Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *cinfo,
                        short roQ, short rwQ);
 SMask_t       getBVec(unsigned int todA, unsigned int &todB);
 void          Recycle(XrdCmsKeyItem *theList);
+void          LockAll();
+void          UnLockAll();
+
+// The key table is split into lock stripes selected by the high order bits of
+// the key hash, so that lookups of different paths do not serialize. Each
+// stripe keeps a copy of the server currency clock and the valid node vector
+// that is only changed with all stripes locked. The global mutex protects the
+// item free list, the TOD lists and the bounce history and, when needed, is
+// always obtained after the stripe lock.
+//
+static const int StripeBits = 6;
+static const int numStripes = 1 << StripeBits;
+
+struct  CacheStripe
+       {XrdSysMutex  Mutex;
+        XrdCmsNash   CTable;
+        SMask_t      okVec;
+        unsigned int BClock;
+                     CacheStripe() : CTable(610, 987), okVec(0), BClock(0) {}
+       }              Stripes[numStripes];
+
+inline CacheStripe &Stripe(XrdCmsKey &Key)
+                          {if (!Key.Hash) Key.setHash();
+                           return Stripes[Key.Hash >> (32 - StripeBits)];
+                          }
 
 struct  {SMask_t      Vec;
          unsigned int Start;
@@ -103,7 +131,6 @@ struct  {SMask_t      Vec;
         }             Bhistory[XrdCmsKeyItem::TickRate];
 
 XrdSysMutex   myMutex;
-XrdCmsNash    CTable;
 unsigned int  Bounced[STMax];
 SMask_t       okVec;
 unsigned int  Tick;
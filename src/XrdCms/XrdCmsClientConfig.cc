@@ -524,10 +524,12 @@ int XrdCmsClientConfig::xmang(XrdOucStream &Config)
 
 /* Function: xperf
 
-   Purpose:  To parse the directive: perf [xrootd] [int <sec>]
+   Purpose:  To parse the directive: perf [xrootd] [int <sec>] [latency]
                                           [lib <lib> [<parms>] | pgm <pgm>]
 
          int <time>    estimated time (seconds, M, H) between reports by <pgm>
+         latency       also report the average open/read service time and the
+                       number of requests in progress (cms.sched latency).
          lib <lib>     the shared library holding the XrdCmsPerf object that
                        reports perf values. It must be the last option.
          pgm <pgm>     program to start that will write perf values to standard
@@ -550,6 +552,7 @@ int XrdCmsClientConfig::xperf(XrdOucStream &Config)
 
     if (strcmp("xrootd", val)) return Config.noEcho();
     perfInt = 3*60;
+    if (!(val = Config.GetWord())) return 0;
 
     do {     if (!strcmp("int", val))
                 {if (!(val = Config.GetWord()))
@@ -558,6 +561,7 @@ int XrdCmsClientConfig::xperf(XrdOucStream &Config)
                     }
                  if (XrdOuca2x::a2tm(Say,"perf int",val,&perfInt,0)) return 1;
                 }
+        else if (!strcmp("latency", val)) latRep = true;
         else if (!strcmp("lib",  val))
                 {return (XrdOucUtils::parseLib(Say, Config, "perf lib",
                                                prfLib, &prfParms) ? 0 : 1);
@@ -583,12 +587,17 @@ int XrdCmsClientConfig::xperf(XrdOucStream &Config)
 
    Purpose:  To parse the directive: request [repwait <sec1>] [delay <sec2>]
                                              [noresp <cnt>] [prep <ms>]
-                                             [fwd <ms>]
+                                             [fwd <ms>] [hedge <ms2>]
+                                             [loccache <sec3>]
 
              <sec1>  max number of seconds to wait for a cmsd reply
              <sec2>  number of seconds to delay a retry upon failure
              <cnt>   number of no-responses before cms fault declared.
              <ms>    milliseconds between prepare/forward requests
+             <ms2>   milliseconds to wait for a read-only locate reply before
+                     also sending it to a second manager. A value of 0 sends
+                     it to two managers at once; the first reply is used.
+             <sec3>  seconds a locate (not an open) result is reused for a path.
 
    Type: Remote server only, dynamic.
 
@@ -598,14 +607,17 @@ int XrdCmsClientConfig::xperf(XrdOucStream &Config)
 int XrdCmsClientConfig::xreqs(XrdOucStream &Config)
 {
     char *val;
-    static struct reqsopts {const char *opname; int istime; int *oploc;}
+    static struct reqsopts {const char *opname; int istime; int *oploc;
+                           int minv;}
            rqopts[] =
        {
-        {"delay",    1, &RepDelay},
-        {"fwd",      0, &FwdWait},
-        {"noresp",   0, &RepNone},
-        {"prep",     0, &PrepWait},
-        {"repwait",  1, &RepWait}
+        {"delay",    1, &RepDelay,  1},
+        {"fwd",      0, &FwdWait,   1},
+        {"hedge",    0, &HedgeWait, 0},
+        {"loccache", 1, &LocTTL,    0},
+        {"noresp",   0, &RepNone,   1},
+        {"prep",     0, &PrepWait,  1},
+        {"repwait",  1, &RepWait,   1}
        };
     int i, ppp, numopts = sizeof(rqopts)/sizeof(struct reqsopts);
 
@@ -619,8 +631,10 @@ int XrdCmsClientConfig::xreqs(XrdOucStream &Config)
                   {Say.Emsg("Config","request argument value not specified");
                    return 1;}
                    if (rqopts[i].istime ?
-                       XrdOuca2x::a2tm(Say,"request value",val,&ppp,1) :
-                       XrdOuca2x::a2i( Say,"request value",val,&ppp,1))
+                       XrdOuca2x::a2tm(Say,"request value",val,&ppp,
+                                       rqopts[i].minv) :
+                       XrdOuca2x::a2i( Say,"request value",val,&ppp,
+                                       rqopts[i].minv))
                       return 1;
                       else *rqopts[i].oploc = ppp;
                 break;
@@ -56,6 +56,8 @@ int           RepDelay;     // Seconds to delay before retrying manager
 int           RepNone;      // Max number of consecutive non-responses
 int           PrepWait;     // Millisecond wait between prepare requests
 int           FwdWait;      // Millisecond wait between foward  requests
+int           HedgeWait;    // Millisecond wait before hedging (<0 -> never)
+int           LocTTL;       // Seconds a locate result is cached (0 -> never)
 int           haveMeta;     // Have a meta manager (only if we are a manager)
 
 char         *CMSPath;      // Path to the local cmsd for target nodes
@@ -68,6 +70,7 @@ XrdOucTList  *ManList;      // List of managers for remote redirection
 XrdOucTList  *PanList;      // List of managers for proxy  redirection
 XrdCmsPerfMon *perfMon;     // Performance monitor plugin
 int           perfInt;      // Performance poll interval
+bool          latRep;       // Report open/read latency to the cmsd
 unsigned char SMode;        // Manager selection mode
 unsigned char SModeP;       // Manager selection mode (proxy)
 
@@ -76,10 +79,11 @@ enum {FailOver = 'f', RoundRob = 'r'};
       XrdCmsClientConfig(XrdCmsPerfMon *cmsmon=0)
                            : ConWait(10), RepWait(3),  RepWaitMS(3000),
                              RepDelay(5), RepNone(8),  PrepWait(33),
-                             FwdWait(0),  haveMeta(0), CMSPath(0),
+                             FwdWait(0),  HedgeWait(-1), LocTTL(0),
+                             haveMeta(0), CMSPath(0),
                              myHost(0),   myName(0),   myVNID(0),
                              cidTag(0),   ManList(0),  PanList(0),
-                             perfMon(0),  perfInt(3*60),
+                             perfMon(0),  perfInt(3*60), latRep(false),
                              SMode(FailOver), SModeP(FailOver),
                              VNID_Lib(0),  VNID_Parms(0),
                              prfLib(0), prfParms(0), cmsMon(cmsmon),
@@ -76,6 +76,7 @@ XrdCmsClientMsg *XrdCmsClientMsg::Alloc(XrdOucErrInfo *erp)
    mp->Hold.Lock();
    mp->id      = (mp->id & MidMask) | lclid;
    mp->Resp    = erp;
+   mp->From    = 0;
    mp->next    = 0;
    mp->inwaitq = 1;
 
@@ -151,8 +152,9 @@ int XrdCmsClientMsg::Reply(const char *Man, CmsRRHdr &hdr, XrdOucBuffer *buff)
        return 0;
       }
 
-// Decode the response
+// Decode the response and note who sent it
 //
+   mp->From   = Man;
    mp->Result = XrdCmsParser::Decode(Man,hdr,buff,(XrdOucErrInfo *)(mp->Resp));
 
 // Signal a reply and return
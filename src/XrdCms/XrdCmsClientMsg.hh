@@ -43,6 +43,8 @@ public:
 
 static XrdCmsClientMsg *Alloc(XrdOucErrInfo *erp);
 
+inline const char *getFrom() {return From;}
+
 inline int       getResult() {return Result;}
 
 inline int       ID() {return id;}
@@ -61,7 +63,10 @@ static int       Reply(const char *Man,XrdCms::CmsRRHdr &hdr,XrdOucBuffer *buff)
 
        int       Wait4Reply(int wtime) {return Hold.Wait(wtime);}
 
-      XrdCmsClientMsg() : Hold(0) {next = 0; inwaitq = 0; Resp = 0; Result = 0;}
+       int       Wait4ReplyMS(int wtime) {return Hold.WaitMS(wtime);}
+
+      XrdCmsClientMsg() : Hold(0) {next = 0; inwaitq = 0; Resp = 0; From = 0;
+                                   Result = 0;}
      ~XrdCmsClientMsg() {}
 
 private:
@@ -83,6 +88,7 @@ XrdSysCondVar             Hold;
 int                       inwaitq;
 int                       id;
 XrdOucErrInfo            *Resp;
+const char               *From;    // Manager prefix that replied
 int                       Result;
 };
 #endif
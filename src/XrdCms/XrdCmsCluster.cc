@@ -46,16 +46,20 @@
 #include "XrdCms/XrdCmsBlackList.hh"
 #include "XrdCms/XrdCmsCache.hh"
 #include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsKey.hh"
 #include "XrdCms/XrdCmsCluster.hh"
 #include "XrdCms/XrdCmsClustID.hh"
 #include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
 #include "XrdCms/XrdCmsRole.hh"
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsState.hh"
 #include "XrdCms/XrdCmsSelect.hh"
+#include "XrdCms/XrdCmsTelemetry.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdCms/XrdCmsTypes.hh"
 
+#include "XrdOuc/XrdOucCRC.hh"
 #include "XrdOuc/XrdOucPup.hh"
 
 #include "XrdSys/XrdSysPlatform.hh"
@@ -100,6 +104,33 @@ XrdCmsNode *nodeP;
 int         nodeEnt;
 int         nodeInst;
 };
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// CRC values of similar strings are correlated so they are scrambled before
+// being placed on the hash ring (this is the murmur3 finalizer).
+//
+unsigned int RingMix(unsigned int h)
+{
+   h ^= h >> 16; h *= 0x85ebca6b;
+   h ^= h >> 13; h *= 0xc2b2ae35;
+   h ^= h >> 16;
+   return h;
+}
+
+// Ring points are ordered by their position which is their first member
+//
+int RingCmp(const void *a, const void *b)
+{
+   unsigned int aPos = *(const unsigned int *)a;
+   unsigned int bPos = *(const unsigned int *)b;
+   return (aPos < bPos ? -1 : (aPos > bPos ? 1 : 0));
+}
+}
   
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
@@ -108,6 +139,9 @@ int         nodeInst;
 XrdCmsCluster::XrdCmsCluster()
 {
      memset((void *)NodeTab, 0, sizeof(NodeTab));
+     memset((void *)BQBuff,  0, sizeof(BQBuff));
+     memset((void *)BQDlen,  0, sizeof(BQDlen));
+     memset((void *)BQInst,  0, sizeof(BQInst));
      memset((void *)AltMans, (int)' ', sizeof(AltMans));
      AltMend = AltMans;
      AltMent = -1;
@@ -118,8 +152,14 @@ XrdCmsCluster::XrdCmsCluster()
      SelRcnt = 0;
      SelRtot = 0;
      SelTcnt = 0;
+     SelSeed = static_cast<unsigned int>(time(0));
      peerHost  = 0;
      peerMask  = ~peerHost;
+     nsVec     = 0;
+     Ring      = 0;
+     RingNum   = 0;
+     RingMax   = 0;
+     RingOK    = false;
 }
   
 /******************************************************************************/
@@ -214,6 +254,7 @@ XrdCmsNode *XrdCmsCluster::Add(XrdLink *lp, int port, int Status, int sport,
                 act = "Shoved ";
                }
        NodeTab[Slot] = nP = new XrdCmsNode(lp, theIF, theNID, port, 0, Slot);
+       RingOK = false;
        if (!cidP) cidP = XrdCmsClustID::AddID(theNID);
        if ((cidP->AddNode(nP, SpecAlt))) nP->cidP = cidP;
           else {delete nP; NodeTab[Slot] = 0; return 0;} // OK to do delete!
@@ -314,7 +355,7 @@ XrdCmsNode *XrdCmsCluster::AddAlt(XrdCmsClustID *cidP, XrdLink *lp,
    if ((pP = NodeTab[slot]) && !(pP->isBound))
       {setAltMan(nP->NodeID, nP->Link, sport);
        Say.Emsg("AddAlt", nP->Ident, "replacing dropped", pP->Ident);
-       NodeTab[slot] = nP;
+       NodeTab[slot] = nP; RingOK = false;
        pP->DropJob = new XrdCmsDrop(pP); // Schedule deletion
       }
 
@@ -389,8 +430,8 @@ SMask_t XrdCmsCluster::Broadcast(SMask_t smask, const struct iovec *iod,
 // the node lock for this but we do need to up the reference count to keep the
 // node pointer valid for the duration of the send() (may or may not block).
 //
-   for (i = 0; i <= STHi; i++)
-       {if ((nP = NodeTab[i]) && nP->isNode(bmask))
+   for (i = bmask.First(); i >= 0 && i <= STHi; i = bmask.First(i+1))
+       {if ((nP = NodeTab[i]))
            {if (nP->isOffline) unQueried |= nP->Mask();
                else {nP->g2Ref(STMutex);
                      if (nP->Send(iod, iovcnt, iotot) < 0)
@@ -541,8 +582,8 @@ XrdCmsSelected *XrdCmsCluster::List(SMask_t mask, CmsLSOpts opts, bool &oksel)
 //
    oksel = false;
    STMutex.Lock();
-   for (i = 0; i <= STHi; i++)
-        if ((nP=NodeTab[i]) && (nP->NodeMask & mask))
+   for (i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+        if ((nP=NodeTab[i]))
            {oksel = true;
             if (retDest)
                {     if (nP->netIF.HasDest(ifType)) ifGet = ifType;
@@ -600,7 +641,7 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
 //
    if (*Sel.Path.Val != '*') Path = Sel.Path.Val;
       else {if (*(Sel.Path.Val+1) == '\0')
-               {Sel.Vec.hf = ~0LL; Sel.Vec.pf = Sel.Vec.wf = 0;
+               {Sel.Vec.hf = FULLMASK; Sel.Vec.pf = Sel.Vec.wf = 0;
                 return 0;
                }
             Path = Sel.Path.Val+1;
@@ -646,12 +687,16 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
 // First check if we have seen this file before. If so, get nodes that have it.
 // A Refresh request kills this because it's as if we hadn't seen it before.
 // If the file was found but either a query is in progress or we have a server
-// bounce; the client must wait.
+// bounce; the client must wait. On a miss only the nodes whose name space
+// filter admits the file are asked, unless none does (filters may be stale).
 //
-   if (Sel.Opts & XrdCmsSelect::Refresh 
-   || !(retc = Cache.GetFile(Sel, pinfo.rovec)))
+   if (Sel.Opts & XrdCmsSelect::Refresh)
       {Cache.AddFile(Sel, 0);
        qfVec = pinfo.rovec; Sel.Vec.hf = 0;
+      }
+   else if (!(retc = Cache.GetFile(Sel, pinfo.rovec)))
+      {Cache.AddFile(Sel, 0);
+       qfVec = nsPrune(Sel, pinfo.rovec); Sel.Vec.hf = 0;
       } else qfVec = Sel.Vec.bf;
 
 // Compute the delay, if any
@@ -666,13 +711,42 @@ int XrdCmsCluster::Locate(XrdCmsSelect &Sel)
        if (Sel.Opts & XrdCmsSelect::Refresh)
           QReq.Hdr.modifier |= CmsStateRequest::kYR_refresh;
        TRACE(Files, "seeking " <<Sel.Path.Val);
-       qfVec = Cluster.Broadcast(qfVec, QReq.Hdr, 
-                                 (void *)Sel.Path.Val, Sel.Path.Len+1);
+       qfVec = Cluster.Query(qfVec, QReq.Hdr, Sel.Path.Val, Sel.Path.Len+1);
        if (qfVec) Cache.UnkFile(Sel, qfVec);
       }
    return retc;
 }
   
+/******************************************************************************/
+/*                              M o n B a t c h                               */
+/******************************************************************************/
+  
+void *XrdCmsCluster::MonBatch()
+{
+   char *sBuff[STMax];
+   int   sDlen[STMax], sInst[STMax], sSlot[STMax];
+   int   i, n;
+
+// Every batch interval send off whatever queries have accumulated. Buffers
+// are detached under the lock and sent without it.
+//
+   while(1)
+        {XrdSysTimer::Wait(Config.QryBatch);
+         n = 0;
+         BQMutex.Lock();
+         for (i = BQMask.First(); i >= 0; i = BQMask.First(i+1))
+             if (BQBuff[i] && BQDlen[i])
+                {sBuff[n] = BQBuff[i]; sDlen[n] = BQDlen[i];
+                 sInst[n] = BQInst[i]; sSlot[n] = i; n++;
+                 BQBuff[i] = 0; BQDlen[i] = 0;
+                }
+         BQMask = 0;
+         BQMutex.UnLock();
+         for (i = 0; i < n; i++) SendBatch(sSlot[i], sInst[i], sBuff[i], sDlen[i]);
+        }
+   return (void *)0;
+}
+
 /******************************************************************************/
 /*                               M o n P e r f                                */
 /******************************************************************************/
@@ -732,6 +806,74 @@ void *XrdCmsCluster::MonRefs()
    return (void *)0;
 }
 
+/******************************************************************************/
+/*                                 Q u e r y                                  */
+/******************************************************************************/
+
+SMask_t XrdCmsCluster::Query(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
+                             char *Path,    int Plen)
+{
+   CmsBatchEntry qEnt;
+   XrdCmsNode *nP;
+   SMask_t bmask, qmask, unQueried(0);
+   char *fBuff[STMax];
+   int   fDlen[STMax], fInst[STMax], fSlot[STMax], qInst[STMax];
+   int   i, n = 0, eLen = sizeof(qEnt) + Plen;
+
+// If we are not batching or the path is too long, just send it off
+//
+   if (!Config.QryBatch || eLen > BQSize)
+      return Broadcast(smask, Hdr, (void *)Path, Plen);
+
+// Split the nodes into those that take batches and those that don't. Offline
+// nodes will not be queried either way and peers are never queried.
+//
+   STMutex.Lock();
+   bmask = smask & peerMask;
+   for (i = bmask.First(); i >= 0 && i <= STHi; i = bmask.First(i+1))
+       if ((nP = NodeTab[i]) && nP->canBatch)
+          {if (nP->isOffline) unQueried |= nP->Mask();
+              else {qmask.Set(i); qInst[i] = nP->Inst();}
+          }
+   STMutex.UnLock();
+   if ((bmask &= ~qmask & ~unQueried))
+      unQueried |= Broadcast(bmask, Hdr, (void *)Path, Plen);
+   if (!qmask) return unQueried;
+
+// Construct the batch entry
+//
+   qEnt.Hash = Hdr.streamid;
+   qEnt.Mods = Hdr.modifier;
+   qEnt.Rsvd = 0;
+   qEnt.Plen = htons(static_cast<unsigned short>(Plen));
+
+// Add the entry to each node's batch. Batches that would overflow are sent
+// right away and a node that was replaced in its slot gets a fresh batch.
+//
+   BQMutex.Lock();
+   for (i = qmask.First(); i >= 0; i = qmask.First(i+1))
+       {if (BQBuff[i] && BQInst[i] != qInst[i]) BQDlen[i] = 0;
+        if (BQBuff[i] && BQDlen[i] + eLen > BQSize)
+           {fBuff[n] = BQBuff[i]; fDlen[n] = BQDlen[i];
+            fInst[n] = BQInst[i]; fSlot[n] = i; n++;
+            BQBuff[i] = 0; BQDlen[i] = 0;
+           }
+        if (!BQBuff[i] && !(BQBuff[i] = (char *)malloc(BQSize)))
+           {unQueried.Set(i); continue;}
+        BQInst[i] = qInst[i];
+        memcpy(BQBuff[i]+BQDlen[i], &qEnt, sizeof(qEnt));
+        memcpy(BQBuff[i]+BQDlen[i]+sizeof(qEnt), Path, Plen);
+        BQDlen[i] += eLen;
+        BQMask.Set(i);
+       }
+   BQMutex.UnLock();
+
+// Send off any full batches
+//
+   for (i = 0; i < n; i++) SendBatch(fSlot[i], fInst[i], fBuff[i], fDlen[i]);
+   return unQueried;
+}
+
 /******************************************************************************/
 /*                                R e m o v e                                 */
 /******************************************************************************/
@@ -845,7 +987,7 @@ void XrdCmsCluster::Remove(const char *reason, XrdCmsNode *theNode, int immed)
    if (theNode->isMan && theNode->cidP && !(theNode->cidP->IsSingle())
    && (altNode = theNode->cidP->RemNode(theNode)))
       {if (altNode->isBound) NodeCnt++;
-       NodeTab[NodeID] = altNode;
+       NodeTab[NodeID] = altNode; RingOK = false;
        if (Config.asManager())
           CmsState.Update(XrdCmsState::Counts,
                           altNode->isBad & XrdCmsNode::isSuspend ? 0 :  1,
@@ -887,7 +1029,7 @@ void XrdCmsCluster::Remove(const char *reason, XrdCmsNode *theNode, int immed)
 void XrdCmsCluster::ResetRef(SMask_t nMask, bool isLocked)
 {
    XrdCmsNode *nP;
-   bool doAll (nMask == 0);
+   bool doAll (!nMask);
 
 // Obtain a lock on the table if not already locked
 //
@@ -972,7 +1114,8 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
 // have servers that we can query regarding the file. Note that for files being
 // opened in write mode, only one writable copy may exist unless this is a
 // meta-operation (e.g., remove) in which case the file itself remain unmodified
-// or a replica request, in which case we select a new target server.
+// or a replica request, in which case we select a new target server. When the
+// file is not known, name space filters narrow the set of nodes to be asked.
 //
    if (!(Sel.Opts & XrdCmsSelect::Refresh)
    &&   (retc = Cache.GetFile(Sel, pinfo.rovec)))
@@ -1006,7 +1149,8 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
        if (Sel.Vec.hf & Sel.nmask) Cache.UnkFile(Sel, Sel.nmask);
       } else {
        Cache.AddFile(Sel, 0); 
-       Sel.Vec.bf = pinfo.rovec; 
+       if (Sel.Opts & XrdCmsSelect::Refresh) Sel.Vec.bf = pinfo.rovec;
+          else Sel.Vec.bf = nsPrune(Sel, pinfo.rovec);
        Sel.Vec.hf = Sel.Vec.pf = pmask = smask = 0;
        retc = 0;
       }
@@ -1024,8 +1168,8 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
           QReq.Hdr.modifier |= CmsStateRequest::kYR_refresh;
        if (dowt) retc= (fRD ? Cache.WT4File(Sel,Sel.Vec.hf) : Config.LUPDelay);
        TRACE(Files, "seeking " <<Sel.Path.Val);
-       amask = Cluster.Broadcast(Sel.Vec.bf, QReq.Hdr,
-                                 (void *)Sel.Path.Val,Sel.Path.Len+1);
+       amask = Cluster.Query(Sel.Vec.bf, QReq.Hdr,
+                             Sel.Path.Val, Sel.Path.Len+1);
        if (amask) Cache.UnkFile(Sel, amask);
        if (dowt) return retc;
       } else if (dowt && retc < 0 && !noSel)
@@ -1035,7 +1179,7 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
 //
    if ((Sel.Opts & XrdCmsSelect::Freshen) && (amask = pmask & ~Sel.Vec.bf))
       {CmsStateRequest Qupt={{0,kYR_state,kYR_raw|CmsStateRequest::kYR_noresp,0}};
-       Cluster.Broadcast(amask, Qupt.Hdr,(void *)Sel.Path.Val,Sel.Path.Len+1);
+       Cluster.Query(amask, Qupt.Hdr, Sel.Path.Val, Sel.Path.Len+1);
       }
 
 // If we need to defer selection, simply return as this is a mindless prepare
@@ -1069,11 +1213,9 @@ int XrdCmsCluster::Select(XrdCmsSelect &Sel)
 int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
                           int isrw, int isMulti, int ifWant)
 {
-   static const SMask_t smLow(255);
    XrdCmsSelector selR;
    XrdCmsNode *nP = 0;
-   SMask_t tmask;
-   int Snum = 0;
+   int Snum;
    XrdNetIF::ifType nType = static_cast<XrdNetIF::ifType>(ifWant);
 
 // If there is nothing to select from, return failure
@@ -1095,7 +1237,8 @@ int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
 //
    if (isMulti || baseFS.isDFS())
       {STMutex.Lock();
-       nP = (Config.sched_RR ? SelbyRef(pmask,selR) : SelbyLoad(pmask,selR));
+       nP = (Config.sched_RR  ? SelbyRef(pmask,selR)
+          :  Config.sched_Lat ? SelbyLat(pmask,selR) : SelbyLoad(pmask,selR));
        if (nP) hlen = nP->netIF.GetName(hbuff, port, nType) + 1;
           else hlen = 0;
        STMutex.UnLock();
@@ -1105,9 +1248,7 @@ int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
 // In shared-nothing systems the incomming mask will only have a single node.
 // Compute the a single node number that is contained in the mask.
 //
-   do {if (!(tmask = pmask & smLow)) Snum += 8;
-         else {while((tmask = tmask>>1)) Snum++; break;}
-      } while((pmask = pmask >> 8));
+   Snum = pmask.First();
 
 // See if the node passes muster
 //
@@ -1118,8 +1259,10 @@ int XrdCmsCluster::Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
        else if (!(selR.needNet & nP->hasNet))                      nP = 0;
        if (nP)
           {if (isrw)
-              if (nP->isNoStage || nP->DiskFree < nP->DiskMinF)    nP = 0;
-                 else {SelWcnt++; nP->RefTotW++; nP->RefW++;}
+              if (nP->isNoStage || nP->DiskLeft() < nP->DiskMinF)  nP = 0;
+                 else {SelWcnt++; nP->RefTotW++; nP->RefW++;
+                       nP->DiskReserve(Config.DiskResv);
+                      }
               else    {SelRcnt++; nP->RefTotR++; nP->RefR++;}
           }
       }
@@ -1166,6 +1309,25 @@ int XrdCmsCluster::SelFail(XrdCmsSelect &Sel, int rc)
     return -1;
 }
   
+/******************************************************************************/
+/*                           s e t N S F i l t e r                            */
+/******************************************************************************/
+
+void XrdCmsCluster::setNSFilter(XrdCmsNode *nP, XrdCmsNSFilter *nsF,
+                                unsigned int nsGen)
+{
+   XrdCmsNSFilter *oldF;
+
+// Swap the filters. Selections only look at filters with the STMutex held so
+// the old one can be safely deleted afterwards.
+//
+   STMutex.Lock();
+   oldF = nP->nsFilt; nP->nsFilt = nsF; nP->nsGen = nsGen;
+   if (nsF) nsVec |= nP->NodeMask;
+   STMutex.UnLock();
+   if (oldF) delete oldF;
+}
+
 /******************************************************************************/
 /*                                 S p a c e                                  */
 /******************************************************************************/
@@ -1184,21 +1346,21 @@ void XrdCmsCluster::Space(SpaceData &sData, SMask_t smask)
 
 // Run through the table getting space information
 //
-   for (i = 0; i <= STHi; i++)
-       if ((nP = NodeTab[i]) && nP->isNode(bmask) && !(nP->isOffline))
+   for (i = bmask.First(); i >= 0 && i <= STHi; i = bmask.First(i+1))
+       if ((nP = NodeTab[i]) && !(nP->isOffline))
           {if (doAll || !sData.Total) 
               {sData.Total += nP->DiskTotal;
-               sData.TotFr += nP->DiskFree;
+               sData.TotFr += nP->DiskLeft();
               }
            if (nP->isRW & XrdCmsNode::allowsSS)
               {sData.sNum++;
-               if (sData.sFree < nP->DiskFree)
-                  {sData.sFree = nP->DiskFree; sData.sUtil = nP->DiskUtil;}
+               if (sData.sFree < nP->DiskLeft())
+                  {sData.sFree = nP->DiskLeft(); sData.sUtil = nP->DiskUtil;}
               }
            if (nP->isRW & XrdCmsNode::allowsRW)
               {sData.wNum++;
-               if (sData.wFree < nP->DiskFree)
-                  {sData.wFree = nP->DiskFree; sData.wUtil = nP->DiskUtil;
+               if (sData.wFree < nP->DiskLeft())
+                  {sData.wFree = nP->DiskLeft(); sData.wUtil = nP->DiskUtil;
                    sData.wMinF = nP->DiskMinF;
                   }
               }
@@ -1250,6 +1412,9 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
    static int AddFrq = (Config.RepStats & XrdCmsConfig::RepStat_frq);
    static int AddShr = (Config.RepStats & XrdCmsConfig::RepStat_shr)
                        && Config.asMetaMan();
+   static int AddTel = Config.RepStats & (XrdCmsConfig::RepStat_cache
+                                        | XrdCmsConfig::RepStat_lat
+                                        | XrdCmsConfig::RepStat_why);
 
    XrdCmsRRQ::Info Frq;
    XrdCmsSelected *sp;
@@ -1275,6 +1440,7 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
           (sizeof(statfmt2) + 10*2 + 256 + 16) * STMax + sizeof(statfmt4);
        if (AddShr) n += sizeof(statfmt3) + 12;
        if (AddFrq) n += sizeof(statfmt4) + (10*8);
+       if (AddTel) n += Telemetry.Report(0, 0, AddTel);
        return n;
       }
 
@@ -1331,6 +1497,11 @@ int XrdCmsCluster::Statt(char *bfr, int bln)
        bfr += mlen; bln -= mlen; tlen += mlen;
       }
 
+   if (AddTel && bln > 0)
+      {if (!(mlen = Telemetry.Report(bfr, bln, AddTel))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+      }
+
 // See if we overflowed. otherwise finish up
 //
    if (sp || bln < (int)sizeof(statfmt0)) return 0;
@@ -1413,7 +1584,7 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 
 // Cleanup status
 //
-   NodeTab[sent] = 0;
+   NodeTab[sent] = 0; RingOK = false;
    nP->isOffline = 1; // STMutex is locked
    nP->DropTime  = 0;
    nP->DropJob   = 0;
@@ -1463,30 +1634,9 @@ int XrdCmsCluster::Drop(int sent, int sinst, XrdCmsDrop *djp)
 
 int XrdCmsCluster::Multiple(SMask_t mVec)
 {
-   static const unsigned long long Left32  = 0xffffffff00000000LL;
-   static const unsigned long long Right32 = 0x00000000ffffffffLL;
-   static const unsigned long long Left16  = 0x00000000ffff0000LL;
-   static const unsigned long long Right16 = 0x000000000000ffffLL;
-   static const unsigned long long Left08  = 0x000000000000ff00LL;
-   static const unsigned long long Right08 = 0x00000000000000ffLL;
-   static const unsigned long long Left04  = 0x00000000000000f0LL;
-   static const unsigned long long Right04 = 0x000000000000000fLL;
-//                                0 1 2 3 4 5 6 7 8 9 A B C D E F
-   static const int isMult[16] = {0,0,0,1,0,1,1,1,0,1,1,1,1,1,1,1};
-
-   if (mVec & Left32) {if (mVec & Right32) return 1;
-                          else mVec = mVec >> 32LL;
-                      }
-   if (mVec & Left16) {if (mVec & Right16) return 1;
-                          else mVec = mVec >> 16LL;
-                      }
-   if (mVec & Left08) {if (mVec & Right08) return 1;
-                          else mVec = mVec >>  8LL;
-                      }
-   if (mVec & Left04) {if (mVec & Right04) return 1;
-                          else mVec = mVec >>  4LL;
-                      }
-   return isMult[mVec];
+   int n = mVec.First();
+
+   return n >= 0 && mVec.First(n+1) >= 0;
 }
   
 /******************************************************************************/
@@ -1499,17 +1649,60 @@ bool XrdCmsCluster::maxBits(SMask_t mVec, int mbits)
 
 // Count bits. This is the fastest way assuming few bits are set
 //
-   while(mVec)
-        {mVec &= (mVec - 1);
-         count++;
-         if (count >= mbits) return true;
-        }
+   for (int n = mVec.First(); n >= 0; n = mVec.First(n+1))
+       if (++count >= mbits) return true;
 
 // Indicate we have not reached the maximum bits set
 //
    return false;
 }
 
+/******************************************************************************/
+/*                               n s P r u n e                                */
+/******************************************************************************/
+
+// Returns the nodes in mask whose name space filter says that they may have
+// the file. Nodes without a filter may have any file. A filter only reflects
+// the name space as of its last walk plus announced files, so it may miss a
+// file that does exist. Hence, if no node is left, all of them are returned.
+//
+SMask_t XrdCmsCluster::nsPrune(const XrdCmsSelect &Sel, SMask_t mask)
+{
+   EPNAME("nsPrune")
+   XrdCmsNSFilter *nsF;
+   SMask_t fmask, nmask;
+   unsigned int h1, h2;
+   int i;
+
+// Filters only apply to paths in the form that the data servers recorded
+//
+   if (!(fmask = mask & nsVec) || !XrdCmsNSFilter::isCanon(Sel.Path.Val))
+      return mask;
+   XrdCmsNSFilter::Hash(Sel.Path.Val, Sel.Path.Len, h1, h2);
+
+// Find all of the nodes that certainly do not have the file. The STMutex keeps
+// the filters from being replaced. Paths are added to a filter in use under the
+// node's nsMutex, which cannot be taken here as it is held while the STMutex is
+// obtained to replace a filter. As bits are only ever set, and are set and
+// tested atomically, a concurrent add can at most hide a path created at that
+// very moment; the node reported it with a have and so is in the cache anyway.
+//
+   STMutex.Lock();
+   for (i = fmask.First(); i >= 0; i = fmask.First(i+1))
+       {if (NodeTab[i] && (nsF = NodeTab[i]->nsFilt) && !nsF->Maybe(h1, h2))
+           nmask |= NodeTab[i]->NodeMask;
+       }
+   STMutex.UnLock();
+
+// Return the nodes that are left or fall back to asking everyone
+//
+   if (!(fmask = mask & ~nmask))
+      {TRACE(Files, "no filter admits " <<Sel.Path.Val);
+       return mask;
+      }
+   return fmask;
+}
+
 /******************************************************************************/
 /*                                R e c o r d                                 */
 /******************************************************************************/
@@ -1522,6 +1715,7 @@ void XrdCmsCluster::Record(char *path, const char *reason, bool force)
    int skipmsg;
 
    DEBUG(reason <<path);
+   Telemetry.Delayed(reason);
    mcMutex.Lock();
    msgcnt++; skipmsg = msgcnt & (force ? 0x0f : 0xff);
    mcMutex.UnLock();
@@ -1529,6 +1723,34 @@ void XrdCmsCluster::Record(char *path, const char *reason, bool force)
    if (!skipmsg) Say.Emsg(epname, "client defered;", reason, path);
 }
  
+/******************************************************************************/
+/*                             S e n d B a t c h                              */
+/******************************************************************************/
+
+void XrdCmsCluster::SendBatch(int Slot, int Inst, char *Buff, int Blen)
+{
+   EPNAME("SendBatch")
+   CmsStateRequest QReq = {{0, kYR_state,
+                            kYR_raw | CmsStateRequest::kYR_batch, 0}};
+   struct iovec ioV[2] = {{(char *)&QReq, sizeof(QReq)}, {Buff, (size_t)Blen}};
+   XrdCmsNode *nP;
+
+// Send the batch if the node it was meant for is still there. Queries that
+// do not make it will time out as any other unanswered query.
+//
+   QReq.Hdr.datalen = htons(static_cast<unsigned short>(Blen));
+   STMutex.Lock();
+   if ((nP = NodeTab[Slot]) && nP->Inst() == Inst && !nP->isOffline)
+      {nP->g2Ref(STMutex);
+       if (nP->Send(ioV, 2, sizeof(QReq)+Blen) < 0)
+          {DEBUG(nP->Ident <<" is unreachable");}
+          else {DEBUG(Blen <<" query bytes sent to " <<nP->Ident);}
+       nP->Ref2g(STMutex);
+      }
+   STMutex.UnLock();
+   free(Buff);
+}
+
 /******************************************************************************/
 /*                               S e l N o d e                                */
 /******************************************************************************/
@@ -1566,8 +1788,14 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
    mask = pmask & peerMask;
    while(pass--)
         {if (mask)
-            {nP = (Config.sched_RR || (Sel.Opts & XrdCmsSelect::UseRef)
-                ?  SelbyRef(mask,selR) : SelbyLoad(mask,selR));
+            {if (Config.sched_Hash && !selR.selPack
+             &&  !(Sel.Opts & XrdCmsSelect::UseRef))
+                nP = SelbyHash(mask, selR, Sel.Path);
+                else
+                nP = (Config.sched_RR || (Sel.Opts & XrdCmsSelect::UseRef)
+                   ?  SelbyRef(mask,selR)
+                   :  Config.sched_Lat ? SelbyLat(mask,selR)
+                                       : SelbyLoad(mask,selR));
              if (nP || (selR.nPick && selR.delay)
              ||  NodeCnt < Config.SUPCount) break;
             }
@@ -1575,11 +1803,14 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
          if (!(Sel.Opts & XrdCmsSelect::isMeta)) selR.needSpace |= isalt;
         }
 
-// If we found an eligible node then dispatch the client to it. We will
+// If we found an eligible node then dispatch the client to it. Space that
+// will be written is reserved on the node until its next reports. We will
 // swap the global mutex for the node mutex to minimize interefrence.
 //
    if (nP)
-      {nP->g2nLock(STMutex);
+      {if (selR.needSpace)
+          nP->DiskReserve(Sel.ASize ? Sel.ASize : Config.DiskResv);
+       nP->g2nLock(STMutex);
        Sel.Resp.DLen = nP->netIF.GetName(Sel.Resp.Data, Sel.Resp.Port, nType);
        if (!Sel.Resp.DLen) {nP->UnLock(); return Unreachable(Sel, false);}
        Sel.Resp.DLen++; Sel.smask = nP->NodeMask;
@@ -1605,6 +1836,7 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
           {if (isalt) act = (Sel.iovN ? " staging " : " assigned ");
               else    act = " serving ";
           }
+       Telemetry.Redirected(act);
        TRACE(Stage, Sel.Resp.Data <<act <<Sel.Path.Val);
        return 0;
       }
@@ -1642,6 +1874,7 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
            Sel.Resp.DLen++; Sel.smask = nP->NodeMask;
            if (Sel.iovN && Sel.iovP) nP->Send(Sel.iovP, Sel.iovN);
            nP->UnLock();
+           Telemetry.Redirected("peer");
            TRACE(Stage, "Peer " <<Sel.Resp.Data <<" handling " <<Sel.Path.Val);
            return 0;
           }
@@ -1666,6 +1899,55 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
    return Unuseable(Sel);
 }
 
+/******************************************************************************/
+/*                             R i n g B u i l d                              */
+/******************************************************************************/
+
+// Each node is placed at RingVN pseudo-random points derived from its name and
+// data port, so a node keeps its share of the ring across restarts and adding
+// or dropping a node only moves the paths next to its own points.
+
+// Caller must have the STMutex locked.
+
+void XrdCmsCluster::RingBuild()
+{
+   XrdCmsNode *nP;
+   char nBuff[512];
+   unsigned int nHash;
+   int i, k, n = 0, nLen;
+
+// Make sure the ring is large enough for all of the nodes
+//
+   for (i = 0; i <= STHi; i++) if (NodeTab[i]) n++;
+   if (n*RingVN > RingMax)
+      {RingPoint *newRing;
+       if (!(newRing = (RingPoint *)realloc(Ring, n*RingVN*sizeof(RingPoint))))
+          {RingNum = 0; return;}
+       Ring = newRing; RingMax = n*RingVN;
+      }
+
+// Place each node on the ring
+//
+   RingNum = 0;
+   for (i = 0; i <= STHi; i++)
+       if ((nP = NodeTab[i]))
+          {nLen = snprintf(nBuff, sizeof(nBuff), "%s:%d", nP->Name(),
+                           nP->netIF.Port());
+           if (nLen >= (int)sizeof(nBuff)) nLen = sizeof(nBuff)-1;
+           nHash = XrdOucCRC::CRC32((const unsigned char *)nBuff, nLen);
+           for (k = 0; k < RingVN; k++)
+               {Ring[RingNum].Pos  = RingMix(nHash + k*0x9e3779b9U);
+                Ring[RingNum].Slot = i;
+                RingNum++;
+               }
+          }
+
+// Sort the points by position
+//
+   qsort(Ring, RingNum, sizeof(RingPoint), RingCmp);
+   RingOK = true;
+}
+
 /******************************************************************************/
 /*                              R e f C o u n t                               */
 /******************************************************************************/
@@ -1680,6 +1962,24 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
            {sP->RefW += sP->Shrip; sP->RefR += sP->Shrip;      \
             sP->Shrem = sP->Share; sP->Shrin++;                \
            }
+
+/******************************************************************************/
+/*                               R s v M a s s                                */
+/******************************************************************************/
+
+// The mass of a node for write selection also counts the space reserved by
+// write selections since its last report as disk utilization.
+
+// Caller must have the STMutex locked.
+
+inline int XrdCmsCluster::RsvMass(XrdCmsNode *nP)
+{
+   if (!nP->DiskRsvd || !nP->DiskTotal || !Config.P_dsk) return nP->myMass;
+   long long rsvUtil = static_cast<long long>(nP->DiskRsvd) * 100LL
+                     / (static_cast<long long>(nP->DiskTotal) * 1024LL);
+   if (rsvUtil > 100) rsvUtil = 100;
+   return nP->myMass + static_cast<int>(Config.P_dsk * rsvUtil / 100);
+}
   
 /******************************************************************************/
 /*                             S e l b y C o s t                              */
@@ -1698,8 +1998,8 @@ XrdCmsNode *XrdCmsCluster::SelbyCost(SMask_t mask, XrdCmsSelector &selR)
 // Scan for a node (sp points to the selected one)
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
+   for (int i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+       if ((np = NodeTab[i]))
           {if (!(selR.needNet &  np->hasNet))    {selR.xNoNet= true; continue;}
            selR.nPick++;
            if (np->isOffline)                    {selR.xOff  = true; continue;}
@@ -1727,6 +2027,151 @@ XrdCmsNode *XrdCmsCluster::SelbyCost(SMask_t mask, XrdCmsSelector &selR)
    return sp;
 }
   
+/******************************************************************************/
+/*                             S e l b y H a s h                              */
+/******************************************************************************/
+
+// Hash selection walks the consistent hash ring clockwise from the path's
+// position and picks the first eligible node. So that a popular path does not
+// overload its node, a node is passed over when its selection count would
+// exceed the average by more than P_hbnd percent (i.e. bounded loads).
+
+// Caller must have the STMutex locked. The returned node. if any, is unlocked.
+
+XrdCmsNode *XrdCmsCluster::SelbyHash(SMask_t mask, XrdCmsSelector &selR,
+                                     XrdCmsKey &Path)
+{
+    XrdCmsNode *np, *sp = 0;
+    SMask_t okMask;
+    long long tRefs = 0, maxRefs;
+    unsigned int pHash;
+    int okNum = 0, lo, hi, mid;
+    bool reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+
+// Collect eligible nodes (preset possible, suspended, overloaded, full, dead)
+//
+   selR.Reset(); SelTcnt++;
+   for (int i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+       if ((np = NodeTab[i]))
+          {if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
+           selR.nPick++;
+           if (np->isOffline)                     {selR.xOff  = true; continue;}
+           if (np->isBad)                         {selR.xSusp = true; continue;}
+           if (!Config.sched_RR && np->myLoad > Config.MaxLoad)
+                                                  {selR.xOvld = true; continue;}
+           if (selR.needSpace && (np->DiskLeft() < np->DiskMinF
+                                  || (reqSS && np->isNoStage)))
+              {selR.xFull = true; continue;}
+           okMask.Set(i); okNum++;
+           tRefs += (selR.needSpace ? np->RefW : np->RefR);
+           if (!sp) sp = np;
+          }
+
+// Check for overloaded node
+//
+   if (!okNum) return calcDelay(selR);
+
+// Find the path's position on the ring (the first point at or after its hash)
+//
+   if (okNum > 1)
+      {if (!RingOK) RingBuild();
+       if (RingNum)
+          {pHash = RingMix(XrdOucCRC::CRC32((const unsigned char *)Path.Val,
+                                            Path.Len));
+           lo = 0; hi = RingNum;
+           while(lo < hi)
+                {mid = (lo + hi) / 2;
+                 if (Ring[mid].Pos < pHash) lo = mid+1;
+                    else hi = mid;
+                }
+
+// Take the first eligible node that is not above the bound
+//
+           maxRefs = ((tRefs+1)*(100+Config.P_hbnd) + okNum*100 - 1)
+                   / (okNum*100);
+           for (int j = 0; j < RingNum; j++)
+               {mid = Ring[(lo + j) % RingNum].Slot;
+                if (!okMask.Test(mid)) continue;
+                np = NodeTab[mid];
+                if ((selR.needSpace ? np->RefW : np->RefR) < maxRefs)
+                   {sp = np; break;}
+               }
+          }
+      }
+
+// Return result
+//
+   RefCount(sp, okNum > 1, selR.needSpace);
+   return sp;
+}
+
+/******************************************************************************/
+/*                              S e l b y L a t                               */
+/******************************************************************************/
+
+// Latency selection picks two eligible nodes at random and uses the one with
+// the lower expected service time, i.e. its reported average service time
+// multiplied by its queue depth. The queue depth is the reported number of
+// requests in progress plus the redirections we made since that report. Only
+// comparing two random nodes, instead of always taking the best one, keeps a
+// burst of requests from herding onto the same node between load reports.
+
+// Caller must have the STMutex locked. The returned node. if any, is unlocked.
+  
+XrdCmsNode *XrdCmsCluster::SelbyLat(SMask_t mask, XrdCmsSelector &selR)
+{
+    XrdCmsNode *np, *sp, *okTab[STMax];
+    long long   spCost, npCost;
+    int         okNum = 0;
+    bool reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+
+// Affinity is a matter of node age and not of latency
+//
+   if (selR.selPack) return SelbyLoad(mask, selR);
+
+// Collect eligible nodes (preset possible, suspended, overloaded, full, dead)
+//
+   selR.Reset(); SelTcnt++;
+   for (int i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+       if ((np = NodeTab[i]))
+          {if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
+           selR.nPick++;
+           if (np->isOffline)                     {selR.xOff  = true; continue;}
+           if (np->isBad)                         {selR.xSusp = true; continue;}
+           if (np->myLoad > Config.MaxLoad)       {selR.xOvld = true; continue;}
+           if (selR.needSpace && (np->DiskLeft() < np->DiskMinF
+                                  || (reqSS && np->isNoStage)))
+              {selR.xFull = true; continue;}
+           okTab[okNum++] = np;
+          }
+
+// Check for overloaded node
+//
+   if (!okNum) return calcDelay(selR);
+
+// Pick two distinct candidates and keep the cheaper one
+//
+   sp = okTab[0];
+   if (okNum > 1)
+      {int i = rand_r(&SelSeed) % okNum, j = rand_r(&SelSeed) % (okNum-1);
+       if (j >= i) j++;
+       sp = okTab[i]; np = okTab[j];
+       spCost = static_cast<long long>(sp->SvcTime+1)
+              * (sp->InFlight + sp->LatRefs + 1);
+       npCost = static_cast<long long>(np->SvcTime+1)
+              * (np->InFlight + np->LatRefs + 1);
+       if (npCost < spCost
+       || (npCost == spCost && (selR.needSpace ? np->RefW < sp->RefW
+                                               : np->RefR < sp->RefR))) sp = np;
+      }
+
+// Return result
+//
+   sp->LatRefs++;
+   RefCount(sp, okNum > 1, selR.needSpace);
+   return sp;
+}
+
 /******************************************************************************/
 /*                             S e l b y L o a d                              */
 /******************************************************************************/
@@ -1741,25 +2186,26 @@ XrdCmsNode *XrdCmsCluster::SelbyLoad(SMask_t mask, XrdCmsSelector &selR)
 // Scan for a node (preset possible, suspended, overloaded, full, and dead)
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
+   for (int i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+       if ((np = NodeTab[i]))
           {if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
            selR.nPick++;
            if (np->isOffline)                     {selR.xOff  = true; continue;}
            if (np->isBad)                         {selR.xSusp = true; continue;}
            if (np->myLoad > Config.MaxLoad)       {selR.xOvld = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
+           if (selR.needSpace && (np->DiskLeft() < np->DiskMinF
                                   || (reqSS && np->isNoStage)))
               {selR.xFull = true; continue;}
            if (!sp) sp = np;
               else{if (selR.needSpace)
-                      {if (abs(sp->myMass - np->myMass) <= Config.P_fuzz)
+                      {int spMass = RsvMass(sp), npMass = RsvMass(np);
+                       if (abs(spMass - npMass) <= Config.P_fuzz)
                           {if (selR.selPack)
                               {if (sp->Inst() > np->Inst())             sp=np;}
                            else
                            if (sp->RefW > (np->RefW+Config.DiskLinger)) sp=np;
                           }
-                          else if (sp->myMass > np->myMass)             sp=np;
+                          else if (spMass > npMass)                     sp=np;
                       } else {
                        if (abs(sp->myLoad - np->myLoad) <= Config.P_fuzz)
                           {if (selR.selPack)
@@ -1793,13 +2239,13 @@ XrdCmsNode *XrdCmsCluster::SelbyRef(SMask_t mask, XrdCmsSelector &selR)
 // Scan for a node (sp points to the selected one)
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
-       if ((np = NodeTab[i]) && (np->NodeMask & mask))
+   for (int i = mask.First(); i >= 0 && i <= STHi; i = mask.First(i+1))
+       if ((np = NodeTab[i]))
           {if (!(selR.needNet & np->hasNet))    {selR.xNoNet= true; continue;}
            selR.nPick++;
            if (np->isOffline)                   {selR.xOff  = true; continue;}
            if (np->isBad)                       {selR.xSusp = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
+           if (selR.needSpace && (np->DiskLeft() < np->DiskMinF
                                   || (reqSS && np->isNoStage)))
               {selR.xFull = true; continue;}
            if (!sp) sp = np;
@@ -107,6 +107,8 @@ int       sUtil;    // Average utilization (largest one)
 //
 class XrdCmsBaseFR;
 class XrdCmsClustID;
+class XrdCmsKey;
+class XrdCmsNSFilter;
 class XrdCmsSelected;
 class XrdOucTList;
 
@@ -160,6 +162,10 @@ XrdCmsSelected *List(SMask_t mask, CmsLSOpts opts, bool &oksel);
 //
 int             Locate(XrdCmsSelect &Sel);
 
+// Always run as a separate thread to send out batched state queries
+//
+void           *MonBatch();
+
 // Always run as a separate thread to monitor subscribed node performance
 //
 void           *MonPerf();
@@ -172,6 +178,13 @@ void           *MonRefs();
 //
 long long       Refs() {return SelWcnt+SelWtot+SelRcnt+SelRtot;}
 
+// Sends a state query for a path to all nodes matching smask. Queries to
+// nodes that accept batches are held for the delay batch interval and sent
+// together with other queries to the same node. Returns the unqueried nodes.
+//
+SMask_t         Query(SMask_t smask, XrdCms::CmsRRHdr &Hdr,
+                      char *Path,    int Plen);
+
 // Called to remove a node from the cluster
 //
 void            Remove(XrdCmsNode *theNode);
@@ -191,6 +204,11 @@ int             Select(XrdCmsSelect &Sel);
 int             Select(SMask_t pmask, int &port, char *hbuff, int &hlen,
                        int isrw, int isMulti, int ifWant);
 
+// Replaces the name space filter used for a node (the node's nsMutex is held)
+//
+void            setNSFilter(XrdCmsNode *nP, XrdCmsNSFilter *nsF,
+                            unsigned int nsGen);
+
 // Manipulate the global selection lock
 //
 void            SLock(bool dolock)
@@ -216,12 +234,18 @@ XrdCmsNode *AddAlt(XrdCmsClustID *cidP, XrdLink *lp, int port, int Status,
 XrdCmsNode *calcDelay(XrdCmsSelector &selR);
 int         Drop(int sent, int sinst, XrdCmsDrop *djp=0);
 void        Record(char *path, const char *reason, bool force=false);
+void        RingBuild();
+int         RsvMass(XrdCmsNode *nP);
 bool        maxBits(SMask_t mVec, int mbits);
 int         Multiple(SMask_t mVec);
+SMask_t     nsPrune(const XrdCmsSelect &Sel, SMask_t mask);
 enum        {eExists, eDups, eROfs, eNoRep, eNoSel, eNoEnt}; // Passed to SelFail
+void        SendBatch(int Slot, int Inst, char *Buff, int Blen);
 int         SelFail(XrdCmsSelect &Sel, int rc);
 int         SelNode(XrdCmsSelect &Sel, SMask_t  pmask, SMask_t  amask);
 XrdCmsNode *SelbyCost(SMask_t, XrdCmsSelector &selR);
+XrdCmsNode *SelbyHash(SMask_t, XrdCmsSelector &selR, XrdCmsKey &Path);
+XrdCmsNode *SelbyLat (SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyLoad(SMask_t, XrdCmsSelector &selR);
 XrdCmsNode *SelbyRef (SMask_t, XrdCmsSelector &selR);
 int         SelDFS(XrdCmsSelect &Sel, SMask_t amask,
@@ -246,6 +270,7 @@ long long     SelWtot;          // Total number of r/w selections (successful)
 long long     SelRcnt;          // Curr  number of r/o selections (successful)
 long long     SelRtot;          // Total number of r/o selections (successful)
 long long     SelTcnt;          // Total number of all selections
+unsigned int  SelSeed;          // Random seed for latency selection
 
 // The following is a list of IP:Port tokens that identify supervisor nodes.
 // The information is sent via the try request to redirect nodes; as needed.
@@ -255,10 +280,31 @@ char          AltMans[STMax*AltSize]; // ||123.123.123.123:12345|| = 21
 char         *AltMend;
 int           AltMent;
 
-// The foloowing three variables are protected by the STMutex
+// Batched state queries pending for each node (protected by the BQMutex)
+//
+static const  int BQSize = 8192; // Must be less than the maximum request size
+
+XrdSysMutex   BQMutex;
+char         *BQBuff[STMax];    // Queries pending for the node in the slot
+int           BQDlen[STMax];    // Amount of data in the above
+int           BQInst[STMax];    // Instance of the node the above are for
+SMask_t       BQMask;           // Slots with pending queries
+
+// The foloowing variables are protected by the STMutex
 //
 SMask_t       peerHost;         // Nodes that are acting as peers
 SMask_t       peerMask;         // Always ~peerHost
+SMask_t       nsVec;            // Nodes that may have a name space filter
+
+// The consistent hash ring used for hash placement (also under the STMutex)
+//
+static const  int RingVN = 128; // Points on the ring per node
+
+struct RingPoint {unsigned int Pos; int Slot;};
+RingPoint    *Ring;             // Points sorted by position
+int           RingNum;          // Number of points in use
+int           RingMax;          // Number of points allocated
+bool          RingOK;           // False when nodes were added or dropped
 };
 
 XRDOUC_ENUM_OPERATORS(XrdCmsCluster::CmsLSOpts)
@@ -56,6 +56,7 @@
 #include "XrdCms/XrdCmsManager.hh"
 #include "XrdCms/XrdCmsMeter.hh"
 #include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
 #include "XrdCms/XrdCmsPrepare.hh"
 #include "XrdCms/XrdCmsPrepArgs.hh"
 #include "XrdCms/XrdCmsProtocol.hh"
@@ -131,12 +132,16 @@ namespace XrdCms
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
 /******************************************************************************/
 
+void *XrdCmsStartMonBatch(void *carg) { return Cluster.MonBatch(); }
+
 void *XrdCmsStartMonPerf(void *carg) { return Cluster.MonPerf(); }
 
 void *XrdCmsStartMonRefs(void *carg) { return Cluster.MonRefs(); }
 
 void *XrdCmsStartMonStat(void *carg) { return CmsState.Monitor(); }
 
+void *XrdCmsStartNSSum(void *carg) { return NSSum.Start(); }
+
 void *XrdCmsStartAdmin(void *carg)
       {return XrdCms::Admin.Start((XrdNetSocket *)carg);
       }
@@ -379,12 +384,12 @@ int XrdCmsConfig::Configure2()
    sprintf(buff, " phase 2 %s initialization started.", myRole);
    Say.Say("++++++ ", myInstance, buff);
 
-// Fix up the QryMinum (we hard code 64 as the max) and P_gshr values.
+// Fix up the QryMinum (we hard code STMax as the max) and P_gshr values.
 // The QryMinum only applies to a metamanager and is set as 1 minus the min.
 //
         if (!isMeta)       QryMinum =  0;
    else if (QryMinum <  2) QryMinum =  0;
-   else if (QryMinum > 64) QryMinum = 64;
+   else if (QryMinum > STMax) QryMinum = STMax;
    if (P_gshr < 0) P_gshr = 0;
       else if (P_gshr > 100) P_gshr = 100;
 
@@ -517,6 +522,7 @@ int XrdCmsConfig::ConfigXeq(char *var, XrdOucStream &CFile, XrdSysError *eDest)
    TS_Xeq("manager",       xmang);   // Server,  non-dynamic
    TS_Lib("namelib", N2N_Lib, &N2N_Parms);
    TS_Xeq("nbsendq",       xnbsq);   // Any      non-dynamic
+   TS_Xeq("nsfilter",      xnsfilt); // Server,  non-dynamic
    TS_Lib("osslib",  ossLib,  &ossParms);
    TS_Xeq("perf",          xperf);   // Server,  non-dynamic
    TS_Xeq("pidpath",       xpidf);   // Any,     non-dynamic
@@ -606,6 +612,15 @@ void XrdCmsConfig::DoIt()
 //
    if (isManager || isServer || isPeer) XrdCmsManager::Start(ManList);
 
+// Start the name space summary thread if we are a data server that wants it
+//
+   if (NSSum.Every && isServer && !isManager && !isProxy && !DiskSS
+   &&  !baseFS.isDFS())
+      {if (XrdSysThread::Run(&tid, XrdCmsStartNSSum, (void *)0,
+                             0, "Name space summary"))
+          Say.Emsg("cmsd", errno, "start name space summary");
+      }
+
 // Start state monitoring thread
 //
    if (XrdSysThread::Run(&tid, XrdCmsStartMonStat, (void *)0,
@@ -664,6 +679,7 @@ void XrdCmsConfig::ConfigDefaults(void)
    LUPDelay = 5;
    QryDelay =-1;
    QryMinum = 0;
+   QryBatch = 0;
    LUPHold  = 178;
    DELDelay = 960;  // 15 minutes
    DRPDelay = 10*60;
@@ -684,6 +700,7 @@ void XrdCmsConfig::ConfigDefaults(void)
    P_fuzz   = 20;
    P_gsdf   = 0;
    P_gshr   = 0;
+   P_hbnd   = 25;
    P_io     = 0;
    P_load   = 0;
    P_mem    = 0;
@@ -706,6 +723,8 @@ void XrdCmsConfig::ConfigDefaults(void)
    myPaths  = (char *)""; // Default is 'r /'
    ConfigFN = 0;
    sched_RR = sched_Pack = sched_Level = 0; sched_Force = 1;
+   sched_Lat= 0;
+   sched_Hash=0;
    isManager= 0;
    isMeta   = 0;
    isPeer   = 0;
@@ -747,6 +766,7 @@ void XrdCmsConfig::ConfigDefaults(void)
    emptylife= 0;
    pendplife=   60*60*24*7;
    DiskLinger=0;
+   DiskResv = 0;
    ProgCH   = 0;
    ProgMD   = 0;
    ProgMV   = 0;
@@ -1091,8 +1111,28 @@ int XrdCmsConfig::setupManager()
 //
    sched_RR = (100 == P_fuzz) || !AskPerf
               || !(P_cpu || P_io || P_load || P_mem || P_pag);
+   if (sched_Hash)
+      {Say.Say("Config consistent hash scheduling in effect.");
+       if (sched_Lat)
+          {Say.Say("Config warning: latency-aware scheduling ignored; "
+                   "consistent hashing takes precedence.");
+           sched_Lat = 0;
+          }
+      }
+   if (sched_Lat)
+      {if (AskPerf && 100 != P_fuzz)
+          {Say.Say("Config latency-aware scheduling in effect; data servers "
+                   "must specify 'cms.perf xrootd latency'.");
+           sched_RR = 0;
+          } else {
+           Say.Say("Config warning: latency-aware scheduling disabled; "
+                   "load reports are ", (AskPerf ? "ignored (fuzz 100)."
+                                                 : "not requested."));
+           sched_Lat = 0;
+          }
+      }
    if (sched_RR)
-      {Say.Say("Config round robin scheduling in effect.");
+      {if (!sched_Hash) Say.Say("Config round robin scheduling in effect.");
        sched_Level = 0;
       }
 
@@ -1104,6 +1144,16 @@ int XrdCmsConfig::setupManager()
        return 1;
       }
 
+// Create query batching thread
+//
+   if (QryBatch)
+      {if ((rc = XrdSysThread::Run(&tid, XrdCmsStartMonBatch, (void *)0,
+                                   0, "Query batcher")))
+          {Say.Emsg("Config", rc, "create query batching thread");
+           return 1;
+          }
+      }
+
 // Create reference monitoring thread
 //
    RefTurn  = 3*STMax*(DiskLinger+1);
@@ -1503,8 +1553,9 @@ int XrdCmsConfig::xcid(XrdSysError *eDest, XrdOucStream &CFile)
                                            [service <sec>] [hold <msec>]
                                            [peer <sec>] [rw <lvl>] [qdl <sec>]
                                            [qdn <cnt>] [delnode <sec>]
-                                           [nostage <cnt>]
+                                           [nostage <cnt>] [batch <msec>]
 
+   batch     <msec>    milliseconds to coalesce state queries to a server.
    delnode   <sec>     maximum seconds to wait to be able to delete a node.
    discard   <cnt>     maximum number a message may be forwarded.
    drop      <sec>     seconds to delay a drop of an offline server.
@@ -1537,6 +1588,7 @@ int XrdCmsConfig::xdelay(XrdSysError *eDest, XrdOucStream &CFile)
     static struct delayopts {const char *opname; int *oploc; int istime;}
            dyopts[] =
        {
+        {"batch",    &QryBatch, 0},
         {"delnode",  &DELDelay, 1},
         {"discard",  &MsgTTL,   0},
         {"drop",     &DRPDelay, 1},
@@ -2106,6 +2158,60 @@ int XrdCmsConfig::xnbsq(XrdSysError *eDest, XrdOucStream &CFile)
    return 0;
 }
 
+/******************************************************************************/
+/*                               x n s f i l t                                */
+/******************************************************************************/
+
+/* Function: xnsfilt
+
+   Purpose:  To parse the directive: nsfilter [every <tm>] [bits <n>]
+
+         every <tm>    the time (seconds, M, H) between walks of the exported
+                       name space. The default is 30m.
+         bits <n>      the number of filter bits per file. The default is 10
+                       which gives about one false hit per 100 lookups.
+
+   Notes:    Causes a data server to summarize its exported name space in a
+             Bloom filter that is sent to managers that accept it. Managers
+             use it to avoid asking the server about files it does not have.
+
+   Type: Server only, non-dynamic.
+
+   Output: 0 upon success or !0 upon failure. Ignored by manager.
+*/
+int XrdCmsConfig::xnsfilt(XrdSysError *eDest, XrdOucStream &CFile)
+{
+    char *val;
+    int  nsEvery = 30*60, nsBits = 10;
+
+    if (!isServer) return CFile.noEcho();
+
+    while((val = CFile.GetWord()))
+         {     if (!strcmp("every", val))
+                  {if (!(val = CFile.GetWord()))
+                      {eDest->Emsg("Config", "nsfilter every value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2tm(*eDest,"nsfilter every",val,&nsEvery,60))
+                      return 1;
+                  }
+          else if (!strcmp("bits",  val))
+                  {if (!(val = CFile.GetWord()))
+                      {eDest->Emsg("Config", "nsfilter bits value not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(*eDest,"nsfilter bits",val,&nsBits,4,32))
+                      return 1;
+                  }
+          else eDest->Say("Config warning: ignoring invalid nsfilter option '",
+                          val, "'.");
+         }
+
+    NSSum.Every   = nsEvery;
+    NSSum.BitsPer = nsBits;
+    return 0;
+}
+
 /******************************************************************************/
 /*                                 x p e r f                                  */
 /******************************************************************************/
@@ -2397,8 +2503,11 @@ int XrdCmsConfig::xreps(XrdSysError *eDest, XrdOucStream &CFile)
     static struct repsopts {const char *opname; int opval;} rsopts[] =
        {
         {"all",      RepStat_All},
+        {"cache",    RepStat_cache},
         {"frq",      RepStat_frq},
-        {"shr",      RepStat_shr}
+        {"lat",      RepStat_lat},
+        {"shr",      RepStat_shr},
+        {"why",      RepStat_why}
        };
     int i, neg, rsval = 0, numopts = sizeof(rsopts)/sizeof(struct repsopts);
 
@@ -2610,6 +2719,7 @@ int XrdCmsConfig::xrole(XrdSysError *eDest, XrdOucStream &CFile)
                                        [fuzz <p>] [maxload <p>] [refreset <sec>]
                                        [maxretries <n>[@<host>:<port>]]
                                        [nomultisrc[@<host>:<port>]]
+                                       [latency] [hash] [hashbound <p>]
                 [affinity [default] {none | weak | strong | strict}]
 
              <p>      is the percentage to include in the load as a value
@@ -2622,6 +2732,18 @@ int XrdCmsConfig::xrole(XrdSysError *eDest, XrdOucStream &CFile)
                       metamanager (i.e. global share). The gsdflt is the
                       default to be used by the metamanager.
 
+             latency  selects the better of two randomly chosen eligible
+                      servers based on their reported service time and the
+                      number of requests they have in progress.
+
+             hash     places a file on the first eligible server found on a
+                      consistent hash ring starting at the file's position.
+                      A server is skipped when it already has more than
+                      hashbound percent above the average number of
+                      selections (the default is 25). The same file is thus
+                      normally served by the same server, as is wanted for
+                      caching proxy clusters.
+
    Type: Any, dynamic.
 
    Output: retc upon success or -EINVAL upon failure.
@@ -2638,6 +2760,7 @@ int XrdCmsConfig::xsched(XrdSysError *eDest, XrdOucStream &CFile)
         {"fuzz",     100, &P_fuzz},
         {"gsdflt",   100, &P_gsdf},
         {"gshr",     100, &P_gshr},
+        {"hashbound",1000,&P_hbnd},
         {"io",       100, &P_io},
         {"runq",     100, &P_load}, // Actually load, runq to avoid confusion
         {"mem",      100, &P_mem},
@@ -2740,6 +2863,14 @@ int XrdCmsConfig::xschedx(char *val, XrdSysError *eDest, XrdOucStream &CFile)
        return 0;
       }
 
+// Check for latency-aware selection
+//
+   if (!strcmp(val, "latency")) {sched_Lat = 1; return 0;}
+
+// Check for consistent hash placement
+//
+   if (!strcmp(val, "hash")) {sched_Hash = 1; return 0;}
+
 // Check for unqualified nomultisrc
 //
    if (!strcmp(val, "nomultisrc"))
@@ -2855,6 +2986,7 @@ int XrdCmsConfig::xsecl(XrdSysError *eDest, XrdOucStream &CFile)
 /* Function: xspace
 
    Purpose:  To parse the directive: space [linger <num>] [recalc <sec>]
+                                           [resv <rsz>]
 
                           [[min] {<mnp> [<min>] | <min>}  [[<hwp>] <hwm>]]
 
@@ -2877,6 +3009,11 @@ int XrdCmsConfig::xsecl(XrdSysError *eDest, XrdOucStream &CFile)
              <sec> Number of seconds that must elapse before a disk free space
                    calculation will occur.
 
+             <rsz> Bytes (or K, M, G) to subtract from a server's free space
+                   each time it is selected for writing and the client did not
+                   say how much it will write (oss.asize). Reservations are
+                   halved with each load or space report. The default is 0.
+
              mwfiles
                    space supports multiple writable file copies. This suppresses
                    multiple file check when open a file in write mode.
@@ -2892,7 +3029,7 @@ int XrdCmsConfig::xspace(XrdSysError *eDest, XrdOucStream &CFile)
 {
     char *val;
     int i, alinger = -1, arecalc = -1, minfP = -1, hwmP = -1;
-    long long minf = -1, hwm = -1;
+    long long minf = -1, hwm = -1, aresv = -1;
     bool haveopt = false;
 
     while((val = CFile.GetWord()))
@@ -2906,6 +3043,11 @@ int XrdCmsConfig::xspace(XrdSysError *eDest, XrdOucStream &CFile)
                   {eDest->Emsg("Config", "recalc value not specified"); return 1;}
                if (XrdOuca2x::a2i(*eDest,"recalc",val,&arecalc,1)) return 1;
               }
+      else if (!strcmp("resv", val))
+              {if (!(val = CFile.GetWord()))
+                  {eDest->Emsg("Config", "resv value not specified"); return 1;}
+               if (XrdOuca2x::a2sz(*eDest,"resv",val,&aresv,0)) return 1;
+              }
       else if (!strcmp("min", val))
               {if (!(val = CFile.GetWord()) || !isdigit(*val))
                   {eDest->Emsg("Config", "space min value not specified"); return 1;}
@@ -2958,11 +3100,15 @@ int XrdCmsConfig::xspace(XrdSysError *eDest, XrdOucStream &CFile)
 
     if (val) {eDest->Emsg("Config", "invalid space parameter -", val); return 1;}
     
-    if (!haveopt && alinger < 0 && arecalc < 0 && minf < 0)
+    if (!haveopt && alinger < 0 && arecalc < 0 && minf < 0 && aresv < 0)
        {eDest->Emsg("Config", "no space values specified"); return 1;}
 
     if (alinger >= 0) DiskLinger = alinger;
     if (arecalc >= 0) DiskAsk    = arecalc;
+    if (aresv   >= 0)
+       {aresv = (aresv + 1048575LL) >> 20LL;       // Now Megabytes
+        DiskResv = (aresv > 0x3fffffffLL ? 0x3fffffff : static_cast<int>(aresv));
+       }
 
     if (minfP > 0)
        {if (hwmP < minfP) hwmP = minfP + 1;
@@ -75,6 +75,7 @@ int         PSDelay;      // Maximum delay time before peer is selected
 int         RWDelay;      // R/W lookup delay handling (0 | 1 | 2)
 int         QryDelay;     // Query Response Deadline
 int         QryMinum;     // Query Response Deadline Minimum Available
+int         QryBatch;     // Query batching window (in milliseconds)
 int         SRVDelay;     // Minimum delay at startup
 int         SUPCount;     // Minimum server count
 int         SUPLevel;     // Minimum server count as floating percentage
@@ -100,6 +101,7 @@ int         P_dsk;        // % DSK Capacity in load factor
 int         P_fuzz;       // %     Capacity to fuzz when comparing
 int         P_gsdf;       // %     Global share default (0 -> no default)
 int         P_gshr;       // %     Global share of requests allowed
+int         P_hbnd;       // %     Excess selections allowed for hash placement
 int         P_io;         // % I/O Capacity in load factor
 int         P_load;       // % MSC Capacity in load factor
 int         P_mem;        // % MEM Capacity in load factor
@@ -115,6 +117,7 @@ int         DiskHWM;      // Minimum MB needed of space to requalify
 short       DiskMinP;     // Minimum MB needed of space in a partition as %
 short       DiskHWMP;     // Minimum MB needed of space to requalify   as %
 int         DiskLinger;   // Manager Only
+int         DiskResv;     // MB reserved per write selection without a size hint
 int         DiskAsk;      // Seconds between disk space reclaculations
 int         DiskWT;       // Seconds to defer client while waiting for space
 int         DiskSS;       // This is a staging server
@@ -124,6 +127,8 @@ char        sched_RR;     // 1 -> Simply do round robin scheduling
 char        sched_Pack;   // 1 -> Pick oldest node (>1 same but wait for resps)
 char        sched_Level;  // 1 -> Use load-based level for "pack" selection
 char        sched_Force;  // 1 -> Client cannot select mode
+char        sched_Lat;    // 1 -> Use latency-aware two-choice selection
+char        sched_Hash;   // 1 -> Use consistent hash placement by path
 int         doWait;       // 1 -> Wait for a data end-point
 
 int         adsPort;      // Alternate server port
@@ -198,6 +203,9 @@ XrdNetSecurity    *Police;
 //
 static const int RepStat_frq    = 0x0001; // Fast Response Queue
 static const int RepStat_shr    = 0x0002; // Share
+static const int RepStat_cache  = 0x0004; // Location cache lookups
+static const int RepStat_lat    = 0x0008; // Locate and select latency
+static const int RepStat_why    = 0x0010; // Redirect and delay reasons
 static const int RepStat_All    = 0xffff; // All
 
 private:
@@ -228,6 +236,7 @@ int  xfxhld(XrdSysError *edest, XrdOucStream &CFile);
 int  xlclrt(XrdSysError *edest, XrdOucStream &CFile);
 int  xmang(XrdSysError *edest, XrdOucStream &CFile);
 int  xnbsq(XrdSysError *edest, XrdOucStream &CFile);
+int  xnsfilt(XrdSysError *edest, XrdOucStream &CFile);
 int  xperf(XrdSysError *edest, XrdOucStream &CFile);
 int  xpidf(XrdSysError *edest, XrdOucStream &CFile);
 int  xping(XrdSysError *edest, XrdOucStream &CFile);
@@ -109,6 +109,8 @@ XrdCmsFinderRMT::XrdCmsFinderRMT(XrdSysLogger *lp, int whoami, int Port)
      myPort      = Port;
      SMode       = 0;
      sendID      = 0;
+     HedgeWait   = -1;
+     LocTTL      = 0;
      isMeta      = whoami & IsMeta;
      isProxy     = whoami & IsProxy;
      isTarget    = whoami & IsTarget;
@@ -174,6 +176,8 @@ int XrdCmsFinderRMT::Configure(const char *cfn, char *Args, XrdOucEnv *envP)
    ConWait    = config.ConWait;
    FwdWait    = config.FwdWait;
    PrepWait   = config.PrepWait;
+   HedgeWait  = config.HedgeWait;
+   LocTTL     = config.LocTTL;
    if (isProxy)
            {SMode = config.SModeP;
             StartManagers(config.PanList);
@@ -261,6 +265,10 @@ int XrdCmsFinderRMT::Forward(XrdOucErrInfo &Resp, const char *cmd,
    xmsg[0].iov_base      = (char *)&Data.Request;
    xmsg[0].iov_len       = sizeof(Data.Request);
 
+// Cached locate results for a path that will be removed or renamed are stale
+//
+   if (doAll && LocTTL && arg1) LocDel(arg1);
+
 // This may be a 2way message. If so, use the longer path.
 //
    if (is2way) return send2Man(Resp, (arg1 ? arg1 : "/"), xmsg, iovcnt+1);
@@ -336,7 +344,8 @@ int XrdCmsFinderRMT::Locate(XrdOucErrInfo &Resp, const char *path, int flags,
    static const int xNum   = 12;
 
    XrdCmsRRData   Data;
-   int            n, iovcnt;
+   int            n, iovcnt, retc, lcOpts = 0;
+   bool           isRO;
    char           Work[xNum*12];
    struct iovec   xmsg[xNum];
    char          *triedRC, *affmode;
@@ -442,9 +451,69 @@ int XrdCmsFinderRMT::Locate(XrdOucErrInfo &Resp, const char *path, int flags,
    xmsg[0].iov_base      = (char *)&Data.Request;
    xmsg[0].iov_len       = sizeof(Data.Request);
 
-// Send the 2way message
+// Requests that only look for the file may be hedged. Only the results of a
+// locate may be cached as a select must be subject to the cluster's load and
+// space based server selection each time. Anything else (e.g. a write or a
+// refresh) as well as a retry (i.e. tried hosts) invalidates any cached result
+// for the path so that other clients are not sent to a failing server.
+//
+   if (Data.Request.rrCode == kYR_locate)
+      isRO = !(Data.Opts & CmsLocateRequest::kYR_refresh);
+      else isRO = !(Data.Opts & (CmsSelectRequest::kYR_refresh
+                              |  CmsSelectRequest::kYR_create
+                              |  CmsSelectRequest::kYR_trunc
+                              |  CmsSelectRequest::kYR_write));
+   if (LocTTL)
+      {if (!isRO || Data.Avoid) LocDel(path);
+          else if (Data.Request.rrCode == kYR_locate)
+                  {lcOpts = Data.Opts | (Data.Request.rrCode << 24);
+                   if (LocGet(Resp, path, lcOpts, retc)) return retc;
+                  }
+      }
+
+// Send the 2way message and cache the result if so wanted
 //
-   return send2Man(Resp, path, xmsg, iovcnt+1);
+   retc = send2Man(Resp, path, xmsg, iovcnt+1, isRO);
+   if (lcOpts) LocPut(Resp, path, lcOpts, retc);
+   return retc;
+}
+  
+/******************************************************************************/
+/*                                L o c D e l                                 */
+/******************************************************************************/
+
+void XrdCmsFinderRMT::LocDel(const char *path)
+{
+   LocMutex.Lock();
+   LocCache.Del(path);
+   LocMutex.UnLock();
+}
+  
+/******************************************************************************/
+/*                                L o c G e t                                 */
+/******************************************************************************/
+
+bool XrdCmsFinderRMT::LocGet(XrdOucErrInfo &Resp, const char *path, int opts,
+                             int &retc)
+{
+   EPNAME("LocGet")
+   LocInfo *lP;
+
+// Find a result for this path that was obtained using the same options
+//
+   LocMutex.Lock();
+   if ((lP = LocCache.Find(path)))
+      while(lP && lP->Opts != opts) lP = lP->Next;
+   if (!lP) {LocMutex.UnLock(); return false;}
+
+// Return the result as if the manager had sent it
+//
+   Resp.setErrInfo(lP->Code, lP->Text);
+   retc = lP->Retc;
+   LocMutex.UnLock();
+   TRACE(Redirect, Resp.getErrUser() <<" cached " <<Resp.getErrText()
+                   <<':' <<Resp.getErrInfo() <<' ' <<path);
+   return true;
 }
   
 /******************************************************************************/
@@ -520,6 +589,38 @@ int XrdCmsFinderRMT::LocLocal(XrdOucErrInfo &Resp, XrdOucEnv *Env)
    return SFS_DATA;
 }
   
+/******************************************************************************/
+/*                                L o c P u t                                 */
+/******************************************************************************/
+
+void XrdCmsFinderRMT::LocPut(XrdOucErrInfo &Resp, const char *path, int opts,
+                             int retc)
+{
+   LocInfo *lP;
+   int code;
+   const char *text;
+
+// Only location lists (and the redirects of a locate) that fit in the message
+// buffer are kept. Errors and waits are transient and are always obtained anew.
+//
+   if ((retc != SFS_REDIRECT && retc != SFS_DATA) || Resp.extData()) return;
+   text = Resp.getErrText(code);
+
+// Add the result to the list for the path. The cache is simply cleared should
+// it grow too large as entries are short-lived anyway.
+//
+   LocMutex.Lock();
+   if ((lP = LocCache.Find(path)))
+      {LocInfo *nP = lP;
+       while(nP && nP->Opts != opts) nP = nP->Next;
+       if (!nP) lP->Next = new LocInfo(lP->Next, opts, retc, code, text);
+      } else {
+       if (LocCache.Num() >= LocMax) LocCache.Purge();
+       LocCache.Add(path, new LocInfo(0, opts, retc, code, text), LocTTL);
+      }
+   LocMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                               P r e p a r e                                */
 /******************************************************************************/
@@ -646,6 +747,21 @@ int XrdCmsFinderRMT::Prepare(XrdOucErrInfo &Resp, XrdSfsPrep &pargs,
    return RepDelay;
 }
 
+/******************************************************************************/
+/*                       S e l e c t A l t e r n a t e                        */
+/******************************************************************************/
+
+XrdCmsClientMan *XrdCmsFinderRMT::SelectAlternate(XrdCmsClientMan *Manp)
+{
+   XrdCmsClientMan *Altp = Manp;
+
+// Find the next usable manager after the selected one, if any
+//
+   while((Altp = Altp->nextManager()) != Manp)
+        if (Altp->isActive() && !Altp->Suspended()) return Altp;
+   return (XrdCmsClientMan *)0;
+}
+  
 /******************************************************************************/
 /*                         S e l e c t M a n a g e r                          */
 /******************************************************************************/
@@ -707,19 +823,24 @@ void XrdCmsFinderRMT::SelectManFail(XrdOucErrInfo &Resp)
 /******************************************************************************/
   
 int XrdCmsFinderRMT::send2Man(XrdOucErrInfo &Resp, const char *path,
-                              struct iovec  *xmsg, int         xnum)
+                              struct iovec  *xmsg, int         xnum, bool hedge)
 {
    EPNAME("send2Man")
-   unsigned int     iMan;
+   unsigned int     iMan, iAlt = 0;
    int              retc;
+   bool             isSent, gotReply = false;
    XrdCmsClientMsg *mp;
-   XrdCmsClientMan *Manp;
+   XrdCmsClientMan *Manp, *Altp = 0;
 
 // Select the right manager for this request
 //
    if (!(Manp = SelectManager(Resp, path)) || Manp->Suspended()) 
       return ConWait;
 
+// If the request may be hedged, find a second manager to also send it to
+//
+   if (hedge && HedgeWait >= 0) Altp = SelectAlternate(Manp);
+
 // Allocate a message object. There is only a fixed number of these and if
 // all of them are in use, th client has to wait to prevent over-runs.
 //
@@ -735,17 +856,37 @@ int XrdCmsFinderRMT::send2Man(XrdOucErrInfo &Resp, const char *path,
    if (savePath) Resp.setErrData(path);
       else Resp.setErrData(0);
 
-// Send message and simply wait for the reply (msg object is locked via Alloc)
+// Send the message (msg object is locked via Alloc). When hedging, the same
+// message (hence stream id) also goes to the alternate manager either right
+// away, when the primary did not take it, or when the primary did not reply
+// within the hedge window. Only the first reply finds the message object.
+//
+   isSent = Manp->Send(iMan, xmsg, xnum) != 0;
+   if (Altp)
+      {if (isSent && HedgeWait > 0 && !mp->Wait4ReplyMS(HedgeWait))
+          gotReply = true;
+          else if (Altp->Send(iAlt, xmsg, xnum))
+                  {TRACE(Redirect, Resp.getErrUser() <<" hedged to "
+                                   <<Altp->NPfx() <<" path=" <<path);
+                   if (!isSent) {Manp = Altp; iMan = iAlt; Altp = 0;}
+                   isSent = true;
+                  } else Altp = 0;
+      }
+
+// Simply wait for the reply
 //
-   if (!Manp->Send(iMan, xmsg, xnum) || (mp->Wait4Reply(Manp->waitTime())))
+   if (!gotReply && (!isSent || mp->Wait4Reply(Manp->waitTime())))
       {mp->Recycle();
+       if (Altp) Altp->whatsUp(Resp.getErrUser(), path, iAlt);
        retc = Manp->whatsUp(Resp.getErrUser(), path, iMan);
        Resp.setErrInfo(retc, "");
        return retc;
       }
 
-// A reply was received; process as appropriate
+// A reply was received. Should it be from the alternate, the alternate must
+// handle any delayed response as it will be the one sending it.
 //
+   if (Altp && mp->getFrom() == Altp->NPfx()) Manp = Altp;
    retc = mp->getResult();
    if (retc == SFS_STARTED) retc = Manp->delayResp(Resp);
       else if (retc == SFS_STALL) retc = Resp.getErrInfo();
@@ -900,6 +1041,9 @@ XrdCmsFinderTRG::XrdCmsFinderTRG(XrdSysLogger *lp, int whoami, int port,
    myPort  = port;
    resMax  = -1;
    resCur  = 0;
+   perfMon = 0;
+   perfInt = 0;
+   latRep  = false;
    Say.logger(lp);
 }
  
@@ -985,10 +1129,11 @@ int XrdCmsFinderTRG::Configure(const char *cfn, char *Ags, XrdOucEnv *envP)
 // environment as we don't need these at all.
 //
    if (RunAdmin(config.CMSPath, config.myVNID)
-   &&  config.perfMon && config.perfInt)
+   &&  (config.perfMon || config.latRep) && config.perfInt)
       {pthread_t tid;
        perfMon = config.perfMon;
        perfInt = config.perfInt;
+       if ((latRep = config.latRep)) XrdCmsLatency::Enable();
        if (XrdSysThread::Run(&tid, StartPM, (void *)this, 0, "perfmon"))
 //     if (XrdSysThread::Run(&tid, StartRsp, (void *)this, 0, "cms i/f"))
           {Say.Emsg("Config", errno, "start performance monitor."); return 0;}
@@ -1057,6 +1202,30 @@ void XrdCmsFinderTRG::PutInfo(XrdCmsPerfMon::PerfInfo &perfInfo, bool alert)
    myData.UnLock();
 }
 
+/******************************************************************************/
+/*                            P u t L a t e n c y                             */
+/******************************************************************************/
+  
+void XrdCmsFinderTRG::PutLatency(XrdCmsLatency::LatInfo &latInfo)
+{
+   char  buff[256];
+   char *data[2] = {buff, 0};
+   int   dlen[2];
+
+// Format: lat <version> <svctime> <inflight>
+//
+   dlen[0] = snprintf(buff, sizeof(buff), "lat %u %u %u\n", latInfo.version,
+                      latInfo.svc_time, latInfo.req_load);
+   dlen[1] = 0;
+
+// Now send the notification
+//
+   myData.Lock();
+   if (Active && CMSp->Put((const char **)data, (const int *)dlen))
+      {CMSp->Close(); Active = 0;}
+   myData.UnLock();
+}
+
 /******************************************************************************/
 /*                               R e l e a s e                                */
 /******************************************************************************/
@@ -1244,13 +1413,21 @@ int XrdCmsFinderTRG::RunAdmin(char *Path, const char *vnid)
 void *XrdCmsFinderTRG::RunPM()
 {
    XrdCmsPerfMon::PerfInfo perfInfo;
+   XrdCmsLatency::LatInfo  latInfo;
 
-// Keep asking the plugin for statistics.
+// Keep asking the plugin for statistics and, if wanted, report the latency
+// seen during the last interval.
 //
    while(1)
-        {perfMon->GetInfo(perfInfo);
-         PutInfo(perfInfo);
-         perfInfo.Clear();
+        {if (perfMon)
+            {perfMon->GetInfo(perfInfo);
+             PutInfo(perfInfo);
+             perfInfo.Clear();
+            }
+         if (latRep)
+            {XrdCmsLatency::GetInfo(latInfo);
+             PutLatency(latInfo);
+            }
          XrdSysTimer::Snooze(perfInt);
         }
    return (void *)0;
@@ -30,9 +30,14 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "XrdCms/XrdCmsClient.hh"
+#include "XrdCms/XrdCmsLatency.hh"
 #include "XrdCms/XrdCmsPerfMon.hh"
 
+#include "XrdOuc/XrdOucHash.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 class  XrdCmsClientMan;
@@ -83,14 +88,43 @@ static  bool   VCheck(XrdVersionInfo &urVersion);
 static const int MaxMan = 15;
 
 private:
+
+// Locate results are cached by path. Each path has a list of results, one for
+// each distinct option combination. Select (i.e. open) results are not cached.
+//
+struct LocInfo
+      {LocInfo *Next;
+       char    *Text;
+       int      Code;
+       int      Opts;
+       int      Retc;
+               LocInfo(LocInfo *np, int opts, int retc, int code,
+                       const char *text)
+                      : Next(np), Text(strdup(text)), Code(code),
+                        Opts(opts), Retc(retc) {}
+              ~LocInfo() {if (Text) free(Text); if (Next) delete Next;}
+      };
+
 int              Decode(char **resp);
 void             Inform(XrdCmsClientMan *xman, struct iovec xmsg[], int xnum);
+void             LocDel(const char *path);
+bool             LocGet(XrdOucErrInfo &Resp, const char *path, int opts,
+                        int &retc);
 int              LocLocal(XrdOucErrInfo &Resp, XrdOucEnv *Env);
+void             LocPut(XrdOucErrInfo &Resp, const char *path, int opts,
+                        int retc);
+XrdCmsClientMan *SelectAlternate(XrdCmsClientMan *Manp);
 XrdCmsClientMan *SelectManager(XrdOucErrInfo &Resp, const char *path);
 void             SelectManFail(XrdOucErrInfo &Resp);
-int              send2Man(XrdOucErrInfo &, const char *, struct iovec *, int);
+int              send2Man(XrdOucErrInfo &, const char *, struct iovec *, int,
+                          bool hedge=false);
 int              StartManagers(XrdOucTList *);
 
+static const int LocMax = 16384;  // Max number of paths in the locate cache
+
+XrdOucHash<LocInfo> LocCache;
+XrdSysMutex      LocMutex;
+
 XrdCmsClientMan *myManTable[MaxMan];
 XrdCmsClientMan *myManagers;
 XrdOucTList     *myManList;
@@ -103,6 +137,8 @@ int              RepNone;
 int              RepWait;
 int              FwdWait;
 int              PrepWait;
+int              HedgeWait;
+int              LocTTL;
 int              isMeta;
 int              isProxy;
 int              isTarget;
@@ -136,6 +172,8 @@ XrdOucTList   *Managers() {return myManList;}
 
         void   PutInfo(XrdCmsPerfMon::PerfInfo &perfInfo, bool alert=false);
 
+        void   PutLatency(XrdCmsLatency::LatInfo &latInfo);
+
         void   Removed(const char *path);
 
         void   Resume (int Perm=1);
@@ -181,5 +219,6 @@ int            isProxy;
 int            Active;
 XrdCmsPerfMon *perfMon;
 int            perfInt;
+bool           latRep;
 };
 #endif
@@ -0,0 +1,116 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s L a t e n c y . c c                       */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdCms/XrdCmsLatency.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdSysMutex XrdCmsLatency::latMutex;
+long long   XrdCmsLatency::svcSum   = 0;
+int         XrdCmsLatency::svcNum   = 0;
+int         XrdCmsLatency::inFlight = 0;
+bool        XrdCmsLatency::isOn     = false;
+
+/******************************************************************************/
+/*                                 B e g i n                                  */
+/******************************************************************************/
+
+long long XrdCmsLatency::Begin()
+{
+   struct timespec tNow;
+
+// Do nothing unless we are reporting latency
+//
+   if (!isOn) return 0;
+
+// Count the request and return the start time in microseconds
+//
+   AtomicBeg(latMutex);
+   AtomicInc(inFlight);
+   AtomicEnd(latMutex);
+   clock_gettime(CLOCK_MONOTONIC, &tNow);
+   return static_cast<long long>(tNow.tv_sec)*1000000 + tNow.tv_nsec/1000 + 1;
+}
+
+/******************************************************************************/
+/*                                   E n d                                    */
+/******************************************************************************/
+
+void XrdCmsLatency::End(long long tBeg)
+{
+   struct timespec tNow;
+   long long tSvc;
+
+// Compute the service time (Begin() added one to never return zero)
+//
+   clock_gettime(CLOCK_MONOTONIC, &tNow);
+   tSvc = static_cast<long long>(tNow.tv_sec)*1000000 + tNow.tv_nsec/1000
+        - (tBeg - 1);
+   if (tSvc < 0) tSvc = 0;
+
+// Account for it
+//
+   latMutex.Lock();
+   svcSum += tSvc;
+   svcNum++;
+   latMutex.UnLock();
+   AtomicBeg(latMutex);
+   AtomicDec(inFlight);
+   AtomicEnd(latMutex);
+}
+
+/******************************************************************************/
+/*                               G e t I n f o                                */
+/******************************************************************************/
+
+void XrdCmsLatency::GetInfo(XrdCmsLatency::LatInfo &info)
+{
+   long long tSum;
+   int       tNum, tInq;
+
+// Grab the figures for this interval and start a new one
+//
+   latMutex.Lock();
+   tSum = svcSum; tNum = svcNum;
+   svcSum = 0;    svcNum = 0;
+   latMutex.UnLock();
+   AtomicBeg(latMutex);
+   tInq = AtomicGet(inFlight);
+   AtomicEnd(latMutex);
+
+// Report the average in milliseconds, rounding up so that any activity is
+// distinguishable from an idle server.
+//
+   info.version  = LatVersion;
+   info.svc_time = (tNum ? static_cast<unsigned int>((tSum/tNum + 999)/1000)
+                         : 0);
+   info.req_load = (tInq > 0 ? static_cast<unsigned int>(tInq) : 0);
+}
@@ -0,0 +1,120 @@
+#ifndef __CMS_LATENCY__
+#define __CMS_LATENCY__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d C m s L a t e n c y . h h                       */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <time.h>
+
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                   c l a s s   X r d C m s L a t e n c y                    */
+/******************************************************************************/
+
+/* The XrdCmsLatency object keeps track of the time a data server takes to
+   service opens and reads and of the number of such requests in progress.
+   The cms xrootd plugin periodically sends these figures to the local cmsd
+   using the versioned "lat" message (see cms.perf xrootd latency) so that
+   managers may use latency-aware scheduling. Tracking is off until Enable()
+   is called, in which case Begin() and End() cost next to nothing.
+*/
+
+class XrdCmsLatency
+{
+public:
+
+//------------------------------------------------------------------------------
+//! Structure used for reporting latency metrics. The version tells the
+//! receiver which of the fields are present; fields are only ever appended.
+//------------------------------------------------------------------------------
+
+static const unsigned int LatVersion = 1;
+
+struct LatInfo
+      {unsigned int  version;  //!< Structure version (i.e. LatVersion)
+       unsigned int  svc_time; //!< Average open/read service time in ms
+       unsigned int  req_load; //!< Number of requests currently in progress
+
+       LatInfo() : version(LatVersion), svc_time(0), req_load(0) {}
+      ~LatInfo() {}
+      };
+
+//------------------------------------------------------------------------------
+//! Start timing a request.
+//!
+//! @return The start time to be passed to End() or zero if not tracking.
+//------------------------------------------------------------------------------
+
+static long long Begin();
+
+//------------------------------------------------------------------------------
+//! Turn on latency tracking. This is a one-time call.
+//------------------------------------------------------------------------------
+
+static void      Enable() {isOn = true;}
+
+//------------------------------------------------------------------------------
+//! Finish timing a request.
+//!
+//! @param  tBeg  The value returned by the corresponding Begin().
+//------------------------------------------------------------------------------
+
+static void      End(long long tBeg);
+
+//------------------------------------------------------------------------------
+//! Obtain the figures since the last call and start a new interval.
+//!
+//! @param  info  Reference to the structure to be filled out.
+//------------------------------------------------------------------------------
+
+static void      GetInfo(LatInfo &info);
+
+//------------------------------------------------------------------------------
+//! Helper that times a request for the duration of a scope.
+//------------------------------------------------------------------------------
+
+class Timer
+{
+public:
+      Timer() : tBeg(XrdCmsLatency::Begin()) {}
+     ~Timer() {if (tBeg) XrdCmsLatency::End(tBeg);}
+private:
+long long tBeg;
+};
+
+private:
+
+static XrdSysMutex latMutex;
+static long long   svcSum;     // Service time in microseconds this interval
+static int         svcNum;     // Requests completed this interval
+static int         inFlight;   // Requests in progress
+static bool        isOn;
+};
+#endif
@@ -40,6 +40,7 @@
 #include "XrdCms/XrdCmsManager.hh"
 #include "XrdCms/XrdCmsManTree.hh"
 #include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
 #include "XrdCms/XrdCmsProtocol.hh"
 #include "XrdCms/XrdCmsRouting.hh"
 #include "XrdCms/XrdCmsUtils.hh"
@@ -307,6 +308,32 @@ void XrdCmsManager::Inform(CmsRRHdr &Hdr, const char *Arg, int Alen)
     Inform(Router.getName(Hdr.rrCode), ioV, (Arg ? 2 : 1), Alen+sizeof(Hdr));
 }
 
+/******************************************************************************/
+
+void XrdCmsManager::Inform(XrdCmsNSSum &nsSum)
+{
+   XrdCmsNode *nP;
+   int i;
+
+// Obtain a lock on the table
+//
+   MTMutex.Lock();
+
+// Run through the table giving each manager that accepts a name space filter
+// whatever it needs to be brought up to date.
+//
+   for (i = 0; i <= MTHi; i++)
+       {if ((nP=MastTab[i]) && !nP->isOffline && nP->nsAccept)
+           {nP->Lock(true);
+            MTMutex.UnLock();
+            nsSum.Send(nP);
+            nP->UnLock();
+            MTMutex.Lock();
+           }
+       }
+   MTMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                                R e m o v e                                 */
 /******************************************************************************/
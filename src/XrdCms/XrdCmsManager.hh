@@ -44,6 +44,7 @@ class XrdLink;
 class XrdCmsManList;
 class XrdCmsManTree;
 class XrdCmsNode;
+class XrdCmsNSSum;
 class XrdOucTList;
   
 /******************************************************************************/
@@ -72,6 +73,7 @@ static void Inform(const char *What, const char *Data, int Dlen);
 static void Inform(const char *What, struct iovec *vP, int vN, int vT=0);
 static void Inform(XrdCms::CmsReqCode rCode, int rMod, const char *Arg=0, int Alen=0);
 static void Inform(XrdCms::CmsRRHdr &Hdr, const char *Arg=0, int Alen=0);
+static void Inform(XrdCmsNSSum &nsSum);
 
 static bool Present() {return MTHi >= 0;};
 
@@ -107,6 +107,8 @@ XrdCmsMeter::XrdCmsMeter() : myMeter(&Say)
     mem_load = 0;
     pag_load = 0;
     net_load = 0;
+    svc_time = 0;
+    req_load = 0;
     myLoad   = 0;
     prevLoad = -1;
     Virtual  = 0;
@@ -344,6 +346,32 @@ void XrdCmsMeter::PutInfo(XrdCmsPerfMon::PerfInfo &perfInfo, bool alert)
    if (alert) XrdCmsNode::Report_Usage(0);
 }
 
+/******************************************************************************/
+/*                               L a t e n c y                                */
+/******************************************************************************/
+  
+void XrdCmsMeter::Latency(int &psvc, int &pinf)
+{
+   repMutex.Lock();
+   psvc = static_cast<int>(svc_time);
+   pinf = static_cast<int>(req_load);
+   repMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                            P u t L a t e n c y                             */
+/******************************************************************************/
+  
+void XrdCmsMeter::PutLatency(unsigned int svct, unsigned int infl)
+{
+   static const unsigned int maxVal = 0x7fffffff;
+
+   repMutex.Lock();
+   svc_time = (svct <= maxVal ? svct : maxVal);
+   req_load = (infl <= maxVal ? infl : maxVal);
+   repMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                                R e c o r d                                 */
 /******************************************************************************/
@@ -366,6 +394,16 @@ void XrdCmsMeter::Record(int pcpu, int pnet, int pxeq,
    pag_load = (pag_load + (ppag > temp ? temp : ppag))/2;
    repMutex.UnLock();
 }
+
+/******************************************************************************/
+  
+void XrdCmsMeter::Record(int psvc, int pinf)
+{
+   repMutex.Lock();
+   svc_time = (svc_time + static_cast<uint32_t>(psvc))/2;
+   req_load = (req_load + static_cast<uint32_t>(pinf))/2;
+   repMutex.UnLock();
+}
  
 /******************************************************************************/
 /*                                R e p o r t                                 */
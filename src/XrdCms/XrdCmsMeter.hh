@@ -50,14 +50,20 @@ void  Init();
 
 int   isOn() {return Running;}
 
+void  Latency(int &psvc, int &pinf);
+
 int   Monitor(char *pgm, int itv);
 int   Monitor(int itv);
 
 void  PutInfo(XrdCmsPerfMon::PerfInfo &perfInfo, bool alert=false);
 
+void  PutLatency(unsigned int svct, unsigned int infl);
+
 void  Record(int pcpu, int pnet, int pxeq,
              int pmem, int ppag, int pdsk);
 
+void  Record(int psvc, int pinf);
+
 int   Report(int &pcpu, int &pnet, int &pxeq,
              int &pmem, int &ppag, int &pdsk);
 
@@ -122,6 +128,8 @@ uint32_t      cpu_load;
 uint32_t      mem_load;
 uint32_t      pag_load;
 uint32_t      net_load;
+uint32_t      svc_time;
+uint32_t      req_load;
 int           myLoad;
 int           prevLoad;
 };
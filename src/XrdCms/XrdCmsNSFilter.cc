@@ -0,0 +1,460 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C m s N S F i l t e r . c c                      */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <sys/uio.h>
+
+#include "XProtocol/YProtocol.hh"
+
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsManager.hh"
+#include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
+#include "XrdCms/XrdCmsPList.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucName2Name.hh"
+#include "XrdOuc/XrdOucNSWalk.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPlatform.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+       XrdCmsNSSum   XrdCms::NSSum;
+
+/******************************************************************************/
+/*                  C l a s s   X r d C m s N S F i l t e r                   */
+/******************************************************************************/
+/******************************************************************************/
+/*                          C o n s t r u c t o r s                           */
+/******************************************************************************/
+
+XrdCmsNSFilter::XrdCmsNSFilter(unsigned int words, int hashes)
+               : nsBits(new unsigned int[words]()), nsWords(words),
+                 nsMask(words*32-1), nsHash(hashes) {}
+
+/******************************************************************************/
+
+XrdCmsNSFilter::XrdCmsNSFilter(const XrdCmsNSFilter &rhs)
+               : nsBits(new unsigned int[rhs.nsWords]), nsWords(rhs.nsWords),
+                 nsMask(rhs.nsMask), nsHash(rhs.nsHash)
+{
+   memcpy(nsBits, rhs.nsBits, nsWords*sizeof(unsigned int));
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+
+// Bits are only ever set. They are set and tested one word at a time without
+// tearing so that a selection may test a filter while a path is being added.
+//
+void XrdCmsNSFilter::Add(unsigned int h1, unsigned int h2)
+{
+   unsigned int bnum;
+
+   for (int i = 0; i < nsHash; i++)
+       {bnum = (h1 + i*h2) & nsMask;
+        __atomic_fetch_or(&nsBits[bnum >> 5], 1U << (bnum & 31),
+                          __ATOMIC_RELAXED);
+       }
+}
+
+/******************************************************************************/
+/*                                  H a s h                                   */
+/******************************************************************************/
+
+// The first hash is a CRC32, as used for location cache keys, the second one is
+// an FNV-1a hash which is forced to be odd so that the bit positions derived
+// from the two all differ.
+//
+void XrdCmsNSFilter::Hash(const char *Path, int Plen,
+                          unsigned int &h1, unsigned int &h2)
+{
+   const unsigned char *pP = (const unsigned char *)Path;
+   unsigned int hval = 2166136261U;
+
+   h1 = XrdOucCRC::CRC32(pP, Plen);
+   for (int i = 0; i < Plen; i++) {hval ^= pP[i]; hval *= 16777619U;}
+   h2 = hval | 1;
+}
+
+/******************************************************************************/
+/*                               i s C a n o n                                */
+/******************************************************************************/
+
+bool XrdCmsNSFilter::isCanon(const char *Path)
+{
+   const char *pP = Path;
+
+// The path must be absolute and must not end with a slash
+//
+   if (*pP != '/' || !*(pP+1)) return false;
+
+// Each component must be a real name (i.e. not empty, dot, or dot-dot)
+//
+   while(*pP == '/')
+        {pP++;
+         if (*pP == '/' || !*pP) return false;
+         if (*pP == '.' && (*(pP+1) == '/' || !*(pP+1)
+         ||  (*(pP+1) == '.' && (*(pP+2) == '/' || !*(pP+2))))) return false;
+         while(*pP && *pP != '/') pP++;
+        }
+   return true;
+}
+
+/******************************************************************************/
+/*                                 M a y b e                                  */
+/******************************************************************************/
+
+bool XrdCmsNSFilter::Maybe(unsigned int h1, unsigned int h2)
+{
+   unsigned int bnum;
+
+   for (int i = 0; i < nsHash; i++)
+       {bnum = (h1 + i*h2) & nsMask;
+        if (!(__atomic_load_n(&nsBits[bnum >> 5], __ATOMIC_RELAXED)
+            & (1U << (bnum & 31)))) return false;
+       }
+   return true;
+}
+
+/******************************************************************************/
+/*                                   S e t                                    */
+/******************************************************************************/
+
+void XrdCmsNSFilter::Set(unsigned int Offs, unsigned int Count, const char *wP)
+{
+   unsigned int theWord;
+
+   for (unsigned int i = Offs; i < Offs+Count; i++)
+       {memcpy(&theWord, wP, sizeof(theWord)); wP += sizeof(theWord);
+        nsBits[i] = ntohl(theWord);
+       }
+}
+
+/******************************************************************************/
+/*                                  S i z e                                   */
+/******************************************************************************/
+
+unsigned int XrdCmsNSFilter::Size(long long nEnt, int bpe)
+{
+   long long nBits = nEnt * bpe;
+   unsigned int words = minWords;
+
+// The size is a power of two so that it rarely changes between generations
+//
+   while(words < maxWords && (long long)words*32 < nBits) words <<= 1;
+   return words;
+}
+
+/******************************************************************************/
+/*                     C l a s s   X r d C m s N S S u m                      */
+/******************************************************************************/
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+
+void XrdCmsNSSum::Add(const char *Path)
+{
+   unsigned int h1, h2;
+
+// Record the path in the current filter and, if a walk is in progress, in the
+// next one as the walk may have already passed its directory.
+//
+   if (!Every || !XrdCmsNSFilter::isCanon(Path)) return;
+   XrdCmsNSFilter::Hash(Path, strlen(Path), h1, h2);
+   myMutex.Lock();
+   if (curFilt) curFilt->Add(h1, h2);
+   if (inWalk)  addHash(h1, h2);
+   myMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                  S e n d                                   */
+/******************************************************************************/
+
+void XrdCmsNSSum::Send(XrdCmsNode *nP)
+{
+   EPNAME("NSSum");
+   static const int BSize = 8192;
+   static const int MinRoom = sizeof(CmsNSFiltRun) + 16*sizeof(unsigned int);
+   static const int Fixed = sizeof(CmsNSFiltRequest) - sizeof(CmsRRHdr);
+   CmsNSFiltRequest nsReq;
+   CmsNSFiltRun     nsRun;
+   struct iovec     ioV[2];
+   char buff[BSize], *bP = buff, *bEnd = buff + BSize;
+   unsigned int *cwP, *owP = 0, theWord, words, theGen, i, j, n, room;
+   int hashes, rc = 0;
+
+// Nothing to send if the node is up to date or we have nothing
+//
+   myMutex.Lock();
+   if (!curFilt || nP->nsGen == curGen) {myMutex.UnLock(); return;}
+
+// If the node has the previous generation we can just send the words that
+// changed since then. Otherwise, the whole filter is sent. The filters are
+// copied so that the lock is not held while the manager is being written to.
+//
+   words = curFilt->Words(); hashes = curFilt->Hashes(); theGen = curGen;
+   cwP = new unsigned int[words];
+   memcpy(cwP, curFilt->Bits(), words*sizeof(unsigned int));
+   if (nP->nsGen && nP->nsGen+1 == curGen && oldFilt
+   &&  oldFilt->Words() == words && oldFilt->Hashes() == hashes)
+      {owP = new unsigned int[words];
+       memcpy(owP, oldFilt->Bits(), words*sizeof(unsigned int));
+      }
+   myMutex.UnLock();
+
+// Construct the fixed part of the request
+//
+   memset(&nsReq, 0, sizeof(nsReq));
+   nsReq.Hdr.rrCode   = kYR_nsfilt;
+   nsReq.Hdr.modifier = kYR_raw | CmsNSFiltRequest::kYR_nsfirst;
+   nsReq.Gen          = htonl(theGen);
+   nsReq.Base         = htonl(owP ? theGen-1 : 0);
+   nsReq.Words        = htonl(words);
+   nsReq.Hashes       = static_cast<kXR_char>(hashes);
+   ioV[0].iov_base = (char *)&nsReq; ioV[0].iov_len = sizeof(nsReq);
+   ioV[1].iov_base = buff;
+
+// Send the filter as runs of words. The last request is always sent as it
+// tells the node to start using the new generation.
+//
+   i = 0;
+   do {if (owP) while(i < words && cwP[i] == owP[i]) i++;
+       if (i < words)
+          {room = (bEnd - bP - sizeof(nsRun)) / sizeof(unsigned int);
+           for (j = i+1; j < words && j-i < room; j++)
+               if (owP && cwP[j] == owP[j]) break;
+           nsRun.Offs  = htonl(i);
+           nsRun.Count = htonl(j-i);
+           memcpy(bP, &nsRun, sizeof(nsRun)); bP += sizeof(nsRun);
+           for (n = i; n < j; n++)
+               {theWord = htonl(cwP[n]);
+                memcpy(bP, &theWord, sizeof(theWord)); bP += sizeof(theWord);
+               }
+           i = j;
+          }
+       if (i >= words || bEnd - bP < MinRoom)
+          {if (i >= words) nsReq.Hdr.modifier |= CmsNSFiltRequest::kYR_nslast;
+           nsReq.Hdr.datalen = htons(static_cast<unsigned short>
+                                    (Fixed + (bP - buff)));
+           ioV[1].iov_len = bP - buff;
+           if ((rc = nP->Send(ioV, 2, sizeof(nsReq) + (bP - buff))) < 0)
+              break;
+           nsReq.Hdr.modifier &= ~CmsNSFiltRequest::kYR_nsfirst;
+           bP = buff;
+          }
+      } while(i < words);
+
+// If all went well the node now has this generation
+//
+   if (rc >= 0)
+      {DEBUG(nP->Name() <<" gen " <<theGen <<(owP ? " update" : " full"));
+       nP->nsGen = theGen;
+      }
+   delete [] cwP;
+   if (owP) delete [] owP;
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+void *XrdCmsNSSum::Start()
+{
+   static const int nsTick = 15;
+   time_t nextWalk = 0;
+
+// Walk the name space every so often and bring managers up to date. Managers
+// that newly logged in are given the current filter within a tick.
+//
+   while(1)
+        {if (time(0) >= nextWalk)
+            {if (!Build())
+                Say.Emsg("NSSum", "Name space walk failed; filter not updated.");
+             nextWalk = time(0) + Every;
+            }
+         XrdCmsManager::Inform(*this);
+         XrdSysTimer::Snooze(nsTick);
+        }
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                               a d d H a s h                                */
+/******************************************************************************/
+
+// The caller must hold myMutex. Should we run out of memory the walk is
+// marked as incomplete as a filter that misses a path must never be used.
+//
+void XrdCmsNSSum::addHash(unsigned int h1, unsigned int h2)
+{
+   if (hNum >= hMax)
+      {int newMax = (hMax ? hMax*2 : 65536);
+       unsigned int *newVec;
+       if (!(newVec = (unsigned int *)realloc(hVec, newMax*sizeof(int))))
+          {if (!hLost) Say.Emsg("NSSum", ENOMEM, "record name space");
+           hLost = true; return;
+          }
+       hVec = newVec; hMax = newMax;
+      }
+   hVec[hNum++] = h1; hVec[hNum++] = h2;
+}
+
+/******************************************************************************/
+/*                                 B u i l d                                  */
+/******************************************************************************/
+
+bool XrdCmsNSSum::Build()
+{
+   EPNAME("NSSum");
+   XrdCmsNSFilter *newFilt;
+   XrdCmsPList *pP, *xP;
+   const char *pPath, *xPath;
+   int n, hashes;
+   bool aOK = true;
+
+// Start collecting path hashes
+//
+   myMutex.Lock(); hNum = 0; hLost = false; inWalk = true; myMutex.UnLock();
+
+// Walk each exported path unless it is covered by another exported path
+//
+   for (pP = Config.PathList.First(); pP && aOK; pP = pP->Next())
+       {pPath = pP->Path();
+        for (xP = Config.PathList.First(); xP; xP = xP->Next())
+            {if (xP == pP) continue;
+             xPath = xP->Path(); n = strlen(xPath);
+             if (n && !strncmp(pPath, xPath, n)
+             &&  (xPath[n-1] == '/' || pPath[n] == '/' || !pPath[n])) break;
+            }
+        if (!xP) aOK = Walk(pPath);
+       }
+
+// Build the new filter from the collected hashes and make it current. The
+// number of bits set per path is optimal for the number of bits per path.
+//
+   myMutex.Lock();
+   inWalk = false;
+   if (hLost) aOK = false;
+   if (aOK)
+      {hashes = (BitsPer*693+500)/1000;
+       if (hashes < 1) hashes = 1;
+          else if (hashes > XrdCmsNSFilter::maxHash)
+                   hashes = XrdCmsNSFilter::maxHash;
+       newFilt = new XrdCmsNSFilter(XrdCmsNSFilter::Size(hNum/2, BitsPer),
+                                    hashes);
+       for (n = 0; n < hNum; n += 2) newFilt->Add(hVec[n], hVec[n+1]);
+       if (oldFilt) delete oldFilt;
+       oldFilt = curFilt; curFilt = newFilt; curGen++;
+       DEBUG("gen " <<curGen <<' ' <<hNum/2 <<" paths in "
+                    <<newFilt->Words() <<" words");
+      }
+   if (hVec) {free(hVec); hVec = 0;}
+   hNum = hMax = 0;
+   myMutex.UnLock();
+   return aOK;
+}
+
+/******************************************************************************/
+/*                                  W a l k                                   */
+/******************************************************************************/
+
+bool XrdCmsNSSum::Walk(const char *lfn)
+{
+   static const int nsOpts = XrdOucNSWalk::Recurse | XrdOucNSWalk::retDir
+                           | XrdOucNSWalk::retFile | XrdOucNSWalk::noPath
+                           | XrdOucNSWalk::skpErrs;
+   XrdOucNSWalk::NSEnt *nP, *fP;
+   const char *dPath;
+   char pfnBuff[XrdCmsMAX_PATH_LEN+1], lfnBuff[XrdCmsMAX_PATH_LEN+1];
+   unsigned int h1, h2;
+   int n, rc;
+
+// Get the physical name of the exported path
+//
+   if ((rc = Config.GenLocalPath(lfn, pfnBuff)))
+      {Say.Emsg("NSSum", -rc, "determine pfn for export", lfn);
+       return false;
+      }
+
+// Record the exported directory itself
+//
+   n = strlen(lfn);
+   while(n > 1 && lfn[n-1] == '/') n--;
+   XrdCmsNSFilter::Hash(lfn, n, h1, h2);
+   myMutex.Lock(); addHash(h1, h2); myMutex.UnLock();
+
+// Record everything below it. Entries we cannot get to are skipped as they
+// cannot be served either. A name too long to be recorded makes the walk
+// incomplete as the filter would otherwise miss it.
+//
+   XrdOucNSWalk nsWalk(0, pfnBuff, 0, nsOpts);
+   while((nP = nsWalk.Index(rc, &dPath)))
+        {if (!Config.lcl_N2N) rc = (strlcpy(lfnBuff, dPath, sizeof(lfnBuff))
+                                    >= sizeof(lfnBuff) ? ENAMETOOLONG : 0);
+            else rc = Config.lcl_N2N->pfn2lfn(dPath,lfnBuff,sizeof(lfnBuff));
+         if (rc)
+            {Say.Emsg("NSSum", rc, "determine lfn for", dPath);
+             while((fP = nP)) {nP = nP->Next; delete fP;}
+             return false;
+            }
+         n = strlen(lfnBuff);
+         if (!n || lfnBuff[n-1] != '/') lfnBuff[n++] = '/';
+         myMutex.Lock();
+         while((fP = nP))
+              {if (n + fP->Plen < (int)sizeof(lfnBuff))
+                  {strcpy(lfnBuff+n, fP->File);
+                   XrdCmsNSFilter::Hash(lfnBuff, n + fP->Plen, h1, h2);
+                   addHash(h1, h2);
+                  } else {
+                   Say.Emsg("NSSum", ENAMETOOLONG, "record an entry in", dPath);
+                   hLost = true;
+                  }
+               nP = nP->Next; delete fP;
+              }
+         myMutex.UnLock();
+        }
+   return true;
+}
@@ -0,0 +1,159 @@
+#ifndef __CMS_NSFILTER__H
+#define __CMS_NSFILTER__H
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d C m s N S F i l t e r . h h                      */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <string.h>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdCmsNode;
+
+/******************************************************************************/
+/*                  C l a s s   X r d C m s N S F i l t e r                   */
+/******************************************************************************/
+
+// A Bloom filter of logical file names. A path that was added is always
+// found but a path that was not added may be found as well (false positive).
+// As the filter lags behind the name space, a miss is a hint and not a proof.
+//
+class XrdCmsNSFilter
+{
+public:
+
+// Add() records a path (two forms; the second uses the result of Hash())
+//
+inline void          Add(const char *Path, int Plen=0)
+                        {unsigned int h1, h2;
+                         Hash(Path, (Plen ? Plen : strlen(Path)), h1, h2);
+                         Add(h1, h2);
+                        }
+
+       void          Add(unsigned int h1, unsigned int h2);
+
+inline unsigned int *Bits()   {return nsBits;}
+
+// Hash() computes the two hashes from which all the bit positions are derived
+//
+static void          Hash(const char *Path, int Plen,
+                          unsigned int &h1, unsigned int &h2);
+
+inline int           Hashes() {return nsHash;}
+
+// isCanon() returns true if the path is in a form that a name space walk would
+//           produce. Only such paths may be looked up.
+//
+static bool          isCanon(const char *Path);
+
+// Maybe() returns false if the path was certainly never added
+//
+       bool          Maybe(unsigned int h1, unsigned int h2);
+
+// Set() replaces words starting at Offs with ones in network byte order
+//
+       void          Set(unsigned int Offs, unsigned int Count, const char *wP);
+
+// Size() returns the number of words needed for nEnt paths at bpe bits each
+//
+static unsigned int  Size(long long nEnt, int bpe);
+
+inline unsigned int  Words()  {return nsWords;}
+
+static const int          maxHash  = 16;
+static const unsigned int maxWords = 1 << 23;  // 256M bits (32MB)
+static const unsigned int minWords = 1 << 11;  //  64K bits  (8KB)
+
+       XrdCmsNSFilter(unsigned int words, int hashes);
+       XrdCmsNSFilter(const XrdCmsNSFilter &rhs);
+      ~XrdCmsNSFilter() {delete [] nsBits;}
+
+private:
+XrdCmsNSFilter &operator=(const XrdCmsNSFilter &rhs);
+
+unsigned int *nsBits;
+unsigned int  nsWords;
+unsigned int  nsMask;   // Bit number mask (nsWords*32-1)
+int           nsHash;
+};
+
+/******************************************************************************/
+/*                     C l a s s   X r d C m s N S S u m                      */
+/******************************************************************************/
+
+// This a single-instance global class used by data servers to summarize their
+// exported name space and send the summary to managers that accept it.
+//
+class XrdCmsNSSum
+{
+public:
+
+// Add() records a path that was newly created
+//
+void        Add(const char *Path);
+
+// Send() sends the current filter to a manager node that must be locked. Only
+//        the words that changed since the generation it has are sent.
+//
+void        Send(XrdCmsNode *nP);
+
+// Start() is always run as a separate thread that periodically walks the name
+//         space and informs all managers about it.
+//
+void       *Start();
+
+int         Every;      // Seconds between name space walks (0 -> none)
+int         BitsPer;    // Filter bits per path
+
+            XrdCmsNSSum() : Every(0), BitsPer(10), curFilt(0), oldFilt(0),
+                            hVec(0), hNum(0), hMax(0), curGen(0), hLost(false),
+                            inWalk(false)
+                            {}
+           ~XrdCmsNSSum() {} // This object should never be deleted
+
+private:
+void        addHash(unsigned int h1, unsigned int h2);
+bool        Build();
+bool        Walk(const char *lfn);
+
+XrdSysMutex     myMutex;
+XrdCmsNSFilter *curFilt;    // Filter of the current  generation
+XrdCmsNSFilter *oldFilt;    // Filter of the previous generation
+unsigned int   *hVec;       // Hash pairs collected by a walk
+int             hNum;
+int             hMax;
+unsigned int    curGen;
+bool            hLost;      // A hash could not be recorded
+bool            inWalk;
+};
+
+namespace XrdCms
+{
+extern    XrdCmsNSSum NSSum;
+}
+#endif
@@ -52,12 +52,16 @@
 #include "XrdCms/XrdCmsPrepare.hh"
 #include "XrdCms/XrdCmsRRData.hh"
 #include "XrdCms/XrdCmsNode.hh"
+#include "XrdCms/XrdCmsNSFilter.hh"
 #include "XrdCms/XrdCmsSelect.hh"
 #include "XrdCms/XrdCmsState.hh"
+#include "XrdCms/XrdCmsTelemetry.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 
 #include "XrdOss/XrdOss.hh"
 
+#include "XrdOuc/XrdOuca2x.hh"
+#include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucName2Name.hh"
 #include "XrdOuc/XrdOucProg.hh"
 #include "XrdOuc/XrdOucPup.hh"
@@ -97,11 +101,10 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
                        int port, int lvl, int id) : nodeMutex(0, "nodeCV")
 {
     static XrdSysMutex   iMutex;
-    static const SMask_t smask_1(1);
     static int           iNum = 1;
 
     Link     =  lnkp;
-    NodeMask =  (id < 0 ? 0 : smask_1 << id);
+    NodeMask =  (id < 0 ? SMask_t(0) : SMask_t::Bit(id));
     NodeID   = id;
     cidP     =  0;
     hasNet   =  0;
@@ -114,13 +117,23 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
     isPerm   =  0;
     isMan    =  0;
     isKnown  =  0;
+    canBatch =  0;
+    nsAccept =  0;
+    nsGen    =  0;
+    nsFilt   =  0;
+    nsNext   =  0;
+    nsNGen   =  0;
     isPeer   =  0;
     incUL    =  0;
     myCost   =  0;
     myLoad   =  0;
     myMass   =  0;
+    SvcTime  =  0;
+    InFlight =  0;
+    LatRefs  =  0;
     DiskTotal=  0;
     DiskFree =  0;
+    DiskRsvd =  0;
     DiskMinF =  0;
     DiskNums =  0;
     DiskUtil =  0;
@@ -173,6 +186,8 @@ XrdCmsNode::~XrdCmsNode()
 // Delete other appendages
 //
    if (cidP) {cidP->RemNode(this); cidP = 0;}
+   if (nsFilt) delete nsFilt;
+   if (nsNext) delete nsNext;
    if (Ident) free(Ident);
    if (myNID) free(myNID);
    if (myName)free(myName);
@@ -342,6 +357,7 @@ const char *XrdCmsNode::do_Avail(XrdCmsRRData &Arg)
 //
    DiskFree = Arg.dskFree;
    DiskUtil = static_cast<int>(Arg.dskUtil);
+   DiskRsvd = DiskRsvd / 2;
 
 // Do some debugging
 //
@@ -463,11 +479,34 @@ const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
    XrdCmsPInfo  pinfo;
    int isnew, Opts;
 
+// A batched response is handled as a sequence of individual responses
+//
+   if (Arg.Request.modifier & CmsHaveRequest::Batch)
+      {char *bP = Arg.Buff, *bEnd = Arg.Buff + Arg.Dlen, *oBuff = Arg.Buff;
+       int   oDlen = Arg.Dlen;
+       while(getBatch(Arg, bP, bEnd))
+            {Arg.Request.modifier |= kYR_raw;
+             Arg.Buff = Arg.Path;
+             do_Have(Arg);
+            }
+       Arg.Buff = oBuff; Arg.Dlen = oDlen;
+       return 0;
+      }
+
 // Do some debugging
 //
    TRACER(Files, (Arg.Request.modifier&CmsHaveRequest::Pending ? "P ":"") 
                  <<Arg.Path);
 
+// Record the file in the name space filter of the node, if it sent us one
+//
+   if (nsFilt || nsNext)
+      {nsMutex.Lock();
+       if (nsFilt) nsFilt->Add(Arg.Path);
+       if (nsNext) nsNext->Add(Arg.Path);
+       nsMutex.UnLock();
+      }
+
 // Find if we can handle the file in r/w mode and if staging is present
 //
    Opts = (Cache.Paths.Find(Arg.Path, pinfo) && (pinfo.rwvec & NodeMask)
@@ -529,11 +568,25 @@ const char *XrdCmsNode::do_Load(XrdCmsRRData &Arg)
    DiskFree = Arg.dskFree;
    DiskUtil = pdsk;
 
+// Each report reflects some of the data written since the last one so release
+// half of the space reserved by write selections made in the mean time.
+//
+   DiskRsvd = DiskRsvd / 2;
+
+// Record the service time and queue depth, if reported. Redirections made
+// since the last report are now accounted for in the reported queue depth.
+//
+   SvcTime  = static_cast<int>(Arg.svcTime);
+   InFlight = static_cast<int>(Arg.inFlight);
+   LatRefs  = 0;
+   Arg.svcTime = Arg.inFlight = 0;
+
 // Do some debugging
 //
    DEBUGR("cpu=" <<pcpu <<" net=" <<pnet <<" xeq=" <<pxeq
        <<" mem=" <<pmem <<" pag=" <<ppag <<" dsk=" <<pdsk
-       <<"% " <<DiskFree <<"MB load=" <<myLoad <<" mass=" <<myMass);
+       <<"% " <<DiskFree <<"MB load=" <<myLoad <<" mass=" <<myMass
+       <<" svc=" <<SvcTime <<"ms inq=" <<InFlight);
 
 // If we are also a manager then use this load figure to come up with
 // an overall load to report when asked. If we get free space, then we
@@ -541,6 +594,7 @@ const char *XrdCmsNode::do_Load(XrdCmsRRData &Arg)
 //
    if (Config.asManager())
       {Meter.Record(pcpu, pnet, pxeq, pmem, ppag, pdsk);
+       Meter.Record(SvcTime, InFlight);
        if (isRW && DiskFree != LastFree)
           {mlMutex.Lock();
            temp = LastFree; LastFree = DiskFree; Meter.setVirtUpdt();
@@ -592,6 +646,7 @@ const char *XrdCmsNode::do_Locate(XrdCmsRRData &Arg)
    char eBuff[128], theopts[8], *toP = theopts;
    XrdCmsCluster::CmsLSOpts lsopts = XrdCmsCluster::LS_NULL;
    XrdNetIF::ifType ifType;
+   unsigned int tBeg = XrdCmsTelemetry::Now();
    int rc, bytes;
    bool lsuniq = false, oksel = false, lsall = (*Arg.Path == '*');
 
@@ -697,6 +752,7 @@ const char *XrdCmsNode::do_Locate(XrdCmsRRData &Arg)
    Arg.Request.datalen = htons(bytes);
    ioV[1].iov_len      = bytes;
    Link->Send(ioV, 2, bytes+sizeof(Arg.Request));
+   Telemetry.Latency(true, tBeg);
    return 0;
 }
 
@@ -883,6 +939,80 @@ const char *XrdCmsNode::do_Mv(XrdCmsRRData &Arg)
    return (rc ? fsFail(Arg.Ident, "mv", Arg.Path, rc) : 0);
 }
 
+/******************************************************************************/
+/*                             d o _ N S F i l t                              */
+/******************************************************************************/
+  
+// Name space filters are local to the cell and never propagated. A filter is
+// assembled from one or more requests and only used once it is complete. A
+// request that cannot be applied is ignored as is the rest of the filter; the
+// previous filter remains in use as it is still valid.
+//
+const char *XrdCmsNode::do_NSFilt(XrdCmsRRData &Arg)
+{
+   EPNAME("do_NSFilt")
+   static const int Fixed = sizeof(CmsNSFiltRequest) - sizeof(CmsRRHdr);
+   CmsNSFiltRequest nsReq;
+   CmsNSFiltRun     nsRun;
+   XrdCmsNSFilter  *nsF;
+   char *bP = Arg.Buff, *bEnd = Arg.Buff + Arg.Dlen;
+   unsigned int Gen, Base, Words, Offs, Count;
+
+// Extract the fixed part of the request and validate it
+//
+   if (Arg.Dlen < Fixed) return "invalid nsfilt request";
+   memcpy(&nsReq.Gen, bP, Fixed); bP += Fixed;
+   Gen   = ntohl(nsReq.Gen);
+   Base  = ntohl(nsReq.Base);
+   Words = ntohl(nsReq.Words);
+   if (Words < XrdCmsNSFilter::minWords || Words > XrdCmsNSFilter::maxWords
+   ||  (Words & (Words-1)) || !nsReq.Hashes
+   ||  nsReq.Hashes > XrdCmsNSFilter::maxHash) return "invalid nsfilt request";
+
+// The first request starts a new filter, either empty or as a copy of the one
+// in use if it is of the generation being updated.
+//
+   nsMutex.Lock();
+   if (Arg.Request.modifier & CmsNSFiltRequest::kYR_nsfirst)
+      {if (nsNext) {delete nsNext; nsNext = 0;}
+       if (!Base) nsNext = new XrdCmsNSFilter(Words, nsReq.Hashes);
+          else if (nsFilt && nsGen == Base && nsFilt->Words() == Words
+               &&  nsFilt->Hashes() == nsReq.Hashes)
+                  nsNext = new XrdCmsNSFilter(*nsFilt);
+          else {nsMutex.UnLock();
+                DEBUGR("gen " <<Gen <<" ignored; base " <<Base <<" not held");
+                return 0;
+               }
+       nsNGen = Gen;
+      } else if (!nsNext || nsNGen != Gen) {nsMutex.UnLock(); return 0;}
+
+// Apply each run of words
+//
+   while(bEnd - bP >= (int)sizeof(nsRun))
+        {memcpy(&nsRun, bP, sizeof(nsRun)); bP += sizeof(nsRun);
+         Offs  = ntohl(nsRun.Offs);
+         Count = ntohl(nsRun.Count);
+         if (Offs >= Words || Count > Words - Offs
+         ||  Count > (unsigned int)(bEnd - bP) / sizeof(unsigned int))
+            {delete nsNext; nsNext = 0;
+             nsMutex.UnLock();
+             return "invalid nsfilt run";
+            }
+         nsNext->Set(Offs, Count, bP);
+         bP += Count * sizeof(unsigned int);
+        }
+
+// If this is the last request, start using the new filter
+//
+   if (Arg.Request.modifier & CmsNSFiltRequest::kYR_nslast)
+      {nsF = nsNext; nsNext = 0;
+       Cluster.setNSFilter(this, nsF, Gen);
+       DEBUGR("gen " <<Gen <<(Base ? " update" : " full") <<" in use");
+      }
+   nsMutex.UnLock();
+   return 0;
+}
+
 /******************************************************************************/
 /*                               d o _ P i n g                                */
 /******************************************************************************/
@@ -1112,6 +1242,7 @@ const char *XrdCmsNode::do_Select(XrdCmsRRData &Arg)
    struct iovec ioV[2];
    char theopts[16], *toP = theopts;
    XrdNetIF::ifType ifType;
+   unsigned int tBeg = XrdCmsTelemetry::Now();
    int rc, bytes;
 
 // Init select data (note that refresh supresses fast redirects)
@@ -1151,6 +1282,20 @@ const char *XrdCmsNode::do_Select(XrdCmsRRData &Arg)
         }
    *toP = '\0';
 
+// If data will be written, see if the client told us how much (oss.asize)
+//
+   if ((Sel.Opts & XrdCmsSelect::Write) && !(Sel.Opts & XrdCmsSelect::isMeta)
+   &&  Arg.Opaque && strstr(Arg.Opaque, "oss.asize="))
+      {XrdOucEnv selEnv(Arg.Opaque);
+       const char *asz = selEnv.Get("oss.asize");
+       long long aSize;
+       if (asz && !XrdOuca2x::a2sz(Say, "invalid oss.asize", asz, &aSize, 0))
+          {aSize = (aSize + 1048575LL) >> 20LL;
+           Sel.ASize = (aSize > 0x3fffffffLL ? 0x3fffffff
+                                             : static_cast<int>(aSize));
+          }
+      }
+
 // If the client can override selection mode, check if this has been done. Note
 // that true packed selection turns off fast redirect.
 //
@@ -1218,6 +1363,7 @@ const char *XrdCmsNode::do_Select(XrdCmsRRData &Arg)
 // Send back the response
 //
    Link->Send(ioV, 2, bytes+sizeof(Arg.Request));
+   Telemetry.Latency(false, tBeg);
    return 0;
 }
   
@@ -1339,7 +1485,12 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
 {
    EPNAME("do_State")
    struct iovec xmsg[2];
-   int rc, noResp = Arg.Request.modifier & CmsStateRequest::kYR_noresp;
+   int noResp = Arg.Request.modifier & CmsStateRequest::kYR_noresp;
+
+// Batched queries are answered with a single batched response
+//
+   if (Arg.Request.modifier & CmsStateRequest::kYR_batch)
+      return do_StateBatch(Arg);
 
 // Do some debugging
 //
@@ -1349,21 +1500,7 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
 // Respond: have <path>
 //
    isKnown = 1;
-
-// If we are a manager then check for the file in the local cache. Otherwise,
-// ask the underlying filesystem whether it has the file.
-//
-        if (isMan) {if(!(Arg.Request.modifier = do_StateFWD(Arg))) return 0;}
-   else if (!Config.DiskOK && !Config.asProxy()) return 0;
-   else if (baseFS.Limit() && Arg.Request.modifier&CmsStateRequest::kYR_metaman)
-           {XrdCmsPInfo pinfo;
-            pinfo.rovec = NodeMask;
-            if ((rc = baseFS.Exists(Arg,pinfo)) > 0) Arg.Request.modifier = rc;
-               else return 0;
-           }
-   else     if ((rc = baseFS.Exists(Arg.Path, -(Arg.PathLen-1))) > 0)
-                Arg.Request.modifier = rc;
-   else     return 0;
+   if (!(Arg.Request.modifier = isHere(Arg))) return 0;
 
 // Respond appropriately
 //
@@ -1380,6 +1517,59 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
    return 0;
 }
   
+/******************************************************************************/
+/*                         d o _ S t a t e B a t c h                          */
+/******************************************************************************/
+
+const char *XrdCmsNode::do_StateBatch(XrdCmsRRData &Arg)
+{
+   EPNAME("do_StateBatch")
+   CmsRRHdr haveHdr = {0, kYR_have, kYR_raw | CmsHaveRequest::Batch, 0};
+   CmsBatchEntry hEnt;
+   struct iovec xmsg[2];
+   char *bP = Arg.Buff, *bEnd = Arg.Buff + Arg.Dlen, *rP = Arg.Buff;
+   char *oBuff = Arg.Buff;
+   int   rc, oDlen = Arg.Dlen;
+
+// Process: state <batch>
+// Respond: have  <batch>
+//
+   isKnown = 1;
+
+// Each path is handled as if it came in its own request. Found paths are
+// compacted into the front of the request buffer, which becomes the response.
+// The buffer is hidden from the paths so that a deferred query copies them.
+//
+   Arg.Buff = 0;
+   while(getBatch(Arg, bP, bEnd))
+        {TRACER(Files,Arg.Path);
+         if (Arg.Request.modifier & CmsStateRequest::kYR_noresp)
+            {isHere(Arg); continue;}
+         if (!(rc = isHere(Arg))) continue;
+         hEnt.Hash = Arg.Request.streamid;
+         hEnt.Mods = static_cast<kXR_char>(rc);
+         hEnt.Rsvd = 0;
+         hEnt.Plen = htons(static_cast<unsigned short>(Arg.PathLen));
+         memmove(rP+sizeof(hEnt), Arg.Path, Arg.PathLen);
+         memcpy(rP, &hEnt, sizeof(hEnt));
+         rP += sizeof(hEnt) + Arg.PathLen;
+        }
+   Arg.Buff = oBuff; Arg.Dlen = oDlen;
+
+// Respond with whatever we have
+//
+   if (rP != oBuff)
+      {DEBUGR("responding have for " <<(rP - oBuff) <<" bytes");
+       haveHdr.datalen  = htons(static_cast<unsigned short>(rP - oBuff));
+       xmsg[0].iov_base = (char *)&haveHdr;
+       xmsg[0].iov_len  = sizeof(haveHdr);
+       xmsg[1].iov_base = oBuff;
+       xmsg[1].iov_len  = rP - oBuff;
+       Link->Send(xmsg, 2);
+      }
+   return 0;
+}
+  
 /******************************************************************************/
 /*                           d o _ S t a t e D F S                            */
 /******************************************************************************/
@@ -1476,7 +1666,7 @@ int XrdCmsNode::do_StateFWD(XrdCmsRRData &Arg)
        if (!retc)
           {if (baseFS.Traverse())
               {Cache.AddFile(Sel, 0);
-               Cluster.Broadsend(pinfo.rovec, Arg.Request, Arg.Buff, Arg.Dlen);
+               Cluster.Broadsend(pinfo.rovec,Arg.Request,Arg.Path,Arg.PathLen);
                return 0;
               }
            if ((retc = baseFS.Exists(Arg, pinfo)) <= 0)
@@ -1498,8 +1688,8 @@ int XrdCmsNode::do_StateFWD(XrdCmsRRData &Arg)
 //
    if (!retc || Sel.Vec.bf != 0)
       {if (!retc) Cache.AddFile(Sel, 0);
-       Cluster.Broadcast((retc ? Sel.Vec.bf : pinfo.rovec), Arg.Request,
-                         (void *)Arg.Buff, Arg.Dlen);
+       Cluster.Query((retc ? Sel.Vec.bf : pinfo.rovec), Arg.Request,
+                     Arg.Path, Arg.PathLen);
       }
 
 // Return true if anyone has the file at this point. In shared-nothing systems
@@ -1776,6 +1966,22 @@ const char *XrdCmsNode::do_Usage(XrdCmsRRData &Arg)
    return 0;
 }
 
+/******************************************************************************/
+/*                               n s R e s e t                                */
+/******************************************************************************/
+  
+// A data server resends its full filter after it logs in again. In the mean
+// time, it may have created files it could not tell us about so the filter we
+// have can no longer be trusted.
+//
+void XrdCmsNode::nsReset()
+{
+   nsMutex.Lock();
+   if (nsNext) {delete nsNext; nsNext = 0;}
+   if (nsFilt) Cluster.setNSFilter(this, 0, 0);
+   nsMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                          R e p o r t _ U s a g e                           */
 /******************************************************************************/
@@ -1786,12 +1992,14 @@ void XrdCmsNode::Report_Usage(XrdLink *lp)   // Static!
    CmsLoadRequest myLoad = {{0, kYR_load, 0, 0}};
    struct iovec xmsg[2];
    char loadbuff[CmsLoadRequest::numLoad];
-   char respbuff[sizeof(loadbuff)+2+sizeof(int)+2], *bp = respbuff;
-   int  blen, maxfr, pcpu, pnet, pxeq, pmem, ppag, pdsk;
+   char respbuff[sizeof(loadbuff)+2+(sizeof(int)+2)*3], *bp = respbuff;
+   int  blen, maxfr, pcpu, pnet, pxeq, pmem, ppag, pdsk, psvc, pinf;
 
 // Respond: <id> load <cpu> <io> <load> <mem> <pag> <dskfree> <dskutil>
+//                   <svctime> <inflight>
 //
    maxfr = Meter.Report(pcpu, pnet, pxeq, pmem, ppag, pdsk);
+   Meter.Latency(psvc, pinf);
 
    loadbuff[CmsLoadRequest::cpuLoad] = static_cast<char>(pcpu);
    loadbuff[CmsLoadRequest::netLoad] = static_cast<char>(pnet);
@@ -1802,6 +2010,8 @@ void XrdCmsNode::Report_Usage(XrdLink *lp)   // Static!
 
    blen  = XrdOucPup::Pack(&bp, loadbuff, sizeof(loadbuff));
    blen += XrdOucPup::Pack(&bp, maxfr);
+   blen += XrdOucPup::Pack(&bp, psvc);
+   blen += XrdOucPup::Pack(&bp, pinf);
    myLoad.Hdr.datalen = htons(static_cast<unsigned short>(blen));
 
    xmsg[0].iov_base = (char *)&myLoad;
@@ -1814,7 +2024,8 @@ void XrdCmsNode::Report_Usage(XrdLink *lp)   // Static!
 // Do some debugging
 //
    DEBUG("cpu=" <<pcpu <<" net=" <<pnet <<" xeq=" <<pxeq
-      <<" mem=" <<pmem <<" pag=" <<ppag <<" dsk=" <<pdsk <<' ' <<maxfr);
+      <<" mem=" <<pmem <<" pag=" <<ppag <<" dsk=" <<pdsk <<' ' <<maxfr
+      <<" svc=" <<psvc <<"ms inq=" <<pinf);
 }
   
 /******************************************************************************/
@@ -1896,6 +2107,39 @@ const char *XrdCmsNode::fsFail(const char *Who,  const char *What,
    return rc ? XrdSysE2T(rc) : 0;
 }
 
+/******************************************************************************/
+/*                              g e t B a t c h                               */
+/******************************************************************************/
+
+// Extract the next entry of a batched request into Arg, advancing bP past it.
+
+bool XrdCmsNode::getBatch(XrdCmsRRData &Arg, char *&bP, char *bEnd)
+{
+   EPNAME("getBatch")
+   CmsBatchEntry bEnt;
+   int plen;
+
+// Make sure we have a complete entry with a null terminated path
+//
+   if (bP + sizeof(bEnt) > bEnd) return false;
+   memcpy(&bEnt, bP, sizeof(bEnt));
+   plen = ntohs(bEnt.Plen);
+   if (plen < 2 || bP + sizeof(bEnt) + plen > bEnd
+   ||  bP[sizeof(bEnt) + plen - 1])
+      {DEBUG("ignoring malformed batch entry");
+       return false;
+      }
+
+// Fill out the request as if it came in by itself
+//
+   Arg.Request.streamid = bEnt.Hash;
+   Arg.Request.modifier = bEnt.Mods;
+   Arg.Path    = bP + sizeof(bEnt);
+   Arg.PathLen = Arg.Dlen = plen;
+   bP += sizeof(bEnt) + plen;
+   return true;
+}
+
 /******************************************************************************/
 /*                               g e t M o d e                                */
 /******************************************************************************/
@@ -1923,3 +2167,28 @@ int XrdCmsNode::getSize(const char *theSize, long long &Size)
    if (!(Size = strtoll(theSize, &eP, 10)) || *eP) return 0;
    return 1;
 }
+
+/******************************************************************************/
+/*                                i s H e r e                                 */
+/******************************************************************************/
+
+// Return the have modifier for the path in Arg or zero if we don't have it.
+
+int XrdCmsNode::isHere(XrdCmsRRData &Arg)
+{
+   int rc;
+
+// If we are a manager then check for the file in the local cache. Otherwise,
+// ask the underlying filesystem whether it has the file.
+//
+        if (isMan) return do_StateFWD(Arg);
+   else if (!Config.DiskOK && !Config.asProxy()) return 0;
+   else if (baseFS.Limit() && Arg.Request.modifier&CmsStateRequest::kYR_metaman)
+           {XrdCmsPInfo pinfo;
+            pinfo.rovec = NodeMask;
+            if ((rc = baseFS.Exists(Arg,pinfo)) > 0) return rc;
+           }
+   else     if ((rc = baseFS.Exists(Arg.Path, -(Arg.PathLen-1))) > 0)
+                return rc;
+   return 0;
+}
@@ -47,6 +47,7 @@ class XrdCmsBaseFS;
 class XrdCmsClustID;
 class XrdCmsDrop;
 class XrdCmsManager;
+class XrdCmsNSFilter;
 class XrdCmsPrepArgs;
 class XrdCmsRRData;
 class XrdCmsSelect;
@@ -74,6 +75,8 @@ public:
        char   RoleID;       //5 The converted XrdCmsRole::RoleID
        char   TimeZone;     //6 Time zone in +UTC-
        char   TZValid;      //7 Time zone has been set
+       char   canBatch;     //0 Set when node accepts batched state queries
+       char   nsAccept;     //1 Set when node accepts name space filters
 
 static const char isBlisted  = 0x01; // in isBad -> Node is black listed
 static const char isDisabled = 0x02; // in isBad -> Node is disable (internal)
@@ -87,8 +90,10 @@ unsigned int    DiskTotal;    // Total disk space in GB
          int    DiskNums;     // Number of file systems
          int    DiskMinF;     // Minimum MB needed for selection
          int    DiskFree;     // Largest free MB
+         int    DiskRsvd;     // MB reserved by write selections (decays)
          int    DiskUtil;     // Total disk utilization
 unsigned int    ConfigID;     // Configuration identifier
+unsigned int    nsGen;        // Name space filter generation sent or in use
 
 const  char  *do_Avail(XrdCmsRRData &Arg);
 const  char  *do_Chmod(XrdCmsRRData &Arg);
@@ -103,6 +108,7 @@ static int    do_LocFmt(char *buff, XrdCmsSelected *sP,
 const  char  *do_Mkdir(XrdCmsRRData &Arg);
 const  char  *do_Mkpath(XrdCmsRRData &Arg);
 const  char  *do_Mv(XrdCmsRRData &Arg);
+const  char  *do_NSFilt(XrdCmsRRData &Arg);
 const  char  *do_Ping(XrdCmsRRData &Arg);
 const  char  *do_Pong(XrdCmsRRData &Arg);
 const  char  *do_PrepAdd(XrdCmsRRData &Arg);
@@ -115,6 +121,7 @@ const  char  *do_Select(XrdCmsRRData &Arg);
 static int    do_SelPrep(XrdCmsPrepArgs &Arg);
 const  char  *do_Space(XrdCmsRRData &Arg);
 const  char  *do_State(XrdCmsRRData &Arg);
+const  char  *do_StateBatch(XrdCmsRRData &Arg);
 static void   do_StateDFS(XrdCmsBaseFR *rP, int rc);
        int    do_StateFWD(XrdCmsRRData &Arg);
 const  char  *do_StatFS(XrdCmsRRData &Arg);
@@ -135,7 +142,8 @@ inline int    Inst() {return Instance;}
 
        bool   inDomain() {return netIF.InDomain(&netID);}
 
-inline int    isNode(SMask_t smask) {return (smask & NodeMask) != 0;}
+inline int    isNode(const SMask_t &smask)
+                     {return NodeID >= 0 && smask.Test(NodeID);}
 
 inline int    isNode(const XrdNetAddr *addr) // Only for avoid processing!
                     {return netID.Same(addr);}
@@ -148,8 +156,21 @@ inline int    isNode(XrdLink *lp, const char *nid, int port)
                      return netID.Same(lp->NetAddr()) && port == netIF.Port();
                     }
 
+inline int    DiskLeft() {return (DiskRsvd < DiskFree ? DiskFree-DiskRsvd : 0);}
+
+// Reserve space for a write selection, the reservation saturates at 2**31-1 MB
+//
+inline void   DiskReserve(int mb)
+                    {long long n = static_cast<long long>(DiskRsvd)
+                                 + (mb > 0 ? mb : 0);
+                     DiskRsvd = (n < 0x7fffffffLL ? static_cast<int>(n)
+                                                  : 0x7fffffff);
+                    }
+
 inline char  *Name()   {return (myName ? myName : (char *)"?");}
 
+       void   nsReset();     // Discards any name space filter
+
 inline SMask_t Mask() {return NodeMask;}
 
 inline void    g2Ref(XrdSysMutex &gMutex) {lkCount++; gMutex.UnLock();}
@@ -233,8 +254,10 @@ static const int fsL2PFail2 = 999992;
        void  DeleteWarn(XrdSysMutex &gMutex, unsigned int &lkVal);
        int   fsExec(XrdOucProg *Prog, char *Arg1, char *Arg2=0);
 const  char *fsFail(const char *Who, const char *What, const char *Path, int rc);
+static bool  getBatch(XrdCmsRRData &Arg, char *&bP, char *bEnd);
        int   getMode(const char *theMode, mode_t &Mode);
        int   getSize(const char *theSize, long long &Size);
+       int   isHere(XrdCmsRRData &Arg);
 
 XrdSysCondVar      nodeMutex;
 unsigned int       lkCount;  // Only Modified with global lock held
@@ -264,6 +287,9 @@ int                logload;
 int                myCost;       // Overall cost (determined by location)
 int                myLoad;       // Overall load
 int                myMass;       // Overall load including space utilization
+int                SvcTime;      // Reported average service time (ms)
+int                InFlight;     // Reported number of requests in progress
+int                LatRefs;      // Redirections since the last load report
 int                RefW;         // Number of times used for writing
 int                RefTotW;
 int                RefR;         // Number of times used for redirection
@@ -276,6 +302,14 @@ char               Shrip;        // Share of requests to skip
 char               Rsvd[2];
 int                Shrin;        // Share intervals used
 
+// The following fields hold the name space filter sent by a data server. The
+// one in use is only replaced with the cluster's STMutex held as well.
+//
+XrdSysMutex        nsMutex;
+XrdCmsNSFilter    *nsFilt;       // Filter in use (guides selection)
+XrdCmsNSFilter    *nsNext;       // Filter being received
+unsigned int       nsNGen;       // Generation of the above
+
 // The following fields are used to keep the supervisor's free space value
 //
 static XrdSysMutex mlMutex;
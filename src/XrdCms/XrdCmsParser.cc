@@ -81,6 +81,47 @@ static char  *PupNVec[XrdCmsRRData::Arg_Count];
 
 };
 
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// getInt() extracts an unsigned int, either inline or following the type byte
+//
+inline bool getInt(const char *&bp, const char *bend, unsigned int &val)
+{
+   unsigned int n32;
+   const char  *dp;
+
+   if (bp+2 > bend || (*bp & PT_MaskT) != PT_int) return false;
+   dp = (*bp & PT_Inline ? bp : bp+1);
+   if (dp+sizeof(n32) > bend) return false;
+   memcpy(&n32, dp, sizeof(n32));
+   if (dp == bp) *(char *)&n32 &= PT_MaskD;
+   val = ntohl(n32);
+   bp  = dp + sizeof(n32);
+   return true;
+}
+
+// getStr() extracts a length prefixed string which is left in place. A zero
+//          length yields a nil pointer.
+//
+inline bool getStr(const char *&bp, const char *bend, char *&val, int &vlen)
+{
+   unsigned short n16;
+
+   if (bp+sizeof(n16) > bend || (*bp & PT_short)) return false;
+   memcpy(&n16, bp, sizeof(n16));
+   vlen = static_cast<int>(ntohs(n16));
+   bp  += sizeof(n16);
+   if (bp+vlen > bend) return false;
+   val  = (vlen ? (char *)bp : 0);
+   bp  += vlen;
+   return true;
+}
+}
+  
 /******************************************************************************/
 /*                        S t a t i c   O b j e c t s                         */
 /******************************************************************************/
@@ -111,6 +152,8 @@ XrdCmsParseInit XrdCmsParseArgN(XrdCmsRRData::Arg_Null,    "",
                                 XrdCmsRRData::Arg_Info,    "info",
                                 XrdCmsRRData::Arg_Port,    "port",
                                 XrdCmsRRData::Arg_SID,     "SID",
+                                XrdCmsRRData::Arg_svcTime, "svctime",
+                                XrdCmsRRData::Arg_inFlight,"inflight",
                                 0,                         (const char *)0
                                );
 
@@ -127,6 +170,10 @@ XrdOucPup      XrdCmsParser::Pup(&Say, &XrdCmsParser::PupName);
 //
 XrdOucPupArgs *XrdCmsParser::vecArgs[kYR_MaxReq] = {0};
 
+// Direct decoder array
+//
+XrdCmsParser::fastFunc XrdCmsParser::fastVec[kYR_MaxReq] = {0};
+
 // The actual parser object
 //
 XrdCmsParser   XrdCms::Parser;
@@ -220,12 +267,15 @@ XrdOucPupArgs XrdCmsParser::pthArgs[] =
 /*2*/         setPUP1(XrdCmsRRData::Arg_Datlen,EndFill,XrdCmsRRData, Request.datalen)
              };
 
-// load <cpu> <io> <load> <mem> <pag> <dut> <dsk>
+// load <cpu> <io> <load> <mem> <pag> <dut> <dsk> [<svctime> <inflight>]
 //      0     1    2      3     5     5
 XrdOucPupArgs XrdCmsParser::lodArgs[] =
 /*0*/        {setPUP1(XrdCmsRRData::Arg_theLoad, char, XrdCmsRRData, Opaque),
 /*1*/         setPUP1(XrdCmsRRData::Arg_dskFree, int,  XrdCmsRRData, dskFree),
-/*2*/         setPUP0(End)
+/*2*/         setPUP0(Fence),
+/*3*/         setPUP1(XrdCmsRRData::Arg_svcTime, int,  XrdCmsRRData, svcTime),
+/*4*/         setPUP1(XrdCmsRRData::Arg_inFlight,int,  XrdCmsRRData, inFlight),
+/*5*/         setPUP0(End)
              };
 
 XrdOucPupArgs XrdCmsParser::logArgs[] =
@@ -278,6 +328,16 @@ XrdCmsParser::XrdCmsParser()
        vecArgs[kYR_have]    =  pthArgs;
        vecArgs[kYR_load]    =  lodArgs;
        vecArgs[kYR_state]   =  pthArgs;
+
+       fastVec[kYR_locate]  =  fastLoc;
+       fastVec[kYR_select]  =  fastLoc;
+       fastVec[kYR_statfs]  =  fastPth;
+       fastVec[kYR_avail]   =  fastAvl;
+       fastVec[kYR_gone]    =  fastPth;
+       fastVec[kYR_try]     =  fastPth;
+       fastVec[kYR_have]    =  fastPth;
+       fastVec[kYR_load]    =  fastLod;
+       fastVec[kYR_state]   =  fastPth;
        Done = 1;
       }
 }
@@ -354,6 +414,106 @@ int XrdCmsParser::Decode(const char *Man, CmsRRHdr &hdr, XrdOucBuffer *dBuff,
    return Result;
 }
 
+/******************************************************************************/
+/*                               f a s t A v l                                */
+/******************************************************************************/
+
+// avail <dskFree> <dskUtil>
+//
+int XrdCmsParser::fastAvl(const char *bp, const char *bend, XrdCmsRRData *Data)
+{
+   unsigned int dFree, dUtil;
+
+   if (!getInt(bp, bend, dFree) || !getInt(bp, bend, dUtil)) return 0;
+
+   Data->dskFree = dFree;
+   Data->dskUtil = dUtil;
+   return 1;
+}
+
+/******************************************************************************/
+/*                               f a s t L o c                                */
+/******************************************************************************/
+
+// {locate, select} <id> <opts> <path> [<opq> [<avoid>]]
+//
+int XrdCmsParser::fastLoc(const char *bp, const char *bend, XrdCmsRRData *Data)
+{
+   char *Ident, *Path, *Opaque = 0, *Avoid = 0;
+   unsigned int Opts;
+   int   iLen, pLen, n;
+   bool  isAvoid = false;
+
+   if (!getStr(bp, bend, Ident, iLen) || !Ident
+   ||  !getInt(bp, bend, Opts)
+   ||  !getStr(bp, bend, Path,  pLen) || !Path) return 0;
+
+   if (bp != bend)
+      {if (!getStr(bp, bend, Opaque, n)) return 0;
+       if (bp != bend)
+          {if (!getStr(bp, bend, Avoid, n)) return 0;
+           isAvoid = true;
+          }
+      }
+
+   Data->Ident   = Ident;
+   Data->Opts    = Opts;
+   Data->Path    = Path;
+   Data->PathLen = pLen;
+   Data->Opaque  = Opaque;
+   if (isAvoid) Data->Avoid = Avoid;
+   return 1;
+}
+
+/******************************************************************************/
+/*                               f a s t L o d                                */
+/******************************************************************************/
+
+// load <load> <dskFree> [<svctime> [<inflight>]]
+//
+int XrdCmsParser::fastLod(const char *bp, const char *bend, XrdCmsRRData *Data)
+{
+   char *theLoad;
+   unsigned int dFree, sTime = 0, iFlight = 0;
+   int   n, xNum = 0;
+
+   if (!getStr(bp, bend, theLoad, n) || !theLoad
+   ||  !getInt(bp, bend, dFree)) return 0;
+
+   if (bp != bend)
+      {if (!getInt(bp, bend, sTime)) return 0;
+       xNum++;
+       if (bp != bend)
+          {if (!getInt(bp, bend, iFlight)) return 0;
+           xNum++;
+          }
+      }
+
+   Data->Opaque  = theLoad;
+   Data->dskFree = dFree;
+   if (xNum > 0) Data->svcTime  = sTime;
+   if (xNum > 1) Data->inFlight = iFlight;
+   return 1;
+}
+
+/******************************************************************************/
+/*                               f a s t P t h                                */
+/******************************************************************************/
+
+// {gone, have, state, statfs, try} <path>
+//
+int XrdCmsParser::fastPth(const char *bp, const char *bend, XrdCmsRRData *Data)
+{
+   char *Path;
+   int   pLen;
+
+   if (!getStr(bp, bend, Path, pLen) || !Path) return 0;
+
+   Data->Path    = Path;
+   Data->PathLen = pLen;
+   return 1;
+}
+
 /******************************************************************************/
 /*                              m a p E r r o r                               */
 /******************************************************************************/
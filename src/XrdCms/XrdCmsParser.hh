@@ -63,15 +63,31 @@ inline int            Parse(XrdCms::CmsLoginData *Data,
                                               (char *)Data);
                            }
 
+// Parse() uses a direct decoder for frequent requests. Should it reject the
+//         arguments, the generic unpacker is used to produce the diagnostic.
+//
 inline int            Parse(int rnum, const char *Aps, const char *Apt, 
                             XrdCmsRRData *Data)
                            {Data->Opaque = Data->Opaque2 = Data->Path = 0;
-                            return rnum < XrdCms::kYR_MaxReq 
-                                   && vecArgs[rnum] != 0
-                                   && Pup.Unpack(Aps, Apt,
-                                      vecArgs[rnum], (char *)Data);
+                            if (rnum >= XrdCms::kYR_MaxReq || !vecArgs[rnum])
+                               return 0;
+                            if (fastVec[rnum] && (*fastVec[rnum])(Aps,Apt,Data))
+                               return 1;
+                            return Pup.Unpack(Aps, Apt,
+                                              vecArgs[rnum], (char *)Data);
                            }
 
+// ParseSlow() always uses the generic unpacker (used for benchmarking).
+//
+inline int            ParseSlow(int rnum, const char *Aps, const char *Apt,
+                                XrdCmsRRData *Data)
+                               {Data->Opaque = Data->Opaque2 = Data->Path = 0;
+                                return rnum < XrdCms::kYR_MaxReq
+                                       && vecArgs[rnum] != 0
+                                       && Pup.Unpack(Aps, Apt,
+                                          vecArgs[rnum], (char *)Data);
+                               }
+
 static XrdOucPup      Pup;
 
 static XrdOucPupArgs *PupArgs(int rnum)
@@ -97,6 +113,18 @@ static XrdOucPupArgs  lodArgs[];  // load
 static XrdOucPupArgs  logArgs[];  // login
 
 static XrdOucPupArgs *vecArgs[XrdCms::kYR_MaxReq];
+
+// Direct decoders. Each one validates the whole argument list before setting
+// anything in Data and returns 0 if the arguments are not in the usual form.
+//
+typedef int (*fastFunc)(const char *, const char *, XrdCmsRRData *);
+
+static int            fastAvl(const char *, const char *, XrdCmsRRData *);
+static int            fastLoc(const char *, const char *, XrdCmsRRData *);
+static int            fastLod(const char *, const char *, XrdCmsRRData *);
+static int            fastPth(const char *, const char *, XrdCmsRRData *);
+
+static fastFunc       fastVec[XrdCms::kYR_MaxReq];
 };
 
 namespace XrdCms
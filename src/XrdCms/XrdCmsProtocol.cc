@@ -393,7 +393,7 @@ void XrdCmsProtocol::Pander(const char *manager, int mport)
 
       // Compute current login mode
       //
-      Mode = Role
+      Mode = Role | CmsLoginData::kYR_batchq
            | (CmsState.Suspended ? int(CmsLoginData::kYR_suspend) : 0)
            | (CmsState.NoStaging ? int(CmsLoginData::kYR_nostage) : 0);
        if (fails >= 6 && manp == manager) 
@@ -409,6 +409,8 @@ void XrdCmsProtocol::Pander(const char *manager, int mport)
        if (!(rc = XrdCmsLogin::Login(Link, Data, TimeOut)))
           {if (!Manager->ManTree->Connect(myNID, myNode)) KickedOut = 1;
              else {XrdOucEnv cgiEnv((const char *)Data.envCGI);
+                   myNode->nsAccept =
+                          (Data.Mode & CmsLoginData::kYR_nsfilter) != 0;
                    const char *sname = cgiEnv.Get("site");
                    Say.Emsg("Protocol", "Logged into", sname, Link->Name());
                    if (Data.SID)
@@ -625,6 +627,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
                                  wasSuspended = 1;
                                 }
    Data.HoldTime = Config.LUPHold;
+   if (Config.asManager()) Data.Mode |= CmsLoginData::kYR_nsfilter;
 
 // Do the login and get the data
 //
@@ -740,6 +743,8 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
       return (XrdCmsRouting *)0;
    myNode->RoleID = static_cast<char>(roleID);
    myNode->setVersion(Data.Version);
+   myNode->canBatch = (Data.Mode & CmsLoginData::kYR_batchq) != 0;
+   myNode->nsReset();
 
 // Calculate the share as the reference mininum if we are a meta-manager
 //
@@ -76,7 +76,7 @@ XrdCmsRRData *XrdCmsRRData::Objectify(XrdCmsRRData *op)
    if (op) {op->Next = Free; Free = op; op = 0;}
       else {if ((op = Free)) Free = op->Next;
                else {op = new XrdCmsRRData; op->Buff = 0; op->Blen = 0;}
-            op->Ident = 0; op->Next = 0;
+            op->Ident = 0; op->Next = 0; op->svcTime = op->inFlight = 0;
            }
 
    myMutex.UnLock();
@@ -68,6 +68,8 @@ XrdCms::CmsRRHdr       Request;     // all
 union  {unsigned int   dskUtil;     // avail
                  int   waitVal;
        };
+        unsigned int   svcTime;     // load (optional)
+        unsigned int   inFlight;    // load (optional)
         char          *Buff;        // Buffer underlying the pointers
         int            Blen;        // Length of buffer
         int            Dlen;        // Length of data in the buffer
@@ -80,6 +82,7 @@ enum ArgName
      Arg_Path2,    Arg_Port,      Arg_Prty,      Arg_Reqid,
      Arg_dskFree,  Arg_dskUtil,   Arg_theLoad,   Arg_SID,
      Arg_dskTot,   Arg_dskMinf,   Arg_CGI,       Arg_Ilist,
+     Arg_svcTime,  Arg_inFlight,
 
      Arg_Count     // Always the last item which equals the number of elements
 };
@@ -37,6 +37,7 @@
 #include "XrdCms/XrdCmsNode.hh"
 #include "XrdCms/XrdCmsRRQ.hh"
 #include "XrdCms/XrdCmsRTable.hh"
+#include "XrdCms/XrdCmsTelemetry.hh"
 #include "XrdCms/XrdCmsTrace.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysTimer.hh"
@@ -324,6 +325,7 @@ void XrdCmsRRQ::sendLocResp(XrdCmsRRQSlot *lP)
           {dataResp.Hdr.streamid = lP->Info.ID;
            nP->Send(data_iov, iov_cnt, bytes);
           }
+       Telemetry.Latency(true, lP->tBeg);
        luFast++;
       } while((lP = lP->LkUp));
    RTable.UnLock();
@@ -347,6 +349,7 @@ do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
 //     DEBUG("Redirect delay " <<nP->Name() <<' ' <<Tdelay);
       }
 //    else {DEBUG("redirector " <<Info->Rnum <<'.' <<Info->Rinst <<"not found");}
+   Telemetry.Latency(true, rP->tBeg);
   } while((rP = rP->LkUp));
    RTable.UnLock();
 }
@@ -387,6 +390,8 @@ do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
                    }
       } 
 //    else {DEBUG("redirector " <<Info->Rnum <<'.' <<Info->Rinst <<"not found");}
+   if (doredir) Telemetry.Redirected("fast");
+   Telemetry.Latency(false, rP->tBeg);
   } while((rP = rP->Cont));
    RTable.UnLock();
 }
@@ -465,6 +470,7 @@ XrdCmsRRQSlot *XrdCmsRRQSlot::Alloc(XrdCmsRRQInfo *theInfo)
        sp->LkUp = 0;
        sp->Arg1 = 0;
        sp->Arg2 = 0;
+       sp->tBeg = XrdCmsTelemetry::Now();
       }
    myMutex.UnLock();
    return sp;
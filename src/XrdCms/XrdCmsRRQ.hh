@@ -94,6 +94,7 @@ static   short                       initSlot;
          SMask_t                     Arg1;
          SMask_t                     Arg2;
 unsigned int                         Expire;
+unsigned int                         tBeg;      // When allocated (Telemetry)
          int                         slotNum;
 };
 
@@ -63,6 +63,7 @@ XrdCmsRouter::theRoute initRouter[] =
        {kYR_gone,    "gone",   &XrdCmsNode::do_Gone},
        {kYR_have,    "have",   &XrdCmsNode::do_Have},
        {kYR_load,    "load",   &XrdCmsNode::do_Load},
+       {kYR_nsfilt,  "nsfilt", &XrdCmsNode::do_NSFilt},
        {kYR_ping,    "ping",   &XrdCmsNode::do_Ping},
        {kYR_pong,    "pong",   &XrdCmsNode::do_Pong},
        {kYR_space,   "space",  &XrdCmsNode::do_Space},
@@ -157,6 +158,7 @@ XrdCmsRouting::theRouting initRSProuting[] =
       {kYR_gone,    XrdCmsRouting::isSync},
       {kYR_have,    XrdCmsRouting::AsyncQ0},
       {kYR_load,    XrdCmsRouting::isSync},
+      {kYR_nsfilt,  XrdCmsRouting::isSync},
       {kYR_pong,    XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
       {kYR_status,  XrdCmsRouting::isSync | XrdCmsRouting::noArgs},
       {0,           0}};
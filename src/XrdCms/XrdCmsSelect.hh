@@ -50,6 +50,7 @@ SMask_t        smask;   // Out: Nodes selected
 struct iovec  *iovP;    //  In: Prepare notification I/O vector
 int            iovN;    //  In: Prepare notification I/O vector count
 int            Opts;    //  In: One or more of the following enums
+int            ASize;   //  In: Expected MB to be written (0 -> unknown)
 
 enum {Write   = 0x00010, // File will be open in write mode     (select & cache)
       NewFile = 0x00020, // File will be created may not exist  (select)
@@ -88,7 +89,8 @@ struct {int  Port;         // Out: Target node port number
        }     Resp;
 
              XrdCmsSelect(int opts=0, char *thePath=0, int thePLen=0)
-                         : Path(thePath,thePLen), InfoP(0), smask(0), Opts(opts)
+                         : Path(thePath,thePLen), InfoP(0), smask(0), Opts(opts),
+                           ASize(0)
                          {Resp.Port = 0; *Resp.Data = '\0'; Resp.DLen = 0;}
             ~XrdCmsSelect() {}
 };
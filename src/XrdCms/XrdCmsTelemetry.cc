@@ -0,0 +1,266 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d C m s T e l e m e t r y . c c                     */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "XrdCms/XrdCmsConfig.hh"
+#include "XrdCms/XrdCmsTelemetry.hh"
+
+using namespace XrdCms;
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+       XrdCmsTelemetry XrdCms::Telemetry;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdCmsTelemetry::XrdCmsTelemetry() : cHit(0), cPend(0), cMiss(0)
+{
+   memset(&locTab, 0, sizeof(locTab));
+   memset(&selTab, 0, sizeof(selTab));
+   memset(&dlyTab, 0, sizeof(dlyTab));
+   memset(&rdrTab, 0, sizeof(rdrTab));
+}
+
+/******************************************************************************/
+/*                               L a t e n c y                                */
+/******************************************************************************/
+
+void XrdCmsTelemetry::Latency(bool isLoc, unsigned int tBeg)
+{
+   LatTab &tab = (isLoc ? locTab : selTab);
+   unsigned int msVal = Now() - tBeg, msMax = 1;
+   int i = 0;
+
+// Find the bin, each one covers four times the range of the previous one
+//
+   while(i < latBins-1 && msVal > msMax) {msMax <<= 2; i++;}
+
+// Record the value
+//
+   AtomicBeg(tMutex);
+   AtomicInc(tab.Bin[i]);
+   AtomicInc(tab.Num);
+   AtomicAdd(tab.Tot, msVal);
+   AtomicEnd(tMutex);
+}
+
+/******************************************************************************/
+/*                                   N o w                                    */
+/******************************************************************************/
+
+unsigned int XrdCmsTelemetry::Now()
+{
+   struct timespec tNow;
+
+// We only care about differences so wrapping around is harmless
+//
+   clock_gettime(CLOCK_MONOTONIC, &tNow);
+   return static_cast<unsigned int>(tNow.tv_sec*1000 + tNow.tv_nsec/1000000);
+}
+
+/******************************************************************************/
+/*                                R e p o r t                                 */
+/******************************************************************************/
+
+int XrdCmsTelemetry::Report(char *bfr, int bln, int what)
+{
+   static const char cacheFmt[] =
+          "<cache><hit>%lld</hit><pnd>%lld</pnd><miss>%lld</miss></cache>";
+   static const int  latLen = 2*(16 + 2*20 + latBins*(14 + 20)) + 12;
+   static const int  whyLen = 2*(12 + (tabMax+1)*(64 + 20)) + 12;
+   long long cVal[3];
+   int mlen, tlen = 0;
+
+// Check if actual length wanted
+//
+   if (!bfr)
+      {if (what & XrdCmsConfig::RepStat_cache) tlen += sizeof(cacheFmt) + 20*3;
+       if (what & XrdCmsConfig::RepStat_lat)   tlen += latLen;
+       if (what & XrdCmsConfig::RepStat_why)   tlen += whyLen;
+       return tlen;
+      }
+
+// Do the cache statistics
+//
+   if (what & XrdCmsConfig::RepStat_cache)
+      {AtomicBeg(tMutex);
+       cVal[0] = AtomicGet(cHit);
+       cVal[1] = AtomicGet(cPend);
+       cVal[2] = AtomicGet(cMiss);
+       AtomicEnd(tMutex);
+       mlen = snprintf(bfr, bln, cacheFmt, cVal[0], cVal[1], cVal[2]);
+       if (mlen >= bln) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+      }
+
+// Do the latency histograms
+//
+   if (what & XrdCmsConfig::RepStat_lat)
+      {if (bln <= 5) return 0;
+       strcpy(bfr, "<lat>"); bfr += 5; bln -= 5; tlen += 5;
+       if (!(mlen = Format(bfr, bln, "loc", locTab))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+       if (!(mlen = Format(bfr, bln, "sel", selTab))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+       if (bln <= 6) return 0;
+       strcpy(bfr, "</lat>"); bfr += 6; bln -= 6; tlen += 6;
+      }
+
+// Do the reasons
+//
+   if (what & XrdCmsConfig::RepStat_why)
+      {if (bln <= 5) return 0;
+       strcpy(bfr, "<why>"); bfr += 5; bln -= 5; tlen += 5;
+       if (!(mlen = Format(bfr, bln, "rdr", rdrTab))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+       if (!(mlen = Format(bfr, bln, "dly", dlyTab))) return 0;
+       bfr += mlen; bln -= mlen; tlen += mlen;
+       if (bln <= 6) return 0;
+       strcpy(bfr, "</why>"); tlen += 6;
+      }
+
+// All done
+//
+   return tlen;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                F o r m a t                                 */
+/******************************************************************************/
+
+int XrdCmsTelemetry::Format(char *bfr, int bln, const char *tag, LatTab &tab)
+{
+   static const char *binName[latBins] = {"1", "4", "16", "64", "256",
+                                          "1k", "4k", "x"};
+   long long bVal[latBins], tNum, tTot;
+   int mlen, tlen;
+
+// Get a consistent copy of the histogram
+//
+   tMutex.Lock();
+   for (int i = 0; i < latBins; i++) bVal[i] = AtomicGet(tab.Bin[i]);
+   tNum = AtomicGet(tab.Num);
+   tTot = AtomicGet(tab.Tot);
+   tMutex.UnLock();
+
+// Format the totals followed by each bin
+//
+   tlen = snprintf(bfr, bln, "<%s><n>%lld</n><ms>%lld</ms>", tag, tNum, tTot);
+   if (tlen >= bln) return 0;
+   for (int i = 0; i < latBins; i++)
+       {mlen = snprintf(bfr+tlen, bln-tlen, "<b%s>%lld</b%s>",
+                        binName[i], bVal[i], binName[i]);
+        if ((tlen += mlen) >= bln) return 0;
+       }
+   mlen = snprintf(bfr+tlen, bln-tlen, "</%s>", tag);
+   if ((tlen += mlen) >= bln) return 0;
+   return tlen;
+}
+
+/******************************************************************************/
+
+int XrdCmsTelemetry::Format(char *bfr, int bln, const char *tag, TallyTab &tab)
+{
+   const char *wP;
+   int mlen, wlen, tlen, n;
+
+// Start the table
+//
+   tlen = snprintf(bfr, bln, "<%s>", tag);
+   if (tlen >= bln) return 0;
+
+// Reasons are trace fragments so we drop any padding and a trailing "for"
+//
+   tMutex.Lock();
+   n = tab.Num;
+   for (int i = 0; i < n; i++)
+       {wP = tab.What[i];
+        while(*wP == ' ') wP++;
+        wlen = strlen(wP);
+        while(wlen && wP[wlen-1] == ' ') wlen--;
+        if (wlen > 4 && !strncmp(wP+wlen-4, " for", 4)) wlen -= 4;
+        if (wlen > 64) wlen = 64;
+        mlen = snprintf(bfr+tlen, bln-tlen, "<r n=\"%.*s\">%lld</r>",
+                        wlen, wP, AtomicGet(tab.Count[i]));
+        if ((tlen += mlen) >= bln) {tMutex.UnLock(); return 0;}
+       }
+   if (tab.Other)
+      {mlen = snprintf(bfr+tlen, bln-tlen, "<r n=\"other\">%lld</r>",
+                       AtomicGet(tab.Other));
+       if ((tlen += mlen) >= bln) {tMutex.UnLock(); return 0;}
+      }
+   tMutex.UnLock();
+
+// End the table
+//
+   mlen = snprintf(bfr+tlen, bln-tlen, "</%s>", tag);
+   if ((tlen += mlen) >= bln) return 0;
+   return tlen;
+}
+
+/******************************************************************************/
+/*                                 T a l l y                                  */
+/******************************************************************************/
+
+void XrdCmsTelemetry::Tally(TallyTab &tab, const char *txt)
+{
+   int i, n;
+
+// Reasons are literals so their address identifies them. Entries are never
+// removed and the count is published only after an entry is complete. So,
+// the common case of a known reason needs no serialization.
+//
+   AtomicBeg(tMutex);
+   n = AtomicGet(tab.Num);
+   for (i = 0; i < n; i++)
+       if (tab.What[i] == txt) {AtomicInc(tab.Count[i]); break;}
+   AtomicEnd(tMutex);
+   if (i < n) return;
+
+// This is a new reason, add it unless someone beat us to it
+//
+   tMutex.Lock();
+   for (i = n; i < tab.Num; i++) if (tab.What[i] == txt) break;
+   if (i < tab.Num) AtomicInc(tab.Count[i]);
+      else if (i >= tabMax) AtomicInc(tab.Other);
+              else {tab.What[i] = txt; tab.Count[i] = 1;
+                    AtomicInc(tab.Num);
+                   }
+   tMutex.UnLock();
+}
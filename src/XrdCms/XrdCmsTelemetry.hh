@@ -0,0 +1,117 @@
+#ifndef __CMS_TELEMETRY__H
+#define __CMS_TELEMETRY__H
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d C m s T e l e m e t r y . h h                     */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                 C l a s s   X r d C m s T e l e m e t r y                  */
+/******************************************************************************/
+
+// This is a single-instance global class that tallies what a redirector does
+// with client requests. It is reported along with the cluster statistics.
+//
+class XrdCmsTelemetry
+{
+public:
+
+// Cached() counts the outcome of a cache lookup (i.e. XrdCmsCache::GetFile())
+//
+inline void         Cached(int retc)
+                          {AtomicBeg(tMutex);
+                           if (retc > 0) AtomicInc(cHit);
+                              else if (retc < 0) AtomicInc(cPend);
+                                      else AtomicInc(cMiss);
+                           AtomicEnd(tMutex);
+                          }
+
+// Delayed() counts a client delay by reason (the reason must be a literal)
+//
+inline void         Delayed(const char *why) {Tally(dlyTab, why);}
+
+// Latency() records the time from tBeg (see Now()) to the response
+//
+       void         Latency(bool isLoc, unsigned int tBeg);
+
+// Now() returns a monotonic time in milliseconds suitable for Latency()
+//
+static unsigned int Now();
+
+// Redirected() counts a successful selection by action (must be a literal)
+//
+inline void         Redirected(const char *how) {Tally(rdrTab, how);}
+
+// Report() formats the statistics selected by the XrdCmsConfig::RepStat_xxx
+//          mask in xml. It returns the length or 0 if the buffer is too small.
+//          When bfr is nil the maximum length is returned.
+//
+       int          Report(char *bfr, int bln, int what);
+
+       XrdCmsTelemetry();
+      ~XrdCmsTelemetry() {} // This object should never be deleted
+
+static const int    latBins = 8;  // <=1, 4, 16, 64, 256, 1024, 4096, more ms
+static const int    tabMax  = 16; // Distinct reasons tallied per table
+
+private:
+
+struct LatTab
+      {long long Bin[latBins];
+       long long Num;
+       long long Tot;
+      };
+
+struct TallyTab
+      {const char *What[tabMax];
+       long long   Count[tabMax];
+       long long   Other;
+       int         Num;
+      };
+
+int         Format(char *bfr, int bln, const char *tag, LatTab &tab);
+int         Format(char *bfr, int bln, const char *tag, TallyTab &tab);
+void        Tally(TallyTab &tab, const char *txt);
+
+XrdSysMutex tMutex;
+long long   cHit;
+long long   cPend;
+long long   cMiss;
+LatTab      locTab;
+LatTab      selTab;
+TallyTab    dlyTab;
+TallyTab    rdrTab;
+};
+
+namespace XrdCms
+{
+extern    XrdCmsTelemetry Telemetry;
+}
+#endif
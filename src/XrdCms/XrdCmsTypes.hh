@@ -29,14 +29,122 @@
 /* be used to endorse or promote products derived from this software without  */
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
-  
-typedef unsigned long long SMask_t;
 
-#define FULLMASK 0xFFFFFFFFFFFFFFFFULL
+#include <stdio.h>
 
-// The following defines our cell size (maximum subscribers)
+// The following defines our cell size (maximum subscribers). It must be a
+// multiple of 64 and may be overridden at build time.
 //
-#define STMax 64
+#ifndef XRDCMS_MAXNODES
+#define XRDCMS_MAXNODES 256
+#endif
+#define STMax XRDCMS_MAXNODES
+
+/******************************************************************************/
+/*                               S M a s k _ t                                */
+/******************************************************************************/
+
+// A server mask holds one bit per subscriber. It behaves like the unsigned
+// integer it used to be (&, |, ^, ~, tests against zero) but can address more
+// than 64 nodes. The word loops have a fixed trip count so the compiler can
+// vectorize them.
+//
+class SMask_t
+{
+public:
+
+static const int Words = STMax/64;
+
+inline bool    Any() const
+                  {unsigned long long v = 0;
+                   for (int i = 0; i < Words; i++) v |= Bits[i];
+                   return v != 0;
+                  }
+
+static SMask_t Bit(int n) {SMask_t m; m.Set(n); return m;}
+
+inline int     Count() const
+                  {int n = 0;
+                   for (int i = 0; i < Words; i++) n += __builtin_popcountll(Bits[i]);
+                   return n;
+                  }
+
+// Return the number of the lowest node at or above n in the mask, else -1.
+//
+inline int     First(int n=0) const
+                  {int i = n >> 6;
+                   if (n < 0 || i >= Words) return -1;
+                   unsigned long long v = Bits[i] & (~0ULL << (n & 63));
+                   while(!v) {if (++i >= Words) return -1; v = Bits[i];}
+                   return (i << 6) + __builtin_ctzll(v);
+                  }
+
+inline void    Set(int n)  {Bits[n >> 6] |=  (1ULL << (n & 63));}
+
+inline bool    Test(int n) const {return (Bits[n >> 6] & (1ULL << (n & 63))) != 0;}
+
+// Return the mask as a hex string (highest word first, leading zeros elided)
+//
+       char   *Hex(char *buff, int blen) const
+                  {int i = Words-1, n;
+                   while(i > 0 && !Bits[i]) i--;
+                   n = snprintf(buff, blen, "%llx", Bits[i]);
+                   while(--i >= 0 && n < blen)
+                        n += snprintf(buff+n, blen-n, "%016llx", Bits[i]);
+                   return buff;
+                  }
+
+inline explicit operator bool() const {return Any();}
+
+inline bool    operator!() const {return !Any();}
+
+inline SMask_t operator~() const
+                  {SMask_t m;
+                   for (int i = 0; i < Words; i++) m.Bits[i] = ~Bits[i];
+                   return m;
+                  }
+
+inline SMask_t &operator&=(const SMask_t &rhs)
+                  {for (int i = 0; i < Words; i++) Bits[i] &= rhs.Bits[i];
+                   return *this;
+                  }
+
+inline SMask_t &operator|=(const SMask_t &rhs)
+                  {for (int i = 0; i < Words; i++) Bits[i] |= rhs.Bits[i];
+                   return *this;
+                  }
+
+inline SMask_t &operator^=(const SMask_t &rhs)
+                  {for (int i = 0; i < Words; i++) Bits[i] ^= rhs.Bits[i];
+                   return *this;
+                  }
+
+friend SMask_t operator&(SMask_t lhs, const SMask_t &rhs) {return lhs &= rhs;}
+friend SMask_t operator|(SMask_t lhs, const SMask_t &rhs) {return lhs |= rhs;}
+friend SMask_t operator^(SMask_t lhs, const SMask_t &rhs) {return lhs ^= rhs;}
+
+friend bool    operator==(const SMask_t &lhs, const SMask_t &rhs)
+                  {unsigned long long v = 0;
+                   for (int i = 0; i < Words; i++) v |= lhs.Bits[i] ^ rhs.Bits[i];
+                   return v == 0;
+                  }
+
+friend bool    operator!=(const SMask_t &lhs, const SMask_t &rhs)
+                  {return !(lhs == rhs);}
+
+// The integer constructor only sets the first 64 nodes (e.g. SMask_t(0)).
+//
+               SMask_t(unsigned long long v=0)
+                      {Bits[0] = v;
+                       for (int i = 1; i < Words; i++) Bits[i] = 0;
+                      }
+
+private:
+
+unsigned long long Bits[Words];
+};
+
+#define FULLMASK (~SMask_t(0))
 
 // The following defines the maximum number of redirectors. It is one greater
 // than the actual maximum as the zeroth is never used.
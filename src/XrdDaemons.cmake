@@ -23,12 +23,7 @@ target_link_libraries(
 #-------------------------------------------------------------------------------
 # cmsd
 #-------------------------------------------------------------------------------
-add_executable(
-  cmsd
-  Xrd/XrdConfig.cc                Xrd/XrdConfig.hh
-  Xrd/XrdProtLoad.cc              Xrd/XrdProtLoad.hh
-  Xrd/XrdStats.cc                 Xrd/XrdStats.hh
-  Xrd/XrdMain.cc
+set( XRD_CMSD_SOURCES
   XrdCms/XrdCmsAdmin.cc           XrdCms/XrdCmsAdmin.hh
   XrdCms/XrdCmsBaseFS.cc          XrdCms/XrdCmsBaseFS.hh
   XrdCms/XrdCmsCache.cc           XrdCms/XrdCmsCache.hh
@@ -43,6 +38,7 @@ add_executable(
   XrdCms/XrdCmsMeter.cc           XrdCms/XrdCmsMeter.hh
   XrdCms/XrdCmsNash.cc            XrdCms/XrdCmsNash.hh
   XrdCms/XrdCmsNode.cc            XrdCms/XrdCmsNode.hh
+  XrdCms/XrdCmsNSFilter.cc        XrdCms/XrdCmsNSFilter.hh
   XrdCms/XrdCmsPList.cc           XrdCms/XrdCmsPList.hh
   XrdCms/XrdCmsPrepare.cc         XrdCms/XrdCmsPrepare.hh
   XrdCms/XrdCmsPrepArgs.cc        XrdCms/XrdCmsPrepArgs.hh
@@ -52,7 +48,17 @@ add_executable(
                                   XrdCms/XrdCmsSelect.hh
   XrdCms/XrdCmsState.cc           XrdCms/XrdCmsState.hh
   XrdCms/XrdCmsSupervisor.cc      XrdCms/XrdCmsSupervisor.hh
+  XrdCms/XrdCmsTelemetry.cc       XrdCms/XrdCmsTelemetry.hh
                                   XrdCms/XrdCmsTrace.hh )
+
+add_executable(
+  cmsd
+  Xrd/XrdConfig.cc                Xrd/XrdConfig.hh
+  Xrd/XrdProtLoad.cc              Xrd/XrdProtLoad.hh
+  Xrd/XrdStats.cc                 Xrd/XrdStats.hh
+  Xrd/XrdMain.cc
+  ${XRD_CMSD_SOURCES} )
+
 target_link_libraries(
   cmsd
   XrdServer
@@ -61,6 +67,22 @@ target_link_libraries(
   ${EXTRA_LIBS}
   ${SOCKET_LIBRARY} )
 
+#-------------------------------------------------------------------------------
+# xrdcmslocatebench (not installed), it drives the cmsd location cache
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdcmslocatebench
+  XrdApps/XrdCmsLocateBench.cc
+  ${XRD_CMSD_SOURCES} )
+
+target_link_libraries(
+  xrdcmslocatebench
+  XrdServer
+  XrdUtils
+  pthread
+  ${EXTRA_LIBS}
+  ${SOCKET_LIBRARY} )
+
 #-------------------------------------------------------------------------------
 # Install
 #-------------------------------------------------------------------------------
@@ -27,6 +27,9 @@ if( BUILD_HTTP )
     XrdHttp/XrdHttpReq.cc         XrdHttp/XrdHttpReq.hh
                                   XrdHttp/XrdHttpSecXtractor.hh
     XrdHttp/XrdHttpExtHandler.cc  XrdHttp/XrdHttpExtHandler.hh
+    XrdHttp/XrdHttpH2.cc          XrdHttp/XrdHttpH2.hh
+    XrdHttp/XrdHttpHpack.cc       XrdHttp/XrdHttpHpack.hh
+    XrdHttp/XrdHttpReadAhead.cc   XrdHttp/XrdHttpReadAhead.hh
                                   XrdHttp/XrdHttpStatic.hh
     XrdHttp/XrdHttpTrace.cc       XrdHttp/XrdHttpTrace.hh
     XrdHttp/XrdHttpUtils.cc       XrdHttp/XrdHttpUtils.hh )
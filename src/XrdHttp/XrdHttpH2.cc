@@ -0,0 +1,843 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "Xrd/XrdBuffer.hh"
+#include "Xrd/XrdLink.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+
+#include "XrdHttpH2.hh"
+#include "XrdHttpProtocol.hh"
+#include "XrdHttpReq.hh"
+#include "XrdHttpTrace.hh"
+#include "XrdHttpUtils.hh"
+
+// This is to fix the trace macros
+#define TRACELINK prot->Link
+
+/******************************************************************************/
+/*                               D e f i n e s                                */
+/******************************************************************************/
+
+// Frame types
+#define H2_DATA          0x0
+#define H2_HEADERS       0x1
+#define H2_PRIORITY      0x2
+#define H2_RST_STREAM    0x3
+#define H2_SETTINGS      0x4
+#define H2_PUSH_PROMISE  0x5
+#define H2_PING          0x6
+#define H2_GOAWAY        0x7
+#define H2_WINDOW_UPDATE 0x8
+#define H2_CONTINUATION  0x9
+
+// Frame flags
+#define H2F_END_STREAM   0x01
+#define H2F_ACK          0x01
+#define H2F_END_HEADERS  0x04
+#define H2F_PADDED       0x08
+#define H2F_PRIORITY     0x20
+
+// Error codes
+#define H2E_NO_ERROR          0x0
+#define H2E_PROTOCOL_ERROR    0x1
+#define H2E_INTERNAL_ERROR    0x2
+#define H2E_FLOW_CONTROL      0x3
+#define H2E_STREAM_CLOSED     0x5
+#define H2E_FRAME_SIZE        0x6
+#define H2E_REFUSED_STREAM    0x7
+#define H2E_COMPRESSION       0x9
+#define H2E_ENHANCE_CALM      0xb
+#define H2E_HTTP_1_1_REQUIRED 0xd
+
+// Settings
+#define H2S_HEADER_TABLE_SIZE      0x1
+#define H2S_MAX_CONCURRENT_STREAMS 0x3
+#define H2S_INITIAL_WINDOW_SIZE    0x4
+#define H2S_MAX_FRAME_SIZE         0x5
+
+#define H2_MAXWINDOW     0x7fffffffLL
+#define H2_MINFRAME      16384
+#define H2_MAXINPUT      (1024*1024)
+#define H2_MAXHDRBLOCK   (64*1024)
+#define H2_OUTSIZE       (1024*1024)
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+bool XrdHttpH2::onTLS = false;
+bool XrdHttpH2::onClear = false;
+int XrdHttpH2::maxStreams = 128;
+
+namespace
+{
+const char h2Preface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const int  h2PrefaceLen = sizeof(h2Preface) - 1;
+
+// Map the errno of a failed open to an http status
+int ErrStatus(int ec) {
+  switch (ec) {
+    case ENOENT: return 404;
+    case EPERM:
+    case EACCES: return 403;
+    case EISDIR: return 409;
+    default: return 500;
+  }
+}
+
+// Turn an h2 header name (always lower case) into its customary form so that
+// the HTTP/1.1 header parsing can be reused
+std::string Canonical(const std::string &name) {
+  std::string cn = name;
+  bool up = true;
+
+  for (size_t i = 0; i < cn.size(); i++) {
+    if (up) cn[i] = toupper(cn[i]);
+    up = (cn[i] == '-');
+  }
+  return cn;
+}
+
+void PutInt(char *bp, unsigned int val, int nbytes) {
+  while (nbytes--) {
+    bp[nbytes] = (char) (val & 0xff);
+    val >>= 8;
+  }
+}
+
+unsigned int GetInt(const char *bp, int nbytes) {
+  const unsigned char *up = (const unsigned char *) bp;
+  unsigned int val = 0;
+
+  for (int i = 0; i < nbytes; i++) val = (val << 8) | up[i];
+  return val;
+}
+}
+
+/******************************************************************************/
+/*                   C o n s t r u c t o r   /   D e s t r u c t o r          */
+/******************************************************************************/
+
+XrdHttpH2::XrdHttpH2(XrdHttpProtocol *protinstance)
+: prot(protinstance), outLen(0), gotPreface(false), goaway(false),
+  error(false), lastId(0), connWindow(65535), initWindow(65535),
+  peerFrame(H2_MINFRAME), hStream(0), sizeUpdate(false) {
+  char settings[6];
+
+  // All of the output goes through a single pool buffer, no matter how many
+  // streams are open. It bounds what a connection can have in flight.
+  outMax = std::min(H2_OUTSIZE, prot->BPool->MaxSize());
+  outBuff = prot->BPool->Obtain(outMax);
+  if (outBuff) outMax = outBuff->bsize;
+
+  // The server speaks first with its settings
+  PutInt(settings, H2S_MAX_CONCURRENT_STREAMS, 2);
+  PutInt(settings + 2, maxStreams, 4);
+  Emit(H2_SETTINGS, 0, 0, settings, sizeof(settings));
+
+  TRACEI(REQ, "Switched to HTTP/2");
+}
+
+XrdHttpH2::~XrdHttpH2() {
+  while (!streams.empty()) Close(streams.begin()->second);
+  if (outBuff) prot->BPool->Release(outBuff);
+}
+
+/******************************************************************************/
+/*                               P r o c e s s                                */
+/******************************************************************************/
+
+int XrdHttpH2::Process() {
+  char *data;
+  int n;
+  bool moved;
+
+  if (!outBuff) return -1;
+
+  while (true) {
+
+    // Take in what the client sent so far. The http buffer is used for the
+    // actual reads, which also takes care of TLS.
+    while (true) {
+      while ((n = prot->BuffUsed()) > 0) {
+        n = prot->BuffgetData(n, &data, false);
+        inBuf.append(data, n);
+      }
+      if (inBuf.size() >= H2_MAXINPUT || !Readable()) break;
+      if (prot->getDataOneShot(prot->BuffAvailable()) < 0) return -1;
+    }
+
+    // Handle all the complete frames, then send as much as the flow control
+    // windows allow for all of the streams
+    if (Frames() < 0 || error) {
+      Flush();
+      return -1;
+    }
+    moved = Pump();
+    if (!Flush() || error) return -1;
+
+    if (goaway && streams.empty()) return -1;
+    if (!moved && !Readable()) return 1;
+  }
+}
+
+/******************************************************************************/
+/*                             i s P r e f a c e                              */
+/******************************************************************************/
+
+int XrdHttpH2::isPreface(const char *data, int dlen) {
+  if (dlen <= 0) return 0;
+  if (memcmp(data, h2Preface, std::min(dlen, h2PrefaceLen))) return 0;
+  return (dlen >= h2PrefaceLen ? 1 : -1);
+}
+
+/******************************************************************************/
+/*                            A L P N S e l e c t                             */
+/******************************************************************************/
+
+int XrdHttpH2::ALPNSelect(SSL *ssl, const unsigned char **out,
+                          unsigned char *outlen, const unsigned char *in,
+                          unsigned int inlen, void *arg) {
+  static const unsigned char h2[] = "\x02h2";
+  static const unsigned char h1[] = "\x08http/1.1";
+
+  // Prefer h2 when we can serve it, otherwise leave the client on HTTP/1.1
+  if (Usable() && SSL_select_next_proto((unsigned char **) out, outlen,
+                                        h2, sizeof(h2) - 1, in, inlen)
+                  == OPENSSL_NPN_NEGOTIATED)
+    return SSL_TLSEXT_ERR_OK;
+
+  if (SSL_select_next_proto((unsigned char **) out, outlen,
+                            h1, sizeof(h1) - 1, in, inlen)
+      == OPENSSL_NPN_NEGOTIATED)
+    return SSL_TLSEXT_ERR_OK;
+
+  return SSL_TLSEXT_ERR_NOACK;
+}
+
+/******************************************************************************/
+/*                                U s a b l e                                 */
+/******************************************************************************/
+
+bool XrdHttpH2::Usable() {
+  // Streams are served from the file system, so unless direct reads are
+  // allowed, a manager (which redirects) or a server without one keeps to
+  // HTTP/1.1
+  return (XrdHttpProtocol::sfsdirect & XrdHttpProtocol::sfsGET)
+         && XrdHttpProtocol::myRole != kXR_isManager && XrdHttpProtocol::getSFS();
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                F r a m e s                                 */
+/******************************************************************************/
+
+int XrdHttpH2::Frames() {
+  size_t pos = 0;
+  int rc = 0;
+
+  // The client must open with the connection preface
+  if (!gotPreface) {
+    if (inBuf.size() < (size_t) h2PrefaceLen) return 0;
+    if (memcmp(inBuf.data(), h2Preface, h2PrefaceLen)) {
+      TRACEI(REQ, "HTTP/2 connection preface missing");
+      return -1;
+    }
+    pos = h2PrefaceLen;
+    gotPreface = true;
+  }
+
+  while (rc >= 0 && inBuf.size() - pos >= 9) {
+    const char *fh = inBuf.data() + pos;
+    int flen = GetInt(fh, 3), type = fh[3] & 0xff, flags = fh[4] & 0xff;
+    unsigned int sid = GetInt(fh + 5, 4) & 0x7fffffff;
+    const char *data = fh + 9;
+
+    if (flen > H2_MINFRAME) {
+      rc = Fail(H2E_FRAME_SIZE);
+      break;
+    }
+    if (inBuf.size() - pos - 9 < (size_t) flen) break;
+    pos += 9 + flen;
+
+    // A header block must be continued without anything in between
+    if (hStream && type != H2_CONTINUATION) {
+      rc = Fail(H2E_PROTOCOL_ERROR);
+      break;
+    }
+
+    switch (type) {
+      case H2_DATA:
+        rc = doData(flags, sid, data, flen);
+        break;
+
+      case H2_HEADERS:
+      {
+        int off = 0, pad = 0;
+        if (!sid) {rc = Fail(H2E_PROTOCOL_ERROR); break;}
+        if (flags & H2F_PADDED) {
+          if (flen < 1) {rc = Fail(H2E_FRAME_SIZE); break;}
+          pad = data[0] & 0xff;
+          off = 1;
+        }
+        if (flags & H2F_PRIORITY) off += 5;
+        if (off + pad > flen) {rc = Fail(H2E_PROTOCOL_ERROR); break;}
+        hBlock.assign(data + off, flen - off - pad);
+        if (flags & H2F_END_HEADERS)
+          rc = doHeaders(sid, hBlock.data(), hBlock.size());
+        else
+          hStream = sid;
+        break;
+      }
+
+      case H2_CONTINUATION:
+        if (!hStream || sid != hStream) {rc = Fail(H2E_PROTOCOL_ERROR); break;}
+        hBlock.append(data, flen);
+        if (hBlock.size() > H2_MAXHDRBLOCK) {rc = Fail(H2E_ENHANCE_CALM); break;}
+        if (flags & H2F_END_HEADERS) {
+          hStream = 0;
+          rc = doHeaders(sid, hBlock.data(), hBlock.size());
+        }
+        break;
+
+      case H2_RST_STREAM:
+      {
+        std::map<unsigned int, Stream *>::iterator it = streams.find(sid);
+        if (!sid || flen != 4) {rc = Fail(H2E_PROTOCOL_ERROR); break;}
+        if (it != streams.end()) {
+          TRACEI(REQ, "HTTP/2 stream " << sid << " reset by the client");
+          Close(it->second);
+        }
+        break;
+      }
+
+      case H2_SETTINGS:
+        rc = (sid ? Fail(H2E_PROTOCOL_ERROR) : doSettings(flags, data, flen));
+        break;
+
+      case H2_PUSH_PROMISE:
+        rc = Fail(H2E_PROTOCOL_ERROR);
+        break;
+
+      case H2_PING:
+        if (sid || flen != 8) {rc = Fail(H2E_FRAME_SIZE); break;}
+        if (!(flags & H2F_ACK)) Emit(H2_PING, H2F_ACK, 0, data, 8);
+        break;
+
+      case H2_GOAWAY:
+        TRACEI(REQ, "HTTP/2 client is going away");
+        goaway = true;
+        break;
+
+      case H2_WINDOW_UPDATE:
+        rc = doWindow(sid, data, flen);
+        break;
+
+      default: // PRIORITY and unknown frames are ignored
+        break;
+    }
+  }
+
+  inBuf.erase(0, pos);
+  return rc;
+}
+
+/******************************************************************************/
+/*                                d o D a t a                                 */
+/******************************************************************************/
+
+int XrdHttpH2::doData(int flags, unsigned int sid, const char *data, int dlen) {
+  char incr[4];
+
+  if (!sid) return Fail(H2E_PROTOCOL_ERROR);
+
+  // We don't want request bodies, but the client must not stall on them
+  if (dlen) {
+    PutInt(incr, dlen, 4);
+    Emit(H2_WINDOW_UPDATE, 0, 0, incr, 4);
+    if (!(flags & H2F_END_STREAM) && streams.count(sid))
+      Emit(H2_WINDOW_UPDATE, 0, sid, incr, 4);
+  }
+  return 0;
+}
+
+/******************************************************************************/
+/*                             d o H e a d e r s                              */
+/******************************************************************************/
+
+int XrdHttpH2::doHeaders(unsigned int sid, const char *data, int dlen) {
+  hdrList hdrs;
+
+  // The block must always be decoded to keep the HPACK state in sync
+  if (!hpack.Decode(data, dlen, hdrs)) return Fail(H2E_COMPRESSION);
+
+  // A known stream is sending trailers, which we don't care about
+  if (streams.count(sid)) return 0;
+
+  if (!(sid & 1)) return Fail(H2E_PROTOCOL_ERROR);
+  if (sid <= lastId) return Fail(H2E_STREAM_CLOSED);
+  lastId = sid;
+
+  Request(sid, hdrs);
+  return 0;
+}
+
+/******************************************************************************/
+/*                            d o S e t t i n g s                             */
+/******************************************************************************/
+
+int XrdHttpH2::doSettings(int flags, const char *data, int dlen) {
+
+  if (flags & H2F_ACK) return (dlen ? Fail(H2E_FRAME_SIZE) : 0);
+  if (dlen % 6) return Fail(H2E_FRAME_SIZE);
+
+  for (int i = 0; i < dlen; i += 6) {
+    unsigned int id = GetInt(data + i, 2), val = GetInt(data + i + 2, 4);
+
+    switch (id) {
+      case H2S_HEADER_TABLE_SIZE:
+        // We never index our responses; telling the client so is enough
+        sizeUpdate = true;
+        break;
+
+      case H2S_INITIAL_WINDOW_SIZE:
+      {
+        if (val > H2_MAXWINDOW) return Fail(H2E_FLOW_CONTROL);
+        long long delta = (long long) val - initWindow;
+        std::map<unsigned int, Stream *>::iterator it;
+        for (it = streams.begin(); it != streams.end(); it++)
+          it->second->window += delta;
+        initWindow = val;
+        break;
+      }
+
+      case H2S_MAX_FRAME_SIZE:
+        if (val < H2_MINFRAME || val > 0xffffff) return Fail(H2E_PROTOCOL_ERROR);
+        peerFrame = (int) std::min((long long) val, (long long) outMax - 9);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  Emit(H2_SETTINGS, H2F_ACK, 0, 0, 0);
+  return 0;
+}
+
+/******************************************************************************/
+/*                              d o W i n d o w                               */
+/******************************************************************************/
+
+int XrdHttpH2::doWindow(unsigned int sid, const char *data, int dlen) {
+  std::map<unsigned int, Stream *>::iterator it;
+  unsigned int incr;
+
+  if (dlen != 4) return Fail(H2E_FRAME_SIZE);
+  incr = GetInt(data, 4) & 0x7fffffff;
+
+  if (!sid) {
+    if (!incr) return Fail(H2E_PROTOCOL_ERROR);
+    if ((connWindow += incr) > H2_MAXWINDOW) return Fail(H2E_FLOW_CONTROL);
+    return 0;
+  }
+
+  if ((it = streams.find(sid)) == streams.end()) return 0;
+  if (!incr || (it->second->window += incr) > H2_MAXWINDOW) {
+    Refuse(sid, (incr ? H2E_FLOW_CONTROL : H2E_PROTOCOL_ERROR));
+    Close(it->second);
+  }
+  return 0;
+}
+
+/******************************************************************************/
+/*                               R e q u e s t                                */
+/******************************************************************************/
+
+void XrdHttpH2::Request(unsigned int sid, const hdrList &hdrs) {
+  std::string method, path, line, cgi, fn;
+  std::vector<char> lbuf;
+  XrdSfsFileSystem *sfsP;
+  XrdHttpReq *req;
+  Stream *sp;
+  hdrList rhdrs;
+  struct stat sbuf;
+  const char *p;
+  long long total = 0;
+  int rc, code;
+
+  if (goaway || (int) streams.size() >= maxStreams) {
+    Refuse(sid, H2E_REFUSED_STREAM);
+    return;
+  }
+
+  for (size_t i = 0; i < hdrs.size(); i++) {
+    if (hdrs[i].first == ":method") method = hdrs[i].second;
+    else if (hdrs[i].first == ":path") path = hdrs[i].second;
+  }
+  if (method.empty() || path.empty()) {
+    Refuse(sid, H2E_PROTOCOL_ERROR);
+    return;
+  }
+
+  // Parse the request as if it came over HTTP/1.1
+  req = new XrdHttpReq(prot);
+  req->reset();
+  line = method + " " + path + " HTTP/1.1\r\n";
+  lbuf.assign(line.begin(), line.end());
+  lbuf.push_back(0);
+  req->parseFirstLine(&lbuf[0], line.size());
+
+  for (size_t i = 0; i < hdrs.size(); i++) {
+    if (hdrs[i].first == ":authority") line = "Host";
+    else if (hdrs[i].first[0] == ':') continue;
+    else line = Canonical(hdrs[i].first);
+    line += ": " + hdrs[i].second + "\r\n";
+    lbuf.assign(line.begin(), line.end());
+    lbuf.push_back(0);
+    req->parseLine(&lbuf[0], line.size());
+  }
+
+  TRACEI(REQ, "HTTP/2 stream " << sid << " " << method << " " << req->resource);
+
+  // Only plain reads of what xrootd would open are handled here, the rest
+  // needs the full machinery
+  fn = req->resource.c_str();
+  if ((req->request != XrdHttpReq::rtGET && req->request != XrdHttpReq::rtHEAD)
+      || req->resource.beginswith("/static/") || !req->m_req_digest.empty()
+      || !Usable() || !XrdHttpProtocol::sfsPathOK(fn)
+      || XrdHttpProtocol::FindMatchingExtHandler(*req)) {
+    Refuse(sid, H2E_HTTP_1_1_REQUIRED);
+    delete req;
+    return;
+  }
+
+  sp = new Stream;
+  sp->id = sid;
+  sp->req = req;
+  sp->fP = 0;
+  sp->segNow = 0;
+  sp->segDone = 0;
+  sp->window = initWindow;
+  streams[sid] = sp;
+
+  // Open the file, adding the opaque info that came from the headers
+  if ((p = strchr(req->resourceplusopaque.c_str(), '?'))) cgi = p + 1;
+  if (!req->hdr2cgistr.empty()) {
+    char *q = quote(req->hdr2cgistr.c_str());
+    if (!cgi.empty()) cgi += "&";
+    cgi += q;
+    free(q);
+  }
+
+  sfsP = XrdHttpProtocol::getSFS();
+  if (!sfsP || !(sp->fP = sfsP->newFile(prot->Link->ID, 0))) {
+    Refuse(sid, H2E_INTERNAL_ERROR);
+    Close(sp);
+    return;
+  }
+
+  rc = sp->fP->open(fn.c_str(), SFS_O_RDONLY, 0, &prot->SecEntity,
+                    (cgi.empty() ? 0 : cgi.c_str()));
+  if (rc == SFS_ERROR) {
+    code = ErrStatus(sp->fP->error.getErrInfo());
+    line = std::string(sp->fP->error.getErrText()) + "\n";
+    delete sp->fP;
+    sp->fP = 0;
+    Respond(sp, code, line);
+    return;
+  }
+
+  // Redirects, stalls and directories (listings) are left to HTTP/1.1
+  if (rc != SFS_OK || sp->fP->stat(&sbuf) != SFS_OK || S_ISDIR(sbuf.st_mode)) {
+    Refuse(sid, H2E_HTTP_1_1_REQUIRED);
+    Close(sp);
+    return;
+  }
+  req->filesize = sbuf.st_size;
+
+  // Lay out the body as a list of segments
+  std::vector<ReadWriteOp> &rwOps = req->rwOps;
+  char buf[128];
+
+  if (!rwOps.empty() && !req->coalesceRWOps()) {
+    snprintf(buf, sizeof(buf), "bytes */%lld", req->filesize);
+    rhdrs.push_back(std::make_pair(std::string("content-range"), std::string(buf)));
+    Respond(sp, 416, "Requested range not satisfiable\n", &rhdrs);
+    return;
+  }
+
+  if (rwOps.empty()) {
+    code = 200;
+    if (req->filesize) {
+      Segment seg = {"", 0, req->filesize};
+      sp->segs.push_back(seg);
+    }
+  } else {
+    for (size_t i = 0; i < rwOps.size(); i++) {
+      if (rwOps.size() > 1) {
+        Segment hdr = {req->buildPartialHdr(rwOps[i].bytestart, rwOps[i].byteend,
+                                            req->filesize, (char *) "123456"), 0, 0};
+        hdr.len = hdr.text.size();
+        sp->segs.push_back(hdr);
+      }
+      Segment seg = {"", rwOps[i].bytestart, rwOps[i].byteend - rwOps[i].bytestart + 1};
+      sp->segs.push_back(seg);
+    }
+
+    code = 206;
+    if (rwOps.size() == 1) {
+      snprintf(buf, sizeof(buf), "bytes %lld-%lld/%lld", rwOps[0].bytestart,
+               rwOps[0].byteend, req->filesize);
+      rhdrs.push_back(std::make_pair(std::string("content-range"), std::string(buf)));
+    } else {
+      Segment end = {req->buildPartialHdrEnd((char *) "123456"), 0, 0};
+      end.len = end.text.size();
+      sp->segs.push_back(end);
+      rhdrs.push_back(std::make_pair(std::string("content-type"),
+                      std::string("multipart/byteranges; boundary=123456")));
+    }
+  }
+
+  for (size_t i = 0; i < sp->segs.size(); i++) total += sp->segs[i].len;
+  snprintf(buf, sizeof(buf), "%lld", total);
+  rhdrs.insert(rhdrs.begin(), std::make_pair(std::string("content-length"), std::string(buf)));
+
+  // A HEAD only gets the headers
+  if (req->request == XrdHttpReq::rtHEAD) sp->segs.clear();
+
+  Headers(sid, code, rhdrs, sp->segs.empty());
+  if (sp->segs.empty()) Close(sp);
+}
+
+/******************************************************************************/
+/*                               R e s p o n d                                */
+/******************************************************************************/
+
+void XrdHttpH2::Respond(Stream *sp, int code, const std::string &body,
+                        hdrList *hdrs) {
+  hdrList rhdrs;
+  char buf[32];
+
+  // Send a short text response, the body goes out with the data of the others
+  if (hdrs) rhdrs = *hdrs;
+  snprintf(buf, sizeof(buf), "%d", (int) body.size());
+  rhdrs.push_back(std::make_pair(std::string("content-length"), std::string(buf)));
+  rhdrs.push_back(std::make_pair(std::string("content-type"), std::string("text/plain")));
+
+  TRACEI(REQ, "HTTP/2 stream " << sp->id << " status " << code);
+
+  sp->segs.clear();
+  if (!body.empty()) {
+    Segment seg = {body, 0, (long long) body.size()};
+    sp->segs.push_back(seg);
+  }
+  sp->segNow = 0;
+  sp->segDone = 0;
+
+  Headers(sp->id, code, rhdrs, sp->segs.empty());
+  if (sp->segs.empty()) Close(sp);
+}
+
+/******************************************************************************/
+/*                               H e a d e r s                                */
+/******************************************************************************/
+
+bool XrdHttpH2::Headers(unsigned int sid, int code, const hdrList &hdrs,
+                        bool endStream) {
+  std::string blk;
+  char buf[8];
+
+  // Acknowledge any header table size change first (we keep nothing there)
+  if (sizeUpdate) {
+    XrdHttpHpack::EncodeInt(blk, 0x20, 5, 0);
+    sizeUpdate = false;
+  }
+
+  snprintf(buf, sizeof(buf), "%d", code);
+  XrdHttpHpack::EncodeHdr(blk, ":status", buf);
+  for (size_t i = 0; i < hdrs.size(); i++)
+    XrdHttpHpack::EncodeHdr(blk, hdrs[i].first.c_str(), hdrs[i].second);
+
+  return Emit(H2_HEADERS, H2F_END_HEADERS | (endStream ? H2F_END_STREAM : 0),
+              sid, blk.data(), blk.size());
+}
+
+/******************************************************************************/
+/*                                R e f u s e                                 */
+/******************************************************************************/
+
+void XrdHttpH2::Refuse(unsigned int sid, int code) {
+  char ecode[4];
+
+  TRACEI(REQ, "HTTP/2 stream " << sid << " reset with error " << code);
+  PutInt(ecode, code, 4);
+  Emit(H2_RST_STREAM, 0, sid, ecode, 4);
+}
+
+/******************************************************************************/
+/*                                 C l o s e                                  */
+/******************************************************************************/
+
+void XrdHttpH2::Close(Stream *sp) {
+  streams.erase(sp->id);
+  if (sp->fP) {
+    sp->fP->close();
+    delete sp->fP;
+  }
+  delete sp->req;
+  delete sp;
+}
+
+/******************************************************************************/
+/*                                  P u m p                                   */
+/******************************************************************************/
+
+bool XrdHttpH2::Pump() {
+  std::map<unsigned int, Stream *>::iterator it;
+  long long share, budget;
+  bool moved = false;
+  int nAct = streams.size();
+
+  if (!nAct || connWindow <= 0) return false;
+
+  // Every stream gets an equal share of the output buffer on each round, but
+  // at least a full frame, so they all progress at about the same rate
+  share = std::max((long long) peerFrame, (long long) outMax / nAct);
+
+  for (it = streams.begin(); it != streams.end() && connWindow > 0;) {
+    Stream *sp = (it++)->second;
+    budget = share;
+
+    while (budget > 0 && sp->window > 0 && connWindow > 0) {
+      Segment &seg = sp->segs[sp->segNow];
+      long long q = seg.len - sp->segDone;
+      q = std::min(q, std::min(budget, std::min(sp->window, connWindow)));
+      q = std::min(q, (long long) peerFrame);
+
+      if (outLen + 9 + q > outMax && !Flush()) return false;
+      char *fh = outBuff->buff + outLen;
+
+      if (!seg.text.empty()) memcpy(fh + 9, seg.text.data() + sp->segDone, q);
+      else {
+        XrdSfsXferSize rlen = sp->fP->read(seg.offs + sp->segDone, fh + 9, q);
+        if (rlen <= 0) {
+          TRACEI(ALL, "HTTP/2 stream " << sp->id << " read failed at "
+                      << seg.offs + sp->segDone << "; "
+                      << sp->fP->error.getErrText());
+          Refuse(sp->id, H2E_INTERNAL_ERROR);
+          Close(sp);
+          break;
+        }
+        q = rlen;
+      }
+
+      if ((sp->segDone += q) == seg.len) {
+        sp->segNow++;
+        sp->segDone = 0;
+      }
+      bool last = (sp->segNow == sp->segs.size());
+
+      PutInt(fh, q, 3);
+      fh[3] = H2_DATA;
+      fh[4] = (last ? H2F_END_STREAM : 0);
+      PutInt(fh + 5, sp->id, 4);
+      outLen += 9 + q;
+
+      sp->window -= q;
+      connWindow -= q;
+      budget -= q;
+      moved = true;
+
+      if (last) {
+        Close(sp);
+        break;
+      }
+    }
+  }
+
+  return moved;
+}
+
+/******************************************************************************/
+/*                                O u t p u t                                 */
+/******************************************************************************/
+
+bool XrdHttpH2::Emit(int type, int flags, unsigned int sid, const char *data,
+                     int dlen) {
+  if (!outBuff || error) return false;
+  if (outLen + 9 + dlen > outMax && !Flush()) return false;
+
+  char *fh = outBuff->buff + outLen;
+  PutInt(fh, dlen, 3);
+  fh[3] = (char) type;
+  fh[4] = (char) flags;
+  PutInt(fh + 5, sid, 4);
+  if (dlen) memcpy(fh + 9, data, dlen);
+  outLen += 9 + dlen;
+  return true;
+}
+
+/******************************************************************************/
+
+bool XrdHttpH2::Flush() {
+  if (outLen && !error) {
+    if (prot->SendData(outBuff->buff, outLen)) error = true;
+    outLen = 0;
+  }
+  return !error;
+}
+
+/******************************************************************************/
+
+bool XrdHttpH2::Readable() {
+  struct pollfd pfd;
+
+  if (prot->ishttps && SSL_pending(prot->ssl) > 0) return true;
+
+  pfd.fd = prot->Link->FDnum();
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return poll(&pfd, 1, 0) > 0;
+}
+
+/******************************************************************************/
+
+int XrdHttpH2::Fail(int code) {
+  char gaway[8];
+
+  TRACEI(REQ, "HTTP/2 connection error " << code);
+  PutInt(gaway, lastId, 4);
+  PutInt(gaway + 4, code, 4);
+  Emit(H2_GOAWAY, 0, 0, gaway, 8);
+  Flush();
+  error = true;
+  return -1;
+}
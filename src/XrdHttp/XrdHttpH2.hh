@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRDHTTPH2_H__
+#define __XRDHTTPH2_H__
+
+/** @file  XrdHttpH2.hh
+ * @brief  HTTP/2 framing and stream multiplexing for XrdHttp connections
+ *
+ * An HTTP/2 connection carries many concurrent requests (streams). GET and
+ * HEAD streams are parsed with the same XrdHttpReq header logic used for
+ * HTTP/1.1 and are served straight from the file system, with the data of
+ * all the open streams interleaved on the connection. Any other request is
+ * refused with HTTP_1_1_REQUIRED so that the client retries it over HTTP/1.1
+ * where the full XrdHttpReq machinery is available.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <openssl/ssl.h>
+
+#include "XrdHttpHpack.hh"
+
+class XrdBuffer;
+class XrdHttpProtocol;
+class XrdHttpReq;
+class XrdSfsFile;
+
+class XrdHttpH2 {
+public:
+
+  /// Process whatever the client sent and move data for the open streams
+  /// Return values:
+  ///  1->wait for the client to send more
+  ///  -1->close the connection
+  int Process();
+
+  /// Tells if the bytes start with the HTTP/2 connection preface
+  /// Return values:
+  ///  1->they do, 0->they don't, -1->too few bytes to tell
+  static int isPreface(const char *data, int dlen);
+
+  /// OpenSSL ALPN callback that selects h2 when it's enabled
+  static int ALPNSelect(SSL *ssl, const unsigned char **out,
+                        unsigned char *outlen, const unsigned char *in,
+                        unsigned int inlen, void *arg);
+
+  /// Tells if a connection may be switched to HTTP/2 at all
+  static bool Usable();
+
+  /// Configuration, see the http.h2 directive
+  static bool onTLS;
+  static bool onClear;
+  static int maxStreams;
+
+  XrdHttpH2(XrdHttpProtocol *protinstance);
+  ~XrdHttpH2();
+
+private:
+
+  /// One piece of a response body, either some text or a range of the file
+  struct Segment {
+    std::string text;
+    long long offs;
+    long long len;
+  };
+
+  struct Stream {
+    unsigned int id;
+    XrdHttpReq *req;
+    XrdSfsFile *fP;
+    std::vector<Segment> segs;
+    size_t segNow;
+    long long segDone;
+    long long window;
+  };
+
+  typedef XrdHttpHpack::hdrList hdrList;
+
+  // Frame handling
+  int Frames();
+  int doData(int flags, unsigned int sid, const char *data, int dlen);
+  int doHeaders(unsigned int sid, const char *data, int dlen);
+  int doSettings(int flags, const char *data, int dlen);
+  int doWindow(unsigned int sid, const char *data, int dlen);
+
+  // Stream handling
+  void Request(unsigned int sid, const hdrList &hdrs);
+  void Respond(Stream *sp, int code, const std::string &body,
+               hdrList *hdrs = 0);
+  bool Headers(unsigned int sid, int code, const hdrList &hdrs,
+               bool endStream);
+  void Refuse(unsigned int sid, int code);
+  void Close(Stream *sp);
+  bool Pump();
+
+  // Output
+  bool Emit(int type, int flags, unsigned int sid, const char *data, int dlen);
+  bool Flush();
+  bool Readable();
+  int Fail(int code);
+
+  XrdHttpProtocol *prot;
+  XrdBuffer *outBuff;
+  int outLen;
+  int outMax;
+
+  std::string inBuf;
+  bool gotPreface;
+  bool goaway;
+  bool error;
+
+  std::map<unsigned int, Stream *> streams;
+  unsigned int lastId;
+  long long connWindow;
+  long long initWindow;
+  int peerFrame;
+
+  // Header block being assembled from CONTINUATION frames
+  std::string hBlock;
+  unsigned int hStream;
+
+  // HPACK decoding state
+  XrdHttpHpack hpack;
+  bool sizeUpdate;
+};
+#endif
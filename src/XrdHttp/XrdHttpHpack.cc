@@ -0,0 +1,297 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "XrdHttpHpack.hh"
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+namespace
+{
+// The HPACK static table (RFC 7541 appendix A)
+struct { const char *name; const char *value; } hpStatic[] = {
+  {0, 0},
+  {":authority", ""}, {":method", "GET"}, {":method", "POST"},
+  {":path", "/"}, {":path", "/index.html"}, {":scheme", "http"},
+  {":scheme", "https"}, {":status", "200"}, {":status", "204"},
+  {":status", "206"}, {":status", "304"}, {":status", "400"},
+  {":status", "404"}, {":status", "500"}, {"accept-charset", ""},
+  {"accept-encoding", "gzip, deflate"}, {"accept-language", ""},
+  {"accept-ranges", ""}, {"accept", ""},
+  {"access-control-allow-origin", ""}, {"age", ""}, {"allow", ""},
+  {"authorization", ""}, {"cache-control", ""},
+  {"content-disposition", ""}, {"content-encoding", ""},
+  {"content-language", ""}, {"content-length", ""},
+  {"content-location", ""}, {"content-range", ""}, {"content-type", ""},
+  {"cookie", ""}, {"date", ""}, {"etag", ""}, {"expect", ""},
+  {"expires", ""}, {"from", ""}, {"host", ""}, {"if-match", ""},
+  {"if-modified-since", ""}, {"if-none-match", ""}, {"if-range", ""},
+  {"if-unmodified-since", ""}, {"last-modified", ""}, {"link", ""},
+  {"location", ""}, {"max-forwards", ""}, {"proxy-authenticate", ""},
+  {"proxy-authorization", ""}, {"range", ""}, {"referer", ""},
+  {"refresh", ""}, {"retry-after", ""}, {"server", ""},
+  {"set-cookie", ""}, {"strict-transport-security", ""},
+  {"transfer-encoding", ""}, {"user-agent", ""}, {"vary", ""},
+  {"via", ""}, {"www-authenticate", ""}
+};
+const unsigned int hpStaticNum = sizeof(hpStatic)/sizeof(hpStatic[0]) - 1;
+
+// The HPACK Huffman code is canonical, so the code length of each symbol
+// (RFC 7541 appendix B) is all that is needed to decode it. Symbol 256 is EOS.
+const unsigned char huffLen[257] = {
+  13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+  28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+   6, 10, 10, 12, 13,  6,  8, 11, 10, 10,  8, 11,  8,  6,  6,  6,
+   5,  5,  5,  6,  6,  6,  6,  6,  6,  6,  7,  8, 15,  6, 12, 10,
+  13,  6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+   7,  7,  7,  7,  7,  7,  7,  7,  8,  7,  8, 13, 19, 13, 14,  6,
+  15,  5,  6,  5,  6,  5,  6,  6,  6,  5,  7,  7,  6,  6,  6,  5,
+   6,  7,  6,  5,  5,  6,  7,  7,  7,  7,  7, 15, 11, 14, 13, 28,
+  20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+  24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+  22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+  21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+  26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+  19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+  20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+  26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+  30
+};
+
+// Canonical decoding tables built from the code lengths
+class HuffDecoder {
+public:
+
+  bool Decode(const unsigned char *sp, int slen, std::string &out) const {
+    unsigned int code = 0;
+    int len = 0;
+
+    for (int i = 0; i < slen; i++) {
+      for (int b = 7; b >= 0; b--) {
+        code = (code << 1) | ((sp[i] >> b) & 1);
+        if (++len > maxLen) return false;
+        if (code - first[len] < (unsigned int) count[len]) {
+          int sym = syms[offs[len] + code - first[len]];
+          if (sym == 256) return false;
+          out += (char) sym;
+          code = 0;
+          len = 0;
+        }
+      }
+    }
+
+    // Whatever is left must be padding, i.e. the start of EOS (all ones)
+    return len <= 7 && code == (1U << len) - 1;
+  }
+
+  HuffDecoder() {
+    unsigned int code = 0;
+    int n = 0;
+
+    memset(count, 0, sizeof(count));
+    for (int i = 0; i < 257; i++) count[huffLen[i]]++;
+    for (int len = 1; len <= maxLen; len++) {
+      code = (code + count[len - 1]) << 1;
+      first[len] = code;
+      offs[len] = n;
+      for (int i = 0; i < 257; i++) if (huffLen[i] == len) syms[n++] = i;
+    }
+    first[0] = 0;
+    offs[0] = 0;
+  }
+
+private:
+  static const int maxLen = 30;
+  unsigned int first[maxLen + 1];
+  int count[maxLen + 1];
+  int offs[maxLen + 1];
+  unsigned short syms[257];
+};
+
+const HuffDecoder huffDecoder;
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdHttpHpack::XrdHttpHpack(unsigned int tabMax)
+: dynSize(0), dynMax(tabMax), dynLimit(tabMax) {}
+
+/******************************************************************************/
+/*                                D e c o d e                                 */
+/******************************************************************************/
+
+bool XrdHttpHpack::Decode(const char *hp, int hlen, hdrList &hdrs) {
+  const unsigned char *p = (const unsigned char *) hp, *pend = p + hlen;
+  std::string name, value;
+  unsigned int ix;
+
+  while (p < pend) {
+    int b = *p;
+
+    if (b & 0x80) {
+      // Indexed header field
+      if (!DecodeInt(p, pend, 7, ix) || !Entry(ix, name, value)) return false;
+    } else if ((b & 0xe0) == 0x20) {
+      // Dynamic table size update
+      if (!DecodeInt(p, pend, 5, ix) || ix > dynLimit) return false;
+      dynMax = ix;
+      Evict(0);
+      continue;
+    } else {
+      // Literal, with incremental indexing (01), without (0000) or never (0001)
+      bool incr = (b & 0xc0) == 0x40;
+      if (!DecodeInt(p, pend, (incr ? 6 : 4), ix)) return false;
+      if (ix) {
+        if (!Entry(ix, name, value)) return false;
+      } else if (!DecodeStr(p, pend, name)) return false;
+      if (!DecodeStr(p, pend, value)) return false;
+
+      if (incr) {
+        unsigned int esize = 32 + name.size() + value.size();
+        Evict(esize);
+        if (esize <= dynMax) {
+          dynTab.push_front(std::make_pair(name, value));
+          dynSize += esize;
+        }
+      }
+    }
+    hdrs.push_back(std::make_pair(name, value));
+  }
+  return true;
+}
+
+/******************************************************************************/
+
+bool XrdHttpHpack::DecodeInt(const unsigned char *&hp,
+                             const unsigned char *hend, int nbits, unsigned int &val) {
+  unsigned int mask = (1U << nbits) - 1;
+  int shift = 0;
+
+  if (hp >= hend) return false;
+  val = *hp++ & mask;
+  if (val < mask) return true;
+
+  while (hp < hend && shift <= 21) {
+    unsigned int b = *hp++;
+    val += (b & 0x7f) << shift;
+    shift += 7;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+/******************************************************************************/
+
+bool XrdHttpHpack::DecodeStr(const unsigned char *&hp,
+                             const unsigned char *hend, std::string &str) {
+  bool huff;
+  unsigned int slen;
+
+  if (hp >= hend) return false;
+  huff = (*hp & 0x80) != 0;
+  if (!DecodeInt(hp, hend, 7, slen) || slen > (unsigned int) (hend - hp))
+    return false;
+
+  str.clear();
+  if (!huff) str.assign((const char *) hp, slen);
+  else if (!huffDecoder.Decode(hp, slen, str)) return false;
+
+  hp += slen;
+  return true;
+}
+
+/******************************************************************************/
+
+bool XrdHttpHpack::Entry(unsigned int ix, std::string &name,
+                         std::string &value) const {
+  if (!ix) return false;
+  if (ix <= hpStaticNum) {
+    name = hpStatic[ix].name;
+    value = hpStatic[ix].value;
+    return true;
+  }
+  ix -= hpStaticNum + 1;
+  if (ix >= dynTab.size()) return false;
+  name = dynTab[ix].first;
+  value = dynTab[ix].second;
+  return true;
+}
+
+/******************************************************************************/
+
+void XrdHttpHpack::Evict(unsigned int room) {
+  while (!dynTab.empty() && dynSize + room > dynMax) {
+    dynSize -= 32 + dynTab.back().first.size() + dynTab.back().second.size();
+    dynTab.pop_back();
+  }
+}
+
+/******************************************************************************/
+/*                                E n c o d e                                 */
+/******************************************************************************/
+
+void XrdHttpHpack::EncodeInt(std::string &out, int first, int nbits,
+                             unsigned int val) {
+  unsigned int mask = (1U << nbits) - 1;
+
+  if (val < mask) {
+    out += (char) (first | val);
+    return;
+  }
+  out += (char) (first | mask);
+  val -= mask;
+  while (val >= 128) {
+    out += (char) ((val & 0x7f) | 0x80);
+    val >>= 7;
+  }
+  out += (char) val;
+}
+
+/******************************************************************************/
+
+void XrdHttpHpack::EncodeHdr(std::string &out, const char *name,
+                             const std::string &value) {
+  unsigned int ix, nx = 0;
+
+  // Use a fully indexed field when there is one (e.g. most status codes),
+  // otherwise a literal without indexing, with an indexed name if possible
+  for (ix = 1; ix <= hpStaticNum; ix++) {
+    if (strcmp(hpStatic[ix].name, name)) continue;
+    if (value == hpStatic[ix].value) {
+      EncodeInt(out, 0x80, 7, ix);
+      return;
+    }
+    if (!nx) nx = ix;
+  }
+
+  EncodeInt(out, 0x00, 4, nx);
+  if (!nx) {
+    EncodeInt(out, 0x00, 7, strlen(name));
+    out += name;
+  }
+  EncodeInt(out, 0x00, 7, value.size());
+  out += value;
+}
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRDHTTPHPACK_H__
+#define __XRDHTTPHPACK_H__
+
+/** @file  XrdHttpHpack.hh
+ * @brief  HPACK header compression (RFC 7541) for the HTTP/2 connections
+ *
+ * The decoder keeps the dynamic table of one direction of a connection and
+ * understands everything a client may send, Huffman coded strings included.
+ * The encoder is stateless: it only refers to the static table and never adds
+ * entries to the peer's dynamic table, nor does it use Huffman coding.
+ */
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+class XrdHttpHpack {
+public:
+
+  typedef std::vector<std::pair<std::string, std::string> > hdrList;
+
+  /// Decode a complete header block, appending the fields to hdrs
+  /// Return values:
+  ///  true->the block is valid, false->a compression error
+  bool Decode(const char *hp, int hlen, hdrList &hdrs);
+
+  /// Look up a field by its HPACK index, static or dynamic
+  bool Entry(unsigned int ix, std::string &name, std::string &value) const;
+
+  /// The size (RFC 7541 section 4.1) and number of entries in the dynamic table
+  unsigned int TableSize() const { return dynSize; }
+  unsigned int TableEntries() const { return dynTab.size(); }
+
+  /// Append an integer with an nbits prefix, first holds the pattern bits
+  static void EncodeInt(std::string &out, int first, int nbits,
+                        unsigned int val);
+
+  /// Append a field, indexed if the static table has it, a literal otherwise
+  static void EncodeHdr(std::string &out, const char *name,
+                        const std::string &value);
+
+  /// tabMax is the SETTINGS_HEADER_TABLE_SIZE the peer encodes for
+  XrdHttpHpack(unsigned int tabMax = 4096);
+  ~XrdHttpHpack() {}
+
+private:
+
+  bool DecodeInt(const unsigned char *&hp, const unsigned char *hend,
+                 int nbits, unsigned int &val);
+  bool DecodeStr(const unsigned char *&hp, const unsigned char *hend,
+                 std::string &str);
+  void Evict(unsigned int room);
+
+  std::deque<std::pair<std::string, std::string> > dynTab;
+  unsigned int dynSize;
+  unsigned int dynMax;
+  unsigned int dynLimit;
+};
+#endif
@@ -33,6 +33,7 @@
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include "XrdOuc/XrdOucPinLoader.hh"
+#include "XrdXrootd/XrdXrootdXPath.hh"
 
 #include "XrdHttpTrace.hh"
 #include "XrdHttpProtocol.hh"
@@ -42,6 +43,7 @@
 #include "XrdHttpUtils.hh"
 #include "XrdHttpSecXtractor.hh"
 #include "XrdHttpExtHandler.hh"
+#include "XrdHttpH2.hh"
 
 #include "XrdTls/XrdTlsContext.hh"
 
@@ -53,6 +55,7 @@
 #include <ctype.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <limits.h>
 
 #define XRHTTP_TK_GRACETIME     600
 
@@ -87,6 +90,16 @@ char *XrdHttpProtocol::staticredir = 0;
 XrdOucHash<XrdHttpProtocol::StaticPreloadInfo> *XrdHttpProtocol::staticpreload = 0;
 
 kXR_int32 XrdHttpProtocol::myRole = kXR_isManager;
+int XrdHttpProtocol::sfsdirect = 0;
+int XrdHttpProtocol::sfsinflight = 4;
+XrdSysMutex XrdHttpProtocol::statsMutex;
+long long XrdHttpProtocol::putCnt = 0;
+long long XrdHttpProtocol::putBytes = 0;
+long long XrdHttpProtocol::putUsec = 0;
+int XrdHttpProtocol::putLastKBs = 0;
+int XrdHttpProtocol::putMinKBs = 0;
+int XrdHttpProtocol::putMaxKBs = 0;
+XrdOucEnv *XrdHttpProtocol::xrdEnv = 0;
 bool XrdHttpProtocol::selfhttps2http = false;
 bool XrdHttpProtocol::isdesthttps = false;
 char *XrdHttpProtocol::sslcafile = 0;
@@ -103,9 +116,6 @@ struct XrdHttpProtocol::XrdHttpExtHandlerInfo XrdHttpProtocol::exthandler[MAX_XR
 int XrdHttpProtocol::exthandlercnt = 0;
 std::map< std::string, std::string > XrdHttpProtocol::hdr2cgimap; 
 
-static const unsigned char *s_server_session_id_context = (const unsigned char *) "XrdHTTPSessionCtx";
-static int s_server_session_id_context_len = 18;
-
 XrdScheduler *XrdHttpProtocol::Sched = 0; // System scheduler
 XrdBuffManager *XrdHttpProtocol::BPool = 0; // Buffer manager
 XrdSysError XrdHttpProtocol::eDest = 0; // Error message handler
@@ -622,11 +632,13 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
 
       if (res < 0) {
           ERR_print_errors(sslbio_err);
+          XrdTlsContext::HandShake(ssl, false);
           SSL_free(ssl);
           ssl = 0;
           return -1;
         }
       BIO_set_nbio(sbio, 0);
+      XrdTlsContext::HandShake(ssl, true);
 
       res = SSL_get_verify_result(ssl);
       TRACEI(DEBUG, " SSL_get_verify_result returned :" << res);
@@ -643,8 +655,19 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
 
       if (res != X509_V_OK) return -1;
       ssldone = true;
+
+      // Switch to HTTP/2 if that is what was negotiated
+      if (XrdHttpH2::onTLS) {
+        const unsigned char *alpn;
+        unsigned int alpnlen;
+        SSL_get0_alpn_selected(ssl, &alpn, &alpnlen);
+        if (alpnlen == 2 && !memcmp(alpn, "h2", 2)) h2 = new XrdHttpH2(this);
+      }
     }
 
+  // An HTTP/2 connection has its own framing and multiplexes its requests
+  if (h2) return h2->Process();
+
 
 
   if (!DoingLogin) {
@@ -668,6 +691,16 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
   }
   DoingLogin = false;
 
+  // A client with prior knowledge of HTTP/2 opens with the connection preface
+  if (!ishttps && XrdHttpH2::onClear && !CurrentReq.headerok
+      && CurrentReq.request == XrdHttpReq::rtUnset && myBuffEnd >= myBuffStart) {
+    int rc = XrdHttpH2::isPreface(myBuffStart, myBuffEnd - myBuffStart);
+    if (rc < 0) return 1;
+    if (rc > 0 && XrdHttpH2::Usable()) {
+      h2 = new XrdHttpH2(this);
+      return h2->Process();
+    }
+  }
 
   // Read the next request header, that is, read until a double CRLF is found
 
@@ -973,34 +1006,40 @@ void XrdHttpProtocol::Recycle(XrdLink *lp, int csec, const char *reason) {
 }
 
 int XrdHttpProtocol::Stats(char *buff, int blen, int do_sync) {
-  // Synchronize statistics if need be
-  //
-  //  if (do_sync) {
-  //
-  //    SI->statsMutex.Lock();
-  //    SI->readCnt += numReads;
-  //    cumReads += numReads;
-  //    numReads = 0;
-  //    SI->prerCnt += numReadP;
-  //    cumReadP += numReadP;
-  //    numReadP = 0;
-  //    SI->rvecCnt += numReadV;
-  //    cumReadV += numReadV;
-  //    numReadV = 0;
-  //    SI->rsegCnt += numSegsV;
-  //    cumSegsV += numSegsV;
-  //    numSegsV = 0;
-  //    SI->writeCnt += numWrites;
-  //    cumWrites += numWrites;
-  //    numWrites = 0;
-  //    SI->statsMutex.UnLock();
-  //  }
-  //
-  //  // Now return the statistics
-  //  //
-  //  return SI->Stats(buff, blen, do_sync);
+  static const char statfmt[] = "<stats id=\"http\"><put><num>%lld</num>"
+  "<bytes>%lld</bytes><us>%lld</us>"
+  "<kbs><last>%d</last><min>%d</min><max>%d</max></kbs></put></stats>";
+  static const long long LLMax = 0x7fffffffffffffffLL;
+  static const int INMax = 0x7fffffff;
+  int len;
 
-  return 0;
+  // If no buffer, caller wants the maximum size we will generate
+  if (!buff) {
+    char dummy[512];
+    return snprintf(dummy, sizeof(dummy), statfmt, LLMax, LLMax, LLMax,
+                    INMax, INMax, INMax);
+  }
+
+  // Format our statistics. The rates are those of single uploads, in KB/s.
+  statsMutex.Lock();
+  len = snprintf(buff, blen, statfmt, putCnt, putBytes, putUsec,
+                 putLastKBs, putMinKBs, putMaxKBs);
+  statsMutex.UnLock();
+
+  return (len < blen ? len : 0);
+}
+
+void XrdHttpProtocol::PutStats(long long bytes, long long usec) {
+  int kbs = (int) (usec > 0 ? (bytes * 1000000 / 1024) / usec : 0);
+
+  statsMutex.Lock();
+  if (!putCnt || kbs < putMinKBs) putMinKBs = kbs;
+  if (kbs > putMaxKBs) putMaxKBs = kbs;
+  putLastKBs = kbs;
+  putCnt++;
+  putBytes += bytes;
+  putUsec += usec;
+  statsMutex.UnLock();
 }
 
 
@@ -1089,6 +1128,8 @@ int XrdHttpProtocol::Config(const char *ConfigFN, XrdOucEnv *myEnv) {
       else if TS_Xeq("staticpreload", xstaticpreload);
       else if TS_Xeq("listingdeny", xlistdeny);
       else if TS_Xeq("header2cgi", xheader2cgi);
+      else if TS_Xeq("sfsdirect", xsfsdirect);
+      else if TS_Xeq("h2", xh2);
       else {
         eDest.Say("Config warning: ignoring unknown directive '", var, "'.");
         Config.Echo();
@@ -1102,6 +1143,12 @@ int XrdHttpProtocol::Config(const char *ConfigFN, XrdOucEnv *myEnv) {
     }
   }
 
+  // HTTP/2 streams bypass the bridge, so they need the direct data path
+  if ((XrdHttpH2::onTLS || XrdHttpH2::onClear) && !(sfsdirect & sfsGET)) {
+    eDest.Say("Config warning: http.h2 requires 'http.sfsdirect get'; "
+              "HTTP/2 disabled.");
+    XrdHttpH2::onTLS = XrdHttpH2::onClear = false;
+  }
 
   if (sslcert)
     InitSecurity();
@@ -1409,6 +1456,114 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
   return 0;
 }
 
+int XrdHttpProtocol::RecvData(char *buff, int blen) {
+  char *data;
+  int rlen;
+
+  // What has already been read comes first
+  if (BuffUsed()) {
+    rlen = BuffgetData(blen, &data, false);
+    memcpy(buff, data, rlen);
+    return rlen;
+  }
+
+  // Then we read directly into the caller's buffer
+  if (ishttps) {
+    rlen = SSL_read(ssl, buff, blen);
+    if (rlen <= 0) {
+      Link->setEtext("link SSL read error");
+      ERR_print_errors(sslbio_err);
+      return -1;
+    }
+    return rlen;
+  }
+
+  rlen = Link->Recv(buff, blen, readWait);
+  if (rlen == 0) {
+    Link->setEtext("link read error or closed");
+    return -1;
+  }
+  if (rlen < 0) {
+    Link->setEtext("link timeout");
+    return -1;
+  }
+  return rlen;
+}
+
+int XrdHttpProtocol::SendData(const struct iovec *iov, int iovcnt) {
+
+  // TLS has no gather write, each piece becomes a record
+  if (ishttps) {
+    for (int i = 0; i < iovcnt; i++)
+      if (SendData((const char *) iov[i].iov_base, iov[i].iov_len)) return -1;
+    return 0;
+  }
+
+  // A single writev can only take so many pieces
+  while (iovcnt > 0) {
+    int n = (iovcnt > IOV_MAX ? IOV_MAX : iovcnt), bytes = 0;
+    for (int i = 0; i < n; i++) bytes += iov[i].iov_len;
+    TRACE(REQ, "Sending " << bytes << " bytes in " << n << " pieces");
+    if (bytes && Link->Send(iov, n, bytes) <= 0) return -1;
+    iov += n;
+    iovcnt -= n;
+  }
+
+  return 0;
+}
+
+/// Get the file system that the xrootd protocol uses, if any
+
+namespace {
+XrdSysMutex     sfsMutex;
+XrdXrootdXPath *sfsExports = 0;
+XrdXrootdXPath *sfsRedirs  = 0;
+}
+
+XrdSfsFileSystem *XrdHttpProtocol::getSFS() {
+  static XrdSfsFileSystem *theFS = 0;
+  static bool tried = false;
+  XrdSysMutexHelper mHelper(sfsMutex);
+
+  // The xrootd protocol may be configured after us, so we look late. Without
+  // its export list we could not tell what may be opened, so we don't.
+  //
+  if (!tried) {
+    if (xrdEnv) {
+      theFS      = (XrdSfsFileSystem *)xrdEnv->GetPtr("XrdSfsFileSystem*");
+      sfsExports = (XrdXrootdXPath *)xrdEnv->GetPtr("XrdXrootdXPList*");
+      sfsRedirs  = (XrdXrootdXPath *)xrdEnv->GetPtr("XrdXrootdRPList*");
+    }
+    if (!sfsExports) theFS = 0;
+    if (!theFS) eDest.Say("Config warning: no file system found; "
+                          "http.sfsdirect requests will use the bridge.");
+    tried = true;
+  }
+  return theFS;
+}
+
+bool XrdHttpProtocol::sfsPathOK(std::string &path) {
+  std::string::size_type n;
+
+  // Like xrootd, refuse relative paths and relative components
+  //
+  if (path.empty() || path[0] != '/' || path.find("/.") != std::string::npos)
+    return false;
+
+  // Squash repeated slashes before the export check, as xrootd does
+  //
+  while ((n = path.find("//")) != std::string::npos) path.erase(n, 1);
+
+  // The path must be exported and not statically redirected, the bridge
+  // handles the latter
+  //
+  if (!sfsExports || !sfsExports->Validate(path.c_str(), path.length()))
+    return false;
+  if (sfsRedirs && sfsRedirs->Validate(path.c_str(), path.length()))
+    return false;
+  return true;
+}
+
 int XrdHttpProtocol::StartSimpleResp(int code, const char *desc, const char *header_to_add, long long bodylen, bool keepalive) {
   std::stringstream ss;
   const std::string crlf = "\r\n";
@@ -1524,6 +1679,7 @@ int XrdHttpProtocol::Configure(char *parms, XrdProtocol_Config * pi) {
   //  SI = new XrdXrootdStats(pi->Stats);
   Sched = pi->Sched;
   BPool = pi->BPool;
+  xrdEnv = pi->theEnv;
   hailWait = 10000;
   readWait = 30000;
 
@@ -1670,9 +1826,12 @@ int XrdHttpProtocol::InitSecurity() {
 
   sslctx = SSL_CTX_new((SSL_METHOD *)meth);
   //SSL_CTX_set_min_proto_version(sslctx, TLS1_2_VERSION);
-  SSL_CTX_set_session_cache_mode(sslctx, SSL_SESS_CACHE_SERVER);
-  SSL_CTX_set_session_id_context(sslctx, s_server_session_id_context,
-          s_server_session_id_context_len);
+
+  // Resume sessions through the cache and ticket keys shared with the
+  // other TLS users in this server
+  if (!XrdTlsContext::ServerSessions(sslctx, "XrdHTTPSessionCtx")) {
+    TRACE(EMSG, " Error setting up TLS session resumption.");
+  }
 
   /* An error write context */
   sslbio_err = BIO_new_fp(stderr, BIO_NOCLOSE);
@@ -1740,6 +1899,9 @@ int XrdHttpProtocol::InitSecurity() {
 
   }
 
+  // Let clients negotiate HTTP/2, if so configured
+  if (XrdHttpH2::onTLS) SSL_CTX_set_alpn_select_cb(sslctx, XrdHttpH2::ALPNSelect, 0);
+
   if (secxtractor) secxtractor->Init(sslctx, XrdHttpTrace->What);
 
   ERR_print_errors(sslbio_err);
@@ -1750,6 +1912,11 @@ void XrdHttpProtocol::Cleanup() {
 
   TRACE(ALL, " Cleanup");
 
+  if (h2) {
+    delete h2;
+    h2 = 0;
+  }
+
   if (BPool && myBuff) {
     BuffConsume(BuffUsed());
     BPool->Release(myBuff);
@@ -1828,6 +1995,7 @@ void XrdHttpProtocol::Reset() {
   Bridge = 0;
   ssl = 0;
   sbio = 0;
+  h2 = 0;
 
 }
 
@@ -2135,6 +2303,120 @@ int XrdHttpProtocol::xlistdeny(XrdOucStream & Config) {
   return 0;
 }
 
+/******************************************************************************/
+/*                                 x s f s d i r e c t                        */
+/******************************************************************************/
+
+/* Function: xsfsdirect
+
+   Purpose:  To parse the directive: sfsdirect {off | [get] [put] [inflight <n>]}
+
+             get      serve GET requests by reading the file system directly
+                      (using sendfile when possible) instead of the bridge
+             put      serve PUT requests by writing the file system directly
+             inflight the number of buffers of a PUT that may be being
+                      written while more data is received, 1 to 64
+                      (default 4)
+             off      always use the bridge (the default)
+
+   Output: 0 upon success or !0 upon failure.
+ */
+
+int XrdHttpProtocol::xsfsdirect(XrdOucStream & Config) {
+  char *val;
+  int what = 0;
+
+  val = Config.GetWord();
+  if (!val || !val[0]) {
+    eDest.Emsg("Config", "sfsdirect argument not specified");
+    return 1;
+  }
+
+  while (val && val[0]) {
+    if (!strcmp(val, "get")) what |= sfsGET;
+    else if (!strcmp(val, "put")) what |= sfsPUT;
+    else if (!strcmp(val, "off")) what = 0;
+    else if (!strcmp(val, "inflight")) {
+      int n;
+      if (!(val = Config.GetWord()) || (n = atoi(val)) < 1 || n > 64) {
+        eDest.Emsg("Config", "invalid sfsdirect inflight value");
+        return 1;
+      }
+      sfsinflight = n;
+    } else {
+      eDest.Emsg("Config", "invalid sfsdirect argument -", val);
+      return 1;
+    }
+    val = Config.GetWord();
+  }
+
+  sfsdirect = what;
+  return 0;
+}
+
+/******************************************************************************/
+/*                                        x h 2                               */
+/******************************************************************************/
+
+/* Function: xh2
+
+   Purpose:  To parse the directive: h2 {off | on [clear] [maxstreams <n>]}
+
+             on       let https clients negotiate HTTP/2 (ALPN)
+             clear    also accept HTTP/2 over plain http from clients that
+                      start with it (prior knowledge)
+             maxstreams
+                      the number of concurrent requests a connection may
+                      carry, 1 to 1024 (default 128)
+             off      only speak HTTP/1.1 (the default)
+
+             HTTP/2 GET and HEAD requests are served from the file system
+             and thus require http.sfsdirect get; any other request is sent
+             back to HTTP/1.1.
+
+   Output: 0 upon success or !0 upon failure.
+ */
+
+int XrdHttpProtocol::xh2(XrdOucStream & Config) {
+  char *val;
+  bool tls = false, clear = false;
+  int n = XrdHttpH2::maxStreams;
+
+  val = Config.GetWord();
+  if (!val || !val[0]) {
+    eDest.Emsg("Config", "h2 argument not specified");
+    return 1;
+  }
+
+  if (!strcmp(val, "off")) {
+    XrdHttpH2::onTLS = XrdHttpH2::onClear = false;
+    return 0;
+  }
+  if (strcmp(val, "on")) {
+    eDest.Emsg("Config", "invalid h2 argument -", val);
+    return 1;
+  }
+  tls = true;
+
+  while ((val = Config.GetWord()) && val[0]) {
+    if (!strcmp(val, "clear")) clear = true;
+    else if (!strcmp(val, "maxstreams")) {
+      if (!(val = Config.GetWord()) || (n = atoi(val)) < 1 || n > 1024) {
+        eDest.Emsg("Config", "invalid h2 maxstreams value");
+        return 1;
+      }
+    } else {
+      eDest.Emsg("Config", "invalid h2 argument -", val);
+      return 1;
+    }
+  }
+
+  XrdHttpH2::onTLS = tls;
+  XrdHttpH2::onClear = clear;
+  XrdHttpH2::maxStreams = n;
+  return 0;
+}
+
 /******************************************************************************/
 /*                                 x l i s t r e d i r                        */
 /******************************************************************************/
@@ -71,11 +71,16 @@ class XrdHttpSecXtractor;
 class XrdHttpExtHandler;
 struct XrdVersionInfo;
 class XrdOucGMap;
+class XrdSfsFileSystem;
+class XrdXrootdXPath;
+class XrdHttpH2;
 
 class XrdHttpProtocol : public XrdProtocol {
   
   friend class XrdHttpReq;
   friend class XrdHttpExtReq;
+  friend class XrdHttpH2;
+  friend class XrdHttpDirectSink;
   
 public:
 
@@ -142,6 +147,9 @@ private:
   /// Send some generic data to the client
   int SendData(const char *body, int bodylen);
 
+  /// Send some generic data to the client, gathered from a vector
+  int SendData(const struct iovec *iov, int iovcnt);
+
   /// Deallocate resources, in order to reutilize an object of this class
   void Cleanup();
 
@@ -156,6 +164,11 @@ private:
   /// This primitive, for the way it is used, is not supposed to block
   int getDataOneShot(int blen, bool wait=false);
 
+  /// Get up to blen bytes of a request body into buff, first those already
+  /// in mybuff and then straight from the connection, waiting for them.
+  /// Returns the number of bytes or -1 if the connection failed
+  int RecvData(char *buff, int blen);
+
   /// Create a new BIO object from an XrdLink.  Returns NULL on failure.
   static BIO *CreateBIO(XrdLink *lp);
   
@@ -180,6 +193,8 @@ private:
   static int xsslverifydepth(XrdOucStream &Config);
   static int xsecretkey(XrdOucStream &Config);
   static int xheader2cgi(XrdOucStream &Config);
+  static int xsfsdirect(XrdOucStream &Config);
+  static int xh2(XrdOucStream &Config);
   
   static XrdHttpSecXtractor *secxtractor;
   
@@ -270,6 +285,9 @@ private:
   /// connection being established
   bool ssldone;
 
+  /// The HTTP/2 session, if the client switched to it
+  XrdHttpH2 *h2;
+
 
 protected:
 
@@ -372,10 +390,37 @@ protected:
 
   /// Our role
   static kXR_int32 myRole;
+
+  /// Requests that bypass the bridge and use the file system directly
+  static int sfsdirect;
+  static const int sfsGET = 1;
+  static const int sfsPUT = 2;
+
+  /// How many buffers a direct PUT may have being written behind the client
+  static int sfsinflight;
+
+  /// Account for a completed upload in the statistics
+  static void PutStats(long long bytes, long long usec);
+
+  /// The environment where the xrootd protocol publishes its file system
+  static XrdOucEnv *xrdEnv;
+
+  /// The file system used by the direct data path, NULL if there is none
+  static XrdSfsFileSystem *getSFS();
+
+  /// Check that the direct data path may open a path, the way the xrootd
+  /// protocol checks an open. The path is squashed in place. Returns false
+  /// if the path is not exported or is subject to static redirection.
+  static bool sfsPathOK(std::string &path);
   
   /// Rules that turn HTTP headers to cgi tokens in the URL, for internal comsumption
   static std::map< std::string, std::string > hdr2cgimap;
 
+  /// Upload statistics, see Stats()
+  static XrdSysMutex statsMutex;
+  static long long putCnt, putBytes, putUsec;
+  static int putLastKBs, putMinKBs, putMaxKBs;
+
   /// Type identifier for our custom BIO objects.
   static int m_bio_type;
 
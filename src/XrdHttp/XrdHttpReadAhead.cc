@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "XrdHttpReadAhead.hh"
+
+/******************************************************************************/
+/*                                  P u m p                                   */
+/******************************************************************************/
+
+int XrdHttpReadAhead::Pump(XrdScheduler *sp, XrdSfsFile *fp, long long offs,
+                           long long blen, char *bp[2], int bsz, Sink &sink,
+                           long long &done) {
+  XrdHttpReadAhead rdAhead;
+  XrdSfsXferSize rlen;
+  int cur = 0;
+
+  done = 0;
+  rlen = fp->read(offs, bp[0], (int) std::min(blen, (long long) bsz));
+
+  while (true) {
+    if (rlen <= 0) return -1;
+    done += rlen;
+
+    // Without a second buffer (the file fitting into one) a short read means
+    // the rest can only be read once the current buffer has been sent
+    bool more = (done < blen), ahead = (more && bp[1]);
+    int want = (int) std::min(blen - done, (long long) bsz);
+    if (ahead) rdAhead.Start(sp, fp, offs + done, bp[1 - cur], want);
+
+    if (sink.Send(bp[cur], rlen)) {
+      if (ahead) rdAhead.Wait();
+      return 1;
+    }
+    if (!more) return 0;
+
+    if (ahead) {
+      rlen = rdAhead.Wait();
+      cur = 1 - cur;
+    } else rlen = fp->read(offs + done, bp[cur], want);
+  }
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRDHTTPREADAHEAD_H__
+#define __XRDHTTPREADAHEAD_H__
+
+/** @file  XrdHttpReadAhead.hh
+ * @brief  Overlapping the reads of a direct GET with sending the data
+ *
+ * Reads the next block (or batch of ranges) of a file in a scheduler thread,
+ * so that it overlaps with sending the current one to the client.
+ */
+
+#include <vector>
+
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdHttpReadAhead : public XrdJob {
+public:
+
+  /// Where Pump() sends the data, Send() returns 0 on success
+  class Sink {
+  public:
+    virtual int Send(const char *buff, int blen) = 0;
+    virtual ~Sink() {}
+  };
+
+  void DoIt() {
+    if (vec) rlen = fP->readv(&(*vec)[0], vec->size());
+    else rlen = fP->read(offs, buff, blen);
+    done.Post();
+  }
+
+  void Start(XrdScheduler *sp, XrdSfsFile *fp, long long off, char *bp, int bl) {
+    fP = fp; offs = off; buff = bp; blen = bl; vec = 0;
+    sp->Schedule((XrdJob *)this);
+  }
+
+  void Start(XrdScheduler *sp, XrdSfsFile *fp, std::vector<XrdOucIOVec> *vp) {
+    fP = fp; vec = vp;
+    sp->Schedule((XrdJob *)this);
+  }
+
+  XrdSfsXferSize Wait() {
+    done.Wait();
+    return rlen;
+  }
+
+  /// Send blen bytes of the file starting at offs. With a second buffer the
+  /// next read overlaps the current send, with bp[1] being 0 the reads are
+  /// done one after the other into bp[0]. A read may come back short.
+  /// Return values:
+  ///  0->all sent, -1->a read failed, 1->the sink failed
+  ///  done holds the number of bytes read
+  static int Pump(XrdScheduler *sp, XrdSfsFile *fp, long long offs,
+                  long long blen, char *bp[2], int bsz, Sink &sink,
+                  long long &done);
+
+  XrdHttpReadAhead() : XrdJob("http readahead"), fP(0), vec(0), offs(0),
+                       buff(0), blen(0), rlen(0), done(0) {}
+
+private:
+  XrdSfsFile *fP;
+  std::vector<XrdOucIOVec> *vec;
+  long long offs;
+  char *buff;
+  int blen;
+  XrdSfsXferSize rlen;
+  XrdSysSemaphore done;
+};
+
+#endif
@@ -42,13 +42,22 @@
 #include "XrdHttpExtHandler.hh"
 #include <string.h>
 #include <arpa/inet.h>
+#include <errno.h>
+#include <sys/time.h>
 #include <sstream>
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdHttpProtocol.hh"
+#include "XrdHttpReadAhead.hh"
 #include "Xrd/XrdLink.hh"
 #include "XrdXrootd/XrdXrootdBridge.hh"
 #include "Xrd/XrdBuffer.hh"
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSys/XrdSysE2T.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 #include <algorithm> 
 #include <functional> 
@@ -63,6 +72,12 @@
 #define MAX_TK_LEN      256
 #define MAX_RESOURCE_LEN 16384
 
+// Block size used by the direct GET path when it can't use sendfile
+#define DIRECT_BLKSZ     2*1024*1024
+
+// Max bytes handed to a single sendfile by the direct GET path
+#define DIRECT_SFMAX     16*1024*1024
+
 // This is to fix the trace macros
 #define TRACELINK prot->Link
 
@@ -357,29 +372,16 @@ int XrdHttpReq::parseRWOp(char *str) {
   }
 
 
-  // This can be largely optimized
+  // The reads are laid out by coalesceRWOps(), once we know the file size
   if (ok) {
 
-    kXR_int32 len_ok = 0;
     long long sz = o1.byteend - o1.bytestart + 1;
-    kXR_int32 newlen = sz;
 
     if (filesize > 0)
-      newlen = (kXR_int32) min(filesize - o1.bytestart, sz);
+      sz = min(filesize - o1.bytestart, sz);
 
     rwOps.push_back(o1);
-
-    while (len_ok < newlen) {
-      ReadWriteOp nfo;
-      int len = min(newlen - len_ok, READV_MAXCHUNKSIZE);
-
-      nfo.bytestart = o1.bytestart + len_ok;
-      nfo.byteend = nfo.bytestart + len - 1;
-      len_ok += len;
-      rwOps_split.push_back(nfo);
-    }
-    length += len_ok;
-
+    if (sz > 0) length += sz;
 
   }
 
@@ -511,31 +513,95 @@ void XrdHttpReq::clientUnMarshallReadAheadList(int nitems) {
   }
 }
 
-int XrdHttpReq::ReqReadV() {
+static bool rwOpBefore(const ReadWriteOp &a, const ReadWriteOp &b) {
+  return a.bytestart < b.bytestart;
+}
 
+bool XrdHttpReq::coalesceRWOps() {
+  std::vector<ReadWriteOp> ops;
+  bool unsat = false;
+
+  // Drop what is malformed or past the end of the file, clip what crosses it
+  for (size_t i = 0; i < rwOps.size(); i++) {
+    ReadWriteOp o = rwOps[i];
+    if (o.bytestart < 0 || o.byteend < o.bytestart) continue;
+    if (o.bytestart >= filesize) {
+      unsat = true;
+      continue;
+    }
+    if (o.byteend > filesize - 1) o.byteend = filesize - 1;
+    ops.push_back(o);
+  }
+
+  // Nothing but unsatisfiable ranges is an error the caller reports
+  if (ops.empty() && unsat) return false;
 
-  kXR_int64 total_len = 0;
+  rwOps.clear();
+  rwOps_split.clear();
+  rwOpDone = rwOpSplitDone = 0;
   rwOpPartialDone = 0;
-  // Now we build the protocol-ready read ahead list
-  //  and also put the correct placeholders inside the cache
-  int n = rwOps_split.size();
-  if (!ralist) ralist = (readahead_list *) malloc(n * sizeof (readahead_list));
 
-  int j = 0;
-  for (int i = 0; i < n; i++) {
+  // Nothing usable at all means the client wants the whole file
+  if (ops.empty()) {
+    length = filesize;
+    return true;
+  }
+  length = 0;
+
+  // Sort the ranges and merge those that overlap or are separated by less
+  // than what a part header would cost us, as RFC 7233 allows
+  std::sort(ops.begin(), ops.end(), rwOpBefore);
+
+  rwOps.push_back(ops[0]);
+  for (size_t i = 1; i < ops.size(); i++) {
+    ReadWriteOp &last = rwOps.back();
+    long long gap = ops[i].bytestart - last.byteend - 1;
+    if (gap < (long long) buildPartialHdr(ops[i].bytestart, ops[i].byteend,
+                                          filesize, (char *) "123456").size()) {
+      if (ops[i].byteend > last.byteend) last.byteend = ops[i].byteend;
+    } else rwOps.push_back(ops[i]);
+  }
+
+  // Lay out the reads. Nearby ranges are read as one, the reads being chunked
+  // to what a readv element can hold.
+  for (size_t i = 0; i < rwOps.size();) {
+    long long beg = rwOps[i].bytestart, end = rwOps[i].byteend;
+
+    length += end - beg + 1;
+    while (++i < rwOps.size() && rwOps[i].bytestart - end - 1 <= READV_MAXGAP) {
+      end = rwOps[i].byteend;
+      length += end - rwOps[i].bytestart + 1;
+    }
+
+    for (long long offs = beg; offs <= end; offs += READV_MAXCHUNKSIZE) {
+      ReadWriteOp nfo;
+      nfo.bytestart = offs;
+      nfo.byteend = min(end, offs + READV_MAXCHUNKSIZE - 1);
+      rwOps_split.push_back(nfo);
+    }
+  }
+
+  return true;
+}
+
+int XrdHttpReq::ReqReadV() {
+
 
-    // We can suppose that we know the length of the file
-    // Hence we can sort out requests that are out of boundary or trim them
-    if (rwOps_split[i].bytestart > filesize) continue;
-    if (rwOps_split[i].byteend > filesize - 1) rwOps_split[i].byteend = filesize - 1;
+  // Now we build the protocol-ready read ahead list for the next batch of
+  // reads. A readv can only take so many of them.
+  size_t n = min(rwOps_split.size() - rwOpSplitDone, (size_t) READV_MAXCHUNKS);
+  if (!ralist) ralist = (readahead_list *) malloc(READV_MAXCHUNKS * sizeof (readahead_list));
+
+  int j = 0;
+  for (size_t i = rwOpSplitDone; i < rwOpSplitDone + n; i++) {
 
     memcpy(&(ralist[j].fhandle), this->fhandle, 4);
 
     ralist[j].offset = rwOps_split[i].bytestart;
     ralist[j].rlen = rwOps_split[i].byteend - rwOps_split[i].bytestart + 1;
-    total_len += ralist[j].rlen;
     j++;
   }
+  rwOpSplitDone += n;
 
   if (j > 0) {
 
@@ -554,6 +620,128 @@ int XrdHttpReq::ReqReadV() {
   return (j * sizeof (struct readahead_list));
 }
 
+int XrdHttpReq::nextReadV(std::vector<XrdOucIOVec> &vec, char *buff, int bsize) {
+  int used = 0;
+
+  vec.clear();
+  while (rwOpSplitDone < rwOps_split.size() && vec.size() < READV_MAXCHUNKS) {
+    ReadWriteOp &op = rwOps_split[rwOpSplitDone];
+    int len = (int) (op.byteend - op.bytestart + 1);
+    if (used + len > bsize) break;
+
+    XrdOucIOVec v;
+    v.offset = op.bytestart;
+    v.size = len;
+    v.info = 0;
+    v.data = buff + used;
+    vec.push_back(v);
+
+    used += len;
+    rwOpSplitDone++;
+  }
+
+  return used;
+}
+
+int XrdHttpReq::addMultipart(long long offs, const char *data, long long dlen) {
+  long long end = offs + dlen;
+
+  while (rwOpDone < rwOps.size()) {
+    ReadWriteOp &op = rwOps[rwOpDone];
+    long long pos = op.bytestart + rwOpPartialDone;
+
+    // Whatever precedes the part we are on is a gap we read but don't send
+    if (pos >= end) break;
+    if (pos < offs) {
+      TRACE(ALL, " Missing data for range " << op.bytestart << "-" << op.byteend);
+      return -1;
+    }
+
+    if (rwOpPartialDone == 0) {
+      TRACEI(REQ, "Sending multipart: " << op.bytestart << "-" << op.byteend);
+      std::string s = buildPartialHdr(op.bytestart, op.byteend, filesize, (char *) "123456");
+      mpSeg hdr = {0, -1, (long long) s.size()};
+      mpHdrs += s;
+      mpSegs.push_back(hdr);
+    }
+
+    long long n = min(op.byteend + 1, end) - pos;
+    mpSeg seg = {(data ? data + (pos - offs) : 0), pos, n};
+    mpSegs.push_back(seg);
+
+    rwOpPartialDone += n;
+    if (rwOpPartialDone > op.byteend - op.bytestart) {
+      rwOpDone++;
+      rwOpPartialDone = 0;
+      if (rwOpDone == rwOps.size()) {
+        std::string s = buildPartialHdrEnd((char *) "123456");
+        mpSeg trl = {0, -1, (long long) s.size()};
+        mpHdrs += s;
+        mpSegs.push_back(trl);
+      }
+    }
+  }
+
+  return 0;
+}
+
+int XrdHttpReq::sendMultipart(int fd) {
+  const char *hp = mpHdrs.c_str();
+  int rc = 0;
+
+  if (fd < 0) {
+    // Everything is in memory, gather it into a single write
+    mpIov.resize(mpSegs.size());
+    for (size_t i = 0; i < mpSegs.size(); i++) {
+      if (mpSegs[i].offs < 0) {
+        mpIov[i].iov_base = (void *) hp;
+        hp += mpSegs[i].len;
+      } else mpIov[i].iov_base = (void *) mpSegs[i].data;
+      mpIov[i].iov_len = mpSegs[i].len;
+    }
+    if (!mpIov.empty()) rc = prot->SendData(&mpIov[0], mpIov.size());
+  } else {
+    // The part headers come from memory and the data from the file
+    XrdLink::sfVec sfv[XrdOucSFVec::sfMax];
+    int n = 0;
+
+    for (size_t i = 0; i < mpSegs.size() && !rc; i++) {
+      if (mpSegs[i].offs < 0) {
+        sfv[n].buffer = (char *) hp;
+        sfv[n].fdnum = -1;
+        hp += mpSegs[i].len;
+      } else {
+        sfv[n].offset = mpSegs[i].offs;
+        sfv[n].fdnum = fd;
+      }
+      sfv[n].sendsz = (int) mpSegs[i].len;
+      if (++n == XrdOucSFVec::sfMax || i + 1 == mpSegs.size()) {
+        if (prot->Link->Send(sfv, n) < 0) rc = -1;
+        n = 0;
+      }
+    }
+  }
+
+  mpSegs.clear();
+  mpHdrs.clear();
+  return rc;
+}
+
+long long XrdHttpReq::multipartLength() {
+  long long cnt = 0;
+
+  for (size_t i = 0; i < rwOps.size(); i++) {
+    cnt += (rwOps[i].byteend - rwOps[i].bytestart + 1);
+    cnt += buildPartialHdr(rwOps[i].bytestart,
+            rwOps[i].byteend,
+            filesize,
+            (char *) "123456").size();
+  }
+  cnt += buildPartialHdrEnd((char *) "123456").size();
+
+  return cnt;
+}
+
 std::string XrdHttpReq::buildPartialHdr(long long bytestart, long long byteend, long long fsz, char *token) {
   ostringstream s;
 
@@ -956,6 +1144,473 @@ void XrdHttpReq::mapXrdErrorToHttpStatus() {
   }
 }
 
+/// Hands the data read by the direct GET path to the client
+
+class XrdHttpDirectSink : public XrdHttpReadAhead::Sink {
+public:
+
+  int Send(const char *buff, int blen) {return prot->SendData(buff, blen);}
+
+  XrdHttpDirectSink(XrdHttpProtocol *p) : prot(p) {}
+
+private:
+  XrdHttpProtocol *prot;
+};
+
+/// Writes the buffers of an upload behind the client, so that receiving the
+/// next buffer overlaps with writing the previous ones. At most a fixed number
+/// of buffers are in flight. The writes use the aio interface and are started
+/// from a scheduler thread, as the file system may well do them synchronously.
+
+class XrdHttpWriteBehind {
+public:
+
+  class Block : public XrdSfsAio, public XrdJob {
+  public:
+
+    void DoIt() {
+      // A file system that can't write asynchronously (the default being
+      // EISDIR) gets the buffer the ordinary way, from this thread
+      if (wb->fP->write(this) != SFS_OK) {
+        Result = wb->fP->write(sfsAio.aio_offset,
+                               (const char *) sfsAio.aio_buf,
+                               sfsAio.aio_nbytes);
+        if (Result < 0) {
+          int ec = wb->fP->error.getErrInfo();
+          Result = -(ec > 0 ? ec : EIO);
+        }
+        doneWrite();
+      }
+    }
+
+    void doneRead() {}
+    void doneWrite() {wb->Done(this);}
+    void Recycle() {}
+
+    Block(XrdHttpWriteBehind *w, XrdBuffer *b) : XrdJob("http write behind"),
+                                                 wb(w), bP(b) {}
+
+    XrdHttpWriteBehind *wb;
+    XrdBuffer *bP;
+  };
+
+  /// Get a free buffer, waiting for one if need be. Returns NULL if a write
+  /// failed or no buffer could be had.
+  Block *Get() {
+    Block *bp = 0;
+
+    cv.Lock();
+    while (!ecode) {
+      if (!freeBlks.empty()) {
+        bp = freeBlks.back();
+        freeBlks.pop_back();
+        break;
+      }
+      if ((int) allBlks.size() < maxBlks) {
+        XrdBuffer *xbP = bPool->Obtain(bSize);
+        if (xbP) {
+          bp = new Block(this, xbP);
+          allBlks.push_back(bp);
+          break;
+        }
+        if (allBlks.empty()) {
+          ecode = ENOMEM;
+          break;
+        }
+      }
+      cv.Wait();
+    }
+    cv.UnLock();
+    return bp;
+  }
+
+  /// Start writing the first blen bytes of a buffer at offs
+  void Put(Block *bp, long long offs, int blen) {
+    bp->sfsAio.aio_buf = bp->bP->buff;
+    bp->sfsAio.aio_nbytes = blen;
+    bp->sfsAio.aio_offset = offs;
+    bp->Result = 0;
+
+    cv.Lock();
+    inFlight++;
+    cv.UnLock();
+    sched->Schedule((XrdJob *) bp);
+  }
+
+  /// Give back a buffer that was not used
+  void Free(Block *bp) {
+    cv.Lock();
+    freeBlks.push_back(bp);
+    cv.UnLock();
+  }
+
+  /// Wait for all the writes. Returns 0 or the errno of the first failure.
+  int Drain() {
+    cv.Lock();
+    while (inFlight) cv.Wait();
+    int rc = ecode;
+    cv.UnLock();
+    return rc;
+  }
+
+  int BlockSize() {return bSize;}
+
+  XrdHttpWriteBehind(XrdSfsFile *fp, XrdBuffManager *bpool, XrdScheduler *sp,
+                     int nblks, int bsize)
+                    : fP(fp), bPool(bpool), sched(sp), maxBlks(nblks),
+                      bSize(bsize), inFlight(0), ecode(0), cv(0) {}
+
+  ~XrdHttpWriteBehind() {
+    Drain();
+    for (size_t i = 0; i < allBlks.size(); i++) {
+      bPool->Release(allBlks[i]->bP);
+      delete allBlks[i];
+    }
+  }
+
+  XrdSfsFile *fP;
+
+private:
+
+  void Done(Block *bp) {
+    cv.Lock();
+    if (bp->Result != (ssize_t) bp->sfsAio.aio_nbytes && !ecode)
+      ecode = (bp->Result < 0 ? (int) -bp->Result : ENOSPC);
+    freeBlks.push_back(bp);
+    inFlight--;
+    cv.Signal();
+    cv.UnLock();
+  }
+
+  XrdBuffManager *bPool;
+  XrdScheduler *sched;
+  int maxBlks;
+  int bSize;
+  int inFlight;
+  int ecode;
+  std::vector<Block *> allBlks;
+  std::vector<Block *> freeBlks;
+  XrdSysCondVar cv;
+};
+
+/// Microseconds since the epoch, for the statistics
+static long long usecNow() {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+// Open the resource using the file system directly. We only return a file
+// that is actually open; anything else (redirects, stalls, errors) is left
+// to the bridge, which knows how to report it
+
+XrdSfsFile *XrdHttpReq::DirectOpen(int oflags, int omode) {
+  XrdSfsFileSystem *sfsP;
+  XrdSfsFile *fP;
+  std::string fn(resource.c_str());
+  const char *cgi;
+  int rc;
+
+  if (prot->myRole == kXR_isManager || !(sfsP = prot->getSFS())) return 0;
+
+  // Only open what xrootd itself would open, the bridge rejects the rest
+  if (!prot->sfsPathOK(fn)) {
+    TRACEI(REQ, "Direct open of " << resource << " not allowed; using the bridge.");
+    return 0;
+  }
+
+  if (!(fP = sfsP->newFile(prot->Link->ID, 0))) return 0;
+
+  cgi = strchr(resourceplusopaque.c_str(), '?');
+  rc = fP->open(fn.c_str(), (XrdSfsFileOpenMode) oflags, (mode_t) omode,
+                &prot->SecEntity, (cgi ? cgi + 1 : 0));
+  if (rc != SFS_OK) {
+    TRACEI(REQ, "Direct open of " << resource << " returned " << rc
+                << "; using the bridge.");
+    delete fP;
+    return 0;
+  }
+
+  return fP;
+}
+
+int XrdHttpReq::ProcessDirectGET() {
+  XrdSfsFile *fP;
+  XrdBuffer *bP[2] = {0, 0};
+  XrdHttpReadAhead rdAhead;
+  XrdLink::sfVec sfv;
+  struct stat sbuf;
+  long long offs = 0, blen, done = 0;
+  bool keepit = keepalive, ok = true, multi;
+  int fd = -1, cur = 0;
+
+  if (!(fP = DirectOpen(SFS_O_RDONLY, 0))) return 0;
+
+  // Get the current size, it may have changed since the first stat
+  if (fP->stat(&sbuf) != SFS_OK) {
+    delete fP;
+    return 0;
+  }
+  filesize = sbuf.st_size;
+
+  // Establish what we are going to send. Ranges past the end are left to the
+  // bridge as they are an error. For many ranges blen is what we read.
+  if (!coalesceRWOps()) {
+    delete fP;
+    return 0;
+  }
+  multi = (rwOps.size() > 1);
+  if (rwOps.size() == 0) {
+    blen = filesize;
+  } else if (!multi) {
+    offs = rwOps[0].bytestart;
+    blen = rwOps[0].byteend - rwOps[0].bytestart + 1;
+  } else {
+    blen = 0;
+    for (size_t i = 0; i < rwOps_split.size(); i++)
+      blen += rwOps_split[i].byteend - rwOps_split[i].bytestart + 1;
+  }
+
+  // Plain http can use sendfile if the file has a descriptor. Otherwise we
+  // need a pair of buffers, one being read while the other is being sent.
+  if (XrdLink::sfOK && !prot->ishttps
+      && fP->fctl(SFS_FCTL_GETFD, 0, fP->error) == SFS_OK)
+    fd = fP->error.getErrInfo();
+
+  if (fd < 0 && blen > 0) {
+    int bsz = (int) min(blen, (long long) DIRECT_BLKSZ);
+    bool two = (blen > bsz || (multi && rwOps_split.size() > READV_MAXCHUNKS));
+    bP[0] = prot->BPool->Obtain(bsz);
+    bP[1] = (two ? prot->BPool->Obtain(bsz) : 0);
+    if (!bP[0] || (two && !bP[1])) {
+      if (bP[0]) prot->BPool->Release(bP[0]);
+      if (bP[1]) prot->BPool->Release(bP[1]);
+      delete fP;
+      return 0;
+    }
+  }
+
+  // Send the header, exactly as the bridge would
+  if (rwOps.size() == 0)
+    prot->SendSimpleResp(200, NULL, NULL, NULL, filesize, keepalive);
+  else if (!multi) {
+    char buf[64];
+    XrdOucString s = "Content-Range: bytes ";
+    sprintf(buf, "%lld-%lld/%lld", rwOps[0].bytestart, rwOps[0].byteend, filesize);
+    s += buf;
+    prot->SendSimpleResp(206, NULL, (char *) s.c_str(), NULL, blen, keepalive);
+  } else
+    prot->SendSimpleResp(206, NULL, "Content-Type: multipart/byteranges; boundary=123456",
+                         NULL, multipartLength(), keepalive);
+
+  TRACEI(REQ, "Direct GET of " << blen << "@" << offs << " from " << resource
+              << (multi ? " in ranges" : "")
+              << (fd >= 0 ? " via sendfile" : " via buffers"));
+
+  if (multi && fd >= 0) {
+    // --------- SENDFILE, the part headers being interleaved with the data
+    for (size_t i = 0; i < rwOps.size() && ok; i++) {
+      for (long long pos = rwOps[i].bytestart; pos <= rwOps[i].byteend && ok; pos += DIRECT_SFMAX) {
+        addMultipart(pos, 0, min(rwOps[i].byteend + 1 - pos, (long long) DIRECT_SFMAX));
+        if (mpSegs.size() >= XrdOucSFVec::sfMax && sendMultipart(fd)) ok = false;
+      }
+    }
+    if (ok && sendMultipart(fd)) ok = false;
+  } else if (multi) {
+    // --------- READV, overlapping the next batch of ranges with the current send
+    std::vector<XrdOucIOVec> vec[2];
+    int bsz = bP[0]->bsize;
+    int want = nextReadV(vec[0], bP[0]->buff, bsz), next;
+    XrdSfsXferSize rlen = fP->readv(&vec[0][0], vec[0].size());
+
+    while (true) {
+      if (rlen != want) {
+        TRACEI(ALL, "Direct GET readv of " << resource << " failed; "
+                    << fP->error.getErrText());
+        ok = false;
+        break;
+      }
+
+      next = (bP[1] ? nextReadV(vec[1 - cur], bP[1 - cur]->buff, bsz) : 0);
+      if (next) rdAhead.Start(prot->Sched, fP, &vec[1 - cur]);
+
+      for (size_t i = 0; i < vec[cur].size() && ok; i++)
+        if (addMultipart(vec[cur][i].offset, vec[cur][i].data, vec[cur][i].size)) ok = false;
+      if (ok && sendMultipart()) ok = false;
+
+      if (!ok) {
+        if (next) rdAhead.Wait();
+        break;
+      }
+      if (!next) break;
+
+      rlen = rdAhead.Wait();
+      want = next;
+      cur = 1 - cur;
+    }
+  } else if (fd >= 0) {
+    // --------- SENDFILE
+    while (done < blen) {
+      sfv.offset = offs + done;
+      sfv.sendsz = (int) min(blen - done, (long long) DIRECT_SFMAX);
+      sfv.fdnum = fd;
+      if (prot->Link->Send(&sfv, 1) < 0) {
+        ok = false;
+        break;
+      }
+      done += sfv.sendsz;
+    }
+  } else if (blen > 0) {
+    // --------- READ, overlapping the next read with the current send
+    XrdHttpDirectSink sink(prot);
+    char *bp[2] = {bP[0]->buff, (bP[1] ? bP[1]->buff : 0)};
+    int rc = XrdHttpReadAhead::Pump(prot->Sched, fP, offs, blen, bp,
+                                    bP[0]->bsize, sink, done);
+    if (rc < 0)
+      TRACEI(ALL, "Direct GET read of " << resource << " failed at "
+                  << offs + done << "; " << fP->error.getErrText());
+    ok = (rc == 0);
+  }
+
+  if (bP[0]) prot->BPool->Release(bP[0]);
+  if (bP[1]) prot->BPool->Release(bP[1]);
+  fP->close();
+  delete fP;
+
+  // It's too late to send an error, all we can do is to drop the connection
+  if (!ok) return -1;
+
+  reset();
+  return keepit ? 1 : -1;
+}
+
+long long XrdHttpReq::DirectChunkSize(bool first) {
+  XrdOucString line;
+  long long sz;
+  char *endptr;
+  int n = first ? 1 : 0;
+
+  // Get the CRLF ending the previous chunk, then the size line. Trailer
+  // headers after the last chunk are skipped up to the final empty line.
+  while (true) {
+    if (!prot->BuffgetLine(line)) {
+      // Only take what is there, more may not come before we respond
+      if (!prot->BuffAvailable() || prot->getDataOneShot(prot->BuffAvailable()))
+        return -1;
+      continue;
+    }
+
+    if (n == 0) {
+      if (line != "\r\n") return -1;
+      n = 1;
+      continue;
+    }
+
+    if (n == 1) {
+      sz = strtoll(line.c_str(), &endptr, 16);
+      if (endptr == line.c_str() || sz < 0 || (*endptr != ';' && *endptr != '\r'))
+        return -1;
+      if (sz) return sz;
+      n = 2;
+      continue;
+    }
+
+    if (line == "\r\n") return 0;
+  }
+}
+
+int XrdHttpReq::ProcessDirectPUT() {
+  XrdSfsFile *fP;
+  XrdHttpWriteBehind::Block *bp;
+  std::string errmsg;
+  long long chunkLeft = 0, tBeg;
+  bool keepit = keepalive, chunked = m_transfer_encoding_chunked;
+  bool first = true, atEnd = false;
+  int blen, n, rc, ecode = 500;
+
+  if (!(fP = DirectOpen(SFS_O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP
+                                     | S_IROTH | SFS_O_MKPTH)))
+    return 0;
+
+  if (sendcontinue)
+    prot->SendSimpleResp(100, NULL, NULL, 0, 0, keepalive);
+
+  if (chunked) {
+    TRACEI(REQ, "Direct chunked PUT to " << resource);
+  } else {
+    TRACEI(REQ, "Direct PUT of " << length << " bytes to " << resource);
+  }
+  tBeg = usecNow();
+
+  // Fill a buffer straight from the socket and have it written while we
+  // go on with the next one
+  {
+    XrdHttpWriteBehind wb(fP, prot->BPool, prot->Sched,
+                          XrdHttpProtocol::sfsinflight, DIRECT_BLKSZ);
+
+    while (!atEnd && errmsg.empty() && (bp = wb.Get())) {
+      blen = 0;
+      while (blen < wb.BlockSize()) {
+        long long want;
+        if (chunked) {
+          if (!chunkLeft) {
+            if ((chunkLeft = DirectChunkSize(first)) < 0) {
+              errmsg = "Invalid chunked encoding";
+              ecode = 400;
+              break;
+            }
+            first = false;
+            if (!chunkLeft) {
+              atEnd = true;
+              break;
+            }
+          }
+          want = chunkLeft;
+        } else if (!(want = length - writtenbytes - blen)) {
+          atEnd = true;
+          break;
+        }
+
+        if ((n = prot->RecvData(bp->bP->buff + blen,
+                                (int) min(want, (long long) (wb.BlockSize() - blen)))) < 0) {
+          TRACEI(ALL, "Direct PUT of " << resource << " lost the client after "
+                      << writtenbytes + blen << " bytes");
+          errmsg = "lost the client";
+          break;
+        }
+        blen += n;
+        if (chunked) chunkLeft -= n;
+      }
+
+      if (blen && errmsg.empty()) {
+        wb.Put(bp, writtenbytes, blen);
+        writtenbytes += blen;
+      } else wb.Free(bp);
+    }
+
+    if ((rc = wb.Drain()) && errmsg.empty()) {
+      errmsg = "Write failed; ";
+      errmsg += XrdSysE2T(rc);
+    }
+  }
+
+  if (errmsg.empty() && fP->close() != SFS_OK)
+    errmsg = fP->error.getErrText();
+  delete fP;
+
+  if (!errmsg.empty()) {
+    TRACEI(ALL, "Direct PUT of " << resource << " failed; " << errmsg);
+    errmsg += "\n";
+    prot->SendSimpleResp(ecode, NULL, NULL, errmsg.c_str(), errmsg.length(), false);
+    return -1;
+  }
+
+  XrdHttpProtocol::PutStats(writtenbytes, usecNow() - tBeg);
+  prot->SendSimpleResp(200, NULL, NULL, (char *) ":-)", 0, keepit);
+  reset();
+  return keepit ? 1 : -1;
+}
+
 int XrdHttpReq::ProcessHTTPReq() {
 
   kXR_int32 l;
@@ -1176,6 +1831,11 @@ int XrdHttpReq::ProcessHTTPReq() {
           }
           else {
 
+            // Serve a simple read without the bridge, if configured to do so
+            if (prot->sfsdirect & XrdHttpProtocol::sfsGET) {
+              int rc = ProcessDirectGET();
+              if (rc) return rc;
+            }
 
             // --------- OPEN
             memset(&xrdreq, 0, sizeof (ClientRequest));
@@ -1226,10 +1886,10 @@ int XrdHttpReq::ProcessHTTPReq() {
         default: // Read() or Close()
         {
 
-          if ( ((reqstate == 3 || (!m_req_digest.empty() && (reqstate == 4))) && (rwOps.size() > 1)) ||
+          if ( ((rwOps.size() > 1) && (rwOpSplitDone >= rwOps_split.size())) ||
             (writtenbytes >= length) ) {
 
-            // Close() if this was a readv or we have finished, otherwise read the next chunk
+            // Close() if all the readv batches were sent or we have finished, otherwise read the next chunk
 
             // --------- CLOSE
 
@@ -1304,7 +1964,7 @@ int XrdHttpReq::ProcessHTTPReq() {
               return -1;
             }
           } else {
-            // More than one chunk to read... use readv
+            // More than one chunk to read... use readv, one batch at a time
 
             length = ReqReadV();
 
@@ -1333,6 +1993,12 @@ int XrdHttpReq::ProcessHTTPReq() {
 
       if (!fopened) {
 
+        // Write without the bridge, if configured to do so
+        if (prot->sfsdirect & XrdHttpProtocol::sfsPUT) {
+          int rc = ProcessDirectPUT();
+          if (rc) return rc;
+        }
+
         // --------- OPEN for write!
         memset(&xrdreq, 0, sizeof (ClientRequest));
         xrdreq.open.requestid = htons(kXR_open);
@@ -2125,6 +2791,14 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
                   TRACEI(ALL, "GET returned no STAT information. Internal error?");
               }
               
+              // Now that we know the size, settle what we are going to send
+              if (!rwOps.empty() && !coalesceRWOps()) {
+                char buf[64];
+                sprintf(buf, "Content-Range: bytes */%lld", filesize);
+                prot->SendSimpleResp(416, NULL, buf, (char *) "Requested range not satisfiable\n", 0, false);
+                return -1;
+              }
+
               if (rwOps.size() == 0) {
                 // Full file.
                 
@@ -2149,21 +2823,7 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
               } else
                 if (rwOps.size() > 1) {
                 // Multiple reads to perform, compose and send the header
-                int cnt = 0;
-                for (size_t i = 0; i < rwOps.size(); i++) {
-
-                  if (rwOps[i].bytestart > filesize) continue;
-                  if (rwOps[i].byteend > filesize - 1)
-                    rwOps[i].byteend = filesize - 1;
-
-                  cnt += (rwOps[i].byteend - rwOps[i].bytestart + 1);
-
-                  cnt += buildPartialHdr(rwOps[i].bytestart,
-                          rwOps[i].byteend,
-                          filesize,
-                          (char *) "123456").size();
-                }
-                cnt += buildPartialHdrEnd((char *) "123456").size();
+                long long cnt = multipartLength();
                 std::string header = "Content-Type: multipart/byteranges; boundary=123456";
                 if (!m_digest_header.empty()) {
                   header += "\n";
@@ -2198,9 +2858,6 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
             // Nothing to do if we are postprocessing a close
             if (ntohs(xrdreq.header.requestid) == kXR_close) return keepalive ? 1 : -1;
             
-            // Close() if this was the third state of a readv, otherwise read the next chunk
-            if ((reqstate == 3) && (ntohs(xrdreq.header.requestid) == kXR_readv)) return keepalive ? 1: -1;
-
             // Prevent scenario where data is expected but none is actually read
             // E.g. Accessing files which return the results of a script
             if ((ntohs(xrdreq.header.requestid) == kXR_read) &&
@@ -2220,35 +2877,15 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
               char *p;
               int len;
 
-              // Cycle on all the data that is coming from the server
+              // Cycle on all the data that is coming from the server, queueing
+              // the parts it contains. Then send them with a single write.
               for (int i = 0; i < iovN; i++) {
 
                 for (p = (char *) iovP[i].iov_base; p < (char *) iovP[i].iov_base + iovP[i].iov_len;) {
                   l = (readahead_list *) p;
                   len = ntohl(l->rlen);
 
-                  // Now we have a chunk coming from the server. This may be a partial chunk
-
-                  if (rwOpPartialDone == 0) {
-                    string s = buildPartialHdr(rwOps[rwOpDone].bytestart,
-                            rwOps[rwOpDone].byteend,
-                            filesize,
-                            (char *) "123456");
-
-                    TRACEI(REQ, "Sending multipart: " << rwOps[rwOpDone].bytestart << "-" << rwOps[rwOpDone].byteend);
-                    if (prot->SendData((char *) s.c_str(), s.size())) return -1;
-                  }
-
-                  // Send all the data we have
-                  if (prot->SendData(p + sizeof (readahead_list), len)) return -1;
-
-                  // If we sent all the data relative to the current original chunk request
-                  // then pass to the next chunk, otherwise wait for more data
-                  rwOpPartialDone += len;
-                  if (rwOpPartialDone >= rwOps[rwOpDone].byteend - rwOps[rwOpDone].bytestart + 1) {
-                    rwOpDone++;
-                    rwOpPartialDone = 0;
-                  }
+                  if (addMultipart(ntohll(l->offset), p + sizeof (readahead_list), len)) return -1;
 
                   p += sizeof (readahead_list);
                   p += len;
@@ -2256,10 +2893,7 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
                 }
               }
 
-              if (rwOpDone == rwOps.size()) {
-                string s = buildPartialHdrEnd((char *) "123456");
-                if (prot->SendData((char *) s.c_str(), s.size())) return -1;
-              }
+              if (sendMultipart()) return -1;
 
             } else
               for (int i = 0; i < iovN; i++) {
@@ -2297,6 +2931,7 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
 
         getfhandle();
         fopened = true;
+        m_put_start = usecNow();
 
         // We try to completely fill up our buffer before flushing
         prot->ResumeBytes = min(length - writtenbytes, (long long) prot->BuffAvailable());
@@ -2333,6 +2968,7 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
 
         if (ntohs(xrdreq.header.requestid) == kXR_close) {
           if (xrdresp == kXR_ok) {
+            XrdHttpProtocol::PutStats(writtenbytes, usecNow() - m_put_start);
             prot->SendSimpleResp(200, NULL, NULL, (char *) ":-)", 0, keepalive);
             return keepalive ? 1 : -1;
           } else {
@@ -2671,6 +3307,9 @@ void XrdHttpReq::reset() {
   rwOps_split.clear();
   rwOpDone = 0;
   rwOpPartialDone = 0;
+  rwOpSplitDone = 0;
+  mpSegs.clear();
+  mpHdrs.clear();
   writtenbytes = 0;
   etext.clear();
   redirdest = "";
@@ -2707,6 +3346,7 @@ void XrdHttpReq::reset() {
   m_transfer_encoding_chunked = false;
   m_current_chunk_size = -1;
   m_current_chunk_offset = 0;
+  m_put_start = 0;
 
   /// State machine to talk to the bridge
   reqstate = 0;
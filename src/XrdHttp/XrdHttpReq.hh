@@ -40,6 +40,7 @@
 
 
 #include "XrdOuc/XrdOucString.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
 
 #include "XProtocol/XProtocol.hh"
 #include "XrdXrootd/XrdXrootdBridge.hh"
@@ -47,6 +48,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <sys/uio.h>
 
 //#include <libxml/parser.h>
 //#include <libxml/tree.h>
@@ -55,6 +57,8 @@
 
 #define READV_MAXCHUNKS            512
 #define READV_MAXCHUNKSIZE         (1024*128)
+// Ranges closer than this are read together, the gap is not sent
+#define READV_MAXGAP               (1024*16)
 
 struct ReadWriteOp {
   // < 0 means "not specified"
@@ -73,6 +77,7 @@ struct DirListInfo {
 
 class XrdHttpProtocol;
 class XrdOucEnv;
+class XrdSfsFile;
 
 class XrdHttpReq : public XrdXrootd::Bridge::Result {
 private:
@@ -85,6 +90,9 @@ private:
   long long m_current_chunk_offset;
   long long m_current_chunk_size;
 
+  // When the upload started (microseconds), for the statistics
+  long long m_put_start;
+
   int parseContentRange(char *);
   int parseHost(char *);
   int parseRWOp(char *);
@@ -109,6 +117,38 @@ private:
   ///  -1->error
   int PostProcessHTTPReq(bool final = false);
 
+  /// Serve a GET or a PUT using the file system directly (see http.sfsdirect)
+  /// Return values:
+  ///  0->not handled, the request must go through the bridge
+  ///  1->request processed completely
+  ///  -1->error
+  int ProcessDirectGET();
+  int ProcessDirectPUT();
+
+  // Open the resource via the file system. Returns NULL unless it's immediately open
+  XrdSfsFile *DirectOpen(int oflags, int omode);
+
+  // Get the size of the next chunk of a chunked PUT body, first skipping the
+  // end of the previous one unless this is the first. Returns 0 at the end
+  // of the body and -1 if the encoding is invalid or the client went away.
+  long long DirectChunkSize(bool first);
+
+  // Fill vec with the next reads of a multi-range GET, using at most bsize
+  // bytes of buff. Returns the number of bytes to read, 0 when done.
+  int nextReadV(std::vector<XrdOucIOVec> &vec, char *buff, int bsize);
+
+  // Queue the multipart framing and the requested bytes contained in a block
+  // of file data starting at offs. A null data means the bytes are to be
+  // sent from the file descriptor. Returns -1 if data is missing.
+  int addMultipart(long long offs, const char *data, long long dlen);
+
+  // Send whatever addMultipart() queued with as few writes as possible,
+  // from fd if the file data is to be sent via sendfile
+  int sendMultipart(int fd = -1);
+
+  // The size of the multipart response body
+  long long multipartLength();
+
   // Parse a resource string, typically a filename, setting the resource field and the opaque data
   void parseResource(char *url);
   // Map an XRootD error code to an appropriate HTTP status code and message
@@ -141,7 +181,11 @@ public:
   /// Parse the body of a request, assuming that it's XML and that it's entirely in memory
   int parseBody(char *body, long long len);
 
-  /// Prepare the buffers for sending a readv request
+  /// Sort, clip and merge the requested ranges once the file size is known,
+  /// then split them into reads. Returns false if none can be satisfied.
+  bool coalesceRWOps();
+
+  /// Prepare the buffers for sending the next readv request
   int ReqReadV();
   readahead_list *ralist;
 
@@ -201,8 +245,8 @@ public:
   // This can be largely optimized...
   /// The original list of multiple reads to perform
   std::vector<ReadWriteOp> rwOps;
-  /// The new list got from chunking the original req respecting the xrootd
-  /// max sizes etc.
+  /// The reads that cover rwOps, nearby ranges being read together, chunked
+  /// respecting the xrootd max sizes etc.
   std::vector<ReadWriteOp> rwOps_split;
 
   bool keepalive;
@@ -234,7 +278,21 @@ public:
 
 
   /// To coordinate multipart responses across multiple calls
-  unsigned int rwOpDone, rwOpPartialDone;
+  size_t rwOpDone;
+  long long rwOpPartialDone;
+  /// How many of rwOps_split have been asked for
+  size_t rwOpSplitDone;
+
+  /// A piece of a multipart response, a part header (offs < 0) or file data
+  struct mpSeg {
+    const char *data;
+    long long offs;
+    long long len;
+  };
+  /// What is ready to be sent; the part headers are concatenated in mpHdrs
+  std::vector<mpSeg> mpSegs;
+  std::string mpHdrs;
+  std::vector<struct iovec> mpIov;
 
   /// The last issued xrd request, often pending
   ClientRequest xrdreq;
@@ -18,6 +18,7 @@ if( BUILD_MACAROONS )
     XrdMacaroons/XrdMacaroons.cc
     XrdMacaroons/XrdMacaroonsHandler.cc     XrdMacaroons/XrdMacaroonsHandler.hh
     XrdMacaroons/XrdMacaroonsAuthz.cc       XrdMacaroons/XrdMacaroonsAuthz.hh
+    XrdMacaroons/XrdMacaroonsCache.cc       XrdMacaroons/XrdMacaroonsCache.hh
     XrdMacaroons/XrdMacaroonsConfigure.cc)
 
   target_link_libraries(
@@ -44,6 +45,24 @@ if( BUILD_MACAROONS )
     LINK_INTERFACE_LIBRARIES ""
     LINK_FLAGS "${MACAROONS_LINK_FLAGS}")
 
+  #-----------------------------------------------------------------------------
+  # xrdmacaroonsbench (not installed)
+  #-----------------------------------------------------------------------------
+  add_executable(
+    xrdmacaroonsbench
+    XrdMacaroons/XrdMacaroonsBench.cc
+    XrdMacaroons/XrdMacaroonsAuthz.cc
+    XrdMacaroons/XrdMacaroonsCache.cc
+    XrdMacaroons/XrdMacaroonsConfigure.cc)
+
+  target_link_libraries(
+    xrdmacaroonsbench
+    XrdHttpUtils
+    XrdUtils
+    XrdServer
+    ${MACAROONS_LIB}
+    ${OPENSSL_CRYPTO_LIBRARY})
+
   #-----------------------------------------------------------------------------
   # Install
   #-----------------------------------------------------------------------------
@@ -17,43 +17,14 @@ using namespace Macaroons;
 
 namespace {
 
-class AuthzCheck
+// Records each caveat while the signature is verified; a caveat that no
+// request could satisfy fails the verification.
+static int
+collect_caveat(void *info_ptr, const unsigned char *pred, size_t pred_sz)
 {
-public:
-    AuthzCheck(const char *req_path, const Access_Operation req_oper, ssize_t m_max_duration, XrdSysError &log);
-
-    const std::string &GetSecName() const {return m_sec_name;}
-
-    static int verify_before_s(void *authz_ptr,
-                               const unsigned char *pred,
-                               size_t pred_sz);
-
-    static int verify_activity_s(void *authz_ptr,
-                                 const unsigned char *pred,
-                                 size_t pred_sz);
-
-    static int verify_path_s(void *authz_ptr,
-                             const unsigned char *pred,
-                             size_t pred_sz);
-
-    static int verify_name_s(void *authz_ptr,
-                             const unsigned char *pred,
-                             size_t pred_sz);
-
-private:
-    int verify_before(const unsigned char *pred, size_t pred_sz);
-    int verify_activity(const unsigned char *pred, size_t pred_sz);
-    int verify_path(const unsigned char *pred, size_t pred_sz);
-    int verify_name(const unsigned char *pred, size_t pred_sz);
-
-    ssize_t m_max_duration;
-    XrdSysError &m_log;
-    const std::string m_path;
-    std::string m_desired_activity;
-    std::string m_sec_name;
-    Access_Operation m_oper;
-    time_t m_now;
-};
+    std::string pred_str(reinterpret_cast<const char *>(pred), pred_sz);
+    return static_cast<TokenInfo*>(info_ptr)->AddCaveat(pred_str) ? 0 : 1;
+}
 
 
 static XrdAccPrivs AddPriv(Access_Operation op, XrdAccPrivs privs)
@@ -113,11 +84,15 @@ Authz::Authz(XrdSysLogger *log, char const *config, XrdAccAuthorize *chain)
 {
     Handler::AuthzBehavior behavior(Handler::AuthzBehavior::PASSTHROUGH);
     XrdOucEnv env;
-    if (!Handler::Config(config, &env, &m_log, m_location, m_secret, m_max_duration, behavior))
+    size_t cache_size;
+    int cache_lifetime;
+    if (!Handler::Config(config, &env, &m_log, m_location, m_secret, m_max_duration, behavior,
+                         cache_size, cache_lifetime))
     {
         throw std::runtime_error("Macaroon authorization config failed.");
     }
     m_authz_behavior = static_cast<int>(behavior);
+    m_cache.reset(new TokenCache(cache_size, cache_lifetime, m_log));
 }
 
 
@@ -155,81 +130,53 @@ Authz::Access(const XrdSecEntity *Entity, const char *path,
     }
     authz += 9;
 
-    macaroon_returncode mac_err = MACAROON_SUCCESS;
-    struct macaroon* macaroon = macaroon_deserialize(
-        authz,
-        &mac_err);
-    if (!macaroon)
+    // HTTP clients present the same token on many requests, so the outcome
+    // of parsing and verifying it is cached by token digest.
+    std::string token(authz);
+    std::shared_ptr<const TokenInfo> info = m_cache->Get(token);
+    if (!info)
     {
-        // Do not log - might be other token type!
-        //m_log.Emsg("Access", "Failed to parse the macaroon");
-        return OnMissing(Entity, path, oper, env);
+        if (!(info = Verify(authz))) {return XrdAccPriv_None;}
+        m_cache->Put(token, info);
     }
 
-    struct macaroon_verifier *verifier = macaroon_verifier_create();
-    if (!verifier)
+    if (info->m_status == TokenInfo::NOT_MACAROON)
     {
-        m_log.Emsg("Access", "Failed to create a new macaroon verifier");
-        return XrdAccPriv_None;
+        // Do not log - might be other token type!
+        //m_log.Emsg("Access", "Failed to parse the macaroon");
+        return OnMissing(Entity, path, oper, env);
     }
     if (!path)
     {
         m_log.Emsg("Access", "Request with no provided path.");
-        macaroon_verifier_destroy(verifier);
         return XrdAccPriv_None;
     }
-
-    AuthzCheck check_helper(path, oper, m_max_duration, m_log);
-
-    if (macaroon_verifier_satisfy_general(verifier, AuthzCheck::verify_before_s, &check_helper, &mac_err) ||
-        macaroon_verifier_satisfy_general(verifier, AuthzCheck::verify_activity_s, &check_helper, &mac_err) ||
-        macaroon_verifier_satisfy_general(verifier, AuthzCheck::verify_name_s, &check_helper, &mac_err) ||
-        macaroon_verifier_satisfy_general(verifier, AuthzCheck::verify_path_s, &check_helper, &mac_err))
+    if (info->m_status == TokenInfo::WRONG_LOCATION)
     {
-        m_log.Emsg("Access", "Failed to configure caveat verifier:");
-        macaroon_verifier_destroy(verifier);
-        return XrdAccPriv_None;
+        m_log.Emsg("Access", "Macaroon is for incorrect location", info->m_location.c_str());
+        return m_chain ? m_chain->Access(Entity, path, oper, env) : XrdAccPriv_None;
     }
 
-    const unsigned char *macaroon_loc;
-    size_t location_sz;
-    macaroon_location(macaroon, &macaroon_loc, &location_sz);
-    if (strncmp(reinterpret_cast<const char *>(macaroon_loc), m_location.c_str(), location_sz))
+    time_t now = time(NULL);
+    if (info->m_status == TokenInfo::VALID && info->m_not_after &&
+        (m_max_duration > 0) && (info->m_latest_before > now + m_max_duration))
     {
-        std::string location_str(reinterpret_cast<const char *>(macaroon_loc), location_sz);
-        m_log.Emsg("Access", "Macaroon is for incorrect location", location_str.c_str());
-        macaroon_verifier_destroy(verifier);
-        macaroon_destroy(macaroon);
-        return m_chain ? m_chain->Access(Entity, path, oper, env) : XrdAccPriv_None;
+        m_log.Log(LogMask::Warning, "Access", "Max token age is greater than configured max duration; rejecting");
     }
-
-    if (macaroon_verify(verifier, macaroon,
-                         reinterpret_cast<const unsigned char *>(m_secret.c_str()),
-                         m_secret.size(),
-                         NULL, 0, // discharge macaroons
-                         &mac_err))
+    if (!info->Allows(path, oper, now, m_max_duration))
     {
         m_log.Log(LogMask::Debug, "Access", "Macaroon verification failed");
-        macaroon_verifier_destroy(verifier);
-        macaroon_destroy(macaroon);
         return m_chain ? m_chain->Access(Entity, path, oper, env) : XrdAccPriv_None;
     }
-    macaroon_verifier_destroy(verifier);
 
-    const unsigned char *macaroon_id;
-    size_t id_sz;
-    macaroon_identifier(macaroon, &macaroon_id, &id_sz);
-
-    std::string macaroon_id_str(reinterpret_cast<const char *>(macaroon_id), id_sz);
-    m_log.Log(LogMask::Info, "Access", "Macaroon verification successful; ID", macaroon_id_str.c_str());
-    macaroon_destroy(macaroon);
+    m_log.Log(LogMask::Info, "Access", "Macaroon verification successful; ID", info->m_id.c_str());
 
     // Copy the name, if present into the macaroon, into the credential object.
-    if (Entity && check_helper.GetSecName().size()) {
-        m_log.Log(LogMask::Debug, "Access", "Setting the security name to", check_helper.GetSecName().c_str());
+    if (Entity && info->m_name.size()) {
+        m_log.Log(LogMask::Debug, "Access", "Setting the security name to", info->m_name.c_str());
         XrdSecEntity &myEntity = *const_cast<XrdSecEntity *>(Entity);
         if (myEntity.name) {free(myEntity.name);}
-        myEntity.name = strdup(check_helper.GetSecName().c_str());
+        myEntity.name = strdup(info->m_name.c_str());
     }
 
     // We passed verification - give the correct privilege.
@@ -237,191 +184,68 @@ Authz::Access(const XrdSecEntity *Entity, const char *path,
 }
 
 
-AuthzCheck::AuthzCheck(const char *req_path, const Access_Operation req_oper, ssize_t max_duration, XrdSysError &log)
-      : m_max_duration(max_duration),
-        m_log(log),
-        m_path(req_path),
-        m_oper(req_oper),
-        m_now(time(NULL))
-{
-    switch (m_oper)
-    {
-    case AOP_Any:
-        break;
-    case AOP_Chmod:
-    case AOP_Chown:
-        m_desired_activity = "UPDATE_METADATA";
-        break;
-    case AOP_Insert:
-    case AOP_Lock:
-    case AOP_Mkdir:
-    case AOP_Rename:
-    case AOP_Update:
-        m_desired_activity = "MANAGE";
-        break;
-    case AOP_Create:
-        m_desired_activity = "UPLOAD";
-        break;
-    case AOP_Delete:
-        m_desired_activity = "DELETE";
-        break;
-    case AOP_Read:
-        m_desired_activity = "DOWNLOAD";
-        break;
-    case AOP_Readdir:
-        m_desired_activity = "LIST";
-        break;
-    case AOP_Stat:
-        m_desired_activity = "READ_METADATA";
-    };
-}
-
-
-int
-AuthzCheck::verify_before_s(void *authz_ptr,
-                            const unsigned char *pred,
-                            size_t pred_sz)
-{
-    return static_cast<AuthzCheck*>(authz_ptr)->verify_before(pred, pred_sz);
-}
-
-
-int
-AuthzCheck::verify_activity_s(void *authz_ptr,
-                              const unsigned char *pred,
-                              size_t pred_sz)
-{
-    return static_cast<AuthzCheck*>(authz_ptr)->verify_activity(pred, pred_sz);
-}
-
-
-int
-AuthzCheck::verify_path_s(void *authz_ptr,
-                          const unsigned char *pred,
-                          size_t pred_sz)
-{
-    return static_cast<AuthzCheck*>(authz_ptr)->verify_path(pred, pred_sz);
-}
-
-
-int
-AuthzCheck::verify_name_s(void *authz_ptr,
-                          const unsigned char *pred,
-                          size_t pred_sz)
-{
-    return static_cast<AuthzCheck*>(authz_ptr)->verify_name(pred, pred_sz);
-}
-
-
-int
-AuthzCheck::verify_before(const unsigned char * pred, size_t pred_sz)
+// Parse the token and verify its signature; the caveats are recorded so that
+// they can be checked against each request without repeating this.  Returns
+// nullptr only on an internal error.
+std::shared_ptr<const TokenInfo>
+Authz::Verify(const char *token)
 {
-    std::string pred_str(reinterpret_cast<const char *>(pred), pred_sz);
-    if (strncmp("before:", pred_str.c_str(), 7))
-    {
-        return 1;
-    }
-    m_log.Log(LogMask::Debug, "AuthzCheck", "running verify before", pred_str.c_str());
+    std::shared_ptr<TokenInfo> info(new TokenInfo());
 
-    struct tm caveat_tm;
-    if (strptime(&pred_str[7], "%Y-%m-%dT%H:%M:%SZ", &caveat_tm) == nullptr)
+    macaroon_returncode mac_err = MACAROON_SUCCESS;
+    struct macaroon* macaroon = macaroon_deserialize(
+        token,
+        &mac_err);
+    if (!macaroon)
     {
-        m_log.Log(LogMask::Debug, "AuthzCheck", "failed to parse time string", &pred_str[7]);
-        return 1;
+        return info;
     }
-    caveat_tm.tm_isdst = -1;
 
-    time_t caveat_time = timegm(&caveat_tm);
-    if (-1 == caveat_time)
-    {
-        m_log.Log(LogMask::Debug, "AuthzCheck", "failed to generate unix time", &pred_str[7]);
-        return 1;
-    }
-    if ((m_max_duration > 0) && (caveat_time > m_now + m_max_duration))
+    const unsigned char *macaroon_loc;
+    size_t location_sz;
+    macaroon_location(macaroon, &macaroon_loc, &location_sz);
+    if (strncmp(reinterpret_cast<const char *>(macaroon_loc), m_location.c_str(), location_sz))
     {
-        m_log.Log(LogMask::Warning, "AuthzCheck", "Max token age is greater than configured max duration; rejecting");
-        return 1;
+        info->m_status = TokenInfo::WRONG_LOCATION;
+        info->m_location.assign(reinterpret_cast<const char *>(macaroon_loc), location_sz);
+        macaroon_destroy(macaroon);
+        return info;
     }
 
-    int result = (m_now >= caveat_time);
-    if (!result) m_log.Log(LogMask::Debug, "AuthzCheck", "verify before successful");
-    else m_log.Log(LogMask::Debug, "AuthzCheck", "verify before failed");
-    return result;
-}
-
-
-int
-AuthzCheck::verify_activity(const unsigned char * pred, size_t pred_sz)
-{
-    if (!m_desired_activity.size()) {return 1;}
-    std::string pred_str(reinterpret_cast<const char *>(pred), pred_sz);
-    if (strncmp("activity:", pred_str.c_str(), 9)) {return 1;}
-    m_log.Log(LogMask::Debug, "AuthzCheck", "running verify activity", pred_str.c_str());
-
-    std::stringstream ss(pred_str.substr(9));
-    for (std::string activity; std::getline(ss, activity, ','); )
+    struct macaroon_verifier *verifier = macaroon_verifier_create();
+    if (!verifier)
     {
-        // Any allowed activity also implies "READ_METADATA"
-        if (m_desired_activity == "READ_METADATA") {return 0;}
-        if (activity == m_desired_activity)
-        {
-            m_log.Log(LogMask::Debug, "AuthzCheck", "macaroon has desired activity", activity.c_str());
-            return 0;
-        }
+        m_log.Emsg("Access", "Failed to create a new macaroon verifier");
+        macaroon_destroy(macaroon);
+        return nullptr;
     }
-    m_log.Log(LogMask::Info, "AuthzCheck", "macaroon does NOT have desired activity", m_desired_activity.c_str());
-    return 1;
-}
-
-
-int
-AuthzCheck::verify_path(const unsigned char * pred, size_t pred_sz)
-{
-    std::string pred_str(reinterpret_cast<const char *>(pred), pred_sz);
-    if (strncmp("path:", pred_str.c_str(), 5)) {return 1;}
-    m_log.Log(LogMask::Debug, "AuthzCheck", "running verify path", pred_str.c_str());
-
-    if ((m_path.find("/./") != std::string::npos) ||
-        (m_path.find("/../") != std::string::npos))
+    if (macaroon_verifier_satisfy_general(verifier, collect_caveat, info.get(), &mac_err))
     {
-        m_log.Log(LogMask::Info, "AuthzCheck", "invalid requested path", m_path.c_str());
-        return 1;
+        m_log.Emsg("Access", "Failed to configure caveat verifier:");
+        macaroon_verifier_destroy(verifier);
+        macaroon_destroy(macaroon);
+        return nullptr;
     }
-    size_t compare_chars = pred_str.size() - 5;
-    if (pred_str[compare_chars + 5 - 1] == '/') {compare_chars--;}
 
-    int result = strncmp(pred_str.c_str() + 5, m_path.c_str(), compare_chars);
-    if (!result)
-    {
-        m_log.Log(LogMask::Debug, "AuthzCheck", "path request verified for", m_path.c_str());
-    }
-    // READ_METADATA permission for /foo/bar automatically implies permission
-    // to READ_METADATA for /foo.
-    else if (m_oper == AOP_Stat)
+    if (macaroon_verify(verifier, macaroon,
+                         reinterpret_cast<const unsigned char *>(m_secret.c_str()),
+                         m_secret.size(),
+                         NULL, 0, // discharge macaroons
+                         &mac_err))
     {
-        result = strncmp(m_path.c_str(), pred_str.c_str() + 5, m_path.size());
-        if (!result) {m_log.Log(LogMask::Debug, "AuthzCheck", "READ_METADATA path request verified for", m_path.c_str());}
-        else {m_log.Log(LogMask::Debug, "AuthzCheck", "READ_METADATA path request NOT allowed", m_path.c_str());}
+        info->m_status = TokenInfo::INVALID;
     }
     else
     {
-        m_log.Log(LogMask::Debug, "AuthzCheck", "path request NOT allowed", m_path.c_str());
+        info->m_status = TokenInfo::VALID;
     }
+    macaroon_verifier_destroy(verifier);
 
-    return result;
-}
-
-
-int
-AuthzCheck::verify_name(const unsigned char * pred, size_t pred_sz)
-{
-    std::string pred_str(reinterpret_cast<const char *>(pred), pred_sz);
-    if (strncmp("name:", pred_str.c_str(), 5)) {return 1;}
-    if (pred_str.size() < 6) {return 1;}
-    m_log.Log(LogMask::Debug, "AuthzCheck", "Verifying macaroon with", pred_str.c_str());
-
-    // Make a copy of the name for the XrdSecEntity; this will be used later.
-    m_sec_name = pred_str.substr(5);
+    const unsigned char *macaroon_id;
+    size_t id_sz;
+    macaroon_identifier(macaroon, &macaroon_id, &id_sz);
+    info->m_id.assign(reinterpret_cast<const char *>(macaroon_id), id_sz);
+    macaroon_destroy(macaroon);
 
-    return 0;
+    return info;
 }
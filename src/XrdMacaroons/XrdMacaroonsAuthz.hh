@@ -1,7 +1,11 @@
 
+#include <memory>
+
 #include "XrdAcc/XrdAccAuthorize.hh"
 #include "XrdSys/XrdSysError.hh"
 
+#include "XrdMacaroonsCache.hh"
+
 
 class XrdSysError;
 
@@ -33,18 +37,24 @@ public:
         return 0;
     }
 
+    // The verified token cache, for statistics.
+    const TokenCache &Cache() const {return *m_cache;}
+
 private:
     XrdAccPrivs OnMissing(const XrdSecEntity     *Entity,
                           const char             *path,
                           const Access_Operation  oper,
                                 XrdOucEnv        *env);
 
+    std::shared_ptr<const TokenInfo> Verify(const char *token);
+
     ssize_t m_max_duration;
     XrdAccAuthorize *m_chain;
     XrdSysError m_log;
     std::string m_secret;
     std::string m_location;
     int m_authz_behavior;
+    std::unique_ptr<TokenCache> m_cache;
 };
 
 }
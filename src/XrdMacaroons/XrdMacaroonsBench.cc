@@ -0,0 +1,247 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include "macaroons.h"
+
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSec/XrdSecEntity.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include "XrdMacaroonsAuthz.hh"
+
+using namespace Macaroons;
+
+// This program measures macaroon authorization decisions per second.  It
+// mints a set of tokens with the same secret key as a throw-away server
+// configuration and then has two Authz objects, one with the verified token
+// cache and one without, decide the same mix of requests.  Both must come
+// to the same decisions before either is timed.
+
+namespace {
+
+// Each token is used for the whole set of requests in turn.
+struct Request {
+    const char *path;
+    Access_Operation oper;
+};
+
+const Request g_requests[] = {
+    {"/data/bench/file1",        AOP_Read},
+    {"/data/bench/dir/file2",    AOP_Read},
+    {"/data/bench/dir",          AOP_Readdir},
+    {"/data",                    AOP_Stat},
+    {"/data/bench/file3",        AOP_Create},
+    {"/data/bench/file1",        AOP_Delete},
+    {"/data/other/file1",        AOP_Read},
+    {"/data/bench/../other/f",   AOP_Read},
+};
+
+
+void
+Usage(const char *msg)
+{
+    if (msg) {fprintf(stderr, "MacaroonsBench: %s\n", msg);}
+    fprintf(stderr, "Usage: xrdmacaroonsbench [-n <requests>] [-t <tokens>] [-c <cache size>]\n");
+    exit(msg ? 1 : 0);
+}
+
+
+std::string
+Mint(const std::string &location, const std::string &secret, const std::string &id,
+     const std::vector<std::string> &caveats)
+{
+    enum macaroon_returncode mac_err;
+    struct macaroon *mac = macaroon_create(reinterpret_cast<const unsigned char*>(location.c_str()),
+                                           location.size(),
+                                           reinterpret_cast<const unsigned char*>(secret.c_str()),
+                                           secret.size(),
+                                           reinterpret_cast<const unsigned char*>(id.c_str()),
+                                           id.size(), &mac_err);
+    for (std::vector<std::string>::const_iterator iter = caveats.begin();
+         mac && iter != caveats.end();
+         iter++)
+    {
+        struct macaroon *mac_tmp = mac;
+        mac = macaroon_add_first_party_caveat(mac_tmp,
+                                              reinterpret_cast<const unsigned char*>(iter->c_str()),
+                                              iter->size(), &mac_err);
+        macaroon_destroy(mac_tmp);
+    }
+    if (!mac) {throw std::runtime_error("Failed to mint a macaroon");}
+
+    size_t size_hint = macaroon_serialize_size_hint(mac);
+    std::vector<char> buff(size_hint);
+    if (macaroon_serialize(mac, &buff[0], size_hint, &mac_err))
+    {
+        macaroon_destroy(mac);
+        throw std::runtime_error("Failed to serialize a macaroon");
+    }
+    macaroon_destroy(mac);
+    return std::string(&buff[0]);
+}
+
+
+std::string
+WriteConfig(const std::string &dir, const std::string &secret, long cache_size)
+{
+    unsigned char b64[128];
+    int b64_len = EVP_EncodeBlock(b64, reinterpret_cast<const unsigned char *>(secret.c_str()), secret.size());
+    std::string key_file = dir + "/secret";
+    FILE *fp = fopen(key_file.c_str(), "w");
+    if (!fp) {throw std::runtime_error("Unable to write " + key_file);}
+    fprintf(fp, "%.*s\n", b64_len, b64);
+    fclose(fp);
+
+    std::string cfg_file = dir + (cache_size ? "/cached.cfg" : "/uncached.cfg");
+    if (!(fp = fopen(cfg_file.c_str(), "w"))) {throw std::runtime_error("Unable to write " + cfg_file);}
+    fprintf(fp, "all.sitename Bench_Site\nmacaroons.secretkey %s\nmacaroons.onmissing deny\n"
+                "macaroons.trace error\nmacaroons.cache size %ld\n",
+            key_file.c_str(), cache_size);
+    fclose(fp);
+    return cfg_file;
+}
+
+
+double
+Now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+double
+Time(Authz &authz, std::vector<XrdOucEnv*> &envs, XrdSecEntity &entity, long count,
+     long &allowed)
+{
+    const size_t nreq = sizeof(g_requests)/sizeof(g_requests[0]);
+    allowed = 0;
+    double start = Now();
+    for (long idx = 0; idx < count; idx++)
+    {
+        const Request &req = g_requests[idx % nreq];
+        XrdOucEnv *env = envs[(idx / nreq) % envs.size()];
+        if (authz.Access(&entity, req.path, req.oper, env) != XrdAccPriv_None) {allowed++;}
+    }
+    return Now() - start;
+}
+
+}
+
+
+int main(int argc, char **argv)
+{
+    long count = 200000, tokens = 16, cache_size = 10000;
+    int c;
+
+    while ((c = getopt(argc, argv, "c:hn:t:")) != -1)
+    {
+        switch (c)
+        {
+            case 'c': if ((cache_size = atol(optarg)) <= 0) {Usage("invalid cache size");}
+                      break;
+            case 'n': if ((count = atol(optarg)) <= 0) {Usage("invalid request count");}
+                      break;
+            case 't': if ((tokens = atol(optarg)) <= 0) {Usage("invalid token count");}
+                      break;
+            case 'h': Usage(nullptr); break;
+            default:  Usage("invalid option");
+        }
+    }
+
+    char dir_template[] = "/tmp/xrdmacaroonsbench.XXXXXX";
+    if (!mkdtemp(dir_template)) {perror("MacaroonsBench: mkdtemp"); return 2;}
+    std::string dir(dir_template);
+
+    unsigned char raw_key[48];
+    if (RAND_bytes(raw_key, sizeof(raw_key)) != 1) {fprintf(stderr, "MacaroonsBench: no random key\n"); return 2;}
+    std::string secret(reinterpret_cast<char *>(raw_key), sizeof(raw_key));
+
+    // The configuration stream expects to be read within a server instance.
+    setenv("XRDINSTANCE", "xrdmacaroonsbench anon@localhost", 0);
+
+    XrdSysLogger logger;
+    std::vector<XrdOucEnv*> envs;
+    int rc = 0;
+    try
+    {
+        std::string uncached_cfg = WriteConfig(dir, secret, 0);
+        std::string cached_cfg = WriteConfig(dir, secret, cache_size);
+        Authz uncached(&logger, uncached_cfg.c_str(), nullptr);
+        Authz cached(&logger, cached_cfg.c_str(), nullptr);
+
+        // Every other token is signed with the wrong key to include
+        // verification failures in the mix.
+        char before[64];
+        time_t expiry = time(NULL) + 3600;
+        struct tm expiry_tm;
+        strftime(before, sizeof(before), "before:%Y-%m-%dT%H:%M:%SZ", gmtime_r(&expiry, &expiry_tm));
+        std::vector<std::string> caveats;
+        caveats.push_back("activity:DOWNLOAD,LIST");
+        caveats.push_back("path:/data/bench/");
+        caveats.push_back(before);
+        for (long idx = 0; idx < tokens; idx++)
+        {
+            std::string key = (idx % 2) ? std::string(secret).replace(0, 1, 1, ~secret[0]) : secret;
+            std::string token = Mint("Bench_Site", key, "bench-" + std::to_string(idx), caveats);
+            envs.push_back(new XrdOucEnv());
+            envs.back()->Put("authz", ("Bearer%20" + token).c_str());
+        }
+
+        XrdSecEntity entity("https");
+        const size_t nreq = sizeof(g_requests)/sizeof(g_requests[0]);
+        int mismatches = 0;
+        for (size_t idx = 0; idx < nreq * envs.size(); idx++)
+        {
+            const Request &req = g_requests[idx % nreq];
+            XrdOucEnv *env = envs[(idx / nreq) % envs.size()];
+            if (uncached.Access(&entity, req.path, req.oper, env) !=
+                cached.Access(&entity, req.path, req.oper, env))
+            {
+                mismatches++;
+            }
+        }
+        if (mismatches)
+        {
+            fprintf(stderr, "MacaroonsBench: %d authorization mismatches\n", mismatches);
+            rc = 3;
+        }
+        else
+        {
+            long allowed;
+            double t_uncached = Time(uncached, envs, entity, count, allowed);
+            double t_cached = Time(cached, envs, entity, count, allowed);
+            printf("%ld requests (%ld allowed) over %ld tokens\n", count, allowed, tokens);
+            printf("uncached: %8.1f us/decision %10.0f decisions/s\n",
+                   t_uncached*1e6/count, count/t_uncached);
+            printf("cached:   %8.1f us/decision %10.0f decisions/s (x%.2f)\n",
+                   t_cached*1e6/count, count/t_cached, t_uncached/t_cached);
+            printf("cache: %llu hits, %llu misses, %llu evictions\n",
+                   cached.Cache().Hits(), cached.Cache().Misses(), cached.Cache().Evictions());
+        }
+    }
+    catch (std::exception &exc)
+    {
+        fprintf(stderr, "MacaroonsBench: %s\n", exc.what());
+        rc = 2;
+    }
+
+    for (std::vector<XrdOucEnv*>::iterator iter = envs.begin(); iter != envs.end(); iter++) {delete *iter;}
+    unlink((dir + "/secret").c_str());
+    unlink((dir + "/cached.cfg").c_str());
+    unlink((dir + "/uncached.cfg").c_str());
+    rmdir(dir.c_str());
+    return rc;
+}
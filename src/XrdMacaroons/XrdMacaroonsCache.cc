@@ -0,0 +1,224 @@
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sstream>
+
+#include <openssl/sha.h>
+
+#include "XrdSys/XrdSysError.hh"
+
+#include "XrdMacaroonsHandler.hh"
+#include "XrdMacaroonsCache.hh"
+
+using namespace Macaroons;
+
+
+int
+TokenInfo::OperActivity(Access_Operation oper)
+{
+    switch (oper)
+    {
+    case AOP_Any:
+        break;
+    case AOP_Chmod:
+    case AOP_Chown:
+        return UPDATE_METADATA;
+    case AOP_Insert:
+    case AOP_Lock:
+    case AOP_Mkdir:
+    case AOP_Rename:
+    case AOP_Update:
+        return MANAGE;
+    case AOP_Create:
+        return UPLOAD;
+    case AOP_Delete:
+        return DELETE;
+    case AOP_Read:
+        return DOWNLOAD;
+    case AOP_Readdir:
+        return LIST;
+    case AOP_Stat:
+        return READ_METADATA;
+    };
+    return 0;
+}
+
+
+// The caveat checks are split into the part that depends only on the token
+// (done here, once, while the signature is verified) and the part that
+// depends on the request (done in Allows).
+bool
+TokenInfo::AddCaveat(const std::string &caveat)
+{
+    if (!strncmp("before:", caveat.c_str(), 7))
+    {
+        struct tm caveat_tm;
+        if (strptime(&caveat[7], "%Y-%m-%dT%H:%M:%SZ", &caveat_tm) == nullptr) {return false;}
+        caveat_tm.tm_isdst = -1;
+        time_t caveat_time = timegm(&caveat_tm);
+        if (-1 == caveat_time) {return false;}
+        if (!m_not_after || caveat_time < m_not_after) {m_not_after = caveat_time;}
+        if (caveat_time > m_latest_before) {m_latest_before = caveat_time;}
+        return true;
+    }
+    if (!strncmp("activity:", caveat.c_str(), 9))
+    {
+        int activities = 0;
+        std::stringstream ss(caveat.substr(9));
+        for (std::string activity; std::getline(ss, activity, ','); )
+        {
+            // Any allowed activity also implies "READ_METADATA"
+            activities |= READ_METADATA;
+            if (activity == "DOWNLOAD") {activities |= DOWNLOAD;}
+            else if (activity == "UPLOAD") {activities |= UPLOAD;}
+            else if (activity == "DELETE") {activities |= DELETE;}
+            else if (activity == "MANAGE") {activities |= MANAGE;}
+            else if (activity == "UPDATE_METADATA") {activities |= UPDATE_METADATA;}
+            else if (activity == "LIST") {activities |= LIST;}
+        }
+        m_activities &= activities;
+        return true;
+    }
+    if (!strncmp("path:", caveat.c_str(), 5))
+    {
+        m_paths.push_back(caveat.substr(5));
+        return true;
+    }
+    if (!strncmp("name:", caveat.c_str(), 5))
+    {
+        if (caveat.size() < 6) {return false;}
+        m_name = caveat.substr(5);
+        return true;
+    }
+    return false;
+}
+
+
+bool
+TokenInfo::Allows(const std::string &path, Access_Operation oper, time_t now,
+                  ssize_t max_duration) const
+{
+    if (m_status != VALID) {return false;}
+
+    if (m_not_after)
+    {
+        if (now >= m_not_after) {return false;}
+        if ((max_duration > 0) && (m_latest_before > now + max_duration)) {return false;}
+    }
+
+    if (!(m_activities & OperActivity(oper))) {return false;}
+
+    if (m_paths.empty()) {return true;}
+    if ((path.find("/./") != std::string::npos) ||
+        (path.find("/../") != std::string::npos))
+    {
+        return false;
+    }
+    for (std::vector<std::string>::const_iterator iter = m_paths.begin();
+         iter != m_paths.end();
+         iter++)
+    {
+        size_t compare_chars = iter->size();
+        if (compare_chars && (*iter)[compare_chars - 1] == '/') {compare_chars--;}
+        if (!strncmp(iter->c_str(), path.c_str(), compare_chars)) {continue;}
+        // READ_METADATA permission for /foo/bar automatically implies
+        // permission to READ_METADATA for /foo.
+        if ((oper == AOP_Stat) && !strncmp(path.c_str(), iter->c_str(), path.size())) {continue;}
+        return false;
+    }
+    return true;
+}
+
+
+TokenCache::TokenCache(size_t max_entries, int lifetime, XrdSysError &log)
+    : m_max_entries(max_entries),
+      m_lifetime(lifetime),
+      m_log(log),
+      m_last_report(time(NULL)),
+      m_hits(0),
+      m_misses(0),
+      m_evictions(0)
+{}
+
+
+std::string
+TokenCache::Digest(const std::string &token)
+{
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char *>(token.c_str()), token.size(), digest);
+    return std::string(reinterpret_cast<const char *>(digest), sizeof(digest));
+}
+
+
+std::shared_ptr<const TokenInfo>
+TokenCache::Get(const std::string &token)
+{
+    if (!Enabled()) {return std::shared_ptr<const TokenInfo>();}
+
+    std::string key = Digest(token);
+    time_t now = time(NULL);
+    std::shared_ptr<const TokenInfo> info;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_map.find(key);
+    if (iter != m_map.end())
+    {
+        if (iter->second->second.first > now)
+        {
+            // Move to the front of the LRU list.
+            m_lru.splice(m_lru.begin(), m_lru, iter->second);
+            info = iter->second->second.second;
+        }
+        else
+        {
+            m_lru.erase(iter->second);
+            m_map.erase(iter);
+        }
+    }
+    if (info) {m_hits++;}
+    else {m_misses++;}
+
+    if (now - m_last_report >= m_report_interval) {Report(now);}
+    return info;
+}
+
+
+void
+TokenCache::Put(const std::string &token, std::shared_ptr<const TokenInfo> info)
+{
+    if (!Enabled()) {return;}
+
+    std::string key = Digest(token);
+    time_t expiry = time(NULL) + m_lifetime;
+    if (info->m_not_after && info->m_not_after < expiry) {expiry = info->m_not_after;}
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto iter = m_map.find(key);
+    if (iter != m_map.end())
+    {
+        m_lru.erase(iter->second);
+        m_map.erase(iter);
+    }
+    m_lru.push_front(Entry(key, std::make_pair(expiry, info)));
+    m_map[key] = m_lru.begin();
+
+    while (m_lru.size() > m_max_entries)
+    {
+        m_map.erase(m_lru.back().first);
+        m_lru.pop_back();
+        m_evictions++;
+    }
+}
+
+
+// Called with the lock held.
+void
+TokenCache::Report(time_t now)
+{
+    char buff[256];
+    snprintf(buff, sizeof(buff), "%zu entries, %llu hits, %llu misses, %llu evictions",
+             m_lru.size(), Hits(), Misses(), Evictions());
+    m_log.Log(LogMask::Info, "TokenCache", buff);
+    m_last_report = now;
+}
@@ -0,0 +1,112 @@
+
+#include <time.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "XrdAcc/XrdAccAuthorize.hh"
+
+class XrdSysError;
+
+namespace Macaroons
+{
+
+// The outcome of parsing and verifying a bearer token once, independent of
+// the path and operation it is later used for.
+class TokenInfo
+{
+public:
+    enum Status {
+        VALID,          // Signature verified; caveats recorded below
+        INVALID,        // Signature or caveats failed verification
+        WRONG_LOCATION, // A macaroon for another site
+        NOT_MACAROON    // Not a macaroon at all (maybe another token type)
+    };
+
+    TokenInfo() :
+        m_status(NOT_MACAROON),
+        m_not_after(0),
+        m_latest_before(0),
+        m_activities(ALL_ACTIVITIES)
+    {}
+
+    // Returns true if the recorded caveats allow the operation on the path
+    // at the given time.
+    bool Allows(const std::string &path, Access_Operation oper, time_t now,
+                ssize_t max_duration) const;
+
+    // Record a caveat; returns false if it is one the verifier would reject.
+    bool AddCaveat(const std::string &caveat);
+
+    // Activity bits; READ_METADATA is granted by any listed activity.
+    enum Activity {
+        DOWNLOAD        = 0x01,
+        UPLOAD          = 0x02,
+        DELETE          = 0x04,
+        MANAGE          = 0x08,
+        UPDATE_METADATA = 0x10,
+        LIST            = 0x20,
+        READ_METADATA   = 0x40,
+        ALL_ACTIVITIES  = 0x7f
+    };
+
+    static int OperActivity(Access_Operation oper);
+
+    Status m_status;
+    time_t m_not_after;     // Earliest "before" caveat (0 if none)
+    time_t m_latest_before; // Latest "before" caveat (0 if none)
+    int m_activities;       // Activities allowed by every activity caveat
+    std::vector<std::string> m_paths;
+    std::string m_name;
+    std::string m_id;
+    std::string m_location;
+};
+
+
+// A bounded, least-recently-used cache of verified tokens keyed by the
+// SHA-256 digest of the token.  Entries are dropped once their lifetime or
+// the token's own expiry passes, whichever comes first.
+class TokenCache
+{
+public:
+    TokenCache(size_t max_entries, int lifetime, XrdSysError &log);
+
+    std::shared_ptr<const TokenInfo> Get(const std::string &token);
+
+    void Put(const std::string &token, std::shared_ptr<const TokenInfo> info);
+
+    bool Enabled() const {return m_max_entries > 0;}
+
+    unsigned long long Hits() const {return m_hits;}
+    unsigned long long Misses() const {return m_misses;}
+    unsigned long long Evictions() const {return m_evictions;}
+
+private:
+    typedef std::pair<std::string, std::pair<time_t, std::shared_ptr<const TokenInfo>>> Entry;
+
+    static std::string Digest(const std::string &token);
+    void Report(time_t now);
+
+    static const int m_report_interval = 300;
+
+    size_t m_max_entries;
+    int m_lifetime;
+    XrdSysError &m_log;
+
+    std::mutex m_mutex;
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_map;
+    time_t m_last_report;
+
+    std::atomic<unsigned long long> m_hits;
+    std::atomic<unsigned long long> m_misses;
+    std::atomic<unsigned long long> m_evictions;
+};
+
+}
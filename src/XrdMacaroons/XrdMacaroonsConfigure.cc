@@ -37,7 +37,7 @@ static bool xonmissing(XrdOucStream &config_obj, XrdSysError *log, Handler::Auth
 
 bool Handler::Config(const char *config, XrdOucEnv *env, XrdSysError *log,
     std::string &location, std::string &secret, ssize_t &max_duration,
-    AuthzBehavior &behavior)
+    AuthzBehavior &behavior, size_t &cache_size, int &cache_lifetime)
 {
   XrdOucStream config_obj(log, getenv("XRDINSTANCE"), env, "=====> ");
 
@@ -57,6 +57,10 @@ bool Handler::Config(const char *config, XrdOucEnv *env, XrdSysError *log,
   // Set default maximum duration (24 hours).
   max_duration = 24*3600;
 
+  // Set default verified token cache size and entry lifetime.
+  cache_size = 10000;
+  cache_lifetime = 600;
+
   // Process items
   //
   char *orig_var, *var;
@@ -75,6 +79,7 @@ bool Handler::Config(const char *config, XrdOucEnv *env, XrdSysError *log,
     else if (!strcmp("trace", var)) {success = xtrace(config_obj, log);}
     else if (!strcmp("maxduration", var)) {success = xmaxduration(config_obj, log, max_duration);}
     else if (!strcmp("onmissing", var)) {success = xonmissing(config_obj, log, behavior);}
+    else if (!strcmp("cache", var)) {success = xcache(config_obj, log, cache_size, cache_lifetime);}
     else {
         log->Say("Config warning: ignoring unknown directive '", orig_var, "'.");
         config_obj.Echo();
@@ -168,6 +173,43 @@ bool Handler::xmaxduration(XrdOucStream &config_obj, XrdSysError *log, ssize_t &
   return true;
 }
 
+
+// macaroons.cache [size <entries>] [lifetime <seconds>]
+//
+bool Handler::xcache(XrdOucStream &config_obj, XrdSysError *log, size_t &cache_size, int &cache_lifetime)
+{
+  char *val = config_obj.GetWord();
+  if (!val || !val[0])
+  {
+    log->Emsg("Config", "macaroons.cache requires at least one option [size | lifetime]");
+    return false;
+  }
+  do {
+    bool is_size = !strcmp(val, "size");
+    if (!is_size && strcmp(val, "lifetime"))
+    {
+      log->Emsg("Config", "macaroons.cache encountered an unknown option:", val);
+      return false;
+    }
+    if (!(val = config_obj.GetWord()) || !val[0])
+    {
+      log->Emsg("Config", "macaroons.cache option requires a value:", is_size ? "size" : "lifetime");
+      return false;
+    }
+    char *endptr = NULL;
+    long long num = strtoll(val, &endptr, 10);
+    if (endptr == val || *endptr || num < 0)
+    {
+      log->Emsg("Config", "Unable to parse macaroons.cache value as a non-negative integer", val);
+      return false;
+    }
+    if (is_size) {cache_size = num;}
+    else {cache_lifetime = num;}
+  } while ((val = config_obj.GetWord()));
+
+  return true;
+}
+
 bool Handler::xsitename(XrdOucStream &config_obj, XrdSysError *log, std::string &location)
 {
   char *val = config_obj.GetWord();
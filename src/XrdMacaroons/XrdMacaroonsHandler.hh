@@ -30,7 +30,10 @@ public:
         m_log(log)
     {
         AuthzBehavior behavior;
-        if (!Config(config, myEnv, m_log, m_location, m_secret, m_max_duration, behavior))
+        size_t cache_size;
+        int cache_lifetime;
+        if (!Config(config, myEnv, m_log, m_location, m_secret, m_max_duration, behavior,
+                    cache_size, cache_lifetime))
         {
             throw std::runtime_error("Macaroon handler config failed.");
         }
@@ -53,7 +56,7 @@ public:
     // this code.
     static bool Config(const char *config, XrdOucEnv *env, XrdSysError *log,
         std::string &location, std::string &secret, ssize_t &max_duration,
-        AuthzBehavior &behavior);
+        AuthzBehavior &behavior, size_t &cache_size, int &cache_lifetime);
 
 private:
     std::string GenerateID(const std::string &, const XrdSecEntity &, const std::string &, const std::vector<std::string> &, const std::string &);
@@ -67,6 +70,7 @@ private:
     static bool xsitename(XrdOucStream &Config, XrdSysError *log, std::string &location);
     static bool xtrace(XrdOucStream &Config, XrdSysError *log);
     static bool xmaxduration(XrdOucStream &Config, XrdSysError *log, ssize_t &max_duration);
+    static bool xcache(XrdOucStream &Config, XrdSysError *log, size_t &cache_size, int &cache_lifetime);
 
     ssize_t m_max_duration;
     XrdAccAuthorize *m_chain;
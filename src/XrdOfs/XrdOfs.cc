@@ -63,6 +63,7 @@
 #include "XrdOfs/XrdOfsTPC.hh"
 
 #include "XrdCms/XrdCmsClient.hh"
+#include "XrdCms/XrdCmsLatency.hh"
 
 #include "XrdOss/XrdOss.hh"
 
@@ -441,6 +442,7 @@ int XrdOfsFile::open(const char          *path,      // In
    EPNAME("open");
    static const int crMask = (SFS_O_CREAT  | SFS_O_TRUNC);
    static const int opMask = (SFS_O_RDONLY | SFS_O_WRONLY | SFS_O_RDWR);
+   XrdCmsLatency::Timer latTimer;
 
    struct OpenHelper
          {const char   *Path;
@@ -922,6 +924,7 @@ XrdSfsXferSize XrdOfsFile::read(XrdSfsFileOffset  offset,    // In
 */
 {
    EPNAME("read");
+   XrdCmsLatency::Timer latTimer;
    XrdSfsXferSize nbytes;
 
 // Perform required tracing
@@ -970,6 +973,7 @@ XrdSfsXferSize XrdOfsFile::readv(XrdOucIOVec     *readV,     // In
 */
 {
    EPNAME("readv");
+   XrdCmsLatency::Timer latTimer;
 
    XrdSfsXferSize nbytes = oh->Select().ReadV(readV, readCount);
    if (nbytes < 0)
@@ -1152,6 +1156,60 @@ int XrdOfsFile::getMmap(void **Addr, off_t &Size)         // Out
    return SFS_OK;
 }
   
+/******************************************************************************/
+/*                              s e t C k s u m                               */
+/******************************************************************************/
+
+int            XrdOfsFile::setCksum(const XrdCksData &cksData)
+/*
+  Function: Record the checksum of a file the caller has just written.
+
+  Input:    cksData   - The checksum name and its binary value.
+
+  Output:   Returns SFS_OK upon success and SFS_ERROR upon failure.
+
+  Notes:    1) The checksum is associated with the file's current modification
+               time so any later change to the file invalidates it.
+            2) This is only available to code running in the server as a
+               client could otherwise record whatever checksum it liked.
+*/
+{
+   EPNAME("setCksum");
+   XrdCksData cksRec(cksData);
+   char pBuff[MAXPATHLEN+8], cksVal[XrdCksData::ValuSize*2+1];
+   const char *Path;
+   int rc;
+
+// Make sure we can actually do this
+//
+   if (!XrdOfsFS->Cks)
+      {error.setErrInfo(ENOTSUP, "Checksums are not supported.");
+       return SFS_ERROR;
+      }
+   if (!oh || !oh->isRW)
+      {error.setErrInfo(EBADF, "checksum set for a file not open for writing");
+       return SFS_ERROR;
+      }
+   if (!cksRec.Length || !cksRec.Get(cksVal, sizeof(cksVal)))
+      {error.setErrInfo(EINVAL, "Invalid checksum specification.");
+       return SFS_ERROR;
+      }
+
+// Perform required tracing
+//
+   FTRACE(write, "set " <<cksRec.Name <<' ' <<cksVal);
+
+// Convert the lfn to a pfn, if need be, and record the checksum
+//
+   Path = oh->Name();
+   if (XrdOfsFS->CksPfn
+   &&  !(Path = XrdOfsOss->Lfn2Pfn(oh->Name(), pBuff, MAXPATHLEN, rc)))
+      return XrdOfsFS->Emsg(epname, error, rc, "set checksum", oh->Name());
+   if ((rc = XrdOfsFS->Cks->Set(Path, cksRec)))
+      return XrdOfsFS->Emsg(epname, error, rc, "set checksum", oh->Name());
+   return SFS_OK;
+}
+
 /******************************************************************************/
 /*                                  s t a t                                   */
 /******************************************************************************/
@@ -39,6 +39,7 @@
 #include "XrdSfs/XrdSfsInterface.hh"
 #include "XrdCms/XrdCmsClient.hh"
 
+class XrdCksData;
 class XrdNetIF;
 class XrdOfsEvs;
 class XrdOfsPocq;
@@ -149,6 +150,10 @@ public:
 
         int            read(XrdSfsAio *aioparm);
 
+        // Record the checksum of data written through this object. This is
+        // for in-process callers only; clients cannot reach it.
+        int            setCksum(const XrdCksData &cksData);
+
         XrdSfsXferSize write(XrdSfsFileOffset   fileOffset,
                              const char        *buffer,
                              XrdSfsXferSize     buffer_size);
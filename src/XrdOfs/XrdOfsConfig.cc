@@ -1344,6 +1344,8 @@ int XrdOfs::xrole(XrdOucStream &Config, XrdSysError &Eroute)
                                          [streams <num>[,<max>]]
                                          [echo] [scan {stderr | stdout}]
                                          [autorm] [pgm <path> [parms]]
+                                         [engine {pgm | xrdcl}]
+                                         [chunks <num>[,<size>]]
                                          [fcreds  [?]<auth> =<evar>]
                                          [fcpath <path>] [oids]
 
@@ -1374,6 +1376,12 @@ int XrdOfs::xrole(XrdOucStream &Config, XrdSysError &Eroute)
                      default is to scan both.
              pgm     specifies the transfer command with optional paramaters.
                      It must be the last parameter on the line.
+             engine  how copies are done: pgm runs the transfer command for
+                     each copy (the default) while xrdcl copies in-process
+                     using the client library over shared connections. Copies
+                     that forward credentials always use the transfer command.
+             chunks  the number of chunks an xrdcl copy keeps in flight and,
+                     optionally, the size of each chunk.
              fcreds  Forward destination credentials for protocol <auth>. The
                      request fails if thee are no credentials for <auth>. If a
                      question mark preceeds <auth> then if the client has not
@@ -1488,6 +1496,31 @@ int XrdOfs::xtpc(XrdOucStream &Config, XrdSysError &Eroute)
              if (XrdOuca2x::a2i(Eroute,"tpc streams",val,&Parms.Strm,0,15)) return 1;
              continue;
             }
+         if (!strcmp(val, "engine"))
+            {if (!(val = Config.GetWord()))
+                {Eroute.Emsg("Config","tpc engine not specified"); return 1;}
+                  if (!strcmp(val, "pgm"))   Parms.xfrEng = 0;
+             else if (!strcmp(val, "xrdcl")) Parms.xfrEng = 1;
+             else {Eroute.Emsg("Config","invalid tpc engine -",val); return 1;}
+             continue;
+            }
+         if (!strcmp(val, "chunks"))
+            {if (!(val = Config.GetWord()))
+                {Eroute.Emsg("Config","tpc chunks value not specified"); return 1;}
+             char *comma = index(val,',');
+             long long chSz;
+             if (comma)
+                {*comma++ = 0;
+                 if (!(*comma))
+                    {Eroute.Emsg("Config","tpc chunks size missing"); return 1;}
+                 if (XrdOuca2x::a2sz(Eroute,"tpc chunk size",comma,&chSz,
+                                     4096, 1024*1024*1024)) return 1;
+                 Parms.ChunkSz = static_cast<int>(chSz);
+                }
+             if (XrdOuca2x::a2i(Eroute,"tpc chunks",val,&Parms.Chunks,1,64))
+                return 1;
+             continue;
+            }
          if (!strcmp(val, "fcreds"))
             {char aBuff[64];
              Parms.fCreds = 1;
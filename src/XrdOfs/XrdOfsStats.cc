@@ -41,9 +41,10 @@ int XrdOfsStats::Report(char *buff, int blen)
            "<opr>%d</opr><opw>%d</opw><opp>%d</opp><ups>%d</ups><han>%d</han>"
            "<rdr>%d</rdr><bxq>%d</bxq><rep>%d</rep><err>%d</err><dly>%d</dly>"
            "<sok>%d</sok><ser>%d</ser>"
-           "<tpc><grnt>%d</grnt><deny>%d</deny><err>%d</err><exp>%d</exp></tpc>"
-           "</stats>";
-    static const int  statsz = sizeof(stats1) + (12*10) + 64;
+           "<tpc><grnt>%d</grnt><deny>%d</deny><err>%d</err><exp>%d</exp>"
+           "<xfr>%d</xfr><fail>%d</fail><bytes>%lld</bytes><msec>%lld</msec>"
+           "</tpc></stats>";
+    static const int  statsz = sizeof(stats1) + (18*10) + (2*20) + 64;
 
     StatsData myData;
 
@@ -69,5 +70,7 @@ int XrdOfsStats::Report(char *buff, int blen)
                     myData.numErrors,   myData.numDelays,
                     myData.numSeventOK, myData.numSeventER,
                     myData.numTPCgrant, myData.numTPCdeny,
-                    myData.numTPCerrs,  myData.numTPCexpr);
+                    myData.numTPCerrs,  myData.numTPCexpr,
+                    myData.numTPCxfrs,  myData.numTPCfail,
+                    myData.TPCbytes,    myData.TPCmsecs);
 }
@@ -55,6 +55,10 @@ int         numTPCgrant;
 int         numTPCdeny;
 int         numTPCerrs;
 int         numTPCexpr;
+int         numTPCxfrs; // Copies completed
+int         numTPCfail; // Copies failed
+long long   TPCbytes;   // Bytes copied
+long long   TPCmsecs;   // Milliseconds spent copying
 }           Data;
 
 XrdSysMutex sdMutex;
@@ -63,6 +67,14 @@ inline void Add(int &Cntr) {sdMutex.Lock(); Cntr++; sdMutex.UnLock();}
 
 inline void Dec(int &Cntr) {sdMutex.Lock(); Cntr--; sdMutex.UnLock();}
 
+inline void AddXfr(bool isOK, long long bytes, long long msecs)
+                  {sdMutex.Lock();
+                   if (isOK) Data.numTPCxfrs++;
+                      else   Data.numTPCfail++;
+                   Data.TPCbytes += bytes; Data.TPCmsecs += msecs;
+                   sdMutex.UnLock();
+                  }
+
        int  Report(char *Buff, int Blen);
 
        void setRole(const char *theRole) {myRole = theRole;}
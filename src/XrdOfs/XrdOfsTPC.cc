@@ -80,6 +80,8 @@ int                tcpSTRM  = 0;
 int                tcpSMax  = 15;
 int                LogOK    = 0;
 int                xfrMax   = 9;
+int                xfrChunks= 0;
+int                xfrChSz  = 0;
 int                tpcOK    = 0;
 int                encTPC   = 0;
 int                errMon   =-3;
@@ -87,6 +89,7 @@ int                fcNum    = 0;
 bool               doEcho   = false;
 bool               autoRM   = false;
 bool               noids    = true;
+bool               xfrXrdCl = false;
 }
 
 using namespace XrdOfsTPCParms;
@@ -453,6 +456,9 @@ void XrdOfsTPC::Init(XrdOfsTPC::iParm &Parms)
    if (Parms.Grab   <  0) errMon = Parms.Grab;
    if (Parms.xEcho  >= 0) doEcho = Parms.xEcho != 0;
    if (Parms.autoRM >= 0) autoRM = Parms.autoRM != 0;
+   if (Parms.xfrEng >= 0) xfrXrdCl = Parms.xfrEng != 0;
+   if (Parms.Chunks >  0) xfrChunks= Parms.Chunks;
+   if (Parms.ChunkSz>  0) xfrChSz  = Parms.ChunkSz;
 
    noids  = Parms.oidsOK == 0;
 
@@ -88,14 +88,18 @@ struct  iParm {char *Pgm;
                int   Strm;
                int   SMax;
                int   Xmax;
+               int   Chunks;
+               int   ChunkSz;
                signed char Grab;
                signed char xEcho;
                signed char autoRM;
                signed char oidsOK;
+               signed char xfrEng;
                      iParm() : Pgm(0), Ckst(0), cpath(0), fCreds(0),
                                Dflttl(-1), Maxttl(-1),
-                               Logok(-1), Strm(-1), SMax(64), Xmax(-1), Grab(0),
-                               xEcho(-1), autoRM(-1), oidsOK(0) {}
+                               Logok(-1), Strm(-1), SMax(64), Xmax(-1),
+                               Chunks(-1), ChunkSz(-1), Grab(0),
+                               xEcho(-1), autoRM(-1), oidsOK(0), xfrEng(-1) {}
               };
 
 static  void  Init(iParm &Parms);
@@ -30,13 +30,19 @@
 
 #include <stdio.h>
 #include <strings.h>
+#include <sys/stat.h>
+#include <sys/time.h>
   
+#include "XrdVersion.hh"
+#include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOfs/XrdOfsTPC.hh"
 #include "XrdOfs/XrdOfsTPCJob.hh"
 #include "XrdOfs/XrdOfsTPCProg.hh"
+#include "XrdOfs/XrdOfsTPCXfr.hh"
 #include "XrdOfs/XrdOfsTrace.hh"
 #include "XrdOss/XrdOss.hh"
 #include "XrdOuc/XrdOucCallBack.hh"
+#include "XrdOuc/XrdOucPinLoader.hh"
 #include "XrdOuc/XrdOucProg.hh"
 #include "XrdOuc/XrdOucTrace.hh"
 #include "XrdSys/XrdSysError.hh"
@@ -48,17 +54,25 @@
 /******************************************************************************/
   
 extern XrdSysError  OfsEroute;
+extern XrdOfsStats  OfsStats;
 extern XrdOucTrace  OfsTrace;
 extern XrdOss      *XrdOfsOss;
 
+XrdVERSIONINFOREF(XrdOfs);
+
 namespace XrdOfsTPCParms
 {
 extern char        *XfrProg;
 extern char        *cksType;
+extern int          tcpSTRM;
 extern int          xfrMax;
+extern int          xfrChunks;
+extern int          xfrChSz;
 extern int          errMon;
+extern int          fcNum;
 extern bool         doEcho;
 extern bool         autoRM;
+extern bool         xfrXrdCl;
 };
 
 using namespace XrdOfsTPCParms;
@@ -69,6 +83,7 @@ using namespace XrdOfsTPCParms;
   
 XrdSysMutex        XrdOfsTPCProg::pgmMutex;
 XrdOfsTPCProg     *XrdOfsTPCProg::pgmIdle  = 0;
+XrdOfsTPCXfr      *XrdOfsTPCProg::xfrEngine= 0;
 
 /******************************************************************************/
 /*                     E x t e r n a l   L i n k a g e s                      */
@@ -122,7 +137,7 @@ int         credFile::cSeq = 0;
 XrdOfsTPCProg::XrdOfsTPCProg(XrdOfsTPCProg *Prev, int num, int errMon)
              : Prog(&OfsEroute, errMon),
                JobStream(&OfsEroute),
-               Next(Prev), Job(0)
+               Next(Prev), Job(0), Canceled(false)
              {snprintf(Pname, sizeof(Pname), "TPC job %d: ", num);
               Pname[sizeof(Pname)-1] = 0;
              }
@@ -172,9 +187,22 @@ int XrdOfsTPCProg::Init()
 //
    for (n = 0; n < xfrMax; n++)
        {pgmIdle = new XrdOfsTPCProg(pgmIdle, n, errMon);
-        if (pgmIdle->Prog.Setup(XfrProg, &OfsEroute)) return 0;
+        if ((!xfrXrdCl || fcNum) && pgmIdle->Prog.Setup(XfrProg, &OfsEroute))
+           return 0;
        }
 
+// Load the in-process copy engine if so wanted. The program is still set up
+// when credentials are forwarded as those copies always need it.
+//
+   if (xfrXrdCl)
+      {XrdOucPinLoader myLib(&OfsEroute, &XrdVERSIONINFOVAR(XrdOfs),
+                             "tpc engine", "libXrdOfsTPCXrdCl.so");
+       XrdOfsTPCGetXfr_t ep;
+       if (!(ep = (XrdOfsTPCGetXfr_t)(myLib.Resolve("XrdOfsTPCGetXfr")))
+       ||  !(xfrEngine = ep(&OfsEroute, tcpSTRM, xfrChunks, xfrChSz)))
+          return 0;
+      }
+
 // All done
 //
    doEcho = doEcho || GTRACE(debug);
@@ -239,10 +267,78 @@ XrdOfsTPCProg *XrdOfsTPCProg::Start(XrdOfsTPCJob *jP, int &rc)
 int XrdOfsTPCProg::Xeq()
 {
    EPNAME("Xeq");
+   struct timeval tBeg, tEnd;
+   char *Quest = index(Job->Info.Key, '?'), *tident = Job->Info.Org;
+   long long bytes = -1, msecs;
+   int rc;
+
+// Echo out what we are doing if so desired
+//
+   if (doEcho)
+      {if (Quest) *Quest = 0;
+       OfsEroute.Say(Pname,tident," copying ",Job->Info.Key," to ",Job->Info.Dst);
+       if (Quest) *Quest = '?';
+      }
+
+// Do the copy. The in-process engine, if any, is used unless credentials
+// must be passed to the copy as those are passed via the environment.
+//
+   *eRec = 0;
+   Canceled = false;
+   gettimeofday(&tBeg, 0);
+   if (xfrEngine && !(Job->Info.Csz > 0 && Job->Info.Crd && Job->Info.Env))
+      rc = XeqXfr(bytes);
+      else rc = XeqPgm();
+   gettimeofday(&tEnd, 0);
+   msecs = (tEnd.tv_sec - tBeg.tv_sec) * 1000LL
+         + (tEnd.tv_usec - tBeg.tv_usec) / 1000;
+   DEBUG(Pname <<"ended with rc=" <<rc);
+
+// Check if we should generate a message
+//
+   if (rc && !(*eRec)) sprintf(eRec, "Copy failed with return code %d", rc);
+
+// Log failures and optionally remove the file (Info would do that as well
+// but much later on, so we do it now).
+//
+   if (rc)
+      {OfsEroute.Emsg("TPC", Job->Info.Org, Job->Info.Lfn, eRec);
+       if (autoRM) XrdOfsOss->Unlink(Job->Info.Lfn);
+      } else Job->Info.Success();
+
+// Record the copy in the statistics. The program does not tell us how much
+// it copied, so we use the size of the file it produced.
+//
+   if (rc) bytes = 0;
+      else if (bytes < 0)
+              {struct stat Stat;
+               bytes = (XrdOfsOss->Stat(Job->Info.Lfn, &Stat) ? 0 : Stat.st_size);
+              }
+   OfsStats.AddXfr(rc == 0, bytes, msecs);
+
+// Echo out the copy rate if so desired
+//
+   if (doEcho && !rc)
+      {char sBuff[128];
+       snprintf(sBuff, sizeof(sBuff), "copied %lld bytes in %lld ms (%.1f MB/s)",
+                bytes, msecs, (msecs ? bytes / (msecs * 1000.0) : 0.0));
+       OfsEroute.Say(Pname, tident, " ", sBuff);
+      }
+
+// All done
+//
+   return rc;
+}
+
+/******************************************************************************/
+/* Private:                       X e q P g m                                 */
+/******************************************************************************/
+  
+int XrdOfsTPCProg::XeqPgm()
+{
    credFile cFile(Job);
    const char *Args[6], *eVec[5], **envArg;
    char *lP, *Colon, *cksVal, sBuff[8], *tident = Job->Info.Org;
-   char *Quest = index(Job->Info.Key, '?');
    int i, rc, aNum = 0;
 
 // If we have credentials, write them out to a file
@@ -252,14 +348,6 @@ int XrdOfsTPCProg::Xeq()
        return rc;
       }
 
-// Echo out what we are doing if so desired
-//
-   if (doEcho)
-      {if (Quest) *Quest = 0;
-       OfsEroute.Say(Pname,tident," copying ",Job->Info.Key," to ",Job->Info.Dst);
-       if (Quest) *Quest = '?';
-      }
-
 // Determine checksum option
 //
    cksVal = (Job->Info.Cks ? Job->Info.Cks : XrdOfsTPCParms::cksType);
@@ -314,14 +402,12 @@ int XrdOfsTPCProg::Xeq()
 //
    if ((rc = Prog.Run(&JobStream, Args, aNum, envArg)))
       {strcpy(eRec, "Copy failed; unable to start job.");
-       OfsEroute.Emsg("TPC", Job->Info.Org, Job->Info.Lfn, eRec);
        return rc;
       }
 
 // Now we drain the output looking for an end of run line. This line should
 // be printed as an error message should the copy fail.
 //
-   *eRec = 0;
    while((lP = JobStream.GetLine()))
         {if ((Colon = index(lP, ':')) && *(Colon+1) == ' ')
             {strncpy(eRec, Colon+2, sizeof(eRec)-1); 
@@ -333,21 +419,19 @@ int XrdOfsTPCProg::Xeq()
 // The job has completed. So, we must get the ending status.
 //
    if ((rc = Prog.RunDone(JobStream)) < 0) rc = -rc;
-   DEBUG(Pname <<"ended with rc=" <<rc);
-
-// Check if we should generate a message
-//
-   if (rc && !(*eRec)) sprintf(eRec, "Copy failed with return code %d", rc);
+   return rc;
+}
 
-// Log failures and optionally remove the file (Info would do that as well
-// but much later on, so we do it now).
-//
-   if (rc)
-      {OfsEroute.Emsg("TPC", Job->Info.Org, Job->Info.Lfn, eRec);
-       if (autoRM) XrdOfsOss->Unlink(Job->Info.Lfn);
-      } else Job->Info.Success();
+/******************************************************************************/
+/* Private:                       X e q X f r                                 */
+/******************************************************************************/
+  
+int XrdOfsTPCProg::XeqXfr(long long &bytes)
+{
+   const char *cksVal = (Job->Info.Cks ? Job->Info.Cks : cksType);
 
-// All done
+// Run the copy on this thread using the in-process engine
 //
-   return rc;
+   return xfrEngine->Copy(Job->Info.Key, Job->Info.Dst, cksVal, Canceled,
+                          bytes, eRec, sizeof(eRec));
 }
@@ -30,18 +30,21 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
+
 #include "XrdOuc/XrdOucProg.hh"
 #include "XrdOuc/XrdOucStream.hh"
 #include "XrdSys/XrdSysPthread.hh"
   
 class XrdOfsTPCJob;
+class XrdOfsTPCXfr;
 class XrdOucProg;
   
 class XrdOfsTPCProg
 {
 public:
 
-       void      Cancel() {JobStream.Drain();}
+       void      Cancel() {Canceled = true; JobStream.Drain();}
 
 static int       Init();
 
@@ -57,8 +60,11 @@ XrdOfsTPCProg   *Start(XrdOfsTPCJob *jP, int &rc);
                 ~XrdOfsTPCProg() {}
 private:
        int            ExportCreds(const char *path);
+       int            XeqPgm();
+       int            XeqXfr(long long &bytes);
 static XrdSysMutex    pgmMutex;
 static XrdOfsTPCProg *pgmIdle;
+static XrdOfsTPCXfr  *xfrEngine;
 
        XrdOucProg     Prog;
        XrdOucStream   JobStream;
@@ -66,5 +72,6 @@ static XrdOfsTPCProg *pgmIdle;
        XrdOfsTPCJob  *Job;
        char           Pname[32];
        char           eRec[1024];
+       std::atomic<bool> Canceled;
 };
 #endif
@@ -0,0 +1,97 @@
+#ifndef __XRDOFSTPCXFR_HH__
+#define __XRDOFSTPCXFR_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d O f s T P C X f r . h h                        */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <atomic>
+
+/******************************************************************************/
+/*                          X r d O f s T P C X f r                           */
+/******************************************************************************/
+
+//-----------------------------------------------------------------------------
+//! The XrdOfsTPCXfr class describes an in-process copy engine that performs
+//! third party copies in place of the external copy program (see the
+//! "ofs.tpc engine" directive). Each copy is run on its own thread and any
+//! number of copies may run at the same time.
+//-----------------------------------------------------------------------------
+
+class XrdSysError;
+
+class XrdOfsTPCXfr
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Copy a file.
+//!
+//! @param  src    The source url.
+//! @param  dst    The local path of the destination file.
+//! @param  cks    The checksum to verify as <type>[:<value>] or nil.
+//! @param  cancel Reference to a flag set to true when the copy is to be
+//!                cancelled.
+//! @param  bytes  Upon return, the number of bytes copied.
+//! @param  eBuff  Buffer to receive the reason for a failure.
+//! @param  eBlen  The length of the buffer.
+//!
+//! @return 0 upon success or an errno value upon failure.
+//-----------------------------------------------------------------------------
+
+virtual int  Copy(const char *src, const char *dst, const char *cks,
+                  const std::atomic<bool> &cancel, long long &bytes,
+                  char *eBuff, int eBlen) = 0;
+
+             XrdOfsTPCXfr() {}
+virtual     ~XrdOfsTPCXfr() {}
+};
+
+/******************************************************************************/
+/*                     X r d O f s T P C G e t X f r                          */
+/******************************************************************************/
+
+//-----------------------------------------------------------------------------
+//! Obtain an instance of the copy engine. The function is loaded from the
+//! shared library named by the "ofs.tpc engine" directive.
+//!
+//! @param  eDest   The error object to use for messages.
+//! @param  streams The number of TCP streams to use per source connection.
+//! @param  chunks  The number of chunks to keep in flight per copy (0 means
+//!                 use the default).
+//! @param  chunkSz The size of each chunk (0 means use the default).
+//!
+//! @return A pointer to the engine or nil upon failure.
+//-----------------------------------------------------------------------------
+
+typedef XrdOfsTPCXfr *(*XrdOfsTPCGetXfr_t)(XrdSysError *eDest, int streams,
+                                           int chunks, int chunkSz);
+
+/*! extern "C" XrdOfsTPCXfr *XrdOfsTPCGetXfr(XrdSysError *eDest, int streams,
+                                             int chunks, int chunkSz);
+*/
+#endif
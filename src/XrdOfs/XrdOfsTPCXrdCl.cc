@@ -0,0 +1,188 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d O f s T P C X r d C l . c c                      */
+/*                                                                            */
+/* (c) 2026 by the XRootD contributors                                        */
+/*                            All Rights Reserved                             */
+/*   Author: agent <agent@local>                                              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "XProtocol/XProtocol.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClCopyProcess.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClPropertyList.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdOfs/XrdOfsTPCXfr.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdVersion.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+class xfrMonitor : public XrdCl::CopyProgressHandler
+{
+public:
+
+void     JobProgress(uint16_t jobNum, uint64_t bDone, uint64_t bTotal)
+                    {(void)jobNum; (void)bTotal; Bytes = bDone;}
+
+bool     ShouldCancel(uint16_t jobNum) {(void)jobNum; return Cancel;}
+
+         xfrMonitor(const std::atomic<bool> &cancel) : Bytes(0), Cancel(cancel) {}
+        ~xfrMonitor() {}
+
+uint64_t    Bytes;
+
+private:
+const std::atomic<bool> &Cancel;
+};
+
+/******************************************************************************/
+/*                        X r d O f s T P C X r d C l                         */
+/******************************************************************************/
+
+// All copies share the client's connections, so copies from the same source
+// server reuse one authenticated channel (with its substreams) instead of
+// each paying for a new process, login, and handshake.
+//
+class XrdOfsTPCXrdCl : public XrdOfsTPCXfr
+{
+public:
+
+int  Copy(const char *src, const char *dst, const char *cks,
+          const std::atomic<bool> &cancel, long long &bytes, char *eBuff, int eBlen);
+
+     XrdOfsTPCXrdCl(int chunks, int chunkSz)
+                   : Chunks(chunks), ChunkSz(chunkSz) {}
+    ~XrdOfsTPCXrdCl() {}
+
+private:
+
+int  Chunks;
+int  ChunkSz;
+};
+}
+
+/******************************************************************************/
+/*                                  C o p y                                   */
+/******************************************************************************/
+  
+int XrdOfsTPCXrdCl::Copy(const char *src, const char *dst, const char *cks,
+                         const std::atomic<bool> &cancel, long long &bytes,
+                         char *eBuff, int eBlen)
+{
+   XrdCl::CopyProcess   process;
+   XrdCl::PropertyList  props, results;
+   XrdCl::XRootDStatus  st;
+   xfrMonitor           xfrMon(cancel);
+   std::string          target("file://");
+   int rc;
+
+// Describe the copy the way "xrdcp --server" would. The destination file is
+// always a local file that the client has already created.
+//
+   target += dst;
+   props.Set("source", src);
+   props.Set("target", target);
+   props.Set("force",  true);
+   if (Chunks)  props.Set("parallelChunks", Chunks);
+   if (ChunkSz) props.Set("chunkSize",      ChunkSz);
+
+// Set checksum options which are specified as <type>[:<value>]
+//
+   if (cks)
+      {std::string cksType(cks), cksVal;
+       std::string::size_type colon = cksType.find(':');
+       props.Set("checkSumMode", "end2end");
+       if (colon != std::string::npos)
+          {cksVal = cksType.substr(colon+1);
+           cksType.erase(colon);
+           if (cksVal == "print") props.Set("checkSumMode", "target");
+              else props.Set("checkSumPreset", cksVal);
+          }
+       props.Set("checkSumType", cksType);
+      }
+
+// Run the copy
+//
+   bytes = 0;
+   st = process.AddJob(props, &results);
+   if (st.IsOK()) st = process.Prepare();
+   if (st.IsOK())
+      {st = process.Run(&xfrMon);
+       if (results.HasProperty("status"))
+          results.Get("status", st);
+      }
+   bytes = static_cast<long long>(xfrMon.Bytes);
+
+// Return the result as an errno value
+//
+   if (st.IsOK()) {*eBuff = 0; return 0;}
+        if (st.code == XrdCl::errErrorResponse)
+           rc = XProtocol::toErrno(st.errNo);
+   else if (st.code == XrdCl::errOperationInterrupted || cancel)
+           rc = ECANCELED;
+   else if (st.code == XrdCl::errOSError && st.errNo)
+           rc = st.errNo;
+   else    rc = EIO;
+
+   snprintf(eBuff, eBlen, "Copy failed; %s", st.ToStr().c_str());
+   return rc;
+}
+
+/******************************************************************************/
+/*                       X r d O f s T P C G e t X f r                        */
+/******************************************************************************/
+
+XrdVERSIONINFO(XrdOfsTPCGetXfr, XrdOfsTPCXrdCl);
+
+extern "C"
+{
+XrdOfsTPCXfr *XrdOfsTPCGetXfr(XrdSysError *eDest, int streams,
+                              int chunks, int chunkSz)
+{
+   XrdCl::Env *env = XrdCl::DefaultEnv::GetEnv();
+
+// The number of substreams is a property of a connection and is fixed when
+// the connection is made, so it applies to all copies.
+//
+   if (streams > 1 && !env->PutInt("SubStreamsPerChannel", streams))
+      eDest->Say("Config warning: tpc streams overridden by "
+                 "XRD_SUBSTREAMSPERCHANNEL.");
+
+// Return the engine
+//
+   return new XrdOfsTPCXrdCl(chunks, chunkSz);
+}
+}
@@ -11,6 +11,7 @@ set( LIB_XRD_CMSREDIRL  XrdCmsRedirectLocal-${PLUGIN_VERSION} )
 set( LIB_XRD_GPFS       XrdOssSIgpfsT-${PLUGIN_VERSION} )
 set( LIB_XRD_ZCRC32     XrdCksCalczcrc32-${PLUGIN_VERSION} )
 set( LIB_XRD_THROTTLE   XrdThrottle-${PLUGIN_VERSION} )
+set( LIB_XRD_OFSTPCCL   XrdOfsTPCXrdCl-${PLUGIN_VERSION} )
 
 #-------------------------------------------------------------------------------
 # Shared library version
@@ -42,6 +43,25 @@ set_target_properties(
   INTERFACE_LINK_LIBRARIES ""
   LINK_INTERFACE_LIBRARIES "" )
 
+#-------------------------------------------------------------------------------
+# The XrdOfsTPCXrdCl module
+#-------------------------------------------------------------------------------
+add_library(
+  ${LIB_XRD_OFSTPCCL}
+  MODULE
+  XrdOfs/XrdOfsTPCXrdCl.cc     XrdOfs/XrdOfsTPCXfr.hh )
+
+target_link_libraries(
+  ${LIB_XRD_OFSTPCCL}
+  XrdCl
+  XrdUtils )
+
+set_target_properties(
+  ${LIB_XRD_OFSTPCCL}
+  PROPERTIES
+  INTERFACE_LINK_LIBRARIES ""
+  LINK_INTERFACE_LIBRARIES "" )
+
 #-------------------------------------------------------------------------------
 # The XrdBwm module
 #-------------------------------------------------------------------------------
@@ -172,5 +192,5 @@ set_target_properties(
 # Install
 #-------------------------------------------------------------------------------
 install(
-  TARGETS ${LIB_XRD_PSS} ${LIB_XRD_BWM} ${LIB_XRD_GPFS} ${LIB_XRD_ZCRC32} ${LIB_XRD_THROTTLE} ${LIB_XRD_N2NO2P} ${LIB_XRD_CMSREDIRL}
+  TARGETS ${LIB_XRD_PSS} ${LIB_XRD_BWM} ${LIB_XRD_GPFS} ${LIB_XRD_ZCRC32} ${LIB_XRD_THROTTLE} ${LIB_XRD_N2NO2P} ${LIB_XRD_CMSREDIRL} ${LIB_XRD_OFSTPCCL}
   LIBRARY DESTINATION ${CMAKE_INSTALL_LIBDIR} )
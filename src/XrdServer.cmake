@@ -73,6 +73,7 @@ add_library(
   XrdOfs/XrdOfsTPCJob.cc        XrdOfs/XrdOfsTPCJob.hh
   XrdOfs/XrdOfsTPCInfo.cc       XrdOfs/XrdOfsTPCInfo.hh
   XrdOfs/XrdOfsTPCProg.cc       XrdOfs/XrdOfsTPCProg.hh
+                                XrdOfs/XrdOfsTPCXfr.hh
 
   #-----------------------------------------------------------------------------
   # XrdSfs - Standard File System (basic)
@@ -146,6 +147,7 @@ add_library(
   XrdCms/XrdCmsClientMsg.cc       XrdCms/XrdCmsClientMsg.hh
   XrdCms/XrdCmsClient.cc          XrdCms/XrdCmsClient.hh
   XrdCms/XrdCmsFinder.cc          XrdCms/XrdCmsFinder.hh
+  XrdCms/XrdCmsLatency.cc         XrdCms/XrdCmsLatency.hh
   XrdCms/XrdCmsLogin.cc           XrdCms/XrdCmsLogin.hh
   XrdCms/XrdCmsParser.cc          XrdCms/XrdCmsParser.hh
                                   XrdCms/XrdCmsPerfMon.hh
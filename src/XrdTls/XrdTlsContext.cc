@@ -17,12 +17,26 @@
 //------------------------------------------------------------------------------
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
 #include <sys/stat.h>
 
+#include <list>
+#include <map>
+#include <string>
+
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
@@ -44,16 +58,62 @@ namespace XrdTlsGlobal
 extern XrdTls::msgCB_t msgCB;
 };
   
+/******************************************************************************/
+/*                        X r d T l s S e s s i o n s                         */
+/******************************************************************************/
+
+// A bounded set of resumable sessions kept in least recently used order. The
+// key is the session id server-side and the peer's "host:port" client-side.
+//
+class XrdTlsSessions
+{
+public:
+
+// Returns a session holding a reference for the caller or nil.
+//
+SSL_SESSION *Get(const std::string &key);
+
+// Takes over the caller's reference to the session.
+//
+void         Add(const std::string &key, SSL_SESSION *sess);
+
+void         Remove(const std::string &key, SSL_SESSION *sess);
+
+int          Stats(int &num, long long &hits, long long &miss,
+                   long long &evict);
+
+void         SetMax(int maxn) {sMutex.Lock(); maxSess = maxn; sMutex.UnLock();}
+
+             XrdTlsSessions(int maxn=0) : maxSess(maxn), numHits(0),
+                                          numMiss(0), numEvict(0) {}
+            ~XrdTlsSessions();
+
+private:
+
+typedef std::list<std::pair<std::string, SSL_SESSION *> > sessList;
+
+XrdSysMutex                               sMutex;
+sessList                                  lruList;
+std::map<std::string, sessList::iterator> sessMap;
+int                                       maxSess;
+long long                                 numHits;
+long long                                 numMiss;
+long long                                 numEvict;
+};
+
 /******************************************************************************/
 /*                      X r d T l s C o n t e x t I m p l                     */
 /******************************************************************************/
 
 struct XrdTlsContextImpl
 {
-    XrdTlsContextImpl() : ctx( 0 ) { }
-   ~XrdTlsContextImpl() {if (ctx) SSL_CTX_free(ctx);}
+    XrdTlsContextImpl() : ctx( 0 ), cltSess( 0 ) { }
+   ~XrdTlsContextImpl() {if (ctx) SSL_CTX_free(ctx);
+                         if (cltSess) delete cltSess;
+                        }
 
     SSL_CTX                      *ctx;
+    XrdTlsSessions               *cltSess;  //!< Client-side sessions by peer
     XrdTlsContext::CTX_Params     Parm;
 };
   
@@ -116,6 +176,28 @@ std::atomic<bool>      initDone( false );
 bool                   initDone = false;
 #endif
 
+int                    ctxIdx = -1; // SSL_CTX ex_data index -> XrdTlsContextImpl
+int                    sslIdx = -1; // SSL     ex_data index -> peer for reuse
+
+XrdTlsContext::SessionParms sessParms;
+
+// Server-side sessions shared by all contexts. It is never deleted as the
+// sessions must not be freed after the ssl library has been cleaned up.
+//
+XrdTlsSessions        *srvSess = new XrdTlsSessions(sessParms.cacheMax);
+
+// Handshake and session ticket statistics
+//
+XrdSysMutex            statsMutex;
+long long              srvFull    = 0;
+long long              srvResumed = 0;
+long long              srvFailed  = 0;
+long long              cltFull    = 0;
+long long              cltResumed = 0;
+long long              cltFailed  = 0;
+long long              tktIssued  = 0;
+long long              tktRotated = 0;
+
 /******************************************************************************/
 /*                               I n i t T L S                                */
 /******************************************************************************/
@@ -139,6 +221,11 @@ void InitTLS() // This is strictly a one-time call!
    ERR_load_BIO_strings();
    ERR_load_crypto_strings();
 
+// Obtain the indices used to find our objects from the ssl ones
+//
+   ctxIdx = SSL_CTX_get_ex_new_index(0, 0, 0, 0, 0);
+   sslIdx = SSL_get_ex_new_index(0, 0, 0, 0, 0);
+
 // Set callbacks if we need to do this
 //
 #ifdef XRDTLS_SET_CALLBACKS
@@ -168,6 +255,70 @@ const char *GetTlsMethod(const SSL_METHOD *&meth)
   return 0;
 }
   
+/******************************************************************************/
+/*                        T i c k e t   K e y   R i n g                       */
+/******************************************************************************/
+
+// Session tickets are encrypted with the current key; tickets encrypted with
+// the previous key are still accepted but are replaced by new ones. Keys are
+// rotated when the current one is older than the rotation interval.
+//
+struct TicketKey
+      {unsigned char name[16];
+       unsigned char aesKey[32];
+       unsigned char macKey[32];
+       time_t        born;
+      };
+
+XrdSysMutex  tktMutex;
+TicketKey    tktKeys[2];  // [0] is current, [1] is previous
+int          tktNum = 0;
+
+bool TicketKeyNew(TicketKey &key, time_t now)
+{
+   if (RAND_bytes(key.name,   sizeof(key.name))   != 1
+   ||  RAND_bytes(key.aesKey, sizeof(key.aesKey)) != 1
+   ||  RAND_bytes(key.macKey, sizeof(key.macKey)) != 1) return false;
+   key.born = now;
+   return true;
+}
+
+bool TicketKeyCur(TicketKey &key)
+{
+   XrdSysMutexHelper tktHelper(tktMutex);
+   time_t now = time(0);
+
+   if (!tktNum || now - tktKeys[0].born >= sessParms.rotate)
+      {TicketKey newKey;
+       if (!TicketKeyNew(newKey, now)) return false;
+       if (tktNum) {tktKeys[1] = tktKeys[0]; tktNum = 2;}
+          else tktNum = 1;
+       tktKeys[0] = newKey;
+       AtomicBeg(statsMutex);
+       AtomicInc(tktRotated);
+       AtomicEnd(statsMutex);
+      }
+   key = tktKeys[0];
+   return true;
+}
+
+// Returns 1 for the current key, 2 for the previous key, and 0 if the key
+// is unknown or has been retired.
+//
+int TicketKeyGet(const unsigned char *name, TicketKey &key)
+{
+   XrdSysMutexHelper tktHelper(tktMutex);
+   time_t now = time(0);
+
+   for (int i = 0; i < tktNum; i++)
+       {if (memcmp(name, tktKeys[i].name, sizeof(tktKeys[i].name))) continue;
+        if (now - tktKeys[i].born >= 2*sessParms.rotate) return 0;
+        key = tktKeys[i];
+        return (i ? 2 : 1);
+       }
+   return 0;
+}
+
 /******************************************************************************/
 /*                              V e r P a t h s                               */
 /******************************************************************************/
@@ -257,10 +408,206 @@ int VerCB(int aOK, X509_STORE_CTX *x509P)
 
    return aOK;
 }
+
+/******************************************************************************/
+/*                              T i c k e t C B                               */
+/******************************************************************************/
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int TicketCB(SSL *ssl, unsigned char *name, unsigned char *iv,
+             EVP_CIPHER_CTX *cctx, EVP_MAC_CTX *hctx, int enc)
+#else
+int TicketCB(SSL *ssl, unsigned char *name, unsigned char *iv,
+             EVP_CIPHER_CTX *cctx, HMAC_CTX *hctx, int enc)
+#endif
+{
+   TicketKey key;
+   int rc = 1;
+
+// When encrypting, use the current key with a fresh iv. When decrypting, find
+// the key the ticket was encrypted with; if it is no longer the current one
+// the client gets a new ticket (rc 2). So does every TLS 1.3 client as those
+// tickets are meant to be used only once. An unknown key means a full
+// handshake.
+//
+   if (enc)
+      {if (!TicketKeyCur(key) || RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1)
+          return -1;
+       memcpy(name, key.name, sizeof(key.name));
+       if (!EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), 0, key.aesKey, iv))
+          return -1;
+       AtomicBeg(statsMutex);
+       AtomicInc(tktIssued);
+       AtomicEnd(statsMutex);
+      } else {
+       if (!(rc = TicketKeyGet(name, key))) return 0;
+#ifdef TLS1_3_VERSION
+       if (SSL_version(ssl) >= TLS1_3_VERSION) rc = 2;
+#endif
+       if (!EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), 0, key.aesKey, iv))
+          return -1;
+      }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+   OSSL_PARAM params[3];
+   params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+                                                 key.macKey,
+                                                 sizeof(key.macKey));
+   params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                                                (char *)"SHA256", 0);
+   params[2] = OSSL_PARAM_construct_end();
+   if (!EVP_MAC_CTX_set_params(hctx, params)) return -1;
+#else
+   if (!HMAC_Init_ex(hctx, key.macKey, sizeof(key.macKey), EVP_sha256(), 0))
+      return -1;
+#endif
+   return rc;
+}
+
+/******************************************************************************/
+/*                    S e s s i o n   C a l l b a c k s                       */
+/******************************************************************************/
+
+int SrvNewSess(SSL *ssl, SSL_SESSION *sess)
+{
+   unsigned int idlen;
+   const unsigned char *id = SSL_SESSION_get_id(sess, &idlen);
+
+   srvSess->Add(std::string((const char *)id, idlen), sess);
+   return 1; // We took over the reference
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+SSL_SESSION *SrvGetSess(SSL *ssl, const unsigned char *id, int idlen, int *copy)
+#else
+SSL_SESSION *SrvGetSess(SSL *ssl,       unsigned char *id, int idlen, int *copy)
+#endif
+{
+   *copy = 0; // The reference we return is for ssl
+   return srvSess->Get(std::string((const char *)id, idlen));
+}
+
+void SrvRemSess(SSL_CTX *ctx, SSL_SESSION *sess)
+{
+   unsigned int idlen;
+   const unsigned char *id = SSL_SESSION_get_id(sess, &idlen);
+
+   srvSess->Remove(std::string((const char *)id, idlen), sess);
+}
+
+int CltNewSess(SSL *ssl, SSL_SESSION *sess)
+{
+   XrdTlsContextImpl *impl = static_cast<XrdTlsContextImpl *>
+                             (SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), ctxIdx));
+   const char *peer = static_cast<const char *>(SSL_get_ex_data(ssl, sslIdx));
+
+   if (!impl || !impl->cltSess || !peer) return 0;
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+   if (!SSL_SESSION_is_resumable(sess)) return 0;
+#endif
+   impl->cltSess->Add(std::string(peer), sess);
+   return 1; // We took over the reference
+}
 }
   
 } // Anonymous namespace end
 
+/******************************************************************************/
+/*                X r d T l s S e s s i o n s   M e t h o d s                 */
+/******************************************************************************/
+
+XrdTlsSessions::~XrdTlsSessions()
+{
+   for (sessList::iterator it = lruList.begin(); it != lruList.end(); it++)
+       SSL_SESSION_free(it->second);
+}
+
+/******************************************************************************/
+
+SSL_SESSION *XrdTlsSessions::Get(const std::string &key)
+{
+   XrdSysMutexHelper sHelper(sMutex);
+   std::map<std::string, sessList::iterator>::iterator it = sessMap.find(key);
+   SSL_SESSION *sess;
+
+// Sessions past their lifetime are dropped here as they cannot be resumed
+//
+   if (it == sessMap.end()) {numMiss++; return 0;}
+   sess = it->second->second;
+   if (SSL_SESSION_get_time(sess) + SSL_SESSION_get_timeout(sess) < time(0))
+      {lruList.erase(it->second);
+       sessMap.erase(it);
+       SSL_SESSION_free(sess);
+       numMiss++;
+       return 0;
+      }
+
+// Move the session to the front and add a reference for the caller
+//
+   lruList.splice(lruList.begin(), lruList, it->second);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+   SSL_SESSION_up_ref(sess);
+#else
+   CRYPTO_add(&sess->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif
+   numHits++;
+   return sess;
+}
+
+/******************************************************************************/
+
+void XrdTlsSessions::Add(const std::string &key, SSL_SESSION *sess)
+{
+   XrdSysMutexHelper sHelper(sMutex);
+   std::map<std::string, sessList::iterator>::iterator it = sessMap.find(key);
+
+   if (it != sessMap.end())
+      {SSL_SESSION_free(it->second->second);
+       lruList.erase(it->second);
+       sessMap.erase(it);
+      }
+
+   if (maxSess <= 0) {SSL_SESSION_free(sess); return;}
+
+   lruList.push_front(std::make_pair(key, sess));
+   sessMap[key] = lruList.begin();
+
+   while ((int)sessMap.size() > maxSess)
+         {sessMap.erase(lruList.back().first);
+          SSL_SESSION_free(lruList.back().second);
+          lruList.pop_back();
+          numEvict++;
+         }
+}
+
+/******************************************************************************/
+
+void XrdTlsSessions::Remove(const std::string &key, SSL_SESSION *sess)
+{
+   XrdSysMutexHelper sHelper(sMutex);
+   std::map<std::string, sessList::iterator>::iterator it = sessMap.find(key);
+
+   if (it != sessMap.end() && it->second->second == sess)
+      {SSL_SESSION_free(sess);
+       lruList.erase(it->second);
+       sessMap.erase(it);
+      }
+}
+
+/******************************************************************************/
+
+int XrdTlsSessions::Stats(int &num, long long &hits, long long &miss,
+                          long long &evict)
+{
+   XrdSysMutexHelper sHelper(sMutex);
+
+   num   = sessMap.size();
+   hits  = numHits;
+   miss  = numMiss;
+   evict = numEvict;
+   return num;
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -397,6 +744,14 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
        return;
       }
 
+// Server contexts resume sessions through the process-wide session cache
+// and session tickets.
+//
+   if ((opts & servr) && !ServerSessions(pImpl->ctx, "xrootd"))
+      {XrdTls::Emsg("TLS_Context", "Unable to set up session resumption.");
+       return;
+      }
+
 // If there is no cert then assume this is a generic context for a client
 //
    if (cert == 0)
@@ -444,6 +799,33 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
 
 XrdTlsContext::~XrdTlsContext() {if (pImpl) delete pImpl;}
 
+/******************************************************************************/
+/*                        C l i e n t S e s s i o n s                         */
+/******************************************************************************/
+
+bool XrdTlsContext::ClientSessions(int maxSess)
+{
+   if (!pImpl->ctx || (pImpl->Parm.opts & servr)) return false;
+
+// Turn off session reuse, if so wanted
+//
+   if (maxSess <= 0)
+      {SSL_CTX_set_session_cache_mode(pImpl->ctx, SSL_SESS_CACHE_OFF);
+       return true;
+      }
+
+// Sessions are kept by us, per peer, as they arrive. With TLS 1.3 that is
+// after the handshake has completed.
+//
+   if (pImpl->cltSess) pImpl->cltSess->SetMax(maxSess);
+      else pImpl->cltSess = new XrdTlsSessions(maxSess);
+   SSL_CTX_set_ex_data(pImpl->ctx, ctxIdx, pImpl);
+   SSL_CTX_set_session_cache_mode(pImpl->ctx, SSL_SESS_CACHE_CLIENT
+                                            | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+   SSL_CTX_sess_set_new_cb(pImpl->ctx, CltNewSess);
+   return true;
+}
+
 /******************************************************************************/
 /*                               C o n t e x t                                */
 /******************************************************************************/
@@ -462,6 +844,28 @@ const XrdTlsContext::CTX_Params *XrdTlsContext::GetParams()
   return &pImpl->Parm;
 }
 
+/******************************************************************************/
+/*                             H a n d S h a k e                              */
+/******************************************************************************/
+
+void XrdTlsContext::HandShake(void *sslP, bool isOK)
+{
+   SSL *ssl = static_cast<SSL *>(sslP);
+   bool resumed = isOK && SSL_session_reused(ssl);
+
+   AtomicBeg(statsMutex);
+   if (SSL_is_server(ssl))
+      {if (!isOK)   AtomicInc(srvFailed);
+          else if (resumed) AtomicInc(srvResumed);
+                  else      AtomicInc(srvFull);
+      } else {
+       if (!isOK)   AtomicInc(cltFailed);
+          else if (resumed) AtomicInc(cltResumed);
+                  else      AtomicInc(cltFull);
+      }
+   AtomicEnd(statsMutex);
+}
+
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -490,3 +894,115 @@ bool XrdTlsContext::x509Verify()
    return !(pImpl->Parm.cadir.empty()) || !(pImpl->Parm.cafile.empty());
 }
 
+/******************************************************************************/
+/*                          R e u s e S e s s i o n                           */
+/******************************************************************************/
+
+bool XrdTlsContext::ReuseSession(void *sslP, const char *peer)
+{
+   SSL *ssl = static_cast<SSL *>(sslP);
+   SSL_SESSION *sess;
+   int rc;
+
+// Record the peer so that the session negotiated with it is kept
+//
+   if (!pImpl->cltSess || !peer) return false;
+   SSL_set_ex_data(ssl, sslIdx, (void *)peer);
+
+// Offer the session last negotiated with this peer, if any
+//
+   if (!(sess = pImpl->cltSess->Get(std::string(peer)))) return false;
+   rc = SSL_set_session(ssl, sess);
+   SSL_SESSION_free(sess);
+   return rc == 1;
+}
+
+/******************************************************************************/
+/*                        S e r v e r S e s s i o n s                         */
+/******************************************************************************/
+
+bool XrdTlsContext::ServerSessions(void *sslCtx, const char *sid)
+{
+   SSL_CTX *ctx = static_cast<SSL_CTX *>(sslCtx);
+   int sidLen = (sid ? strlen(sid) : 0);
+
+// Validate the arguments and make sure the ssl library is initialized
+//
+   if (!ctx || !sidLen || sidLen > SSL_MAX_SID_CTX_LENGTH || Init())
+      return false;
+
+// Sessions are only resumed by contexts with the same id context. Note that
+// a server that verifies certificates fails resumptions without one.
+//
+   if (!SSL_CTX_set_session_id_context(ctx, (const unsigned char *)sid,
+                                       sidLen)) return false;
+   SSL_CTX_set_timeout(ctx, sessParms.lifetime);
+
+// Keep sessions in the cache shared by all server contexts. It holds the
+// sessions of clients that do not use tickets (and, for TLS 1.3, all of
+// them when tickets are off).
+//
+   if (sessParms.cacheMax > 0)
+      {SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER
+                                         | SSL_SESS_CACHE_NO_INTERNAL);
+       SSL_CTX_sess_set_new_cb(ctx, SrvNewSess);
+       SSL_CTX_sess_set_get_cb(ctx, SrvGetSess);
+       SSL_CTX_sess_set_remove_cb(ctx, SrvRemSess);
+      } else SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+
+// Issue session tickets with our rotating keys, if so wanted
+//
+   if (sessParms.tickets)
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+      SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, TicketCB);
+#else
+      SSL_CTX_set_tlsext_ticket_key_cb(ctx, TicketCB);
+#endif
+      else SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+
+   return true;
+}
+
+/******************************************************************************/
+/*                       S e t S e s s i o n P a r m s                        */
+/******************************************************************************/
+
+void XrdTlsContext::SetSessionParms(const XrdTlsContext::SessionParms &parms)
+{
+   sessParms = parms;
+   srvSess->SetMax(parms.cacheMax);
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdTlsContext::Stats(char *buff, int blen, bool do_sync)
+{
+   static const char statfmt[] = "<stats id=\"tls\">"
+          "<srv><full>%lld</full><rsm>%lld</rsm><fail>%lld</fail></srv>"
+          "<clnt><full>%lld</full><rsm>%lld</rsm><fail>%lld</fail></clnt>"
+          "<cache><num>%d</num><hits>%lld</hits><miss>%lld</miss>"
+          "<evict>%lld</evict></cache>"
+          "<tkt><new>%lld</new><keys>%lld</keys></tkt></stats>";
+   long long hits, miss, evict;
+   int num;
+
+// Check if actual length wanted
+//
+   if (!buff) return sizeof(statfmt) + 11*20;
+
+// Format the statistics
+//
+   srvSess->Stats(num, hits, miss, evict);
+   AtomicBeg(statsMutex);
+   int n = snprintf(buff, blen, statfmt,
+                    AtomicGet(srvFull), AtomicGet(srvResumed),
+                    AtomicGet(srvFailed),
+                    AtomicGet(cltFull), AtomicGet(cltResumed),
+                    AtomicGet(cltFailed),
+                    num, hits, miss, evict,
+                    AtomicGet(tktIssued), AtomicGet(tktRotated));
+   AtomicEnd(statsMutex);
+   return (n < blen ? n : 0);
+}
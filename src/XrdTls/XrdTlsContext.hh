@@ -84,6 +84,98 @@ const char     *Init();
 
        bool     x509Verify();
 
+//------------------------------------------------------------------------
+//! Session resumption parameters for server-side contexts. These apply to
+//! every server context in the process (see SetSessionParms()).
+//------------------------------------------------------------------------
+
+struct SessionParms
+      {int  cacheMax;   //!< Maximum number of cached sessions (0 -> no cache)
+       int  lifetime;   //!< Seconds a session may be resumed
+       int  rotate;     //!< Seconds between session ticket key rotations
+       bool tickets;    //!< Issue session tickets
+
+       SessionParms() : cacheMax(20480), lifetime(3600), rotate(3600),
+                        tickets(true) {}
+      ~SessionParms() {}
+      };
+
+//------------------------------------------------------------------------
+//! Set the session resumption parameters for server-side contexts. This
+//! must be called before any server context is created to take effect.
+//!
+//! @param  parms    The parameters to use.
+//------------------------------------------------------------------------
+static
+void            SetSessionParms(const SessionParms &parms);
+
+//------------------------------------------------------------------------
+//! Set up server-side session resumption for an SSL context. Sessions are
+//! kept in a cache shared by all server contexts in the process and, unless
+//! turned off, session tickets are issued that are encrypted with keys that
+//! are periodically rotated. The ticket keys are shared as well. A ticket
+//! remains usable for at least one rotation interval. This is done for every
+//! context created with the servr option; use this method to do the same
+//! for an SSL context created elsewhere.
+//!
+//! @param  sslCtx   Pointer to the SSL_CTX to be set up.
+//! @param  sid      The session id context (at most 32 characters). Sessions
+//!                  are only resumed by contexts with the same id.
+//!
+//! @return True upon success and false otherwise.
+//------------------------------------------------------------------------
+static
+bool            ServerSessions(void *sslCtx, const char *sid);
+
+//------------------------------------------------------------------------
+//! Set up client-side session reuse for this context. The session last
+//! negotiated with each peer is kept and offered on the next connection to
+//! that peer (see ReuseSession()), sparing the full handshake.
+//!
+//! @param  maxSess  The maximum number of peers whose session is kept. A
+//!                  value of zero or less turns off session reuse.
+//!
+//! @return True upon success and false otherwise.
+//------------------------------------------------------------------------
+
+       bool     ClientSessions(int maxSess);
+
+//------------------------------------------------------------------------
+//! Prepare a client-side connection for session reuse. This must be called
+//! before the handshake starts and only has an effect if ClientSessions()
+//! was called.
+//!
+//! @param  ssl      Pointer to the SSL object of the connection.
+//! @param  peer     The peer identification (i.e. "host:port"). It must
+//!                  remain valid for as long as the SSL object exists.
+//!
+//! @return True if a session was offered and false otherwise.
+//------------------------------------------------------------------------
+
+       bool     ReuseSession(void *ssl, const char *peer);
+
+//------------------------------------------------------------------------
+//! Record the outcome of a handshake for statistical purposes.
+//!
+//! @param  ssl      Pointer to the SSL object of the connection.
+//! @param  isOK     True if the handshake succeeded, false if it failed.
+//------------------------------------------------------------------------
+static
+void            HandShake(void *ssl, bool isOK);
+
+//------------------------------------------------------------------------
+//! Format handshake and session resumption statistics.
+//!
+//! @param  buff     Pointer to the buffer to hold the statistics. If nil,
+//!                  the maximum length of the statistics is returned.
+//! @param  blen     The length of the buffer.
+//! @param  do_sync  Not used; present for consistency.
+//!
+//! @return The number of bytes placed in the buffer.
+//------------------------------------------------------------------------
+static
+int             Stats(char *buff, int blen, bool do_sync=false);
+
 //------------------------------------------------------------------------
 //! Constructor. Note that you should use Context() to determine if
 //!              construction was successful. A nil return indicates failure.
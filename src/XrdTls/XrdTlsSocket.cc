@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include "XrdNet/XrdNetAddrInfo.hh"
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdTls/XrdTlsContext.hh"
 #include "XrdTls/XrdTlsSocket.hh"
@@ -55,6 +56,7 @@ struct XrdTlsSocketImpl
     char             cOpts;     //!< Connection options
     char             cAttr;     //!< Connection attributes
     char             hsMode;    //!< Handshake handling
+    std::string      peer;      //!< Peer "host:port" for client session reuse
 };
 
 /******************************************************************************/
@@ -152,6 +154,7 @@ do{if ((rc = SSL_accept( pImpl->ssl )) > 0)
                return XrdTls::TLS_VER_Error;
               }
           }
+       XrdTlsContext::HandShake(pImpl->ssl, true);
        ImplTracker.KeepImpl();
        return XrdTls::TLS_AOK;
       }
@@ -163,7 +166,8 @@ do{if ((rc = SSL_accept( pImpl->ssl )) > 0)
    // Check why we did not succeed. We may be able to recover.
    //
    if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE)
-      {std::string eTxt("TLS Accept() failed; ");
+      {XrdTlsContext::HandShake(pImpl->ssl, false);
+       std::string eTxt("TLS Accept() failed; ");
        eTxt += Err2Text(error);
        XrdTls::Emsg(pImpl->traceID, eTxt.c_str());;
        errno = ECONNABORTED;
@@ -189,10 +193,27 @@ XrdTls::RC XrdTlsSocket::Connect(const char *thehost, XrdNetAddrInfo *netInfo,
 // when we move to new versions of SSL. For now, we use the notary object.
 //
 
+// Offer the session last negotiated with this peer, if there is one. This is
+// done once, before the first handshake attempt.
+//
+   if (pImpl->peer.empty() && thehost && netInfo && !pImpl->hsDone)
+      {char pBuff[16];
+       snprintf(pBuff, sizeof(pBuff), ":%d", netInfo->Port());
+       pImpl->peer  = thehost;
+       pImpl->peer += pBuff;
+       pImpl->tlsctx->ReuseSession(pImpl->ssl, pImpl->peer.c_str());
+      }
+
 // Do the connect.
 //
    int rc = SSL_connect( pImpl->ssl );
-   if (rc != 1) return Diagnose(rc);
+   if (rc != 1)
+      {XrdTls::RC tlsRC = Diagnose(rc);
+       if (tlsRC != XrdTls::TLS_WantRead && tlsRC != XrdTls::TLS_WantWrite)
+          XrdTlsContext::HandShake(pImpl->ssl, false);
+       return tlsRC;
+      }
+   XrdTlsContext::HandShake(pImpl->ssl, true);
 
 //  Set the hsDone flag!
 //
@@ -305,6 +326,7 @@ const char *XrdTlsSocket::Init( XrdTlsContext &ctx, int sfd,
    if (parms->opts & XrdTlsContext::debug) pImpl->cOpts |= Debug;
    if (parms->opts & XrdTlsContext::dnsok) pImpl->cOpts |= DNSok;
    pImpl->traceID = tid;
+   pImpl->peer.clear();
 
 // Obtain the ssl object at this point.
 //
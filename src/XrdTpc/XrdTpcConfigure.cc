@@ -1,9 +1,14 @@
 
 #include "XrdTpcTPC.hh"
+#include "XrdTpcStream.hh"
 
 #include <dlfcn.h>
 #include <fcntl.h>
 
+#include <algorithm>
+
+#include "XrdOuc/XrdOuca2x.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
 #include "XrdOuc/XrdOucStream.hh"
 #include "XrdOuc/XrdOucPinPath.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
@@ -100,6 +105,108 @@ bool TPCHandler::ConfigureFSLib(XrdOucStream &Config, std::string &path1, bool &
     return true;
 }
 
+/*
+ * Parse http.tpcautotune {off | on} [maxstreams <n>] [memlimit <size>]
+ *
+ * maxstreams is the most streams a multi-stream pull is tuned up to and
+ * memlimit bounds the reorder buffers of all pulls together.
+ */
+bool TPCHandler::ConfigureAutotune(XrdOucStream &Config) {
+    char *val;
+    if (!(val = Config.GetWord())) {
+        m_log.Emsg("Config", "http.tpcautotune argument not specified");
+        return false;
+    }
+    while (val) {
+        if (!strcmp("off", val)) {
+            m_autotune = false;
+        } else if (!strcmp("on", val)) {
+            m_autotune = true;
+        } else if (!strcmp("maxstreams", val)) {
+            int streams;
+            if (!(val = Config.GetWord())) {
+                m_log.Emsg("Config", "http.tpcautotune maxstreams value not specified");
+                return false;
+            }
+            if (XrdOuca2x::a2i(m_log, "http.tpcautotune maxstreams", val, &streams, 1, 100)) {
+                return false;
+            }
+            m_autotune_streams = streams;
+        } else if (!strcmp("memlimit", val)) {
+            if (!(val = Config.GetWord())) {
+                m_log.Emsg("Config", "http.tpcautotune memlimit value not specified");
+                return false;
+            }
+            if (XrdOuca2x::a2sz(m_log, "http.tpcautotune memlimit", val,
+                                &m_autotune_memory, static_cast<long long>(m_block_size))) {
+                return false;
+            }
+        } else {
+            m_log.Emsg("Config", "invalid http.tpcautotune option", val);
+            return false;
+        }
+        val = Config.GetWord();
+    }
+    return true;
+}
+
+/*
+ * Parse http.tpcsched [maxactive <n>] [maxpervo <n>] [maxperhost <n>]
+ *                     [order {fifo | sjf}]
+ *
+ * The limits bound the transfers running at once overall, for one VO, and
+ * with one remote host; zero means no limit.  The order decides which of
+ * the queued transfers of a VO runs next.
+ */
+bool TPCHandler::ConfigureScheduler(XrdOucStream &Config) {
+    char *val;
+    if (!(val = Config.GetWord())) {
+        m_log.Emsg("Config", "http.tpcsched argument not specified");
+        return false;
+    }
+    while (val) {
+        size_t *limit = NULL;
+        if (!strcmp("maxactive", val)) {
+            limit = &m_sched_active;
+        } else if (!strcmp("maxpervo", val)) {
+            limit = &m_sched_per_vo;
+        } else if (!strcmp("maxperhost", val)) {
+            limit = &m_sched_per_host;
+        } else if (!strcmp("order", val)) {
+            if (!(val = Config.GetWord())) {
+                m_log.Emsg("Config", "http.tpcsched order not specified");
+                return false;
+            }
+            if (!strcmp("fifo", val)) {
+                m_sched_order = Scheduler::FIFO;
+            } else if (!strcmp("sjf", val)) {
+                m_sched_order = Scheduler::SJF;
+            } else {
+                m_log.Emsg("Config", "invalid http.tpcsched order", val);
+                return false;
+            }
+        } else {
+            m_log.Emsg("Config", "invalid http.tpcsched option", val);
+            return false;
+        }
+        if (limit) {
+            std::string option(val);
+            int limit_val;
+            if (!(val = Config.GetWord())) {
+                m_log.Emsg("Config", "http.tpcsched value not specified for", option.c_str());
+                return false;
+            }
+            option = "http.tpcsched " + option;
+            if (XrdOuca2x::a2i(m_log, option.c_str(), val, &limit_val, 0)) {
+                return false;
+            }
+            *limit = limit_val;
+        }
+        val = Config.GetWord();
+    }
+    return true;
+}
+
 bool TPCHandler::Configure(const char *configfn, XrdOucEnv *myEnv)
 {
     XrdOucStream Config(&m_log, getenv("XRDINSTANCE"), myEnv, "=====> ");
@@ -143,6 +250,31 @@ bool TPCHandler::Configure(const char *configfn, XrdOucEnv *myEnv)
                 m_log.Emsg("Config", "https.desthttps value is invalid", val);
                 return false;
             }
+        } else if (!strcmp("xrootd.chksum", val)) {
+            // Remember the checksums clients may ask for so that pulls can
+            // compute them as the data arrives: chksum [chkcgi] [max <n>] <type> ...
+            m_cksums.clear();
+            while ((val = Config.GetWord()) && *val != '/') {
+                if (!strcmp("chkcgi", val)) {
+                    continue;
+                } else if (!strcmp("max", val)) {
+                    if (!Config.GetWord()) {break;}
+                    continue;
+                }
+                std::string name(val);
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                m_cksums.push_back(name);
+            }
+        } else if (!strcmp("http.tpcautotune", val)) {
+            if (!ConfigureAutotune(Config)) {
+                Config.Close();
+                return false;
+            }
+        } else if (!strcmp("http.tpcsched", val)) {
+            if (!ConfigureScheduler(Config)) {
+                Config.Close();
+                return false;
+            }
         } else if (!strcmp("http.cadir", val)) {
             if (!(val = Config.GetWord())) {
                 Config.Close();
@@ -194,5 +326,23 @@ bool TPCHandler::Configure(const char *configfn, XrdOucEnv *myEnv)
     }
     m_sfs.reset(chained_sfs ? chained_sfs : base_sfs);
     m_log.Emsg("Config", "Successfully configured the filesystem object for TPC handler");
+
+    if (m_autotune) {
+        Stream::SetBudget(m_autotune_memory);
+    }
+    m_sched.reset(new Scheduler(m_sched_active, m_sched_per_vo, m_sched_per_host,
+                                m_sched_order));
+
+    // Only keep the checksums the filesystem can record for us
+    std::vector<std::string>::iterator cks_iter = m_cksums.begin();
+    while (cks_iter != m_cksums.end()) {
+        XrdOucErrInfo einfo;
+        if (m_sfs->chksum(XrdSfsFileSystem::csSize, cks_iter->c_str(), NULL, einfo) != SFS_OK) {
+            cks_iter = m_cksums.erase(cks_iter);
+        } else {
+            m_log.Emsg("Config", "Pulled files will be checksummed on the fly with", cks_iter->c_str());
+            cks_iter++;
+        }
+    }
     return true;
 }
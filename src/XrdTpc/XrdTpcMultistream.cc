@@ -6,12 +6,15 @@
 
 #include "XrdTpcTPC.hh"
 #include "XrdTpcState.hh"
+#include "XrdTpcStream.hh"
 #include "XrdTpcCurlMulti.hh"
 
 #include "XrdSys/XrdSysError.hh"
 
 #include <curl/curl.h>
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <stdexcept>
 
@@ -33,7 +36,9 @@ public:
     MultiCurlHandler(std::vector<State*> &states, XrdSysError &log) :
         m_handle(curl_multi_init()),
         m_states(states),
-        m_log(log)
+        m_log(log),
+        m_max_active(states.size()),
+        m_starved(false)
     {
         if (m_handle == NULL) {
             throw CurlHandlerSetupError("Failed to initialize a libcurl multi-handle");
@@ -68,6 +73,24 @@ public:
 
     CURLM *Get() const {return m_handle;}
 
+    // Add an idle transfer state to those that may be used. The state is
+    // appended to the vector given to the constructor, which owns it.
+    void AddState(State *state) {
+        m_states.push_back(state);
+        m_avail_handles.push_back(state->GetHandle());
+    }
+
+    // Limit the number of transfers that may run at the same time.
+    void SetMaxActive(size_t max_active) {m_max_active = max_active;}
+
+    // Returns true if a transfer could not be started since the last call
+    // because all reorder buffers were taken.
+    bool TakeStarved() {
+        bool starved = m_starved;
+        m_starved = false;
+        return starved;
+    }
+
     void FinishCurlXfer(CURL *curl) {
         CURLMcode mres = curl_multi_remove_handle(m_handle, curl);
         if (mres) {
@@ -160,7 +183,8 @@ private:
         }
     }
 
-    bool CanStartTransfer(bool log_reason) const {
+    bool CanStartTransfer(bool log_reason) {
+        if (m_active_handles.size() >= m_max_active) {return false;}
         size_t idle_handles = m_avail_handles.size();
         size_t transfer_in_progress = 0;
         for (std::vector<State*>::const_iterator state_iter = m_states.begin();
@@ -195,6 +219,7 @@ private:
                 m_states[0]->DumpBuffers();
             }
         }
+        if (available_buffers <= 0) {m_starved = true;}
         return available_buffers > 0;
     }
 
@@ -203,11 +228,72 @@ private:
     std::vector<CURL *> m_active_handles;
     std::vector<State*> &m_states;
     XrdSysError         &m_log;
+    size_t               m_max_active;
+    bool                 m_starved;
+};
+
+
+// Tunes the number of streams of a pull from its throughput.  A stream is
+// added as long as the previous one raised the throughput by at least 10%;
+// otherwise it is taken back and probing pauses for a few periods.  Should
+// the throughput collapse, the number of streams is halved.
+class StreamTuner {
+public:
+    StreamTuner(size_t streams, size_t max_streams) :
+        m_streams(streams),
+        m_max_streams(std::max(streams, max_streams)),
+        m_hold(1),  // The first period includes connection setup
+        m_probing(false),
+        m_last_bytes(0),
+        m_rate(0)
+    {}
+
+    size_t Streams() const {return m_streams;}
+
+    // Account for the bytes received so far; returns the number of streams
+    // to use from now on.
+    size_t Update(off_t bytes, double secs) {
+        if (secs <= 0) {return m_streams;}
+        double rate = (bytes - m_last_bytes) / secs;
+        m_last_bytes = bytes;
+        if (m_probing) {
+            m_probing = false;
+            if (rate < m_rate * 1.1) {
+                m_streams--;
+                m_hold = m_hold_periods;
+                return m_streams;
+            }
+        } else if (m_streams > 1 && rate < m_rate / 2) {
+            m_streams = (m_streams + 1) / 2;
+            m_hold = m_hold_periods;
+            m_rate = rate;
+            return m_streams;
+        }
+        m_rate = rate;
+        if (m_hold) {
+            m_hold--;
+        } else if (m_streams < m_max_streams) {
+            m_streams++;
+            m_probing = true;
+        }
+        return m_streams;
+    }
+
+private:
+    static const int m_hold_periods = 5;
+
+    size_t m_streams;
+    size_t m_max_streams;
+    int    m_hold;
+    bool   m_probing;
+    off_t  m_last_bytes;
+    double m_rate;
 };
 }
 
 
 int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
+                                       Scheduler::Ticket &ticket,
                                        const char *log_prefix, size_t streams,
                                        std::vector<State*> handles)
 {
@@ -219,6 +305,7 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
     }
     off_t content_size = state.GetContentLength();
     off_t current_offset = 0;
+    ticket.SetSize(content_size);
 
     {
         std::stringstream ss;
@@ -247,7 +334,7 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
 
     // Start response to client prior to the first call to curl_multi_perform
     int retval = req.StartChunkedResp(201, "Created", "Content-Type: text/plain");
-    if (retval) {
+    if (retval || (retval = WaitForSlot(req, ticket, handles[0]->GetStream()))) {
         return retval;
     }
 
@@ -256,8 +343,14 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
     current_offset = mch.StartTransfers(current_offset, content_size, m_block_size, running_handles);
 
     // Transfer loop: use curl to actually run the transfer, but periodically
-    // interrupt things to send back performance updates to the client.
+    // interrupt things to send back performance updates to the client and,
+    // when autotuning, to adjust the streams and reorder buffers.
     time_t last_marker = 0;
+    time_t next_tune = m_autotune ? time(NULL) + m_tune_period : 0;
+    std::chrono::steady_clock::time_point last_tune = std::chrono::steady_clock::now();
+    StreamTuner tuner(streams, m_autotune_streams);
+    Stream &stream = handles[0]->GetStream();
+    int idle_periods = 0;
     CURLcode res = static_cast<CURLcode>(-1);
     CURLMcode mres;
     do {
@@ -269,6 +362,35 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
             }
             last_marker = now;
         }
+        if (next_tune && now >= next_tune) {
+            std::chrono::steady_clock::time_point tune_now = std::chrono::steady_clock::now();
+            std::chrono::duration<double> secs = tune_now - last_tune;
+            last_tune = tune_now;
+            next_tune = now + m_tune_period;
+            concurrency = tuner.Update(stream.BytesReceived(), secs.count()) * m_pipelining_multiplier;
+            while (handles.size() < concurrency) {
+                mch.AddState(handles[0]->Duplicate());
+            }
+            mch.SetMaxActive(concurrency);
+#ifdef USE_PIPELINING
+            curl_multi_setopt(multi_handle, CURLMOPT_MAX_HOST_CONNECTIONS, tuner.Streams());
+#endif
+            // Every transfer needs a buffer to start; beyond that, buffers are
+            // added while out-of-order data holds up new transfers and are
+            // given back once they have gone unused for a while.
+            size_t max_used = stream.TakeMaxUsed();
+            if (mch.TakeStarved() || stream.Buffers() < concurrency) {
+                stream.GrowBuffers();
+                idle_periods = 0;
+            } else if (stream.Buffers() > concurrency && max_used + 1 < stream.Buffers()) {
+                if (++idle_periods >= 3) {
+                    stream.ShrinkBuffers();
+                    idle_periods = 0;
+                }
+            } else {
+                idle_periods = 0;
+            }
+        }
 
         mres = curl_multi_perform(multi_handle, &running_handles);
         if (mres == CURLM_CALL_MULTI_PERFORM) {
@@ -317,7 +439,8 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
             }
         }
 
-        int64_t max_sleep_time = next_marker - time(NULL);
+        int64_t max_sleep_time = (next_tune ? std::min(next_marker, next_tune) : next_marker)
+                                 - time(NULL);
         if (max_sleep_time <= 0) {
             continue;
         }
@@ -372,6 +495,12 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
         ss << "failure: Remote side failed with status code " << state.GetStatusCode();
         m_log.Emsg(log_prefix, "Remote server failed request", ss.str().c_str());
     } else {
+        if (m_autotune) {
+            std::stringstream ts;
+            ts << "Pull finished with " << tuner.Streams() << " streams and "
+               << stream.Buffers() << " reorder buffers";
+            m_log.Emsg(log_prefix, ts.str().c_str());
+        }
         if (!handles[0]->Finalize()) {
             ss << "failure: Failed to finalize and close file handle.";
             m_log.Emsg(log_prefix, "Failed to finalize file handle");
@@ -388,11 +517,12 @@ int TPCHandler::RunCurlWithStreamsImpl(XrdHttpExtReq &req, State &state,
 
 
 int TPCHandler::RunCurlWithStreams(XrdHttpExtReq &req, State &state,
+                                   Scheduler::Ticket &ticket,
                                    const char *log_prefix, size_t streams)
 {
     std::vector<State*> handles;
     try {
-        int retval = RunCurlWithStreamsImpl(req, state, log_prefix, streams, handles);
+        int retval = RunCurlWithStreamsImpl(req, state, ticket, log_prefix, streams, handles);
         for (std::vector<State*>::iterator state_iter = handles.begin();
              state_iter != handles.end();
              state_iter++) {
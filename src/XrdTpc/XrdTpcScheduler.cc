@@ -0,0 +1,179 @@
+
+#include <time.h>
+
+#include "XrdTpcScheduler.hh"
+
+using namespace TPC;
+
+
+Scheduler::Scheduler(size_t max_active, size_t max_per_vo, size_t max_per_host,
+                     Order order) :
+    m_max_active(max_active),
+    m_max_per_vo(max_per_vo),
+    m_max_per_host(max_per_host),
+    m_order(order),
+    m_cond(0),
+    m_active(0),
+    m_seq(0)
+{}
+
+
+Scheduler::Ticket::Ticket(Scheduler &sched, const std::string &vo,
+                          const std::string &host, off_t size) :
+    m_sched(sched),
+    m_vo(vo),
+    m_host(host),
+    m_size(size),
+    m_queued(time(NULL)),
+    m_seq(0),
+    m_admitted(false)
+{}
+
+
+Scheduler::Ticket::~Ticket()
+{
+    m_sched.Release(*this);
+}
+
+
+void
+Scheduler::Ticket::SetSize(off_t size)
+{
+    XrdSysCondVarHelper lock(m_sched.m_cond);
+    m_size = size;
+}
+
+
+bool
+Scheduler::Ticket::Wait(int secs)
+{
+    XrdSysCondVarHelper lock(m_sched.m_cond);
+    time_t deadline = time(NULL) + secs;
+    while (!m_admitted) {
+        int remaining = deadline - time(NULL);
+        if (remaining <= 0 || m_sched.m_cond.Wait(remaining)) {break;}
+    }
+    return m_admitted;
+}
+
+
+size_t
+Scheduler::Ticket::Position() const
+{
+    XrdSysCondVarHelper lock(m_sched.m_cond);
+    if (m_admitted) {return 0;}
+    time_t now = time(NULL);
+    size_t position = 0;
+    for (std::list<Ticket*>::const_iterator iter = m_sched.m_queue.begin();
+         iter != m_sched.m_queue.end();
+         iter++) {
+        if (*iter != this && m_sched.Before(**iter, *this, now)) {position++;}
+    }
+    return position;
+}
+
+
+std::unique_ptr<Scheduler::Ticket>
+Scheduler::Enqueue(const std::string &vo, const std::string &host, off_t size)
+{
+    std::unique_ptr<Ticket> ticket(new Ticket(*this, vo, host, size));
+    XrdSysCondVarHelper lock(m_cond);
+    ticket->m_seq = m_seq++;
+    m_queue.push_back(ticket.get());
+    Dispatch();
+    return ticket;
+}
+
+
+size_t
+Scheduler::Queued() const
+{
+    XrdSysCondVarHelper lock(m_cond);
+    return m_queue.size();
+}
+
+
+// Returns true if `one` should be admitted before `two`.
+bool
+Scheduler::Before(const Ticket &one, const Ticket &two, time_t now) const
+{
+    // Favor the VO that has the fewest transfers running
+    std::map<std::string, size_t>::const_iterator iter;
+    size_t one_vo = (iter = m_vo_active.find(one.m_vo)) == m_vo_active.end() ? 0 : iter->second;
+    size_t two_vo = (iter = m_vo_active.find(two.m_vo)) == m_vo_active.end() ? 0 : iter->second;
+    if (one_vo != two_vo) {return one_vo < two_vo;}
+
+    if (m_order == SJF) {
+        // Transfers that waited too long are taken in arrival order
+        bool one_old = now - one.m_queued > m_max_wait;
+        bool two_old = now - two.m_queued > m_max_wait;
+        if (one_old != two_old) {return one_old;}
+        if (!one_old) {
+            // Transfers of unknown size are assumed to be large
+            off_t one_size = one.m_size < 0 ? static_cast<off_t>(-1ULL >> 1) : one.m_size;
+            off_t two_size = two.m_size < 0 ? static_cast<off_t>(-1ULL >> 1) : two.m_size;
+            if (one_size != two_size) {return one_size < two_size;}
+        }
+    }
+    return one.m_seq < two.m_seq;
+}
+
+
+bool
+Scheduler::Eligible(const Ticket &ticket) const
+{
+    std::map<std::string, size_t>::const_iterator iter;
+    if (m_max_per_vo && (iter = m_vo_active.find(ticket.m_vo)) != m_vo_active.end()
+        && iter->second >= m_max_per_vo) {
+        return false;
+    }
+    if (m_max_per_host && (iter = m_host_active.find(ticket.m_host)) != m_host_active.end()
+        && iter->second >= m_max_per_host) {
+        return false;
+    }
+    return true;
+}
+
+
+// Admit as many queued transfers as the limits allow; called with the lock held.
+void
+Scheduler::Dispatch()
+{
+    bool admitted = false;
+    time_t now = time(NULL);
+    while (!m_queue.empty() && (!m_max_active || m_active < m_max_active)) {
+        std::list<Ticket*>::iterator best = m_queue.end();
+        for (std::list<Ticket*>::iterator iter = m_queue.begin();
+             iter != m_queue.end();
+             iter++) {
+            if (Eligible(**iter) && (best == m_queue.end() || Before(**iter, **best, now))) {
+                best = iter;
+            }
+        }
+        if (best == m_queue.end()) {break;}
+        Ticket *ticket = *best;
+        m_queue.erase(best);
+        ticket->m_admitted = true;
+        m_vo_active[ticket->m_vo]++;
+        m_host_active[ticket->m_host]++;
+        m_active++;
+        admitted = true;
+    }
+    if (admitted) {m_cond.Broadcast();}
+}
+
+
+void
+Scheduler::Release(Ticket &ticket)
+{
+    XrdSysCondVarHelper lock(m_cond);
+    if (!ticket.m_admitted) {
+        m_queue.remove(&ticket);
+        return;
+    }
+    ticket.m_admitted = false;
+    if (!--m_vo_active[ticket.m_vo]) {m_vo_active.erase(ticket.m_vo);}
+    if (!--m_host_active[ticket.m_host]) {m_host_active.erase(ticket.m_host);}
+    m_active--;
+    Dispatch();
+}
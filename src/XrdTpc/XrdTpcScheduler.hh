@@ -0,0 +1,90 @@
+
+/**
+ * The scheduler admits third-party-copy transfers so that a server flooded
+ * with requests runs a bounded number of them at a time.
+ *
+ * Transfers beyond the server-wide, per-VO, or per-remote-host limits wait
+ * in a queue.  When a slot frees up, it goes to a waiting transfer of the
+ * VO with the fewest running transfers; among those, either the oldest
+ * (fifo) or the smallest (sjf) transfer goes first.  With sjf, a transfer
+ * waiting for longer than a minute is taken in arrival order so that
+ * large transfers are not starved.
+ */
+
+#include <sys/types.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+namespace TPC {
+class Scheduler {
+public:
+
+    enum Order {FIFO, SJF};
+
+    // A limit of zero means there is no limit.
+    Scheduler(size_t max_active, size_t max_per_vo, size_t max_per_host,
+              Order order);
+
+    // A transfer waiting for or holding a slot.  The slot, or the place
+    // in the queue, is given up when the ticket is destroyed.
+    class Ticket {
+    public:
+        ~Ticket();
+
+        // Set the transfer size once it is known; -1 means unknown.
+        void SetSize(off_t size);
+
+        // Wait up to secs seconds for a slot; returns true once admitted.
+        bool Wait(int secs);
+
+        // Number of transfers that will be admitted before this one.
+        size_t Position() const;
+
+    private:
+        friend class Scheduler;
+
+        Ticket(Scheduler &sched, const std::string &vo,
+               const std::string &host, off_t size);
+
+        Scheduler &m_sched;
+        std::string m_vo;
+        std::string m_host;
+        off_t m_size;
+        time_t m_queued;
+        unsigned long long m_seq;
+        bool m_admitted;
+    };
+
+    std::unique_ptr<Ticket> Enqueue(const std::string &vo,
+                                    const std::string &host, off_t size);
+
+    // Number of queued transfers.
+    size_t Queued() const;
+
+private:
+
+    static const int m_max_wait = 60;  // Seconds before sjf turns to fifo
+
+    bool Before(const Ticket &one, const Ticket &two, time_t now) const;
+    bool Eligible(const Ticket &ticket) const;
+    void Dispatch();
+    void Release(Ticket &ticket);
+
+    size_t m_max_active;
+    size_t m_max_per_vo;
+    size_t m_max_per_host;
+    Order m_order;
+
+    mutable XrdSysCondVar m_cond;
+    std::list<Ticket*> m_queue;
+    std::map<std::string, size_t> m_vo_active;
+    std::map<std::string, size_t> m_host_active;
+    size_t m_active;
+    unsigned long long m_seq;
+};
+}
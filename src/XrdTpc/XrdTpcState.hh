@@ -65,6 +65,8 @@ public:
 
     CURL *GetHandle() const {return m_curl;}
 
+    Stream &GetStream() const {return *m_stream;}
+
     int AvailableBuffers() const;
 
     void DumpBuffers() const;
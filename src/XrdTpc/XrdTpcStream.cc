@@ -3,23 +3,108 @@
 
 #include "XrdTpcStream.hh"
 
+#include "XrdCks/XrdCksCalcadler32.hh"
+#include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdCks/XrdCksCalcmd5.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdOfs/XrdOfs.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
 #include "XrdSys/XrdSysError.hh"
 
 using namespace TPC;
 
+XrdSysMutex Stream::m_budget_mutex;
+off_t Stream::m_budget = 0;
+off_t Stream::m_budget_used = 0;
+
+Stream::Stream(std::unique_ptr<XrdSfsFile> fh, size_t max_blocks, size_t buffer_size, XrdSysError &log)
+    : m_open_for_write(false),
+      m_avail_count(0),
+      m_buffer_size(buffer_size),
+      m_max_blocks(max_blocks),
+      m_max_used(0),
+      m_fh(std::move(fh)),
+      m_offset(0),
+      m_log(log)
+{
+    m_open_for_write = true;
+}
+
+
 Stream::~Stream()
 {
-    for (std::vector<Entry*>::iterator buffer_iter = m_buffers.begin();
-        buffer_iter != m_buffers.end();
-        buffer_iter++) {
-        delete *buffer_iter;
-        *buffer_iter = NULL;
+    ReleaseBuffers();
+    for (std::vector<XrdCksCalc*>::iterator cks_iter = m_cksums.begin();
+        cks_iter != m_cksums.end();
+        cks_iter++) {
+        delete *cks_iter;
     }
     m_fh->close();
 }
 
 
+void
+Stream::AllocateBuffers()
+{
+    if (!m_open_for_write || !m_buffers.empty()) {return;}
+    m_buffers.reserve(m_max_blocks);
+    for (size_t idx=0; idx < m_max_blocks; idx++) {
+        if (!Reserve(m_buffer_size, idx == 0)) {break;}
+        m_buffers.push_back(new Entry(m_buffer_size));
+    }
+    m_avail_count = m_buffers.size();
+}
+
+
+void
+Stream::SetChecksums(const std::vector<std::string> &names)
+{
+    for (std::vector<std::string>::const_iterator name_iter = names.begin();
+         name_iter != names.end();
+         name_iter++) {
+        XrdCksCalc *calc = NULL;
+        if (*name_iter == "adler32") {
+            calc = new XrdCksCalcadler32;
+        } else if (*name_iter == "crc32") {
+            calc = new XrdCksCalccrc32;
+        } else if (*name_iter == "md5") {
+            calc = new XrdCksCalcmd5;
+        }
+        if (calc) {m_cksums.push_back(calc);}
+    }
+}
+
+
+void
+Stream::StoreChecksums()
+{
+    if (m_cksums.empty()) {return;}
+    // The checksum is handed over in-process; only the OFS can record it
+    XrdOfsFile *ofs_fh = dynamic_cast<XrdOfsFile*>(m_fh.get());
+    if (!ofs_fh) {
+        m_log.Emsg("Stream::StoreChecksums", "Checksums not recorded; the "
+                   "file system is not the OFS");
+        return;
+    }
+    for (std::vector<XrdCksCalc*>::iterator cks_iter = m_cksums.begin();
+         cks_iter != m_cksums.end();
+         cks_iter++) {
+        XrdCksData cks;
+        int size;
+        const char *name = (*cks_iter)->Type(size);
+        // Final() gives the binary value; the char* overload wants hex
+        const void *value = (*cks_iter)->Final();
+        if (!cks.Set(name) || !cks.Set(value, size)) {
+            m_log.Emsg("Stream::StoreChecksums", "Unable to record", name,
+                       "invalid checksum");
+        } else if (ofs_fh->setCksum(cks) != SFS_OK) {
+            m_log.Emsg("Stream::StoreChecksums", "Unable to record", name,
+                       ofs_fh->error.getErrText());
+        }
+    }
+}
+
+
 bool
 Stream::Finalize()
 {
@@ -27,16 +112,105 @@ Stream::Finalize()
     if (!m_open_for_write) {
         return false;
     }
+    // Record the checksums only if everything made it to the file
+    bool flushed = m_avail_count == m_buffers.size();
+    if (flushed) {
+        StoreChecksums();
+    }
+    ReleaseBuffers();
+    m_fh->close();
+    m_open_for_write = false;
+    // If there are outstanding buffers to reorder, finalization failed
+    return flushed;
+}
+
+
+void
+Stream::ReleaseBuffers()
+{
     for (std::vector<Entry*>::iterator buffer_iter = m_buffers.begin();
         buffer_iter != m_buffers.end();
         buffer_iter++) {
         delete *buffer_iter;
-        *buffer_iter = NULL;
     }
-    m_fh->close();
-    m_open_for_write = false;
-    // If there are outstanding buffers to reorder, finalization failed
-    return m_avail_count == m_buffers.size();
+    Release(m_buffers.size() * m_buffer_size);
+    m_buffers.clear();
+    m_avail_count = 0;
+}
+
+
+bool
+Stream::GrowBuffers()
+{
+    if (!m_open_for_write || !Reserve(m_buffer_size, false)) {
+        return false;
+    }
+    m_buffers.push_back(new Entry(m_buffer_size));
+    m_avail_count ++;
+    return true;
+}
+
+
+bool
+Stream::ShrinkBuffers()
+{
+    if (m_buffers.size() <= 1) {
+        return false;
+    }
+    for (std::vector<Entry*>::iterator entry_iter = m_buffers.begin();
+         entry_iter != m_buffers.end();
+         entry_iter++) {
+        if ((*entry_iter)->Available()) {
+            delete *entry_iter;
+            m_buffers.erase(entry_iter);
+            m_avail_count --;
+            Release(m_buffer_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+off_t
+Stream::BytesReceived() const
+{
+    off_t bytes = m_offset;
+    for (std::vector<Entry*>::const_iterator entry_iter = m_buffers.begin();
+         entry_iter != m_buffers.end();
+         entry_iter++) {
+        bytes += (*entry_iter)->GetSize();
+    }
+    return bytes;
+}
+
+
+size_t
+Stream::TakeMaxUsed()
+{
+    size_t max_used = m_max_used;
+    m_max_used = m_buffers.size() - m_avail_count;
+    return max_used;
+}
+
+
+bool
+Stream::Reserve(size_t bytes, bool force)
+{
+    XrdSysMutexHelper lock(m_budget_mutex);
+    if (!force && m_budget && (m_budget_used + static_cast<off_t>(bytes) > m_budget)) {
+        return false;
+    }
+    m_budget_used += bytes;
+    return true;
+}
+
+
+void
+Stream::Release(size_t bytes)
+{
+    XrdSysMutexHelper lock(m_budget_mutex);
+    m_budget_used -= bytes;
 }
 
 
@@ -61,6 +235,19 @@ Stream::Write(off_t offset, const char *buf, size_t size)
         if (retval != SFS_ERROR) {
             m_offset += retval;
         }
+        // A short write leaves a hole that the checksums cannot account for
+        for (std::vector<XrdCksCalc*>::iterator cks_iter = m_cksums.begin();
+             cks_iter != m_cksums.end();
+             cks_iter++) {
+            if (retval == static_cast<int>(size)) {
+                (*cks_iter)->Update(buf, size);
+            } else {
+                delete *cks_iter;
+            }
+        }
+        if (retval != static_cast<int>(size)) {
+            m_cksums.clear();
+        }
         // If there are no in-use buffers, then we don't need to
         // do any accounting.
         if (m_avail_count == m_buffers.size()) {
@@ -104,6 +291,9 @@ Stream::Write(off_t offset, const char *buf, size_t size)
         }
         m_avail_count --;
     }
+    if (m_buffers.size() - m_avail_count > m_max_used) {
+        m_max_used = m_buffers.size() - m_avail_count;
+    }
 
     // If we have low buffer occupancy, then release memory.
     if ((m_buffers.size() > 2) && (m_avail_count * 2 > m_buffers.size())) {
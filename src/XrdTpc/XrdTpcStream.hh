@@ -8,31 +8,27 @@
  */
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <cstring>
 
+#include "XrdSys/XrdSysPthread.hh"
+
 struct stat;
 
+class XrdCksCalc;
 class XrdSfsFile;
 class XrdSysError;
 
 namespace TPC {
 class Stream {
 public:
-    Stream(std::unique_ptr<XrdSfsFile> fh, size_t max_blocks, size_t buffer_size, XrdSysError &log)
-        : m_open_for_write(false),
-          m_avail_count(max_blocks),
-          m_fh(std::move(fh)),
-          m_offset(0),
-          m_log(log)
-    {
-        m_buffers.reserve(max_blocks);
-        for (size_t idx=0; idx < max_blocks; idx++) {
-            m_buffers.push_back(new Entry(buffer_size));
-        }
-        m_open_for_write = true;
-    }
+    // The stream gets up to max_blocks reorder buffers once AllocateBuffers()
+    // is called; fewer are allocated if the server-wide budget (see
+    // SetBudget()) does not allow for all of them, though a stream asking for
+    // any always gets one.
+    Stream(std::unique_ptr<XrdSfsFile> fh, size_t max_blocks, size_t buffer_size, XrdSysError &log);
 
     ~Stream();
 
@@ -44,8 +40,37 @@ public:
 
     size_t AvailableBuffers() const {return m_avail_count;}
 
+    size_t Buffers() const {return m_buffers.size();}
+
+    // Allocate the initial reorder buffers.  This is done once the transfer
+    // has been admitted so that queued transfers hold none of the budget.
+    void AllocateBuffers();
+
+    // Add a reorder buffer if the budget allows; returns true if one was added.
+    bool GrowBuffers();
+
+    // Release an unused reorder buffer; returns true if one was released.
+    bool ShrinkBuffers();
+
+    // Returns the most buffers that held data since the last call.
+    size_t TakeMaxUsed();
+
+    // Number of bytes written to the file or held in reorder buffers.
+    off_t BytesReceived() const;
+
+    // Limit the memory all streams together may reserve for their reorder
+    // buffers; zero, the default, means there is no limit.
+    static void SetBudget(off_t bytes) {m_budget = bytes;}
+
     void DumpBuffers() const;
 
+    // Compute the named checksums over the data as it is committed to the
+    // file.  Since data always reaches the file in offset order, the
+    // checksums are complete once all buffers are flushed; Finalize() then
+    // records them with the file so they need not be recomputed from disk.
+    // Unknown checksum names are ignored.
+    void SetChecksums(const std::vector<std::string> &names);
+
     // Flush and finalize the stream.  If all data has been sent to the underlying
     // file handle, close() will be invoked on the file handle.
     //
@@ -57,6 +82,13 @@ public:
 
 private:
 
+    void StoreChecksums();
+
+    void ReleaseBuffers();
+
+    static bool Reserve(size_t bytes, bool force);
+    static void Release(size_t bytes);
+
     class Entry {
     public:
         Entry(size_t capacity) :
@@ -137,9 +169,17 @@ private:
 
     bool m_open_for_write;
     size_t m_avail_count;
+    size_t m_buffer_size;
+    size_t m_max_blocks;
+    size_t m_max_used;  // Most buffers in use since the last TakeMaxUsed().
     std::unique_ptr<XrdSfsFile> m_fh;
     off_t m_offset;
     std::vector<Entry*> m_buffers;
+    std::vector<XrdCksCalc*> m_cksums;
     XrdSysError &m_log;
+
+    static XrdSysMutex m_budget_mutex;
+    static off_t m_budget;
+    static off_t m_budget_used;
 };
 }
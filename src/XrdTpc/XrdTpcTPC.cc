@@ -158,6 +158,13 @@ TPCHandler::~TPCHandler() {
 }
 
 TPCHandler::TPCHandler(XrdSysError *log, const char *config, XrdOucEnv *myEnv) :
+        m_autotune(true),
+        m_autotune_streams(16),
+        m_autotune_memory(2LL*1024*1024*1024),
+        m_sched_active(0),
+        m_sched_per_vo(0),
+        m_sched_per_host(0),
+        m_sched_order(Scheduler::FIFO),
         m_desthttps(false),
         m_log(*log),
         m_handle_base(NULL),
@@ -200,6 +207,37 @@ int TPCHandler::RedirectTransfer(const std::string &redirect_resource, XrdHttpEx
     return req.SendSimpleResp(307, NULL, const_cast<char *>(ss.str().c_str()), NULL, 0);
 }
 
+// Returns the host:port part of a URL
+static std::string RemoteHost(const std::string &url) {
+    std::string::size_type start = url.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    std::string::size_type end = url.find_first_of("/?", start);
+    return url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+std::unique_ptr<Scheduler::Ticket> TPCHandler::Enqueue(XrdHttpExtReq &req,
+                                                       const std::string &remote,
+                                                       off_t size) {
+    const XrdSecEntity &sec = req.GetSecEntity();
+    std::string vo = sec.vorg ? sec.vorg : (sec.name ? sec.name : "");
+    return m_sched->Enqueue(vo, RemoteHost(remote), size);
+}
+
+int TPCHandler::WaitForSlot(XrdHttpExtReq &req, Scheduler::Ticket &ticket,
+                            Stream &stream) {
+#ifdef XRD_CHUNK_RESP
+    while (!ticket.Wait(m_marker_period)) {
+        if (SendPerfMarker(req, 0, ticket.Position() + 1)) {
+            return -1;
+        }
+    }
+#else
+    while (!ticket.Wait(m_marker_period)) {}
+#endif
+    stream.AllocateBuffers();
+    return 0;
+}
+
 int TPCHandler::OpenWaitStall(XrdSfsFile &fh, const std::string &resource,
                       int mode, int openMode, const XrdSecEntity &sec,
                       const std::string &authz)
@@ -251,7 +289,8 @@ int TPCHandler::DetermineXferSize(CURL *curl, XrdHttpExtReq &req, State &state,
     return 0;
 }
 
-int TPCHandler::SendPerfMarker(XrdHttpExtReq &req, off_t bytes_transferred) {
+int TPCHandler::SendPerfMarker(XrdHttpExtReq &req, off_t bytes_transferred,
+                               size_t queue_position) {
     std::stringstream ss;
     const std::string crlf = "\n";
     ss << "Perf Marker" << crlf;
@@ -259,13 +298,17 @@ int TPCHandler::SendPerfMarker(XrdHttpExtReq &req, off_t bytes_transferred) {
     ss << "Stripe Index: 0" << crlf;
     ss << "Stripe Bytes Transferred: " << bytes_transferred << crlf;
     ss << "Total Stripe Count: 1" << crlf;
+    if (queue_position) {
+        ss << "Queue Position: " << queue_position << crlf;
+        ss << "Queue Depth: " << m_sched->Queued() << crlf;
+    }
     ss << "End" << crlf;
 
     return req.ChunkResp(ss.str().c_str(), 0);
 }
 
 int TPCHandler::RunCurlWithUpdates(CURL *curl, XrdHttpExtReq &req, State &state,
-                                   const char *log_prefix)
+                                   Scheduler::Ticket &ticket, const char *log_prefix)
 {
     // Create the multi-handle and add in the current transfer to it.
     CURLM *multi_handle = curl_multi_init();
@@ -289,7 +332,7 @@ int TPCHandler::RunCurlWithUpdates(CURL *curl, XrdHttpExtReq &req, State &state,
 
     // Start response to client prior to the first call to curl_multi_perform
     int retval = req.StartChunkedResp(201, "Created", "Content-Type: text/plain");
-    if (retval) {
+    if (retval || (retval = WaitForSlot(req, ticket, state.GetStream()))) {
         curl_easy_cleanup(curl);
         curl_multi_cleanup(multi_handle);
         return retval;
@@ -401,6 +444,9 @@ int TPCHandler::RunCurlWithUpdates(CURL *curl, XrdHttpExtReq &req, State &state,
     } else if (state.GetStatusCode() >= 400) {
         ss << "failure: Remote side failed with status code " << state.GetStatusCode();
         m_log.Emsg(log_prefix, "Remote server failed request", ss.str().c_str());
+    } else if (!state.Finalize()) {
+        ss << "failure: Failed to finalize and close file handle.";
+        m_log.Emsg(log_prefix, "Failed to finalize and close file handle.");
     } else {
         ss << "success: Created";
     }
@@ -412,8 +458,9 @@ int TPCHandler::RunCurlWithUpdates(CURL *curl, XrdHttpExtReq &req, State &state,
 }
 #else
 int TPCHandler::RunCurlBasic(CURL *curl, XrdHttpExtReq &req, State &state,
-                             const char *log_prefix) {
+                             Scheduler::Ticket &ticket, const char *log_prefix) {
     CURLcode res;
+    WaitForSlot(req, ticket, state.GetStream());
     res = curl_easy_perform(curl);
     curl_easy_cleanup(curl);
     if (res == CURLE_HTTP_RETURNED_ERROR) {
@@ -492,10 +539,14 @@ int TPCHandler::ProcessPushReq(const std::string & resource, XrdHttpExtReq &req)
     State state(0, stream, curl, true);
     state.CopyHeaders(req);
 
+    struct stat buf;
+    std::unique_ptr<Scheduler::Ticket> ticket =
+        Enqueue(req, resource, stream.Stat(&buf) == SFS_OK ? buf.st_size : -1);
+
 #ifdef XRD_CHUNK_RESP
-    return RunCurlWithUpdates(curl, req, state, "ProcessPushReq");
+    return RunCurlWithUpdates(curl, req, state, *ticket, "ProcessPushReq");
 #else
-    return RunCurlBasic(curl, req, state, "ProcessPushReq");
+    return RunCurlBasic(curl, req, state, *ticket, "ProcessPushReq");
 #endif
 }
 
@@ -567,18 +618,34 @@ int TPCHandler::ProcessPullReq(const std::string &resource, XrdHttpExtReq &req)
         curl_easy_setopt(curl, CURLOPT_CAPATH, m_cadir.c_str());
     }
     curl_easy_setopt(curl, CURLOPT_URL, resource.c_str());
+    if (m_autotune && streams > 1) {
+        streams = std::min(static_cast<size_t>(streams), m_autotune_streams);
+    }
     Stream stream(std::move(fh), streams * m_pipelining_multiplier, m_block_size, m_log);
+    stream.SetChecksums(m_cksums);
     State state(0, stream, curl, false);
     state.CopyHeaders(req);
 
+    std::unique_ptr<Scheduler::Ticket> ticket = Enqueue(req, resource, -1);
+
 #ifdef XRD_CHUNK_RESP
     if (streams > 1) {
-        return RunCurlWithStreams(req, state, "ProcessPullReq", streams);
+        return RunCurlWithStreams(req, state, *ticket, "ProcessPullReq", streams);
     } else {
-        return RunCurlWithUpdates(curl, req, state, "ProcessPullReq");
+        // Shortest-job-first needs to know how much there is to pull
+        if (m_sched_order == Scheduler::SJF) {
+            bool success;
+            int result = DetermineXferSize(curl, req, state, success);
+            if (result || !success) {
+                return result;
+            }
+            ticket->SetSize(state.GetContentLength());
+            state.ResetAfterRequest();
+        }
+        return RunCurlWithUpdates(curl, req, state, *ticket, "ProcessPullReq");
     }
 #else
-    return RunCurlBasic(curl, req, state, "ProcessPullReq");
+    return RunCurlBasic(curl, req, state, *ticket, "ProcessPullReq");
 #endif
 }
 
@@ -7,6 +7,8 @@
 
 #include "XrdHttp/XrdHttpExtHandler.hh"
 
+#include "XrdTpcScheduler.hh"
+
 class XrdOucErrInfo;
 class XrdOucStream;
 class XrdSfsFile;
@@ -15,6 +17,7 @@ typedef void CURL;
 
 namespace TPC {
 class State;
+class Stream;
 
 class TPCHandler : public XrdHttpExtHandler {
 public:
@@ -41,34 +44,60 @@ private:
     int DetermineXferSize(CURL *curl, XrdHttpExtReq &req, TPC::State &state,
                           bool &success);
 
-    int SendPerfMarker(XrdHttpExtReq &req, off_t bytes_transferred);
+    // A non-zero queue position adds the transfer's place in the queue.
+    int SendPerfMarker(XrdHttpExtReq &req, off_t bytes_transferred,
+                       size_t queue_position = 0);
 
     // Perform the libcurl transfer, periodically sending back chunked updates.
     int RunCurlWithUpdates(CURL *curl, XrdHttpExtReq &req, TPC::State &state,
-                           const char *log_prefix);
+                           TPC::Scheduler::Ticket &ticket, const char *log_prefix);
 
     // Experimental multi-stream version of RunCurlWithUpdates
     int RunCurlWithStreams(XrdHttpExtReq &req, TPC::State &state,
+                           TPC::Scheduler::Ticket &ticket,
                            const char *log_prefix, size_t streams);
     int RunCurlWithStreamsImpl(XrdHttpExtReq &req, TPC::State &state,
+                           TPC::Scheduler::Ticket &ticket,
                            const char *log_prefix, size_t streams,
                            std::vector<TPC::State*> streams_handles);
 #else
     int RunCurlBasic(CURL *curl, XrdHttpExtReq &req, TPC::State &state,
-                     const char *log_prefix);
+                     TPC::Scheduler::Ticket &ticket, const char *log_prefix);
 #endif
 
+    // Wait for the scheduler to admit the transfer, then give the stream its
+    // reorder buffers; returns non-zero if the client could not be kept
+    // informed meanwhile.
+    int WaitForSlot(XrdHttpExtReq &req, TPC::Scheduler::Ticket &ticket,
+                    TPC::Stream &stream);
+
+    std::unique_ptr<TPC::Scheduler::Ticket> Enqueue(XrdHttpExtReq &req,
+                                                    const std::string &remote,
+                                                    off_t size);
+
     int ProcessPushReq(const std::string & resource, XrdHttpExtReq &req);
     int ProcessPullReq(const std::string &resource, XrdHttpExtReq &req);
 
     bool ConfigureFSLib(XrdOucStream &Config, std::string &path1, bool &path1_alt,
                         std::string &path2, bool &path2_alt);
+    bool ConfigureAutotune(XrdOucStream &Config);
+    bool ConfigureScheduler(XrdOucStream &Config);
     bool Configure(const char *configfn, XrdOucEnv *myEnv);
 
     static int m_marker_period;
     static size_t m_block_size;
+    static const int m_tune_period = 2; // Seconds between autotuning steps
+    bool m_autotune;             // Adapt the streams and buffers of a pull
+    size_t m_autotune_streams;   // Most streams autotuning may use
+    long long m_autotune_memory; // Server-wide reorder buffer budget
+    size_t m_sched_active;       // Most transfers running at once
+    size_t m_sched_per_vo;       // Most transfers running for a VO
+    size_t m_sched_per_host;     // Most transfers running with a remote host
+    TPC::Scheduler::Order m_sched_order;
+    std::unique_ptr<TPC::Scheduler> m_sched;
     bool m_desthttps;
     std::string m_cadir;
+    std::vector<std::string> m_cksums; // Checksums computed during a pull
     static XrdSysMutex m_monid_mutex;
     static uint64_t m_monid;
     XrdSysError &m_log;
@@ -179,6 +179,7 @@
          "libXrdHttpTPC.so",         \
          "libXrdOssSIgpfsT.so",      \
          "libXrdN2No2p.so",          \
+         "libXrdOfsTPCXrdCl.so",     \
          "libXrdPss.so",             \
          "libXrdSec.so",             \
          "libXrdSecgsi.so",          \
@@ -310,6 +310,15 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
    if (!ConfigFS(xrootdEnv, pi->ConfigFN)) return 0;
    fsFeatures = osFS->Features();
 
+// Publish the filesystem so that other protocols (e.g. http) can use it. They
+// must then also honor our exports and statically redirected paths.
+//
+   if (pi->theEnv)
+      {pi->theEnv->PutPtr("XrdSfsFileSystem*", (void *)osFS);
+       pi->theEnv->PutPtr("XrdXrootdXPList*",  (void *)&XPList);
+       pi->theEnv->PutPtr("XrdXrootdRPList*",  (void *)&RPList);
+      }
+
 // Check if the file system includes a custom prepare handler as this will
 // affect how we handle prepare requests.
 //
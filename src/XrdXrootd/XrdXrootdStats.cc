@@ -154,6 +154,7 @@ int XrdXrootdStats::Stats(XrdXrootdResponse &resp, const char *opts)
                  case 'u': xopts |= XRD_STATS_PROC; break;    // u_sage
                  case 'p': xopts |= XRD_STATS_PROT; break;    // p_rotocol
                  case 's': xopts |= XRD_STATS_SCHD; break;    // s_scheduler
+                 case 't': xopts |= XRD_STATS_TLS;  break;    // t_ls
                  default:  break;
                 }
           opts++;
@@ -24,6 +24,11 @@
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "TestEnv.hh"
 #include "IdentityPlugIn.hh"
@@ -44,6 +49,7 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( MkdirRmdirTest );
       CPPUNIT_TEST( ChmodTest );
       CPPUNIT_TEST( PingTest );
+      CPPUNIT_TEST( StaleBrokerTest );
       CPPUNIT_TEST( StatTest );
       CPPUNIT_TEST( StatVFSTest );
       CPPUNIT_TEST( ProtocolTest );
@@ -61,6 +67,7 @@ class FileSystemTest: public CppUnit::TestCase
     void MkdirRmdirTest();
     void ChmodTest();
     void PingTest();
+    void StaleBrokerTest();
     void StatTest();
     void StatVFSTest();
     void ProtocolTest();
@@ -304,6 +311,56 @@ void FileSystemTest::PingTest()
   CPPUNIT_ASSERT_XRDST( fs.Ping() );
 }
 
+//------------------------------------------------------------------------------
+// Stale connection broker test
+//------------------------------------------------------------------------------
+void FileSystemTest::StaleBrokerTest()
+{
+  using namespace XrdCl;
+
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  //----------------------------------------------------------------------------
+  // Leave a broker socket behind that nobody listens on anymore; use our own
+  // user name so that we do not get an already connected channel
+  //----------------------------------------------------------------------------
+  char brokerDir[] = "/tmp/xrdcl-broker-XXXXXX";
+  CPPUNIT_ASSERT( mkdtemp( brokerDir ) );
+  std::string sockPath = std::string( brokerDir ) + "/" + url.GetHostName() +
+                         ":" + std::to_string( url.GetPort() );
+
+  struct sockaddr_un addr;
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sun_family = AF_UNIX;
+  CPPUNIT_ASSERT( sockPath.size() < sizeof( addr.sun_path ) );
+  strcpy( addr.sun_path, sockPath.c_str() );
+  int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+  CPPUNIT_ASSERT( fd >= 0 );
+  CPPUNIT_ASSERT( bind( fd, (struct sockaddr*)&addr, sizeof( addr ) ) == 0 );
+  close( fd );
+
+  Env *env = DefaultEnv::GetEnv();
+  env->PutString( "ConnectionBroker", brokerDir );
+  url.SetUserName( "stalebroker" );
+
+  //----------------------------------------------------------------------------
+  // The connection must go to the server directly
+  //----------------------------------------------------------------------------
+  FileSystem fs( url );
+  XRootDStatus status = fs.Ping();
+
+  env->PutString( "ConnectionBroker", "" );
+  unlink( sockPath.c_str() );
+  rmdir( brokerDir );
+
+  CPPUNIT_ASSERT_XRDST( status );
+}
+
 //------------------------------------------------------------------------------
 // Stat test
 //------------------------------------------------------------------------------
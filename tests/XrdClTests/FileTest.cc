@@ -34,6 +34,18 @@
 #include "XrdCl/XrdClCopyProcess.hh"
 #include "XrdCl/XrdClZipArchiveReader.hh"
 #include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClHedgedOpen.hh"
+
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 using namespace XrdClTests;
 
@@ -49,8 +61,10 @@ class FileTest: public CppUnit::TestCase
       CPPUNIT_TEST( WriteTest );
       CPPUNIT_TEST( WriteVTest );
       CPPUNIT_TEST( VectorReadTest );
+      CPPUNIT_TEST( LargeReadThroughputTest );
       CPPUNIT_TEST( VectorWriteTest );
       CPPUNIT_TEST( VirtualRedirectorTest );
+      CPPUNIT_TEST( HedgedOpenTest );
       CPPUNIT_TEST( XAttrTest );
       CPPUNIT_TEST( PlugInTest );
     CPPUNIT_TEST_SUITE_END();
@@ -59,8 +73,10 @@ class FileTest: public CppUnit::TestCase
     void WriteTest();
     void WriteVTest();
     void VectorReadTest();
+    void LargeReadThroughputTest();
     void VectorWriteTest();
     void VirtualRedirectorTest();
+    void HedgedOpenTest();
     void XAttrTest();
     void PlugInTest();
 };
@@ -244,6 +260,32 @@ void FileTest::ReadTest()
     CPPUNIT_ASSERT( testset[i].expected == result );
   }
 
+  //----------------------------------------------------------------------------
+  // Read all the files at once
+  //----------------------------------------------------------------------------
+  std::vector<std::string> filenames;
+  std::vector<void*>       buffers;
+  for( int i = 0; i < 3; ++i )
+  {
+    uint64_t size = 0;
+    CPPUNIT_ASSERT_XRDST( zip.GetSize( testset[i].file, size ) );
+    filenames.push_back( testset[i].file );
+    buffers.push_back( new char[size] );
+  }
+
+  VectorReadInfo *vrInfo = 0;
+  CPPUNIT_ASSERT_XRDST( zip.ReadFiles( filenames, buffers, vrInfo ) );
+  CPPUNIT_ASSERT( vrInfo->GetChunks().size() == 3 );
+  for( int i = 0; i < 3; ++i )
+  {
+    ChunkInfo &chunk = vrInfo->GetChunks()[i];
+    CPPUNIT_ASSERT( chunk.offset + testset[i].offset + testset[i].expected.size() <= chunk.length );
+    std::string result( (char*)chunk.buffer + testset[i].offset, testset[i].expected.size() );
+    CPPUNIT_ASSERT( testset[i].expected == result );
+    delete [] (char*)buffers[i];
+  }
+  delete vrInfo;
+
   CPPUNIT_ASSERT_XRDST( zip.Close() );
 }
 
@@ -489,6 +531,94 @@ void FileTest::VectorReadTest()
   delete [] buffer2;
 }
 
+//------------------------------------------------------------------------------
+// Large read throughput test - makes sure the data lands in the user buffers
+// straight from the socket
+//------------------------------------------------------------------------------
+void FileTest::LargeReadThroughputTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string filePath = dataPath + "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+  std::string fileUrl = address + "/";
+  fileUrl += filePath;
+
+  const uint32_t MB       = 1024*1024;
+  const uint64_t fileSize = 1048576000;
+  char *buffer = new char[64*MB];
+  File f;
+
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+
+  uint64_t directBefore, copiedBefore;
+  XRootDMsgHandler::GetDataDeliveryStats( directBefore, copiedBefore );
+
+  timeval start, end;
+  gettimeofday( &start, 0 );
+
+  //----------------------------------------------------------------------------
+  // Read the whole file in large blocks
+  //----------------------------------------------------------------------------
+  uint64_t transferred = 0;
+  for( uint64_t offset = 0; offset < fileSize; offset += 64*MB )
+  {
+    uint32_t bytesRead = 0;
+    CPPUNIT_ASSERT_XRDST( f.Read( offset, 64*MB, buffer, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == std::min<uint64_t>( 64*MB, fileSize-offset ) );
+    transferred += bytesRead;
+  }
+
+  //----------------------------------------------------------------------------
+  // And once more as vector reads
+  //----------------------------------------------------------------------------
+  ChunkList chunkList;
+  for( int i = 0; i < 64; ++i )
+    chunkList.push_back( ChunkInfo( i*10*MB, 1*MB ) );
+  VectorReadInfo *info = 0;
+  CPPUNIT_ASSERT_XRDST( f.VectorRead( chunkList, buffer, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == 64*MB );
+  transferred += info->GetSize();
+  delete info;
+
+  gettimeofday( &end, 0 );
+
+  uint64_t directAfter, copiedAfter;
+  XRootDMsgHandler::GetDataDeliveryStats( directAfter, copiedAfter );
+
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+  delete [] buffer;
+
+  //----------------------------------------------------------------------------
+  // Report and check the memcpy bytes per transferred byte
+  //----------------------------------------------------------------------------
+  double elapsed = ( end.tv_sec - start.tv_sec ) +
+                   ( end.tv_usec - start.tv_usec ) / 1000000.0;
+  double copied  = copiedAfter - copiedBefore;
+  XrdCl::Log *log = TestEnv::GetLog();
+  log->Info( 1, "LargeReadThroughputTest: %llu bytes in %.2f s (%.1f MB/s), "
+             "%llu bytes delivered directly, %.0f bytes copied",
+             (unsigned long long)transferred, elapsed,
+             transferred / elapsed / MB,
+             (unsigned long long)( directAfter - directBefore ), copied );
+
+  CPPUNIT_ASSERT( directAfter - directBefore + copied >= transferred );
+  CPPUNIT_ASSERT( copied / transferred < 0.01 );
+}
+
 void gen_random_str(char *s, const int len)
 {
     static const char alphanum[] =
@@ -709,6 +839,97 @@ void FileTest::VirtualRedirectorTest()
   CPPUNIT_ASSERT_XRDST( process.Run(0) );
 }
 
+//------------------------------------------------------------------------------
+// Hedged open test
+//------------------------------------------------------------------------------
+void FileTest::HedgedOpenTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+  Env *env     = DefaultEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  std::string fileUrl = address + "/" + dataPath +
+                        "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+
+  //----------------------------------------------------------------------------
+  // The primary replica: a socket that is never accepted, the connection
+  // gets established by the kernel but the handshake is never answered
+  //----------------------------------------------------------------------------
+  int sock = socket( AF_INET, SOCK_STREAM, 0 );
+  CPPUNIT_ASSERT( sock >= 0 );
+  sockaddr_in addr;
+  socklen_t   addrLen = sizeof( addr );
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  CPPUNIT_ASSERT( bind( sock, (sockaddr*)&addr, sizeof( addr ) ) == 0 );
+  CPPUNIT_ASSERT( listen( sock, 8 ) == 0 );
+  CPPUNIT_ASSERT( getsockname( sock, (sockaddr*)&addr, &addrLen ) == 0 );
+
+  std::ostringstream slowUrl;
+  slowUrl << "root://127.0.0.1:" << ntohs( addr.sin_port ) << "//" << dataPath;
+  slowUrl << "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+
+  //----------------------------------------------------------------------------
+  // The metalink lists the slow replica first
+  //----------------------------------------------------------------------------
+  char mlPath[] = "/tmp/xrdcl-hedge-XXXXXX";
+  int fd = mkstemp( mlPath );
+  CPPUNIT_ASSERT( fd >= 0 );
+  close( fd );
+  std::string metalink = std::string( mlPath ) + ".meta4";
+  CPPUNIT_ASSERT( rename( mlPath, metalink.c_str() ) == 0 );
+  {
+    std::ofstream ml( metalink.c_str() );
+    ml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    ml << "<metalink xmlns=\"urn:ietf:params:xml:ns:metalink\">\n";
+    ml << "  <file name=\"cb4aacf1-6f28-42f2-b68a-90a73460f424.dat\">\n";
+    ml << "    <url priority=\"1\">" << slowUrl.str() << "</url>\n";
+    ml << "    <url priority=\"2\">" << fileUrl << "</url>\n";
+    ml << "  </file>\n";
+    ml << "</metalink>\n";
+  }
+
+  //----------------------------------------------------------------------------
+  // Open with hedging enabled, the second replica has to win
+  //----------------------------------------------------------------------------
+  uint64_t firedBefore, wonBefore, fired, won;
+  HedgedOpen::GetStats( firedBefore, wonBefore );
+
+  env->PutInt( "HedgedOpenPercentile", 90 );
+  env->PutInt( "HedgedOpenDelay", 200 );
+
+  File f;
+  XRootDStatus status = f.Open( "file://" + metalink, OpenFlags::Read,
+                                Access::None, 30 );
+
+  env->PutInt( "HedgedOpenPercentile", DefaultHedgedOpenPercentile );
+  env->PutInt( "HedgedOpenDelay", DefaultHedgedOpenDelay );
+  unlink( metalink.c_str() );
+
+  CPPUNIT_ASSERT_XRDST( status );
+  HedgedOpen::GetStats( fired, won );
+  CPPUNIT_ASSERT_EQUAL( firedBefore + 1, fired );
+  CPPUNIT_ASSERT_EQUAL( wonBefore + 1, won );
+
+  std::string value;
+  CPPUNIT_ASSERT( f.GetProperty( "LastURL", value ) );
+  CPPUNIT_ASSERT( URL( value ).GetPort() != ntohs( addr.sin_port ) );
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  close( sock );
+}
+
 void FileTest::XAttrTest()
 {
   using namespace XrdCl;
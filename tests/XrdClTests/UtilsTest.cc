@@ -27,9 +27,12 @@
 #include "XrdCl/XrdClURL.hh"
 #include "XrdCl/XrdClAnyObject.hh"
 #include "XrdCl/XrdClTaskManager.hh"
+#include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClPropertyList.hh"
 
+#include <unistd.h>
+
 //------------------------------------------------------------------------------
 // Declaration
 //------------------------------------------------------------------------------
@@ -40,12 +43,14 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( URLTest );
       CPPUNIT_TEST( AnyTest );
       CPPUNIT_TEST( TaskManagerTest );
+      CPPUNIT_TEST( JobManagerTest );
       CPPUNIT_TEST( SIDManagerTest );
       CPPUNIT_TEST( PropertyListTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
+    void JobManagerTest();
     void SIDManagerTest();
     void PropertyListTest();
 };
@@ -372,6 +377,134 @@ void UtilsTest::TaskManagerTest()
   CPPUNIT_ASSERT( taskMan.Stop() );
 }
 
+//------------------------------------------------------------------------------
+// Job counting the runs
+//------------------------------------------------------------------------------
+class CountingJob: public XrdCl::Job
+{
+  public:
+    CountingJob( uint32_t total ): pTotal( total ), pRuns( 0 ) {}
+
+    virtual void Run( void * )
+    {
+      // simulate a short callback
+      volatile uint32_t x = 0;
+      for( uint32_t i = 0; i < 500; ++i ) x += i;
+      pRuns.fetch_add( 1 );
+    }
+
+    //--------------------------------------------------------------------------
+    // Wait for all the runs, give up after given number of seconds
+    //--------------------------------------------------------------------------
+    uint32_t Wait( uint32_t secs )
+    {
+      for( uint32_t i = 0; i < secs * 100 && pRuns.load() < pTotal; ++i )
+        ::usleep( 10000 );
+      return pRuns.load();
+    }
+
+  private:
+    uint32_t              pTotal;
+    std::atomic<uint32_t> pRuns;
+};
+
+//------------------------------------------------------------------------------
+// Job that blocks until another one has run
+//------------------------------------------------------------------------------
+class BlockingJob: public XrdCl::Job
+{
+  public:
+    BlockingJob(): pReleased( false ), pUnblocked( false ), pDone( 0 ) {}
+
+    virtual void Run( void *arg )
+    {
+      if( arg )
+      {
+        pReleased = true;
+        return;
+      }
+      for( uint32_t i = 0; i < 1000 && !pReleased.load(); ++i )
+        ::usleep( 10000 );
+      pUnblocked = pReleased.load();
+      pDone = 1;
+    }
+
+    bool Wait()
+    {
+      for( uint32_t i = 0; i < 2000 && !pDone.load(); ++i )
+        ::usleep( 10000 );
+      return pUnblocked.load();
+    }
+
+  private:
+    std::atomic<bool>     pReleased;
+    std::atomic<bool>     pUnblocked;
+    std::atomic<uint32_t> pDone;
+};
+
+//------------------------------------------------------------------------------
+// Job producer thread, acts like an event loop
+//------------------------------------------------------------------------------
+struct JobProducerData
+{
+  XrdCl::JobManager *jobMan;
+  CountingJob       *job;
+  uint32_t           count;
+};
+
+void *JobProducer( void *arg )
+{
+  JobProducerData *data  = (JobProducerData*)arg;
+  uint32_t         queue = data->jobMan->AssignQueue();
+  for( uint32_t i = 0; i < data->count; ++i )
+    data->jobMan->QueueJob( data->job, 0, queue );
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Job manager test, checks that all the jobs queued by several producers run,
+// with fewer and with more workers than queues
+//------------------------------------------------------------------------------
+void UtilsTest::JobManagerTest()
+{
+  using namespace XrdCl;
+
+  const uint32_t producers = 4;
+  const uint32_t perProd   = 1000;
+  const uint32_t workers[] = { 1, 8 };
+
+  for( size_t w = 0; w < sizeof( workers ) / sizeof( uint32_t ); ++w )
+  {
+    JobManager  jobMan( workers[w], producers );
+    CountingJob job( producers * perProd );
+    CPPUNIT_ASSERT( jobMan.Start() );
+
+    JobProducerData data = { &jobMan, &job, perProd };
+    std::vector<pthread_t> threads( producers );
+    for( uint32_t i = 0; i < producers; ++i )
+      CPPUNIT_ASSERT( pthread_create( &threads[i], 0, JobProducer, &data ) == 0 );
+    for( uint32_t i = 0; i < producers; ++i )
+      pthread_join( threads[i], 0 );
+    uint32_t runs = job.Wait( 60 );
+    CPPUNIT_ASSERT( jobMan.Stop() );
+    CPPUNIT_ASSERT_EQUAL( producers * perProd, runs );
+  }
+
+  //----------------------------------------------------------------------------
+  // A job blocking the only worker of its queue until another job of the same
+  // queue has run, the worker of the other queue has to pick it up
+  //----------------------------------------------------------------------------
+  JobManager  jobMan( 2, 2 );
+  BlockingJob job;
+  CPPUNIT_ASSERT( jobMan.Start() );
+  ::usleep( 100000 );
+  jobMan.QueueJob( &job, 0, 0 );
+  jobMan.QueueJob( &job, &job, 0 );
+  bool unblocked = job.Wait();
+  CPPUNIT_ASSERT( jobMan.Stop() );
+  CPPUNIT_ASSERT( unblocked );
+}
+
 //------------------------------------------------------------------------------
 // SID Manager test
 //------------------------------------------------------------------------------
@@ -0,0 +1,326 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdHttp/XrdHttpHpack.hh"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class HpackTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( HpackTest );
+      CPPUNIT_TEST( IntegerTest );
+      CPPUNIT_TEST( FieldTest );
+      CPPUNIT_TEST( RequestTest );
+      CPPUNIT_TEST( RequestHuffmanTest );
+      CPPUNIT_TEST( ResponseTest );
+      CPPUNIT_TEST( ResponseHuffmanTest );
+      CPPUNIT_TEST( TableSizeTest );
+      CPPUNIT_TEST( RoundTripTest );
+    CPPUNIT_TEST_SUITE_END();
+    void IntegerTest();
+    void FieldTest();
+    void RequestTest();
+    void RequestHuffmanTest();
+    void ResponseTest();
+    void ResponseHuffmanTest();
+    void TableSizeTest();
+    void RoundTripTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( HpackTest );
+
+namespace
+{
+  typedef XrdHttpHpack::hdrList hdrList;
+
+  //----------------------------------------------------------------------------
+  // Convert the hex dumps of RFC 7541 appendix C to bytes, blanks are ignored
+  //----------------------------------------------------------------------------
+  std::string Bytes( const char *hex )
+  {
+    std::string out;
+    char        xx[3] = {0, 0, 0};
+    int         n     = 0;
+
+    for( ; *hex; ++hex )
+    {
+      if( isspace( *hex ) ) continue;
+      xx[n++] = *hex;
+      if( n == 2 )
+      {
+        out += (char)strtol( xx, 0, 16 );
+        n = 0;
+      }
+    }
+    return out;
+  }
+
+  //----------------------------------------------------------------------------
+  // Decode a header block and compare it to the expected fields
+  //----------------------------------------------------------------------------
+  void CheckBlock( XrdHttpHpack &hp, const char *hex, const char *fields[][2],
+                   unsigned int tabSize )
+  {
+    std::string blk = Bytes( hex );
+    hdrList     hdrs;
+
+    CPPUNIT_ASSERT( hp.Decode( blk.data(), blk.size(), hdrs ) );
+    size_t n = 0;
+    while( fields[n][0] ) ++n;
+    CPPUNIT_ASSERT_EQUAL( n, hdrs.size() );
+    for( size_t i = 0; i < n; ++i )
+    {
+      CPPUNIT_ASSERT_EQUAL( std::string( fields[i][0] ), hdrs[i].first );
+      CPPUNIT_ASSERT_EQUAL( std::string( fields[i][1] ), hdrs[i].second );
+    }
+    CPPUNIT_ASSERT_EQUAL( tabSize, hp.TableSize() );
+  }
+
+  //----------------------------------------------------------------------------
+  // The fields of the request sequences (C.3 and C.4)
+  //----------------------------------------------------------------------------
+  const char *req1[][2] = { {":method", "GET"}, {":scheme", "http"},
+                            {":path", "/"}, {":authority", "www.example.com"},
+                            {0, 0} };
+  const char *req2[][2] = { {":method", "GET"}, {":scheme", "http"},
+                            {":path", "/"}, {":authority", "www.example.com"},
+                            {"cache-control", "no-cache"}, {0, 0} };
+  const char *req3[][2] = { {":method", "GET"}, {":scheme", "https"},
+                            {":path", "/index.html"},
+                            {":authority", "www.example.com"},
+                            {"custom-key", "custom-value"}, {0, 0} };
+
+  //----------------------------------------------------------------------------
+  // The fields of the response sequences (C.5 and C.6)
+  //----------------------------------------------------------------------------
+  const char *rsp1[][2] = { {":status", "302"}, {"cache-control", "private"},
+                            {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                            {"location", "https://www.example.com"},
+                            {0, 0} };
+  const char *rsp2[][2] = { {":status", "307"}, {"cache-control", "private"},
+                            {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                            {"location", "https://www.example.com"},
+                            {0, 0} };
+  const char *rsp3[][2] = { {":status", "200"}, {"cache-control", "private"},
+                            {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                            {"location", "https://www.example.com"},
+                            {"content-encoding", "gzip"},
+                            {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; "
+                                           "max-age=3600; version=1"},
+                            {0, 0} };
+}
+
+//------------------------------------------------------------------------------
+// Integer representation (C.1)
+//------------------------------------------------------------------------------
+void HpackTest::IntegerTest()
+{
+  std::string out;
+
+  XrdHttpHpack::EncodeInt( out, 0x00, 5, 10 );
+  CPPUNIT_ASSERT( out == Bytes( "0a" ) );
+
+  out.clear();
+  XrdHttpHpack::EncodeInt( out, 0x00, 5, 1337 );
+  CPPUNIT_ASSERT( out == Bytes( "1f9a0a" ) );
+
+  out.clear();
+  XrdHttpHpack::EncodeInt( out, 0x00, 8, 42 );
+  CPPUNIT_ASSERT( out == Bytes( "2a" ) );
+}
+
+//------------------------------------------------------------------------------
+// Header field representation (C.2)
+//------------------------------------------------------------------------------
+void HpackTest::FieldTest()
+{
+  XrdHttpHpack hp;
+  std::string  name, value;
+
+  // C.2.1 literal with indexing
+  const char *f1[][2] = { {"custom-key", "custom-header"}, {0, 0} };
+  CheckBlock( hp, "400a 6375 7374 6f6d 2d6b 6579 0d63 7573"
+                  "746f 6d2d 6865 6164 6572", f1, 55 );
+  CPPUNIT_ASSERT_EQUAL( 1U, hp.TableEntries() );
+  CPPUNIT_ASSERT( hp.Entry( 62, name, value ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "custom-key" ), name );
+  CPPUNIT_ASSERT_EQUAL( std::string( "custom-header" ), value );
+
+  // C.2.2 literal without indexing
+  XrdHttpHpack hp2;
+  const char *f2[][2] = { {":path", "/sample/path"}, {0, 0} };
+  CheckBlock( hp2, "040c 2f73 616d 706c 652f 7061 7468", f2, 0 );
+
+  // C.2.3 literal never indexed
+  const char *f3[][2] = { {"password", "secret"}, {0, 0} };
+  CheckBlock( hp2, "1008 7061 7373 776f 7264 0673 6563 7265 74", f3, 0 );
+
+  // C.2.4 indexed
+  const char *f4[][2] = { {":method", "GET"}, {0, 0} };
+  CheckBlock( hp2, "82", f4, 0 );
+  CPPUNIT_ASSERT_EQUAL( 0U, hp2.TableEntries() );
+
+  // The encoder produces the same representations
+  std::string out;
+  XrdHttpHpack::EncodeHdr( out, ":path", "/sample/path" );
+  CPPUNIT_ASSERT( out == Bytes( "040c 2f73 616d 706c 652f 7061 7468" ) );
+  out.clear();
+  XrdHttpHpack::EncodeHdr( out, ":method", "GET" );
+  CPPUNIT_ASSERT( out == Bytes( "82" ) );
+}
+
+//------------------------------------------------------------------------------
+// Requests without Huffman coding (C.3)
+//------------------------------------------------------------------------------
+void HpackTest::RequestTest()
+{
+  XrdHttpHpack hp;
+  std::string  name, value;
+
+  CheckBlock( hp, "8286 8441 0f77 7777 2e65 7861 6d70 6c65"
+                  "2e63 6f6d", req1, 57 );
+  CheckBlock( hp, "8286 84be 5808 6e6f 2d63 6163 6865", req2, 110 );
+  CheckBlock( hp, "8287 85bf 400a 6375 7374 6f6d 2d6b 6579"
+                  "0c63 7573 746f 6d2d 7661 6c75 65", req3, 164 );
+
+  CPPUNIT_ASSERT_EQUAL( 3U, hp.TableEntries() );
+  CPPUNIT_ASSERT( hp.Entry( 62, name, value ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "custom-key" ), name );
+  CPPUNIT_ASSERT( hp.Entry( 64, name, value ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( ":authority" ), name );
+  CPPUNIT_ASSERT( !hp.Entry( 65, name, value ) );
+}
+
+//------------------------------------------------------------------------------
+// Requests with Huffman coding (C.4)
+//------------------------------------------------------------------------------
+void HpackTest::RequestHuffmanTest()
+{
+  XrdHttpHpack hp;
+
+  CheckBlock( hp, "8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff", req1, 57 );
+  CheckBlock( hp, "8286 84be 5886 a8eb 1064 9cbf", req2, 110 );
+  CheckBlock( hp, "8287 85bf 4088 25a8 49e9 5ba9 7d7f 8925"
+                  "a849 e95b b8e8 b4bf", req3, 164 );
+}
+
+//------------------------------------------------------------------------------
+// Responses without Huffman coding and a 256 byte table (C.5)
+//------------------------------------------------------------------------------
+void HpackTest::ResponseTest()
+{
+  XrdHttpHpack hp( 256 );
+
+  CheckBlock( hp, "4803 3330 3258 0770 7269 7661 7465 611d"
+                  "4d6f 6e2c 2032 3120 4f63 7420 3230 3133"
+                  "2032 303a 3133 3a32 3120 474d 546e 1768"
+                  "7474 7073 3a2f 2f77 7777 2e65 7861 6d70"
+                  "6c65 2e63 6f6d", rsp1, 222 );
+  CheckBlock( hp, "4803 3330 37c1 c0bf", rsp2, 222 );
+  CheckBlock( hp, "88c1 611d 4d6f 6e2c 2032 3120 4f63 7420"
+                  "3230 3133 2032 303a 3133 3a32 3220 474d"
+                  "54c0 5a04 677a 6970 7738 666f 6f3d 4153"
+                  "444a 4b48 514b 425a 584f 5157 454f 5049"
+                  "5541 5851 5745 4f49 553b 206d 6178 2d61"
+                  "6765 3d33 3630 303b 2076 6572 7369 6f6e"
+                  "3d31", rsp3, 215 );
+  CPPUNIT_ASSERT_EQUAL( 3U, hp.TableEntries() );
+}
+
+//------------------------------------------------------------------------------
+// Responses with Huffman coding and a 256 byte table (C.6)
+//------------------------------------------------------------------------------
+void HpackTest::ResponseHuffmanTest()
+{
+  XrdHttpHpack hp( 256 );
+
+  CheckBlock( hp, "4882 6402 5885 aec3 771a 4b61 96d0 7abe"
+                  "9410 54d4 44a8 2005 9504 0b81 66e0 82a6"
+                  "2d1b ff6e 919d 29ad 1718 63c7 8f0b 97c8"
+                  "e9ae 82ae 43d3", rsp1, 222 );
+  CheckBlock( hp, "4883 640e ffc1 c0bf", rsp2, 222 );
+  CheckBlock( hp, "88c1 6196 d07a be94 1054 d444 a820 0595"
+                  "040b 8166 e084 a62d 1bff c05a 839b d9ab"
+                  "77ad 94e7 821d d7f2 e6c7 b335 dfdf cd5b"
+                  "3960 d5af 2708 7f36 72c1 ab27 0fb5 291f"
+                  "9587 3160 65c0 03ed 4ee5 b106 3d50 07", rsp3, 215 );
+  CPPUNIT_ASSERT_EQUAL( 3U, hp.TableEntries() );
+}
+
+//------------------------------------------------------------------------------
+// Dynamic table size updates
+//------------------------------------------------------------------------------
+void HpackTest::TableSizeTest()
+{
+  XrdHttpHpack hp;
+  hdrList      hdrs;
+
+  CheckBlock( hp, "8286 8441 0f77 7777 2e65 7861 6d70 6c65"
+                  "2e63 6f6d", req1, 57 );
+
+  // Shrinking the table to nothing evicts everything
+  std::string blk = Bytes( "20" );
+  CPPUNIT_ASSERT( hp.Decode( blk.data(), blk.size(), hdrs ) );
+  CPPUNIT_ASSERT_EQUAL( 0U, hp.TableSize() );
+  CPPUNIT_ASSERT_EQUAL( 0U, hp.TableEntries() );
+
+  // The table may not grow beyond what the settings allow
+  std::string big;
+  XrdHttpHpack::EncodeInt( big, 0x20, 5, 4097 );
+  CPPUNIT_ASSERT( !hp.Decode( big.data(), big.size(), hdrs ) );
+
+  // Nor may a block refer to an entry that does not exist
+  blk = Bytes( "be" );
+  CPPUNIT_ASSERT( !hp.Decode( blk.data(), blk.size(), hdrs ) );
+
+  // A Huffman string with padding that is not a prefix of EOS is an error
+  blk = Bytes( "4081 0001 61" );
+  CPPUNIT_ASSERT( !hp.Decode( blk.data(), blk.size(), hdrs ) );
+}
+
+//------------------------------------------------------------------------------
+// What the encoder produces decodes to the same fields
+//------------------------------------------------------------------------------
+void HpackTest::RoundTripTest()
+{
+  XrdHttpHpack hp;
+  hdrList      in, out;
+  std::string  blk;
+
+  in.push_back( std::make_pair( ":status", "206" ) );
+  in.push_back( std::make_pair( "content-length", "1048576" ) );
+  in.push_back( std::make_pair( "content-range", "bytes 0-1048575/4194304" ) );
+  in.push_back( std::make_pair( "x-transfer-id", std::string( 300, 'a' ) ) );
+  in.push_back( std::make_pair( "accept-ranges", "bytes" ) );
+
+  for( size_t i = 0; i < in.size(); ++i )
+    XrdHttpHpack::EncodeHdr( blk, in[i].first.c_str(), in[i].second );
+
+  CPPUNIT_ASSERT( hp.Decode( blk.data(), blk.size(), out ) );
+  CPPUNIT_ASSERT( in == out );
+  CPPUNIT_ASSERT_EQUAL( 0U, hp.TableEntries() );
+}
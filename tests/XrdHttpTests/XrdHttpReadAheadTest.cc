@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD contributors
+// Author: agent <agent@local>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdHttp/XrdHttpReadAhead.hh"
+
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class ReadAheadTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( ReadAheadTest );
+      CPPUNIT_TEST( FullReadTest );
+      CPPUNIT_TEST( ShortReadOneBufferTest );
+      CPPUNIT_TEST( ShortReadTwoBuffersTest );
+      CPPUNIT_TEST( TruncatedTest );
+      CPPUNIT_TEST( SinkFailureTest );
+    CPPUNIT_TEST_SUITE_END();
+    void FullReadTest();
+    void ShortReadOneBufferTest();
+    void ShortReadTwoBuffersTest();
+    void TruncatedTest();
+    void SinkFailureTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ReadAheadTest );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // A file in memory, no read returns more than maxRead bytes
+  //----------------------------------------------------------------------------
+  class MemFile: public XrdSfsFile
+  {
+    public:
+      MemFile( const std::string &d, int mr ): data( d ), maxRead( mr ) {}
+
+      XrdSfsXferSize read( XrdSfsFileOffset offset, char *buffer,
+                           XrdSfsXferSize size )
+      {
+        if( offset >= (XrdSfsFileOffset)data.size() ) return 0;
+        size_t n = std::min( (size_t)std::min( size, maxRead ),
+                             (size_t)( data.size() - offset ) );
+        memcpy( buffer, data.data() + offset, n );
+        return n;
+      }
+
+      int open( const char*, XrdSfsFileOpenMode, mode_t, const XrdSecEntity*,
+                const char* ) { return SFS_OK; }
+      int close() { return SFS_OK; }
+      int fctl( const int, const char*, XrdOucErrInfo& ) { return SFS_ERROR; }
+      const char *FName() { return "memfile"; }
+      int getMmap( void **Addr, off_t &Size ) { *Addr = 0; Size = 0;
+                                                return SFS_OK; }
+      XrdSfsXferSize read( XrdSfsFileOffset, XrdSfsXferSize ) { return 0; }
+      int read( XrdSfsAio* ) { return SFS_ERROR; }
+      XrdSfsXferSize write( XrdSfsFileOffset, const char*, XrdSfsXferSize )
+                          { return -EROFS; }
+      int write( XrdSfsAio* ) { return SFS_ERROR; }
+      int stat( struct stat* ) { return SFS_ERROR; }
+      int sync() { return SFS_OK; }
+      int sync( XrdSfsAio* ) { return SFS_ERROR; }
+      int truncate( XrdSfsFileOffset ) { return SFS_ERROR; }
+      int getCXinfo( char cxtype[4], int &cxrsz ) { cxrsz = 0;
+                                                    return SFS_OK; }
+
+    private:
+      std::string    data;
+      XrdSfsXferSize maxRead;
+  };
+
+  //----------------------------------------------------------------------------
+  // Collects what is sent, failing after failAt bytes if that is set
+  //----------------------------------------------------------------------------
+  class StrSink: public XrdHttpReadAhead::Sink
+  {
+    public:
+      StrSink( size_t fa = 0 ): failAt( fa ) {}
+
+      int Send( const char *buff, int blen )
+      {
+        if( failAt && out.size() + blen > failAt ) return -1;
+        out.append( buff, blen );
+        return 0;
+      }
+
+      std::string out;
+      size_t      failAt;
+  };
+
+  //----------------------------------------------------------------------------
+  // The scheduler running the read ahead, it is never deleted
+  //----------------------------------------------------------------------------
+  XrdScheduler *Sched()
+  {
+    static XrdScheduler *sched = 0;
+    if( !sched )
+    {
+      sched = new XrdScheduler( 3, 8, 0 );
+      sched->Start();
+    }
+    return sched;
+  }
+
+  std::string Pattern( size_t n )
+  {
+    std::string s( n, 0 );
+    for( size_t i = 0; i < n; ++i ) s[i] = (char)( i * 7 + i / 251 );
+    return s;
+  }
+
+  //----------------------------------------------------------------------------
+  // Pump len bytes at offs of the file through buffers of bsz bytes
+  //----------------------------------------------------------------------------
+  int Pump( MemFile &file, long long offs, long long len, int bsz, bool two,
+            StrSink &sink, long long &done )
+  {
+    std::string b0( bsz, 0 ), b1( bsz, 0 );
+    char *bp[2] = { &b0[0], ( two ? &b1[0] : 0 ) };
+    return XrdHttpReadAhead::Pump( Sched(), &file, offs, len, bp, bsz, sink,
+                                   done );
+  }
+}
+
+//------------------------------------------------------------------------------
+// The whole file in full blocks
+//------------------------------------------------------------------------------
+void ReadAheadTest::FullReadTest()
+{
+  std::string data = Pattern( 10000 );
+  MemFile     file( data, 1 << 20 );
+  StrSink     sink;
+  long long   done;
+
+  CPPUNIT_ASSERT_EQUAL( 0, Pump( file, 0, 10000, 1024, true, sink, done ) );
+  CPPUNIT_ASSERT_EQUAL( 10000LL, done );
+  CPPUNIT_ASSERT( sink.out == data );
+}
+
+//------------------------------------------------------------------------------
+// A file fitting in one buffer whose reads come back short
+//------------------------------------------------------------------------------
+void ReadAheadTest::ShortReadOneBufferTest()
+{
+  std::string data = Pattern( 1000 );
+  MemFile     file( data, 300 );
+  StrSink     sink;
+  long long   done;
+
+  CPPUNIT_ASSERT_EQUAL( 0, Pump( file, 0, 1000, 1000, false, sink, done ) );
+  CPPUNIT_ASSERT_EQUAL( 1000LL, done );
+  CPPUNIT_ASSERT( sink.out == data );
+}
+
+//------------------------------------------------------------------------------
+// A range read through two buffers with short reads
+//------------------------------------------------------------------------------
+void ReadAheadTest::ShortReadTwoBuffersTest()
+{
+  std::string data = Pattern( 10000 );
+  MemFile     file( data, 700 );
+  StrSink     sink;
+  long long   done;
+
+  CPPUNIT_ASSERT_EQUAL( 0, Pump( file, 123, 9000, 1024, true, sink, done ) );
+  CPPUNIT_ASSERT_EQUAL( 9000LL, done );
+  CPPUNIT_ASSERT( sink.out == data.substr( 123, 9000 ) );
+}
+
+//------------------------------------------------------------------------------
+// The file is shorter than what was promised, e.g. truncated meanwhile
+//------------------------------------------------------------------------------
+void ReadAheadTest::TruncatedTest()
+{
+  std::string data = Pattern( 1500 );
+  MemFile     file1( data, 1 << 20 ), file2( data, 1 << 20 );
+  StrSink     sink1, sink2;
+  long long   done;
+
+  CPPUNIT_ASSERT_EQUAL( -1, Pump( file1, 0, 2000, 2000, false, sink1, done ) );
+  CPPUNIT_ASSERT_EQUAL( 1500LL, done );
+  CPPUNIT_ASSERT( sink1.out == data );
+
+  CPPUNIT_ASSERT_EQUAL( -1, Pump( file2, 0, 2000, 512, true, sink2, done ) );
+  CPPUNIT_ASSERT_EQUAL( 1500LL, done );
+  CPPUNIT_ASSERT( sink2.out == data );
+}
+
+//------------------------------------------------------------------------------
+// The client went away
+//------------------------------------------------------------------------------
+void ReadAheadTest::SinkFailureTest()
+{
+  std::string data = Pattern( 10000 );
+  MemFile     file( data, 1 << 20 );
+  StrSink     sink( 3000 );
+  long long   done;
+
+  CPPUNIT_ASSERT_EQUAL( 1, Pump( file, 0, 10000, 1024, true, sink, done ) );
+  CPPUNIT_ASSERT( sink.out == data.substr( 0, 2048 ) );
+}